@@ -64,6 +64,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    enable_custom_split_merge),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"max_dict_bytes",
+         {offsetof(struct CompressedSecondaryCacheOptions, max_dict_bytes),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
 };
 
 namespace {
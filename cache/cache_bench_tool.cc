@@ -119,6 +119,9 @@ DEFINE_string(secondary_cache_uri, "",
 
 DEFINE_string(cache_type, "lru_cache", "Type of block cache.");
 
+DEFINE_bool(tiny_lfu_admission, false,
+            "Use a TinyLFU admission policy (lru_cache only).");
+
 DEFINE_bool(use_jemalloc_no_dump_allocator, false,
             "Whether to use JemallocNoDumpAllocator");
 
@@ -417,6 +420,10 @@ class CacheBench {
                            0.5 /* high_pri_pool_ratio */);
       opts.hash_seed = BitwiseAnd(FLAGS_seed, INT32_MAX);
       opts.memory_allocator = allocator;
+      if (FLAGS_tiny_lfu_admission) {
+        opts.admission_policy = NewTinyLFUAdmissionPolicy(
+            static_cast<size_t>(FLAGS_cache_size / FLAGS_value_bytes));
+      }
       ConfigureSecondaryCache(opts);
       cache_ = NewLRUCache(opts);
     } else {
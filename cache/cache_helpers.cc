@@ -7,6 +7,10 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+thread_local CacheCaller current_cache_caller = CacheCaller::kOther;
+}  // namespace
+
 void ReleaseCacheHandleCleanup(void* arg1, void* arg2) {
   Cache* const cache = static_cast<Cache*>(arg1);
   assert(cache);
@@ -38,4 +42,13 @@ Status WarmInCache(Cache* cache, const Slice& key, const Slice& saved,
   return st;
 }
 
+CacheCallerScope::CacheCallerScope(CacheCaller caller)
+    : saved_(current_cache_caller) {
+  current_cache_caller = caller;
+}
+
+CacheCallerScope::~CacheCallerScope() { current_cache_caller = saved_; }
+
+CacheCaller CacheCallerScope::Current() { return current_cache_caller; }
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -136,4 +136,24 @@ Status WarmInCache(Cache* cache, const Slice& key, const Slice& saved,
                    Cache::Priority priority = Cache::Priority::LOW,
                    size_t* out_charge = nullptr);
 
+// Sets the CacheCaller that cache insertions on the current thread are
+// charged to, for the lifetime of the object. Cache::Insert() has no caller
+// parameter, so the caller is passed on through a thread-local variable,
+// which only LRUCache with LRUCacheOptions::caller_quota_ratios reads.
+class CacheCallerScope {
+ public:
+  explicit CacheCallerScope(CacheCaller caller);
+  ~CacheCallerScope();
+
+  CacheCallerScope(const CacheCallerScope&) = delete;
+  CacheCallerScope& operator=(const CacheCallerScope&) = delete;
+
+  // The caller of the innermost scope on the current thread, or kOther if
+  // there is none.
+  static CacheCaller Current();
+
+ private:
+  CacheCaller saved_;
+};
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -11,12 +11,19 @@
 
 #include "memory/memory_allocator_impl.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/statistics_impl.h"
+#include "rocksdb/system_clock.h"
 #include "util/coding.h"
 #include "util/compression.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// The dictionary is trained from samples of about this many times its size.
+constexpr size_t kDictSampleFactor = 100;
+}  // namespace
+
 CompressedSecondaryCache::CompressedSecondaryCache(
     const CompressedSecondaryCacheOptions& opts)
     : cache_(opts.LRUCacheOptions::MakeSharedCache()),
@@ -43,6 +50,8 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
 
   std::unique_ptr<SecondaryCacheResultHandle> handle;
   kept_in_sec_cache = false;
+  SystemClock* clock = SystemClock::Default().get();
+  const uint64_t start_micros = stats != nullptr ? clock->NowMicros() : 0;
   Cache::Handle* lru_handle = cache_->Lookup(key);
   if (lru_handle == nullptr) {
     return nullptr;
@@ -61,6 +70,7 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   const char* data_ptr = nullptr;
   CacheTier source = CacheTier::kVolatileCompressedTier;
   CompressionType type = cache_options_.compression_type;
+  bool use_dict = false;
   if (cache_options_.enable_custom_split_merge) {
     CacheValueChunk* value_chunk_ptr =
         reinterpret_cast<CacheValueChunk*>(handle_value);
@@ -79,6 +89,8 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
     data_ptr = GetVarint32Ptr(data_ptr, data_ptr + 1,
                               static_cast<uint32_t*>(&source_32));
     source = static_cast<CacheTier>(source_32);
+    use_dict = *data_ptr != 0;
+    data_ptr++;
     handle_value_charge -= (data_ptr - ptr->get());
   }
   MemoryAllocator* allocator = cache_options_.memory_allocator.get();
@@ -87,17 +99,20 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   Cache::ObjectPtr value{nullptr};
   size_t charge{0};
   if (source == CacheTier::kVolatileCompressedTier) {
-    if (cache_options_.compression_type == kNoCompression ||
-        cache_options_.do_not_compress_roles.Contains(helper->role)) {
+    const CompressionType compression_type = GetCompressionType(helper->role);
+    if (compression_type == kNoCompression) {
       s = helper->create_cb(Slice(data_ptr, handle_value_charge),
                             kNoCompression, CacheTier::kVolatileTier,
                             create_context, allocator, &value, &charge);
     } else {
-      UncompressionContext uncompression_context(
-          cache_options_.compression_type);
-      UncompressionInfo uncompression_info(uncompression_context,
-                                           UncompressionDict::GetEmptyDict(),
-                                           cache_options_.compression_type);
+      // The dictionary never changes once an entry uses it.
+      assert(!use_dict || dict_ready_.load(std::memory_order_acquire));
+      UncompressionContext uncompression_context(compression_type);
+      UncompressionInfo uncompression_info(
+          uncompression_context,
+          use_dict ? dict_->uncompression_dict
+                   : UncompressionDict::GetEmptyDict(),
+          compression_type);
 
       size_t uncompressed_size{0};
       CacheAllocationPtr uncompressed =
@@ -139,6 +154,13 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   }
   handle.reset(new CompressedSecondaryCacheResultHandle(value, charge));
   RecordTick(stats, COMPRESSED_SECONDARY_CACHE_HITS);
+  if (stats != nullptr) {
+    RecordInHistogram(stats, COMPRESSED_SECONDARY_CACHE_HIT_MICROS,
+                      clock->NowMicros() - start_micros);
+    RecordTick(stats, COMPRESSED_SECONDARY_CACHE_HIT_BYTES, charge);
+    RecordTick(stats, COMPRESSED_SECONDARY_CACHE_HIT_COMPRESSED_BYTES,
+               handle_value_charge);
+  }
   return handle;
 }
 
@@ -169,10 +191,15 @@ Status CompressedSecondaryCache::InsertInternal(
   }
 
   auto internal_helper = GetHelper(cache_options_.enable_custom_split_merge);
-  char header[10];
+  // The header of an entry (without custom split/merge) is the compression
+  // type of the saved value, the tier it comes from, and whether the cache
+  // compressed it with the dictionary.
+  char header[11];
   char* payload = header;
   payload = EncodeVarint32(payload, static_cast<uint32_t>(type));
   payload = EncodeVarint32(payload, static_cast<uint32_t>(source));
+  char* dict_flag = payload++;
+  *dict_flag = 0;
 
   size_t header_size = payload - header;
   size_t data_size = (*helper->size_cb)(value);
@@ -187,18 +214,27 @@ Status CompressedSecondaryCache::InsertInternal(
   }
   Slice val(data_ptr, data_size);
 
+  const CompressionType compression_type =
+      type == kNoCompression ? GetCompressionType(helper->role)
+                             : kNoCompression;
+  const Dictionary* dict = nullptr;
+  if (compression_type == kZSTD && cache_options_.max_dict_bytes > 0 &&
+      !cache_options_.enable_custom_split_merge && ZSTD_Supported()) {
+    dict = GetOrSampleDictionary(val);
+    *dict_flag = dict != nullptr ? 1 : 0;
+  }
+
   std::string compressed_val;
-  if (cache_options_.compression_type != kNoCompression &&
-      type == kNoCompression &&
-      !cache_options_.do_not_compress_roles.Contains(helper->role)) {
+  if (compression_type != kNoCompression) {
     PERF_COUNTER_ADD(compressed_sec_cache_uncompressed_bytes, data_size);
     CompressionOptions compression_opts;
-    CompressionContext compression_context(cache_options_.compression_type,
-                                           compression_opts);
+    CompressionContext compression_context(compression_type, compression_opts);
     uint64_t sample_for_compression{0};
     CompressionInfo compression_info(
-        compression_opts, compression_context, CompressionDict::GetEmptyDict(),
-        cache_options_.compression_type, sample_for_compression);
+        compression_opts, compression_context,
+        dict != nullptr ? dict->compression_dict
+                        : CompressionDict::GetEmptyDict(),
+        compression_type, sample_for_compression);
 
     bool success =
         CompressData(val, compression_info,
@@ -224,7 +260,7 @@ Status CompressedSecondaryCache::InsertInternal(
   if (cache_options_.enable_custom_split_merge) {
     size_t charge{0};
     CacheValueChunk* value_chunks_head =
-        SplitValueIntoChunks(val, cache_options_.compression_type, charge);
+        SplitValueIntoChunks(val, compression_type, charge);
     return cache_->Insert(key, value_chunks_head, internal_helper, charge);
   } else {
     std::memcpy(ptr.get(), header, header_size);
@@ -233,6 +269,54 @@ Status CompressedSecondaryCache::InsertInternal(
   }
 }
 
+CompressionType CompressedSecondaryCache::GetCompressionType(
+    CacheEntryRole role) const {
+  if (cache_options_.compression_type == kNoCompression ||
+      cache_options_.do_not_compress_roles.Contains(role)) {
+    return kNoCompression;
+  }
+  if (cache_options_.fast_compression_roles.Contains(role) &&
+      LZ4_Supported()) {
+    return kLZ4Compression;
+  }
+  return cache_options_.compression_type;
+}
+
+const CompressedSecondaryCache::Dictionary*
+CompressedSecondaryCache::GetOrSampleDictionary(const Slice& value) {
+  if (dict_ready_.load(std::memory_order_acquire)) {
+    return dict_.get();
+  }
+  MutexLock l(&dict_mutex_);
+  if (dict_ready_.load(std::memory_order_relaxed)) {
+    return dict_.get();
+  }
+  dict_samples_.append(value.data(), value.size());
+  dict_sample_lens_.push_back(value.size());
+  const size_t max_dict_bytes = cache_options_.max_dict_bytes;
+  if (dict_samples_.size() < kDictSampleFactor * max_dict_bytes) {
+    return nullptr;
+  }
+  std::string dict;
+  if (ZSTD_TrainDictionarySupported()) {
+    dict = ZSTD_TrainDictionary(dict_samples_, dict_sample_lens_,
+                                max_dict_bytes);
+  } else {
+    // Without the trainer, the latest samples make a raw content dictionary,
+    // like for BlockBasedTableBuilder.
+    dict = dict_samples_.substr(dict_samples_.size() - max_dict_bytes);
+  }
+  if (!dict.empty()) {
+    dict_.reset(new Dictionary(dict));
+  }
+  std::string().swap(dict_samples_);
+  std::vector<size_t>().swap(dict_sample_lens_);
+  dict_ready_.store(true, std::memory_order_release);
+  // The sampled entry itself is compressed without the dictionary, like all
+  // the entries before it.
+  return nullptr;
+}
+
 Status CompressedSecondaryCache::Insert(const Slice& key,
                                         Cache::ObjectPtr value,
                                         const Cache::CacheItemHelper* helper,
@@ -294,6 +378,9 @@ std::string CompressedSecondaryCache::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
            cache_options_.compress_format_version);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    max_dict_bytes : %u\n",
+           cache_options_.max_dict_bytes);
+  ret.append(buffer);
   return ret;
 }
 
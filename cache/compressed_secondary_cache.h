@@ -6,8 +6,11 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "cache/cache_reservation_manager.h"
 #include "cache/lru_cache.h"
@@ -139,6 +142,26 @@ class CompressedSecondaryCache : public SecondaryCache {
                         const Cache::CacheItemHelper* helper,
                         CompressionType type, CacheTier source);
 
+  // The compression type of the entries of `role` that are compressed by the
+  // cache.
+  CompressionType GetCompressionType(CacheEntryRole role) const;
+
+  // The ZSTD dictionary that entries are compressed with once trained. See
+  // CompressedSecondaryCacheOptions::max_dict_bytes.
+  struct Dictionary {
+    explicit Dictionary(const std::string& dict)
+        : compression_dict(dict, kZSTD,
+                           CompressionOptions::kDefaultCompressionLevel),
+          uncompression_dict(dict, /*using_zstd=*/true) {}
+
+    CompressionDict compression_dict;
+    UncompressionDict uncompression_dict;
+  };
+
+  // Returns the dictionary to compress an entry with, or nullptr if it is
+  // not trained yet, in which case `value` is added to the training samples.
+  const Dictionary* GetOrSampleDictionary(const Slice& value);
+
   // TODO: clean up to use cleaner interfaces in typed_cache.h
   const Cache::CacheItemHelper* GetHelper(bool enable_custom_split_merge) const;
   std::shared_ptr<Cache> cache_;
@@ -146,6 +169,14 @@ class CompressedSecondaryCache : public SecondaryCache {
   mutable port::Mutex capacity_mutex_;
   std::shared_ptr<ConcurrentCacheReservationManager> cache_res_mgr_;
   bool disable_cache_;
+
+  // Set once the dictionary is trained, or the training failed. dict_ does
+  // not change afterwards, and can be read without the mutex.
+  std::atomic<bool> dict_ready_{false};
+  port::Mutex dict_mutex_;
+  std::string dict_samples_;
+  std::vector<size_t> dict_sample_lens_;
+  std::unique_ptr<Dictionary> dict_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -937,6 +937,131 @@ TEST_P(CompressedSecondaryCacheTestWithCompressionParam, EntryRoles) {
   }
 }
 
+TEST_P(CompressedSecondaryCacheTestWithCompressionParam,
+       FastCompressionRoles) {
+  if (!sec_cache_is_compressed_) {
+    ROCKSDB_GTEST_BYPASS("Only for compressed secondary cache");
+    return;
+  }
+  if (!LZ4_Supported() || !ZSTD_Supported()) {
+    ROCKSDB_GTEST_SKIP("This test requires LZ4 and ZSTD support.");
+    return;
+  }
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 4096;
+  opts.num_shard_bits = 0;
+  opts.compression_type = kZSTD;
+  opts.fast_compression_roles.Add(CacheEntryRole::kDataBlock);
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+
+  // Doesn't compress, so the compressed size tells the compression type.
+  std::string junk(Random(301).RandomString(1000));
+  for (CacheEntryRole role :
+       {CacheEntryRole::kDataBlock, CacheEntryRole::kIndexBlock}) {
+    junk[0] = static_cast<char>(role);
+    TestItem item{junk.data(), junk.length()};
+    Slice key = Slice(junk.data(), 16);
+
+    get_perf_context()->Reset();
+    ASSERT_OK(sec_cache->Insert(key, &item, GetHelper(role),
+                                /*force_insert=*/true));
+    if (role == CacheEntryRole::kDataBlock) {
+      // LZ4, as in EntryRoles
+      ASSERT_EQ(get_perf_context()->compressed_sec_cache_compressed_bytes,
+                1007);
+    } else {
+      ASSERT_NE(get_perf_context()->compressed_sec_cache_compressed_bytes,
+                1007);
+    }
+
+    bool kept_in_sec_cache{true};
+    std::unique_ptr<SecondaryCacheResultHandle> handle = sec_cache->Lookup(
+        key, GetHelper(role), this, true,
+        /*advise_erase=*/true, /*stats=*/nullptr, kept_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    std::unique_ptr<TestItem> val =
+        std::unique_ptr<TestItem>(static_cast<TestItem*>(handle->Value()));
+    ASSERT_NE(val, nullptr);
+    ASSERT_EQ(memcmp(val->Buf(), item.Buf(), item.Size()), 0);
+  }
+}
+
+TEST_P(CompressedSecondaryCacheTestWithCompressionParam, Dictionary) {
+  if (!sec_cache_is_compressed_) {
+    ROCKSDB_GTEST_BYPASS("Only for compressed secondary cache");
+    return;
+  }
+  if (!ZSTD_Supported()) {
+    ROCKSDB_GTEST_SKIP("This test requires ZSTD support.");
+    return;
+  }
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 1 << 20;
+  opts.num_shard_bits = 0;
+  opts.compression_type = kZSTD;
+  opts.max_dict_bytes = 256;
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+  std::shared_ptr<Statistics> stats = CreateDBStatistics();
+
+  // Values are made of a few chunks, which repeat across values but hardly
+  // within one, so that only the dictionary makes them compress well.
+  Random rnd(301);
+  std::vector<std::string> chunks;
+  for (int i = 0; i < 4; i++) {
+    chunks.push_back(rnd.RandomString(48));
+  }
+  auto make_value = [&](int i) {
+    std::string value = std::to_string(i);
+    while (value.size() < 200) {
+      value += chunks[rnd.Uniform(static_cast<int>(chunks.size()))];
+    }
+    value.resize(200);
+    return value;
+  };
+
+  // 128 values of 200 bytes are enough samples for a 256 byte dictionary.
+  const int kNumValues = 200;
+  std::vector<std::string> values;
+  std::vector<uint64_t> compressed_bytes;
+  for (int i = 0; i < kNumValues; i++) {
+    values.push_back(make_value(i));
+    TestItem item{values[i].data(), values[i].size()};
+    get_perf_context()->Reset();
+    ASSERT_OK(sec_cache->Insert(std::to_string(i), &item, GetHelper(),
+                                /*force_insert=*/true));
+    compressed_bytes.push_back(
+        get_perf_context()->compressed_sec_cache_compressed_bytes);
+  }
+  // The values inserted before and after the dictionary is trained
+  uint64_t before = 0;
+  uint64_t after = 0;
+  for (int i = 0; i < 64; i++) {
+    before += compressed_bytes[i];
+    after += compressed_bytes[kNumValues - 1 - i];
+  }
+  ASSERT_LT(after, before);
+
+  for (int i = 0; i < kNumValues; i++) {
+    bool kept_in_sec_cache{true};
+    std::unique_ptr<SecondaryCacheResultHandle> handle = sec_cache->Lookup(
+        std::to_string(i), GetHelper(), this, true,
+        /*advise_erase=*/false, stats.get(), kept_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    std::unique_ptr<TestItem> val =
+        std::unique_ptr<TestItem>(static_cast<TestItem*>(handle->Value()));
+    ASSERT_NE(val, nullptr);
+    ASSERT_EQ(val->ToString(), values[i]);
+  }
+  ASSERT_EQ(stats->getTickerCount(COMPRESSED_SECONDARY_CACHE_HIT_BYTES),
+            uint64_t{200} * kNumValues);
+  ASSERT_LT(
+      stats->getTickerCount(COMPRESSED_SECONDARY_CACHE_HIT_COMPRESSED_BYTES),
+      uint64_t{200} * kNumValues);
+  HistogramData hit_micros;
+  stats->histogramData(COMPRESSED_SECONDARY_CACHE_HIT_MICROS, &hit_micros);
+  ASSERT_EQ(hit_micros.count, kNumValues);
+}
+
 INSTANTIATE_TEST_CASE_P(CompressedSecCacheTests,
                         CompressedSecondaryCacheTestWithCompressionParam,
                         testing::Combine(testing::Bool(),
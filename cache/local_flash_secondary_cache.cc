@@ -0,0 +1,609 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/local_flash_secondary_cache.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <unordered_set>
+
+#include "file/file_util.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/mutexlock.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+const char* kCacheFileSuffix = ".fcache";
+
+// A closed file ends with the index of its records, so that it can be
+// recovered without reading the records:
+//
+//   entries: key size (varint32) | key | offset (varint64) | size (varint64)
+//   footer: offset of the entries (fixed64) |
+//           masked crc32c of the entries (fixed32) | magic number (fixed64)
+constexpr uint64_t kIndexMagicNumber = 0x6663616368696478ull;
+constexpr size_t kIndexFooterSize = 2 * sizeof(uint64_t) + sizeof(uint32_t);
+
+// Returns the size of the record at the start of `input`, or 0 if it does
+// not start with a valid record.
+size_t ParseRecord(const Slice& input, Slice* key, CompressionType* type,
+                   CacheTier* source, Slice* value) {
+  Slice in = input;
+  if (!GetLengthPrefixedSlice(&in, key) || in.size() < 2) {
+    return 0;
+  }
+  *type = static_cast<CompressionType>(in[0]);
+  *source = static_cast<CacheTier>(in[1]);
+  in.remove_prefix(2);
+  if (!GetLengthPrefixedSlice(&in, value) || in.size() < sizeof(uint32_t)) {
+    return 0;
+  }
+  const size_t size = static_cast<size_t>(in.data() - input.data());
+  if (crc32c::Unmask(DecodeFixed32(in.data())) !=
+      crc32c::Value(input.data(), size)) {
+    return 0;
+  }
+  return size + sizeof(uint32_t);
+}
+}  // namespace
+
+LocalFlashSecondaryCache::ResultHandle::ResultHandle(
+    FileSystem* fs, std::string key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, size_t record_size)
+    : fs_(fs),
+      key_(std::move(key)),
+      helper_(helper),
+      create_context_(create_context),
+      record_size_(record_size),
+      buffer_(new char[record_size]) {}
+
+LocalFlashSecondaryCache::ResultHandle::~ResultHandle() {
+  if (io_handle_ != nullptr) {
+    if (!read_done_.load(std::memory_order_acquire)) {
+      std::vector<void*> io_handles{io_handle_};
+      fs_->AbortIO(io_handles).PermitUncheckedError();
+    }
+    del_fn_(io_handle_);
+  }
+  read_status_.PermitUncheckedError();
+}
+
+bool LocalFlashSecondaryCache::ResultHandle::IsReady() {
+  if (!ready_ && read_done_.load(std::memory_order_acquire)) {
+    Complete();
+  }
+  return ready_;
+}
+
+void LocalFlashSecondaryCache::ResultHandle::Wait() {
+  if (ready_) {
+    return;
+  }
+  if (!read_done_.load(std::memory_order_acquire)) {
+    std::vector<void*> io_handles{io_handle_};
+    IOStatus s = fs_->Poll(io_handles, 1);
+    if (!read_done_.load(std::memory_order_acquire)) {
+      // The read did not complete, so make sure it never does
+      fs_->AbortIO(io_handles).PermitUncheckedError();
+      read_status_ = s.ok() ? IOStatus::IOError("Read not completed") : s;
+      read_done_.store(true, std::memory_order_release);
+    }
+  }
+  Complete();
+}
+
+void LocalFlashSecondaryCache::ResultHandle::StartRead(
+    const std::shared_ptr<FSRandomAccessFile>& file, uint64_t offset,
+    bool async) {
+  file_ = file;
+  if (async) {
+    req_.offset = offset;
+    req_.len = record_size_;
+    req_.scratch = buffer_.get();
+    IOStatus s = file_->ReadAsync(req_, IOOptions(), &ReadCallback, this,
+                                  &io_handle_, &del_fn_, /*dbg=*/nullptr);
+    if (s.ok()) {
+      return;
+    }
+    // Fall back to a synchronous read, e.g. if io_uring is not available
+    assert(io_handle_ == nullptr);
+    s.PermitUncheckedError();
+  }
+  Slice result;
+  read_status_ = file_->Read(offset, record_size_, IOOptions(), &result,
+                             buffer_.get(), /*dbg=*/nullptr);
+  if (read_status_.ok()) {
+    if (result.size() != record_size_) {
+      read_status_ = IOStatus::Corruption("Truncated cache file");
+    } else if (result.data() != buffer_.get()) {
+      memcpy(buffer_.get(), result.data(), record_size_);
+    }
+  }
+  read_done_.store(true, std::memory_order_release);
+}
+
+void LocalFlashSecondaryCache::ResultHandle::ReadCallback(
+    const FSReadRequest& req, void* cb_arg) {
+  ResultHandle* handle = static_cast<ResultHandle*>(cb_arg);
+  handle->read_status_ = req.status;
+  if (req.status.ok()) {
+    if (req.result.size() != handle->record_size_) {
+      handle->read_status_ = IOStatus::Corruption("Truncated cache file");
+    } else if (req.result.data() != handle->buffer_.get()) {
+      memcpy(handle->buffer_.get(), req.result.data(), handle->record_size_);
+    }
+  }
+  handle->read_done_.store(true, std::memory_order_release);
+}
+
+void LocalFlashSecondaryCache::ResultHandle::Complete() {
+  assert(read_done_.load(std::memory_order_relaxed));
+  Slice key;
+  CompressionType type;
+  CacheTier source;
+  Slice saved;
+  if (read_status_.ok() &&
+      ParseRecord(Slice(buffer_.get(), record_size_), &key, &type, &source,
+                  &saved) == record_size_ &&
+      key == key_) {
+    Status s = helper_->create_cb(saved, type, source, create_context_,
+                                  /*allocator=*/nullptr, &value_, &size_);
+    if (!s.ok()) {
+      value_ = nullptr;
+      size_ = 0;
+    }
+  }
+  read_status_.PermitUncheckedError();
+  if (io_handle_ != nullptr) {
+    del_fn_(io_handle_);
+    io_handle_ = nullptr;
+  }
+  buffer_.reset();
+  file_.reset();
+  ready_ = true;
+}
+
+LocalFlashSecondaryCache::LocalFlashSecondaryCache(
+    const LocalFlashSecondaryCacheOptions& opts)
+    : opts_(opts),
+      fs_(opts.env->GetFileSystem()),
+      async_io_(CheckFSFeatureSupport(fs_.get(), FSSupportedOps::kAsyncIO)),
+      capacity_(opts.capacity) {}
+
+LocalFlashSecondaryCache::~LocalFlashSecondaryCache() {
+  MutexLock l(&mutex_);
+  // Keep the buffered entries for the next instance
+  Status s;
+  if (!write_buffer_.empty()) {
+    s = FlushWriteBuffer();
+  }
+  if (s.ok() && writer_) {
+    s = CloseCurrentFile();
+  }
+  if (writer_) {
+    writer_->Close(IOOptions(), /*dbg=*/nullptr).PermitUncheckedError();
+  }
+  s.PermitUncheckedError();
+}
+
+std::string LocalFlashSecondaryCache::CacheFileName(
+    uint64_t file_number) const {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "/%06" PRIu64 "%s", file_number,
+           kCacheFileSuffix);
+  return opts_.path + buf;
+}
+
+Status LocalFlashSecondaryCache::Open() {
+  IOStatus s = fs_->CreateDirIfMissing(opts_.path, IOOptions(), nullptr);
+  std::vector<std::string> children;
+  if (s.ok()) {
+    s = fs_->GetChildren(opts_.path, IOOptions(), &children, nullptr);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  std::vector<uint64_t> file_numbers;
+  for (const std::string& child : children) {
+    Slice name(child);
+    uint64_t file_number = 0;
+    if (ConsumeDecimalNumber(&name, &file_number) &&
+        name == kCacheFileSuffix) {
+      file_numbers.push_back(file_number);
+    }
+  }
+  std::sort(file_numbers.begin(), file_numbers.end());
+  MutexLock l(&mutex_);
+  for (uint64_t file_number : file_numbers) {
+    Status rs = RecoverFile(file_number);
+    if (!rs.ok()) {
+      return rs;
+    }
+    next_file_number_ = file_number + 1;
+  }
+  EvictFiles();
+  return Status::OK();
+}
+
+Status LocalFlashSecondaryCache::RecoverFile(uint64_t file_number) {
+  const std::string fname = CacheFileName(file_number);
+  std::unique_ptr<FSRandomAccessFile> reader;
+  uint64_t file_size = 0;
+  IOStatus s = fs_->NewRandomAccessFile(fname, FileOptions(), &reader, nullptr);
+  if (s.ok()) {
+    s = fs_->GetFileSize(fname, IOOptions(), &file_size, nullptr);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  CacheFile file;
+  if (!RecoverFileIndex(file_number, reader.get(), file_size, &file)) {
+    // The previous instance did not close the file, so its records are read
+    // back. A record can be torn by a crash while the file was written. The
+    // records after it are never read.
+    std::string data;
+    s = ReadFileToString(fs_.get(), fname, &data);
+    if (!s.ok()) {
+      return s;
+    }
+    Slice input(data);
+    while (!input.empty()) {
+      Slice key;
+      CompressionType type;
+      CacheTier source;
+      Slice saved;
+      size_t record_size = ParseRecord(input, &key, &type, &source, &saved);
+      if (record_size == 0) {
+        break;
+      }
+      const uint64_t offset = data.size() - input.size();
+      index_[key.ToString()] = Location{file_number, offset, record_size};
+      file.keys.push_back(key.ToString());
+      input.remove_prefix(record_size);
+    }
+    file_size = data.size();
+  }
+  file.reader = std::move(reader);
+  file.size = file_size;
+  usage_ += file.size;
+  files_.emplace(file_number, std::move(file));
+  return Status::OK();
+}
+
+bool LocalFlashSecondaryCache::RecoverFileIndex(uint64_t file_number,
+                                                FSRandomAccessFile* reader,
+                                                uint64_t file_size,
+                                                CacheFile* file) {
+  if (file_size < kIndexFooterSize) {
+    return false;
+  }
+  char footer_buf[kIndexFooterSize];
+  Slice footer;
+  IOStatus s = reader->Read(file_size - kIndexFooterSize, kIndexFooterSize,
+                            IOOptions(), &footer, footer_buf, nullptr);
+  if (!s.ok() || footer.size() != kIndexFooterSize ||
+      DecodeFixed64(footer.data() + sizeof(uint64_t) + sizeof(uint32_t)) !=
+          kIndexMagicNumber) {
+    return false;
+  }
+  const uint64_t entries_offset = DecodeFixed64(footer.data());
+  const uint32_t entries_crc = DecodeFixed32(footer.data() + sizeof(uint64_t));
+  if (entries_offset > file_size - kIndexFooterSize) {
+    return false;
+  }
+  const size_t entries_size =
+      static_cast<size_t>(file_size - kIndexFooterSize - entries_offset);
+  std::unique_ptr<char[]> entries_buf(new char[entries_size]);
+  Slice entries;
+  s = reader->Read(entries_offset, entries_size, IOOptions(), &entries,
+                   entries_buf.get(), nullptr);
+  if (!s.ok() || entries.size() != entries_size ||
+      crc32c::Unmask(entries_crc) !=
+          crc32c::Value(entries.data(), entries.size())) {
+    return false;
+  }
+  std::vector<std::pair<Slice, Location>> locations;
+  while (!entries.empty()) {
+    Slice key;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    if (!GetLengthPrefixedSlice(&entries, &key) ||
+        !GetVarint64(&entries, &offset) || !GetVarint64(&entries, &size) ||
+        offset + size > entries_offset) {
+      return false;
+    }
+    locations.emplace_back(
+        key, Location{file_number, offset, static_cast<size_t>(size)});
+  }
+  for (const auto& location : locations) {
+    index_[location.first.ToString()] = location.second;
+    file->keys.push_back(location.first.ToString());
+  }
+  return true;
+}
+
+Status LocalFlashSecondaryCache::Insert(const Slice& key,
+                                        Cache::ObjectPtr obj,
+                                        const Cache::CacheItemHelper* helper,
+                                        bool /*force_insert*/) {
+  if (!helper->IsSecondaryCacheCompatible()) {
+    return Status::OK();
+  }
+  size_t size = (*helper->size_cb)(obj);
+  std::unique_ptr<char[]> buf(new char[size]);
+  Status s = (*helper->saveto_cb)(obj, 0, size, buf.get());
+  if (!s.ok()) {
+    return s;
+  }
+  return InsertSaved(key, Slice(buf.get(), size), kNoCompression,
+                     CacheTier::kVolatileTier);
+}
+
+Status LocalFlashSecondaryCache::InsertSaved(const Slice& key,
+                                             const Slice& saved,
+                                             CompressionType type,
+                                             CacheTier source) {
+  MutexLock l(&mutex_);
+  if (index_.find(key.ToString()) != index_.end()) {
+    return Status::OK();
+  }
+  Status s = AppendRecord(key, saved, type, source);
+  if (s.ok() && write_buffer_.size() >= opts_.write_buffer_size) {
+    s = FlushWriteBuffer();
+  }
+  EvictFiles();
+  return s;
+}
+
+Status LocalFlashSecondaryCache::AppendRecord(const Slice& key,
+                                              const Slice& saved,
+                                              CompressionType type,
+                                              CacheTier source) {
+  mutex_.AssertHeld();
+  if (!writer_) {
+    const uint64_t file_number = next_file_number_++;
+    IOStatus s = fs_->NewWritableFile(CacheFileName(file_number),
+                                      FileOptions(), &writer_, nullptr);
+    if (!s.ok()) {
+      return s;
+    }
+    files_.emplace(file_number, CacheFile());
+  }
+  auto current = files_.rbegin();
+  const size_t start = write_buffer_.size();
+  PutLengthPrefixedSlice(&write_buffer_, key);
+  write_buffer_.push_back(static_cast<char>(type));
+  write_buffer_.push_back(static_cast<char>(source));
+  PutLengthPrefixedSlice(&write_buffer_, saved);
+  PutFixed32(&write_buffer_,
+             crc32c::Mask(crc32c::Value(write_buffer_.data() + start,
+                                        write_buffer_.size() - start)));
+  const size_t record_size = write_buffer_.size() - start;
+  index_[key.ToString()] =
+      Location{current->first, current->second.size + start, record_size};
+  current->second.keys.push_back(key.ToString());
+  usage_ += record_size;
+  return Status::OK();
+}
+
+Status LocalFlashSecondaryCache::FlushWriteBuffer() {
+  mutex_.AssertHeld();
+  assert(writer_);
+  auto current = std::prev(files_.end());
+  CacheFile& file = current->second;
+  IOStatus s = writer_->Append(write_buffer_, IOOptions(), nullptr);
+  if (s.ok()) {
+    // The cache does not need durability, only for the reads to see the
+    // records.
+    s = writer_->Flush(IOOptions(), nullptr);
+  }
+  if (s.ok() && !file.reader) {
+    std::unique_ptr<FSRandomAccessFile> reader;
+    s = fs_->NewRandomAccessFile(CacheFileName(current->first), FileOptions(),
+                                 &reader, nullptr);
+    file.reader = std::move(reader);
+  }
+  if (!s.ok()) {
+    DropFile(current);
+    return s;
+  }
+  file.size += write_buffer_.size();
+  write_buffer_.clear();
+  if (file.size >= opts_.file_size) {
+    s = CloseCurrentFile();
+  }
+  return s;
+}
+
+IOStatus LocalFlashSecondaryCache::CloseCurrentFile() {
+  mutex_.AssertHeld();
+  assert(writer_ && write_buffer_.empty());
+  auto current = std::prev(files_.end());
+  CacheFile& file = current->second;
+  // Only the entries still in the file are indexed, once each.
+  std::string index;
+  std::unordered_set<std::string> indexed;
+  for (const std::string& key : file.keys) {
+    auto index_it = index_.find(key);
+    if (index_it != index_.end() &&
+        index_it->second.file_number == current->first &&
+        indexed.insert(key).second) {
+      PutLengthPrefixedSlice(&index, key);
+      PutVarint64(&index, index_it->second.offset);
+      PutVarint64(&index, index_it->second.size);
+    }
+  }
+  const uint64_t entries_offset = file.size;
+  const uint32_t entries_crc =
+      crc32c::Mask(crc32c::Value(index.data(), index.size()));
+  PutFixed64(&index, entries_offset);
+  PutFixed32(&index, entries_crc);
+  PutFixed64(&index, kIndexMagicNumber);
+  // A file without its index is still recovered, from its records.
+  IOStatus s = writer_->Append(index, IOOptions(), nullptr);
+  if (s.ok()) {
+    file.size += index.size();
+    usage_ += index.size();
+  }
+  s.PermitUncheckedError();
+  s = writer_->Close(IOOptions(), nullptr);
+  writer_.reset();
+  return s;
+}
+
+void LocalFlashSecondaryCache::EvictFiles() {
+  mutex_.AssertHeld();
+  while (usage_ > capacity_ && !files_.empty()) {
+    DropFile(files_.begin());
+  }
+}
+
+void LocalFlashSecondaryCache::DropFile(
+    std::map<uint64_t, CacheFile>::iterator it) {
+  mutex_.AssertHeld();
+  if (writer_ && std::next(it) == files_.end()) {
+    // The current file
+    writer_->Close(IOOptions(), nullptr).PermitUncheckedError();
+    writer_.reset();
+    usage_ -= write_buffer_.size();
+    write_buffer_.clear();
+  }
+  for (const std::string& key : it->second.keys) {
+    auto index_it = index_.find(key);
+    if (index_it != index_.end() &&
+        index_it->second.file_number == it->first) {
+      index_.erase(index_it);
+    }
+  }
+  usage_ -= it->second.size;
+  // Pending lookups keep the file open until they are done
+  fs_->DeleteFile(CacheFileName(it->first), IOOptions(), nullptr)
+      .PermitUncheckedError();
+  files_.erase(it);
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> LocalFlashSecondaryCache::Lookup(
+    const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool advise_erase,
+    Statistics* /*stats*/, bool& kept_in_sec_cache) {
+  kept_in_sec_cache = false;
+  std::string key_str = key.ToString();
+  std::unique_ptr<ResultHandle> handle;
+  std::shared_ptr<FSRandomAccessFile> file;
+  uint64_t offset = 0;
+  {
+    MutexLock l(&mutex_);
+    auto it = index_.find(key_str);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    const Location loc = it->second;
+    if (advise_erase) {
+      index_.erase(it);
+    } else {
+      kept_in_sec_cache = true;
+    }
+    handle.reset(new ResultHandle(fs_.get(), std::move(key_str), helper,
+                                  create_context, loc.size));
+    const CacheFile& cache_file = files_.at(loc.file_number);
+    if (loc.offset >= cache_file.size) {
+      // Not written to the file yet
+      assert(writer_ && loc.file_number == files_.rbegin()->first);
+      memcpy(handle->buffer(),
+             write_buffer_.data() + (loc.offset - cache_file.size), loc.size);
+    } else {
+      file = cache_file.reader;
+      offset = loc.offset;
+    }
+  }
+  if (file) {
+    handle->StartRead(file, offset, async_io_ && !wait);
+  } else {
+    handle->SetBuffered();
+  }
+  if (wait) {
+    handle->Wait();
+  }
+  return handle;
+}
+
+void LocalFlashSecondaryCache::Erase(const Slice& key) {
+  MutexLock l(&mutex_);
+  index_.erase(key.ToString());
+}
+
+void LocalFlashSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  std::vector<void*> io_handles;
+  for (SecondaryCacheResultHandle* handle : handles) {
+    void* io_handle = static_cast<ResultHandle*>(handle)->io_handle();
+    if (io_handle != nullptr) {
+      io_handles.push_back(io_handle);
+    }
+  }
+  if (!io_handles.empty()) {
+    fs_->Poll(io_handles, io_handles.size()).PermitUncheckedError();
+  }
+  for (SecondaryCacheResultHandle* handle : handles) {
+    handle->Wait();
+  }
+}
+
+Status LocalFlashSecondaryCache::SetCapacity(size_t capacity) {
+  MutexLock l(&mutex_);
+  capacity_ = capacity;
+  EvictFiles();
+  return Status::OK();
+}
+
+Status LocalFlashSecondaryCache::GetCapacity(size_t& capacity) {
+  MutexLock l(&mutex_);
+  capacity = static_cast<size_t>(capacity_);
+  return Status::OK();
+}
+
+uint64_t LocalFlashSecondaryCache::TEST_GetUsage() {
+  MutexLock l(&mutex_);
+  return usage_;
+}
+
+std::string LocalFlashSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(20000);
+  const int kBufferSize{200};
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    path : %s\n", opts_.path.c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    capacity : %" PRIu64 "\n",
+           opts_.capacity);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    file_size : %" PRIu64 "\n",
+           opts_.file_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    write_buffer_size : %" ROCKSDB_PRIszt "\n",
+           opts_.write_buffer_size);
+  ret.append(buffer);
+  return ret;
+}
+
+Status NewLocalFlashSecondaryCache(const LocalFlashSecondaryCacheOptions& opts,
+                                   std::shared_ptr<SecondaryCache>* result) {
+  if (opts.path.empty() || opts.file_size == 0) {
+    return Status::InvalidArgument("Invalid LocalFlashSecondaryCacheOptions");
+  }
+  std::unique_ptr<LocalFlashSecondaryCache> cache(
+      new LocalFlashSecondaryCache(opts));
+  Status s = cache->Open();
+  if (s.ok()) {
+    result->reset(cache.release());
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
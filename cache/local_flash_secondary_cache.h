@@ -0,0 +1,196 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/secondary_cache.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A SecondaryCache that keeps its entries in log-structured files on local
+// flash. Each entry is a record appended to the current cache file:
+//
+//   key size (varint32) | key | compression type (1 byte) |
+//   source cache tier (1 byte) | value size (varint32) | value |
+//   masked crc32c of the above (fixed32)
+//
+// Records are buffered in memory and written write_buffer_size bytes at a
+// time. An in-memory hash index maps each key to the location of its record,
+// which a Lookup reads back, asynchronously if possible. The files are
+// evicted in FIFO order, a whole file at a time. A file is closed with the
+// index of its entries appended. On open, the index is rebuilt from the
+// indexes of the files left by a previous instance, and from the records of
+// any file it did not close.
+class LocalFlashSecondaryCache : public SecondaryCache {
+ public:
+  explicit LocalFlashSecondaryCache(
+      const LocalFlashSecondaryCacheOptions& opts);
+  ~LocalFlashSecondaryCache() override;
+
+  const char* Name() const override { return "LocalFlashSecondaryCache"; }
+
+  // Create the cache directory if missing, and recover the entries of the
+  // existing cache files.
+  Status Open();
+
+  // Saves the object with the helper, as an entry of kVolatileTier.
+  Status Insert(const Slice& key, Cache::ObjectPtr obj,
+                const Cache::CacheItemHelper* helper,
+                bool force_insert) override;
+
+  Status InsertSaved(const Slice& key, const Slice& saved,
+                     CompressionType type = kNoCompression,
+                     CacheTier source = CacheTier::kVolatileTier) override;
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      Statistics* stats, bool& kept_in_sec_cache) override;
+
+  bool SupportForceErase() const override { return true; }
+
+  void Erase(const Slice& key) override;
+
+  // Polls the FileSystem for all the pending reads at once.
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  Status SetCapacity(size_t capacity) override;
+
+  Status GetCapacity(size_t& capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+  // For testing
+  uint64_t TEST_GetUsage();
+
+ private:
+  // Where the record of an entry is
+  struct Location {
+    uint64_t file_number;
+    uint64_t offset;
+    size_t size;
+  };
+
+  struct CacheFile {
+    std::shared_ptr<FSRandomAccessFile> reader;
+    uint64_t size = 0;
+    // The keys whose records are in the file, some of which may have been
+    // erased or overwritten since.
+    std::vector<std::string> keys;
+  };
+
+  class ResultHandle : public SecondaryCacheResultHandle {
+   public:
+    ResultHandle(FileSystem* fs, std::string key,
+                 const Cache::CacheItemHelper* helper,
+                 Cache::CreateContext* create_context, size_t record_size);
+    ~ResultHandle() override;
+
+    bool IsReady() override;
+
+    void Wait() override;
+
+    Cache::ObjectPtr Value() override { return value_; }
+
+    size_t Size() override { return size_; }
+
+    // Reads the record, asynchronously if `async` and supported.
+    void StartRead(const std::shared_ptr<FSRandomAccessFile>& file,
+                   uint64_t offset, bool async);
+
+    // The record was copied to the buffer, without reading it.
+    void SetBuffered() { read_done_.store(true, std::memory_order_release); }
+
+    // Creates the value from the record in the buffer.
+    void Complete();
+
+    // The pending asynchronous read, if any
+    void* io_handle() const {
+      return read_done_.load(std::memory_order_acquire) ? nullptr : io_handle_;
+    }
+
+    char* buffer() { return buffer_.get(); }
+
+   private:
+    static void ReadCallback(const FSReadRequest& req, void* cb_arg);
+
+    FileSystem* fs_;
+    std::string key_;
+    const Cache::CacheItemHelper* helper_;
+    Cache::CreateContext* create_context_;
+    size_t record_size_;
+    std::unique_ptr<char[]> buffer_;
+    std::shared_ptr<FSRandomAccessFile> file_;
+    FSReadRequest req_;
+    IOStatus read_status_;
+    void* io_handle_ = nullptr;
+    IOHandleDeleter del_fn_;
+    std::atomic<bool> read_done_{false};
+    bool ready_ = false;
+    Cache::ObjectPtr value_ = nullptr;
+    size_t size_ = 0;
+  };
+
+  std::string CacheFileName(uint64_t file_number) const;
+
+  // Appends a record for the entry to the write buffer. REQUIRES: mutex_ held
+  Status AppendRecord(const Slice& key, const Slice& saved,
+                      CompressionType type, CacheTier source);
+
+  // Writes the write buffer to the current file, and switches to a new file
+  // once the current one is full. REQUIRES: mutex_ held
+  Status FlushWriteBuffer();
+
+  // Appends the index of the current file to it, and closes it.
+  // REQUIRES: mutex_ held, write buffer empty
+  IOStatus CloseCurrentFile();
+
+  // Deletes the oldest files until the usage is within the capacity.
+  // REQUIRES: mutex_ held
+  void EvictFiles();
+
+  // Deletes a file and the index entries of its records.
+  // REQUIRES: mutex_ held
+  void DropFile(std::map<uint64_t, CacheFile>::iterator it);
+
+  // Adds the records of an existing cache file to the index.
+  Status RecoverFile(uint64_t file_number);
+
+  // Adds the entries of the index at the end of a closed file to the index.
+  // Returns false if the file does not end with a valid index.
+  bool RecoverFileIndex(uint64_t file_number, FSRandomAccessFile* reader,
+                        uint64_t file_size, CacheFile* file);
+
+  const LocalFlashSecondaryCacheOptions opts_;
+  const std::shared_ptr<FileSystem> fs_;
+  // Whether Lookup reads asynchronously
+  bool async_io_;
+
+  port::Mutex mutex_;
+  uint64_t capacity_;
+  std::unordered_map<std::string, Location> index_;
+  // By file number, the oldest first. The current file is the last one.
+  std::map<uint64_t, CacheFile> files_;
+  std::unique_ptr<FSWritableFile> writer_;
+  // Records not yet written to the current file, which start at the
+  // offset files_.rbegin()->second.size.
+  std::string write_buffer_;
+  uint64_t usage_ = 0;
+  uint64_t next_file_number_ = 1;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,298 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/local_flash_secondary_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "file/file_util.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/secondary_cache.h"
+#include "test_util/secondary_cache_test_util.h"
+#include "test_util/testharness.h"
+#include "util/coding.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+using secondary_cache_test_util::TestCreateContext;
+using secondary_cache_test_util::WithCacheType;
+using TestItem = WithCacheType::TestItem;
+
+class LocalFlashSecondaryCacheTest : public testing::Test,
+                                     public TestCreateContext {
+ public:
+  LocalFlashSecondaryCacheTest() {
+    opts_.env = Env::Default();
+    opts_.path = test::PerThreadDBPath("local_flash_secondary_cache_test");
+    opts_.capacity = 1 << 20;
+    opts_.file_size = 64 << 10;
+    opts_.write_buffer_size = 4 << 10;
+    EXPECT_OK(DestroyDir(opts_.env, opts_.path));
+  }
+
+  ~LocalFlashSecondaryCacheTest() override {
+    cache_.reset();
+    EXPECT_OK(DestroyDir(opts_.env, opts_.path));
+  }
+
+  void OpenCache() {
+    cache_.reset();
+    ASSERT_OK(NewLocalFlashSecondaryCache(opts_, &cache_));
+  }
+
+  static std::string Key(int i) {
+    // 16 bytes, like the block cache keys
+    char buf[17];
+    snprintf(buf, sizeof(buf), "key%013d", i);
+    return buf;
+  }
+
+  void Insert(int i, const std::string& value) {
+    TestItem item(value.data(), value.size());
+    ASSERT_OK(cache_->Insert(Key(i), &item, WithCacheType::GetHelper(),
+                             /*force_insert=*/false));
+  }
+
+  // Returns the value of the key, or an empty string if not found.
+  std::string Lookup(int i, bool advise_erase = false) {
+    bool kept_in_sec_cache = false;
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        cache_->Lookup(Key(i), WithCacheType::GetHelper(), this,
+                       /*wait=*/true, advise_erase, /*stats=*/nullptr,
+                       kept_in_sec_cache);
+    if (!handle) {
+      return "";
+    }
+    EXPECT_TRUE(handle->IsReady());
+    EXPECT_EQ(kept_in_sec_cache, !advise_erase);
+    std::unique_ptr<TestItem> item(static_cast<TestItem*>(handle->Value()));
+    return item ? item->ToString() : "";
+  }
+
+  LocalFlashSecondaryCacheOptions opts_;
+  std::shared_ptr<SecondaryCache> cache_;
+};
+
+TEST_F(LocalFlashSecondaryCacheTest, Basic) {
+  OpenCache();
+  Random rnd(301);
+  std::vector<std::string> values;
+  // Some in the files, and some still in the write buffer
+  for (int i = 0; i < 20; i++) {
+    values.push_back(rnd.RandomString(1000));
+    Insert(i, values[i]);
+  }
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(Lookup(i), values[i]);
+  }
+  ASSERT_EQ(Lookup(20), "");
+
+  // An existing entry is not overwritten
+  Insert(0, "foo");
+  ASSERT_EQ(Lookup(0), values[0]);
+
+  cache_->Erase(Key(1));
+  ASSERT_EQ(Lookup(1), "");
+  ASSERT_EQ(Lookup(2, /*advise_erase=*/true), values[2]);
+  ASSERT_EQ(Lookup(2), "");
+
+  // The saved data is passed back to create_cb
+  ASSERT_OK(cache_->InsertSaved(Key(21), "bar", kNoCompression,
+                                CacheTier::kVolatileTier));
+  ASSERT_EQ(Lookup(21), "bar");
+}
+
+TEST_F(LocalFlashSecondaryCacheTest, AsyncLookup) {
+  OpenCache();
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 20; i++) {
+    values.push_back(rnd.RandomString(1000));
+    Insert(i, values[i]);
+  }
+
+  std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+  std::vector<SecondaryCacheResultHandle*> to_wait;
+  for (int i = 0; i < 20; i++) {
+    bool kept_in_sec_cache = false;
+    handles.push_back(cache_->Lookup(Key(i), WithCacheType::GetHelper(), this,
+                                     /*wait=*/false, /*advise_erase=*/false,
+                                     /*stats=*/nullptr, kept_in_sec_cache));
+    ASSERT_NE(handles.back(), nullptr);
+    to_wait.push_back(handles.back().get());
+  }
+  cache_->WaitAll(to_wait);
+  for (int i = 0; i < 20; i++) {
+    ASSERT_TRUE(handles[i]->IsReady());
+    std::unique_ptr<TestItem> item(
+        static_cast<TestItem*>(handles[i]->Value()));
+    ASSERT_NE(item, nullptr);
+    ASSERT_EQ(item->ToString(), values[i]);
+  }
+
+  // A handle can also be waited on alone
+  bool kept_in_sec_cache = false;
+  std::unique_ptr<SecondaryCacheResultHandle> handle =
+      cache_->Lookup(Key(0), WithCacheType::GetHelper(), this,
+                     /*wait=*/false, /*advise_erase=*/false,
+                     /*stats=*/nullptr, kept_in_sec_cache);
+  ASSERT_NE(handle, nullptr);
+  handle->Wait();
+  std::unique_ptr<TestItem> item(static_cast<TestItem*>(handle->Value()));
+  ASSERT_NE(item, nullptr);
+  ASSERT_EQ(item->ToString(), values[0]);
+}
+
+TEST_F(LocalFlashSecondaryCacheTest, Eviction) {
+  opts_.capacity = 256 << 10;
+  OpenCache();
+  auto* cache = static_cast<LocalFlashSecondaryCache*>(cache_.get());
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 1000; i++) {
+    values.push_back(rnd.RandomString(1000));
+    Insert(i, values[i]);
+    ASSERT_LE(cache->TEST_GetUsage(), opts_.capacity);
+  }
+  // The oldest files are evicted whole, the latest entries are kept
+  ASSERT_EQ(Lookup(0), "");
+  for (int i = 900; i < 1000; i++) {
+    ASSERT_EQ(Lookup(i), values[i]);
+  }
+
+  ASSERT_OK(cache_->SetCapacity(128 << 10));
+  ASSERT_LE(cache->TEST_GetUsage(), uint64_t{128} << 10);
+  size_t capacity = 0;
+  ASSERT_OK(cache_->GetCapacity(capacity));
+  ASSERT_EQ(capacity, 128 << 10);
+  ASSERT_EQ(Lookup(999), values[999]);
+}
+
+TEST_F(LocalFlashSecondaryCacheTest, Recovery) {
+  OpenCache();
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 200; i++) {
+    values.push_back(rnd.RandomString(1000));
+    Insert(i, values[i]);
+  }
+  // The index of a file is written when it is closed. Erasures after that
+  // are not persisted, so the entry is recovered.
+  cache_->Erase(Key(0));
+  cache_->Erase(Key(199));
+
+  OpenCache();
+  for (int i = 0; i < 199; i++) {
+    ASSERT_EQ(Lookup(i), values[i]);
+  }
+  ASSERT_EQ(Lookup(199), "");
+  Insert(200, "foo");
+  ASSERT_EQ(Lookup(200), "foo");
+
+  // A file that was not closed is recovered from its records, and a torn
+  // record ends its recovery.
+  cache_.reset();
+  std::vector<std::string> children;
+  ASSERT_OK(opts_.env->GetChildren(opts_.path, &children));
+  std::string last_file;
+  for (const std::string& child : children) {
+    last_file = std::max(last_file, child);
+  }
+  const std::string fname = opts_.path + "/" + last_file;
+  std::string data;
+  ASSERT_OK(ReadFileToString(opts_.env, fname, &data));
+  // Drop the index at the end of the file, and the last byte of the record.
+  const size_t index_offset = static_cast<size_t>(DecodeFixed64(
+      data.data() + data.size() - 2 * sizeof(uint64_t) - sizeof(uint32_t)));
+  ASSERT_LT(index_offset, data.size());
+  ASSERT_OK(WriteStringToFile(opts_.env, data.substr(0, index_offset - 1),
+                              fname));
+  OpenCache();
+  ASSERT_EQ(Lookup(200), "");
+  ASSERT_EQ(Lookup(198), values[198]);
+}
+
+class LocalFlashTieredCacheTest : public LocalFlashSecondaryCacheTest {
+ public:
+  // A tiered cache with the flash cache as its nvm tier, which initially
+  // holds the first entries inserted.
+  void OpenTieredCache(int num_entries, std::vector<std::string>* values) {
+    OpenCache();
+    Random rnd(301);
+    for (int i = 0; i < num_entries; i++) {
+      values->push_back(rnd.RandomString(1000));
+      Insert(i, values->back());
+    }
+    LRUCacheOptions lru_opts;
+    lru_opts.num_shard_bits = 0;
+    lru_opts.high_pri_pool_ratio = 0;
+    TieredCacheOptions opts;
+    opts.cache_opts = &lru_opts;
+    opts.cache_type = PrimaryCacheType::kCacheTypeLRU;
+    opts.comp_cache_opts.num_shard_bits = 0;
+    opts.total_capacity = 1 << 20;
+    opts.compressed_secondary_ratio = 0.5;
+    opts.nvm_sec_cache = cache_;
+    tiered_cache_ = NewTieredCache(opts);
+    ASSERT_NE(tiered_cache_, nullptr);
+  }
+
+  std::shared_ptr<Cache> tiered_cache_;
+};
+
+TEST_F(LocalFlashTieredCacheTest, Lookup) {
+  std::vector<std::string> values;
+  OpenTieredCache(20, &values);
+  for (int i = 0; i < 20; i++) {
+    Cache::Handle* handle = tiered_cache_->Lookup(
+        Key(i), WithCacheType::GetHelper(), this, Cache::Priority::LOW);
+    ASSERT_NE(handle, nullptr);
+    ASSERT_EQ(
+        static_cast<TestItem*>(tiered_cache_->Value(handle))->ToString(),
+        values[i]);
+    tiered_cache_->Release(handle);
+  }
+  ASSERT_EQ(tiered_cache_->Lookup(Key(20), WithCacheType::GetHelper(), this,
+                                  Cache::Priority::LOW),
+            nullptr);
+}
+
+TEST_F(LocalFlashTieredCacheTest, AsyncLookup) {
+  std::vector<std::string> values;
+  OpenTieredCache(20, &values);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 20; i++) {
+    keys.push_back(Key(i));
+  }
+  std::unique_ptr<Cache::AsyncLookupHandle[]> async_handles(
+      new Cache::AsyncLookupHandle[keys.size()]);
+  for (size_t i = 0; i < keys.size(); i++) {
+    async_handles[i].key = keys[i];
+    async_handles[i].helper = WithCacheType::GetHelper();
+    async_handles[i].create_context = this;
+    tiered_cache_->StartAsyncLookup(async_handles[i]);
+  }
+  tiered_cache_->WaitAll(async_handles.get(), keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    Cache::Handle* handle = async_handles[i].Result();
+    ASSERT_NE(handle, nullptr);
+    ASSERT_EQ(
+        static_cast<TestItem*>(tiered_cache_->Value(handle))->ToString(),
+        values[i]);
+    tiered_cache_->Release(handle);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
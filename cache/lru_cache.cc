@@ -14,6 +14,7 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include "cache/cache_helpers.h"
 #include "cache/secondary_cache_adapter.h"
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/statistics_impl.h"
@@ -120,26 +121,37 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                              CacheMetadataChargePolicy metadata_charge_policy,
                              int max_upper_hash_bits,
                              MemoryAllocator* allocator,
-                             const Cache::EvictionCallback* eviction_callback)
+                             const Cache::EvictionCallback* eviction_callback,
+                             CacheAdmissionPolicy* admission_policy,
+                             const std::vector<double>& caller_quota_ratios)
     : CacheShardBase(metadata_charge_policy),
       capacity_(0),
-      high_pri_pool_usage_(0),
-      low_pri_pool_usage_(0),
       strict_capacity_limit_(strict_capacity_limit),
       high_pri_pool_ratio_(high_pri_pool_ratio),
-      high_pri_pool_capacity_(0),
       low_pri_pool_ratio_(low_pri_pool_ratio),
-      low_pri_pool_capacity_(0),
+      num_lists_(caller_quota_ratios.empty()
+                     ? 1
+                     : static_cast<size_t>(CacheCaller::kNumCallers)),
+      lists_(new LRUList[num_lists_]()),
       table_(max_upper_hash_bits, allocator),
       usage_(0),
       lru_usage_(0),
       mutex_(use_adaptive_mutex),
-      eviction_callback_(*eviction_callback) {
-  // Make empty circular linked list.
-  lru_.next = &lru_;
-  lru_.prev = &lru_;
-  lru_low_pri_ = &lru_;
-  lru_bottom_pri_ = &lru_;
+      eviction_callback_(*eviction_callback),
+      admission_policy_(admission_policy) {
+  for (size_t i = 0; i < num_lists_; i++) {
+    LRUList& list = lists_[i];
+    // Make empty circular linked list.
+    list.head.next = &list.head;
+    list.head.prev = &list.head;
+    list.low_pri = &list.head;
+    list.bottom_pri = &list.head;
+    if (caller_quota_ratios.empty()) {
+      list.quota_ratio = 1.0;
+    } else if (i < caller_quota_ratios.size()) {
+      list.quota_ratio = caller_quota_ratios[i];
+    }
+  }
   SetCapacity(capacity);
 }
 
@@ -147,16 +159,20 @@ void LRUCacheShard::EraseUnRefEntries() {
   autovector<LRUHandle*> last_reference_list;
   {
     DMutexLock l(mutex_);
-    while (lru_.next != &lru_) {
-      LRUHandle* old = lru_.next;
-      // LRU list contains only elements which can be evicted.
-      assert(old->InCache() && !old->HasRefs());
-      LRU_Remove(old);
-      table_.Remove(old->key(), old->hash);
-      old->SetInCache(false);
-      assert(usage_ >= old->total_charge);
-      usage_ -= old->total_charge;
-      last_reference_list.push_back(old);
+    for (size_t i = 0; i < num_lists_; i++) {
+      LRUList& list = lists_[i];
+      while (list.head.next != &list.head) {
+        LRUHandle* old = list.head.next;
+        // LRU list contains only elements which can be evicted.
+        assert(old->InCache() && !old->HasRefs());
+        LRU_Remove(old);
+        table_.Remove(old->key(), old->hash);
+        old->SetInCache(false);
+        assert(usage_ >= old->total_charge);
+        usage_ -= old->total_charge;
+        list.usage -= old->total_charge;
+        last_reference_list.push_back(old);
+      }
     }
   }
 
@@ -204,18 +220,19 @@ void LRUCacheShard::ApplyToSomeEntries(
 void LRUCacheShard::TEST_GetLRUList(LRUHandle** lru, LRUHandle** lru_low_pri,
                                     LRUHandle** lru_bottom_pri) {
   DMutexLock l(mutex_);
-  *lru = &lru_;
-  *lru_low_pri = lru_low_pri_;
-  *lru_bottom_pri = lru_bottom_pri_;
+  *lru = &lists_[0].head;
+  *lru_low_pri = lists_[0].low_pri;
+  *lru_bottom_pri = lists_[0].bottom_pri;
 }
 
 size_t LRUCacheShard::TEST_GetLRUSize() {
   DMutexLock l(mutex_);
-  LRUHandle* lru_handle = lru_.next;
   size_t lru_size = 0;
-  while (lru_handle != &lru_) {
-    lru_size++;
-    lru_handle = lru_handle->next;
+  for (size_t i = 0; i < num_lists_; i++) {
+    const LRUHandle* head = &lists_[i].head;
+    for (LRUHandle* h = head->next; h != head; h = h->next) {
+      lru_size++;
+    }
   }
   return lru_size;
 }
@@ -233,11 +250,12 @@ double LRUCacheShard::GetLowPriPoolRatio() {
 void LRUCacheShard::LRU_Remove(LRUHandle* e) {
   assert(e->next != nullptr);
   assert(e->prev != nullptr);
-  if (lru_low_pri_ == e) {
-    lru_low_pri_ = e->prev;
+  LRUList& list = lists_[e->list_index];
+  if (list.low_pri == e) {
+    list.low_pri = e->prev;
   }
-  if (lru_bottom_pri_ == e) {
-    lru_bottom_pri_ = e->prev;
+  if (list.bottom_pri == e) {
+    list.bottom_pri = e->prev;
   }
   e->next->prev = e->prev;
   e->prev->next = e->next;
@@ -246,83 +264,125 @@ void LRUCacheShard::LRU_Remove(LRUHandle* e) {
   lru_usage_ -= e->total_charge;
   assert(!e->InHighPriPool() || !e->InLowPriPool());
   if (e->InHighPriPool()) {
-    assert(high_pri_pool_usage_ >= e->total_charge);
-    high_pri_pool_usage_ -= e->total_charge;
+    assert(list.high_pri_pool_usage >= e->total_charge);
+    list.high_pri_pool_usage -= e->total_charge;
   } else if (e->InLowPriPool()) {
-    assert(low_pri_pool_usage_ >= e->total_charge);
-    low_pri_pool_usage_ -= e->total_charge;
+    assert(list.low_pri_pool_usage >= e->total_charge);
+    list.low_pri_pool_usage -= e->total_charge;
   }
 }
 
 void LRUCacheShard::LRU_Insert(LRUHandle* e) {
   assert(e->next == nullptr);
   assert(e->prev == nullptr);
+  LRUList& list = lists_[e->list_index];
   if (high_pri_pool_ratio_ > 0 && (e->IsHighPri() || e->HasHit())) {
     // Inset "e" to head of LRU list.
-    e->next = &lru_;
-    e->prev = lru_.prev;
+    e->next = &list.head;
+    e->prev = list.head.prev;
     e->prev->next = e;
     e->next->prev = e;
     e->SetInHighPriPool(true);
     e->SetInLowPriPool(false);
-    high_pri_pool_usage_ += e->total_charge;
-    MaintainPoolSize();
+    list.high_pri_pool_usage += e->total_charge;
+    MaintainPoolSize(&list);
   } else if (low_pri_pool_ratio_ > 0 &&
              (e->IsHighPri() || e->IsLowPri() || e->HasHit())) {
     // Insert "e" to the head of low-pri pool.
-    e->next = lru_low_pri_->next;
-    e->prev = lru_low_pri_;
+    e->next = list.low_pri->next;
+    e->prev = list.low_pri;
     e->prev->next = e;
     e->next->prev = e;
     e->SetInHighPriPool(false);
     e->SetInLowPriPool(true);
-    low_pri_pool_usage_ += e->total_charge;
-    MaintainPoolSize();
-    lru_low_pri_ = e;
+    list.low_pri_pool_usage += e->total_charge;
+    MaintainPoolSize(&list);
+    list.low_pri = e;
   } else {
     // Insert "e" to the head of bottom-pri pool.
-    e->next = lru_bottom_pri_->next;
-    e->prev = lru_bottom_pri_;
+    e->next = list.bottom_pri->next;
+    e->prev = list.bottom_pri;
     e->prev->next = e;
     e->next->prev = e;
     e->SetInHighPriPool(false);
     e->SetInLowPriPool(false);
-    // if the low-pri pool is empty, lru_low_pri_ also needs to be updated.
-    if (lru_bottom_pri_ == lru_low_pri_) {
-      lru_low_pri_ = e;
+    // if the low-pri pool is empty, low_pri also needs to be updated.
+    if (list.bottom_pri == list.low_pri) {
+      list.low_pri = e;
     }
-    lru_bottom_pri_ = e;
+    list.bottom_pri = e;
   }
   lru_usage_ += e->total_charge;
 }
 
-void LRUCacheShard::MaintainPoolSize() {
-  while (high_pri_pool_usage_ > high_pri_pool_capacity_) {
+void LRUCacheShard::MaintainPoolSize(LRUList* list) {
+  while (list->high_pri_pool_usage > list->high_pri_pool_capacity) {
     // Overflow last entry in high-pri pool to low-pri pool.
-    lru_low_pri_ = lru_low_pri_->next;
-    assert(lru_low_pri_ != &lru_);
-    lru_low_pri_->SetInHighPriPool(false);
-    lru_low_pri_->SetInLowPriPool(true);
-    assert(high_pri_pool_usage_ >= lru_low_pri_->total_charge);
-    high_pri_pool_usage_ -= lru_low_pri_->total_charge;
-    low_pri_pool_usage_ += lru_low_pri_->total_charge;
+    list->low_pri = list->low_pri->next;
+    assert(list->low_pri != &list->head);
+    list->low_pri->SetInHighPriPool(false);
+    list->low_pri->SetInLowPriPool(true);
+    assert(list->high_pri_pool_usage >= list->low_pri->total_charge);
+    list->high_pri_pool_usage -= list->low_pri->total_charge;
+    list->low_pri_pool_usage += list->low_pri->total_charge;
   }
 
-  while (low_pri_pool_usage_ > low_pri_pool_capacity_) {
+  while (list->low_pri_pool_usage > list->low_pri_pool_capacity) {
     // Overflow last entry in low-pri pool to bottom-pri pool.
-    lru_bottom_pri_ = lru_bottom_pri_->next;
-    assert(lru_bottom_pri_ != &lru_);
-    lru_bottom_pri_->SetInHighPriPool(false);
-    lru_bottom_pri_->SetInLowPriPool(false);
-    assert(low_pri_pool_usage_ >= lru_bottom_pri_->total_charge);
-    low_pri_pool_usage_ -= lru_bottom_pri_->total_charge;
+    list->bottom_pri = list->bottom_pri->next;
+    assert(list->bottom_pri != &list->head);
+    list->bottom_pri->SetInHighPriPool(false);
+    list->bottom_pri->SetInLowPriPool(false);
+    assert(list->low_pri_pool_usage >= list->bottom_pri->total_charge);
+    list->low_pri_pool_usage -= list->bottom_pri->total_charge;
+  }
+}
+
+uint8_t LRUCacheShard::CurrentListIndex() const {
+  if (num_lists_ == 1) {
+    return 0;
+  }
+  return static_cast<uint8_t>(CacheCallerScope::Current());
+}
+
+LRUCacheShard::LRUList* LRUCacheShard::EvictionList(size_t charge,
+                                                    uint8_t list_index) {
+  LRUList* victim = nullptr;
+  size_t victim_usage = 0;
+  for (size_t i = 0; i < num_lists_; i++) {
+    LRUList* list = &lists_[i];
+    if (list->head.next == &list->head) {
+      continue;
+    }
+    const size_t usage = list->usage + (i == list_index ? charge : 0);
+    // Compares usage - quota without underflow.
+    if (victim == nullptr ||
+        usage + victim->quota > victim_usage + list->quota) {
+      victim = list;
+      victim_usage = usage;
+    }
+  }
+  return victim;
+}
+
+void LRUCacheShard::UpdateListCapacities() {
+  for (size_t i = 0; i < num_lists_; i++) {
+    LRUList& list = lists_[i];
+    list.quota = static_cast<size_t>(capacity_ * list.quota_ratio);
+    list.high_pri_pool_capacity = list.quota * high_pri_pool_ratio_;
+    list.low_pri_pool_capacity = list.quota * low_pri_pool_ratio_;
   }
 }
 
 void LRUCacheShard::EvictFromLRU(size_t charge,
-                                 autovector<LRUHandle*>* deleted) {
-  while ((usage_ + charge) > capacity_ && lru_.next != &lru_) {
-    LRUHandle* old = lru_.next;
+                                 autovector<LRUHandle*>* deleted,
+                                 uint8_t list_index) {
+  while ((usage_ + charge) > capacity_) {
+    LRUList* list = EvictionList(charge, list_index);
+    if (list == nullptr) {
+      break;
+    }
+    LRUHandle* old = list->head.next;
     // LRU list contains only elements which can be evicted.
     assert(old->InCache() && !old->HasRefs());
     LRU_Remove(old);
@@ -330,10 +390,23 @@ void LRUCacheShard::EvictFromLRU(size_t charge,
     old->SetInCache(false);
     assert(usage_ >= old->total_charge);
     usage_ -= old->total_charge;
+    list->usage -= old->total_charge;
     deleted->push_back(old);
   }
 }
 
+bool LRUCacheShard::ShouldAdmit(const LRUHandle* e) {
+  if (admission_policy_ == nullptr || strict_capacity_limit_ ||
+      e->IsHighPri() || usage_ + e->total_charge <= capacity_) {
+    return true;
+  }
+  const LRUList* list = EvictionList(e->total_charge, e->list_index);
+  if (list == nullptr) {
+    return true;
+  }
+  return admission_policy_->Admit(e->hash, list->head.next->hash);
+}
+
 void LRUCacheShard::NotifyEvicted(
     const autovector<LRUHandle*>& evicted_handles) {
   MemoryAllocator* alloc = table_.GetAllocator();
@@ -356,8 +429,7 @@ void LRUCacheShard::SetCapacity(size_t capacity) {
   {
     DMutexLock l(mutex_);
     capacity_ = capacity;
-    high_pri_pool_capacity_ = capacity_ * high_pri_pool_ratio_;
-    low_pri_pool_capacity_ = capacity_ * low_pri_pool_ratio_;
+    UpdateListCapacities();
     EvictFromLRU(0, &last_reference_list);
   }
 
@@ -376,11 +448,44 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
   {
     DMutexLock l(mutex_);
 
-    // Free the space following strict LRU policy until enough space
-    // is freed or the lru list is empty.
-    EvictFromLRU(e->total_charge, &last_reference_list);
+    const bool admitted = ShouldAdmit(e);
+    if (admitted) {
+      // Free the space following strict LRU policy until enough space
+      // is freed or the lru list is empty.
+      EvictFromLRU(e->total_charge, &last_reference_list, e->list_index);
+    }
 
-    if ((usage_ + e->total_charge) > capacity_ &&
+    if (!admitted) {
+      // As if the entry was inserted into cache and evicted immediately. A
+      // requested handle refers to it as a standalone entry, so that the
+      // caller can still use the value until it releases the handle. Like an
+      // admitted entry, it replaces any entry with the same key.
+      LRUHandle* old = table_.Remove(e->key(), e->hash);
+      if (old != nullptr) {
+        s = Status::OkOverwritten();
+        assert(old->InCache());
+        old->SetInCache(false);
+        if (!old->HasRefs()) {
+          LRU_Remove(old);
+          assert(usage_ >= old->total_charge);
+          usage_ -= old->total_charge;
+          lists_[old->list_index].usage -= old->total_charge;
+          last_reference_list.push_back(old);
+        }
+      }
+      e->SetInCache(false);
+      if (handle == nullptr) {
+        last_reference_list.push_back(e);
+      } else {
+        e->SetIsStandalone(true);
+        if (!e->HasRefs()) {
+          e->Ref();
+        }
+        usage_ += e->total_charge;
+        lists_[e->list_index].usage += e->total_charge;
+        *handle = e;
+      }
+    } else if ((usage_ + e->total_charge) > capacity_ &&
         (strict_capacity_limit_ || handle == nullptr)) {
       e->SetInCache(false);
       if (handle == nullptr) {
@@ -398,6 +503,7 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
       // capacity if not enough space was freed up.
       LRUHandle* old = table_.Insert(e);
       usage_ += e->total_charge;
+      lists_[e->list_index].usage += e->total_charge;
       if (old != nullptr) {
         s = Status::OkOverwritten();
         assert(old->InCache());
@@ -407,6 +513,7 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
           LRU_Remove(old);
           assert(usage_ >= old->total_charge);
           usage_ -= old->total_charge;
+          lists_[old->list_index].usage -= old->total_charge;
           last_reference_list.push_back(old);
         }
       }
@@ -432,6 +539,9 @@ LRUHandle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash,
                                  Cache::CreateContext* /*create_context*/,
                                  Cache::Priority /*priority*/,
                                  Statistics* /*stats*/) {
+  if (admission_policy_ != nullptr) {
+    admission_policy_->RecordAccess(hash);
+  }
   DMutexLock l(mutex_);
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
@@ -458,15 +568,19 @@ bool LRUCacheShard::Ref(LRUHandle* e) {
 void LRUCacheShard::SetHighPriorityPoolRatio(double high_pri_pool_ratio) {
   DMutexLock l(mutex_);
   high_pri_pool_ratio_ = high_pri_pool_ratio;
-  high_pri_pool_capacity_ = capacity_ * high_pri_pool_ratio_;
-  MaintainPoolSize();
+  UpdateListCapacities();
+  for (size_t i = 0; i < num_lists_; i++) {
+    MaintainPoolSize(&lists_[i]);
+  }
 }
 
 void LRUCacheShard::SetLowPriorityPoolRatio(double low_pri_pool_ratio) {
   DMutexLock l(mutex_);
   low_pri_pool_ratio_ = low_pri_pool_ratio;
-  low_pri_pool_capacity_ = capacity_ * low_pri_pool_ratio_;
-  MaintainPoolSize();
+  UpdateListCapacities();
+  for (size_t i = 0; i < num_lists_; i++) {
+    MaintainPoolSize(&lists_[i]);
+  }
 }
 
 bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
@@ -483,8 +597,8 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
     if (must_free && was_in_cache) {
       // The item is still in cache, and nobody else holds a reference to it.
       if (usage_ > capacity_ || erase_if_last_ref) {
-        // The LRU list must be empty since the cache is full.
-        assert(lru_.next == &lru_ || erase_if_last_ref);
+        // The LRU lists must be empty since the cache is full.
+        assert(EvictionList(0, 0) == nullptr || erase_if_last_ref);
         // Take this opportunity and remove the item.
         table_.Remove(e->key(), e->hash);
         e->SetInCache(false);
@@ -498,6 +612,7 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
     if (must_free) {
       assert(usage_ >= e->total_charge);
       usage_ -= e->total_charge;
+      lists_[e->list_index].usage -= e->total_charge;
     }
   }
 
@@ -538,6 +653,7 @@ LRUHandle* LRUCacheShard::CreateHandle(const Slice& key, uint32_t hash,
   e->key_length = key.size();
   e->hash = hash;
   e->refs = 0;
+  e->list_index = CurrentListIndex();
   e->next = e->prev = nullptr;
   memcpy(e->key_data, key.data(), key.size());
   e->CalcTotalCharge(charge, metadata_charge_policy_);
@@ -570,7 +686,7 @@ LRUHandle* LRUCacheShard::CreateStandalone(const Slice& key, uint32_t hash,
   {
     DMutexLock l(mutex_);
 
-    EvictFromLRU(e->total_charge, &last_reference_list);
+    EvictFromLRU(e->total_charge, &last_reference_list, e->list_index);
 
     if (strict_capacity_limit_ && (usage_ + e->total_charge) > capacity_) {
       if (allow_uncharged) {
@@ -581,6 +697,7 @@ LRUHandle* LRUCacheShard::CreateStandalone(const Slice& key, uint32_t hash,
       }
     } else {
       usage_ += e->total_charge;
+      lists_[e->list_index].usage += e->total_charge;
     }
   }
 
@@ -602,6 +719,7 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
         LRU_Remove(e);
         assert(usage_ >= e->total_charge);
         usage_ -= e->total_charge;
+        lists_[e->list_index].usage -= e->total_charge;
         last_reference = true;
       }
     }
@@ -646,6 +764,14 @@ void LRUCacheShard::AppendPrintableOptions(std::string& str) const {
              "    low_pri_pool_ratio: %.3lf\n", low_pri_pool_ratio_);
   }
   str.append(buffer);
+  if (num_lists_ > 1) {
+    str.append("    caller_quota_ratios:");
+    for (size_t i = 0; i < num_lists_; i++) {
+      snprintf(buffer, kBufferSize, " %.3lf", lists_[i].quota_ratio);
+      str.append(buffer);
+    }
+    str.append("\n");
+  }
 }
 
 LRUCache::LRUCache(const LRUCacheOptions& opts) : ShardedCache(opts) {
@@ -656,7 +782,8 @@ LRUCache::LRUCache(const LRUCacheOptions& opts) : ShardedCache(opts) {
                            opts.high_pri_pool_ratio, opts.low_pri_pool_ratio,
                            opts.use_adaptive_mutex, opts.metadata_charge_policy,
                            /* max_upper_hash_bits */ 32 - opts.num_shard_bits,
-                           alloc, &eviction_callback_);
+                           alloc, &eviction_callback_, admission_policy_.get(),
+                           opts.caller_quota_ratios);
   });
 }
 
@@ -702,6 +829,22 @@ std::shared_ptr<Cache> LRUCacheOptions::MakeSharedCache() const {
     // Invalid high_pri_pool_ratio and low_pri_pool_ratio combination
     return nullptr;
   }
+  if (caller_quota_ratios.size() >
+      static_cast<size_t>(CacheCaller::kNumCallers)) {
+    return nullptr;
+  }
+  double quota_ratio_sum = 0.0;
+  for (double ratio : caller_quota_ratios) {
+    if (ratio < 0.0 || ratio > 1.0) {
+      // Invalid caller_quota_ratios
+      return nullptr;
+    }
+    quota_ratio_sum += ratio;
+  }
+  if (quota_ratio_sum > 1.0) {
+    // Invalid caller_quota_ratios combination
+    return nullptr;
+  }
   // For sanitized options
   LRUCacheOptions opts = *this;
   if (opts.num_shard_bits < 0) {
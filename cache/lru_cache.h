@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
@@ -87,6 +88,10 @@ struct LRUHandle {
     IM_IS_STANDALONE = (1 << 2),
   };
 
+  // The LRU list of the shard that this entry is charged to. Always 0, unless
+  // LRUCacheOptions::caller_quota_ratios is set.
+  uint8_t list_index;
+
   // Beginning of the key (MUST BE THE LAST FIELD IN THIS STRUCT!)
   char key_data[1];
 
@@ -271,7 +276,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
                 bool use_adaptive_mutex,
                 CacheMetadataChargePolicy metadata_charge_policy,
                 int max_upper_hash_bits, MemoryAllocator* allocator,
-                const Cache::EvictionCallback* eviction_callback);
+                const Cache::EvictionCallback* eviction_callback,
+                CacheAdmissionPolicy* admission_policy = nullptr,
+                const std::vector<double>& caller_quota_ratios = {});
 
  public:  // Type definitions expected as parameter to ShardedCache
   using HandleImpl = LRUHandle;
@@ -351,6 +358,57 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
 
  private:
   friend class LRUCache;
+
+  // An LRU list with its priority pools. A shard has one list per CacheCaller
+  // if LRUCacheOptions::caller_quota_ratios is set, and a single list
+  // otherwise.
+  struct LRUList {
+    // Dummy head of the list.
+    // head.prev is newest entry, head.next is oldest entry.
+    // The list contains items which can be evicted, ie reference only by
+    // cache.
+    LRUHandle head;
+
+    // Pointer to head of low-pri pool in the list.
+    LRUHandle* low_pri;
+
+    // Pointer to head of bottom-pri pool in the list.
+    LRUHandle* bottom_pri;
+
+    // Memory size for entries in high-pri pool.
+    size_t high_pri_pool_usage;
+
+    // Memory size for entries in low-pri pool.
+    size_t low_pri_pool_usage;
+
+    // Pool sizes, equal to quota * pool ratio. Remember the values to avoid
+    // recomputing each time.
+    double high_pri_pool_capacity;
+    double low_pri_pool_capacity;
+
+    // Share of capacity reserved for the entries of the list, and the
+    // resulting size.
+    double quota_ratio;
+    size_t quota;
+
+    // Memory size of the entries charged to the list, including the
+    // referenced entries that are not in the list.
+    size_t usage;
+  };
+
+  // The list that the entries inserted by the current thread are charged to.
+  uint8_t CurrentListIndex() const;
+
+  // Returns the list to evict from before inserting `charge` into the list
+  // `list_index`, i.e. the non-empty list whose usage, including the insert,
+  // exceeds its quota by the most. Returns nullptr if all the lists are
+  // empty.
+  // This function is not thread safe - it needs to be executed while
+  // holding the mutex_.
+  LRUList* EvictionList(size_t charge, uint8_t list_index);
+
+  // Recomputes the quota and pool capacities of each list.
+  void UpdateListCapacities();
   // Insert an item into the hash table and, if handle is null, insert into
   // the LRU list. Older items are evicted as necessary. Frees `item` on
   // non-OK status.
@@ -361,13 +419,21 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
 
   // Overflow the last entry in high-pri pool to low-pri pool until size of
   // high-pri pool is no larger than the size specify by high_pri_pool_pct.
-  void MaintainPoolSize();
+  void MaintainPoolSize(LRUList* list);
 
   // Free some space following strict LRU policy until enough space
-  // to hold (usage_ + charge) is freed or the lru list is empty
+  // to hold (usage_ + charge) is freed or the lru lists are empty. `charge`
+  // is to be inserted into the list `list_index`.
+  // This function is not thread safe - it needs to be executed while
+  // holding the mutex_.
+  void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted,
+                    uint8_t list_index = 0);
+
+  // Returns false if inserting `e` requires an eviction and admission_policy_
+  // prefers the next eviction victim over `e`.
   // This function is not thread safe - it needs to be executed while
   // holding the mutex_.
-  void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted);
+  bool ShouldAdmit(const LRUHandle* e);
 
   void NotifyEvicted(const autovector<LRUHandle*>& evicted_handles);
 
@@ -378,39 +444,18 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   // Initialized before use.
   size_t capacity_;
 
-  // Memory size for entries in high-pri pool.
-  size_t high_pri_pool_usage_;
-
-  // Memory size for entries in low-pri pool.
-  size_t low_pri_pool_usage_;
-
   // Whether to reject insertion if cache reaches its full capacity.
   bool strict_capacity_limit_;
 
   // Ratio of capacity reserved for high priority cache entries.
   double high_pri_pool_ratio_;
 
-  // High-pri pool size, equals to capacity * high_pri_pool_ratio.
-  // Remember the value to avoid recomputing each time.
-  double high_pri_pool_capacity_;
-
   // Ratio of capacity reserved for low priority cache entries.
   double low_pri_pool_ratio_;
 
-  // Low-pri pool size, equals to capacity * low_pri_pool_ratio.
-  // Remember the value to avoid recomputing each time.
-  double low_pri_pool_capacity_;
-
-  // Dummy head of LRU list.
-  // lru.prev is newest entry, lru.next is oldest entry.
-  // LRU contains items which can be evicted, ie reference only by cache
-  LRUHandle lru_;
-
-  // Pointer to head of low-pri pool in LRU list.
-  LRUHandle* lru_low_pri_;
-
-  // Pointer to head of bottom-pri pool in LRU list.
-  LRUHandle* lru_bottom_pri_;
+  // The LRU lists, indexed by LRUHandle::list_index.
+  const size_t num_lists_;
+  std::unique_ptr<LRUList[]> lists_;
 
   // ------------^^^^^^^^^^^^^-----------
   // Not frequently modified data members
@@ -428,7 +473,7 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   // Memory size for entries residing in the cache.
   size_t usage_;
 
-  // Memory size for entries residing only in the LRU list.
+  // Memory size for entries residing only in the LRU lists.
   size_t lru_usage_;
 
   // mutex_ protects the following state.
@@ -438,6 +483,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
 
   // A reference to Cache::eviction_callback_
   const Cache::EvictionCallback& eviction_callback_;
+
+  // ShardedCacheOptions::admission_policy, or nullptr
+  CacheAdmissionPolicy* const admission_policy_;
 };
 
 class LRUCache
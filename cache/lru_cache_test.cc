@@ -369,6 +369,200 @@ TEST_F(LRUCacheTest, EntriesWithPriority) {
   ValidateLRUList({"x", "y", "g", "z", "d", "m"}, 2, 2, 2);
 }
 
+TEST(LRUCacheAdmissionTest, TinyLFUKeepsFrequentEntries) {
+  const int kNumHotKeys = 50;
+  const int kNumScanKeys = 400;
+  for (bool use_policy : {false, true}) {
+    SCOPED_TRACE("use_policy=" + std::to_string(use_policy));
+    LRUCacheOptions opts(kNumHotKeys /* capacity */, 0 /* num_shard_bits */,
+                         false /* strict_capacity_limit */,
+                         0.0 /* high_pri_pool_ratio */);
+    opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    if (use_policy) {
+      opts.admission_policy = NewTinyLFUAdmissionPolicy(kNumHotKeys);
+    }
+    std::shared_ptr<Cache> cache = NewLRUCache(opts);
+    if (use_policy) {
+      ASSERT_NE(std::string::npos,
+                cache->GetPrintableOptions().find("TinyLFUAdmissionPolicy"));
+    }
+
+    auto lookup_or_insert = [&](const std::string& key) {
+      Cache::Handle* handle = cache->Lookup(key);
+      if (handle != nullptr) {
+        cache->Release(handle);
+        return true;
+      }
+      EXPECT_OK(cache->Insert(key, nullptr, &kNoopCacheItemHelper,
+                              1 /* charge */));
+      return false;
+    };
+
+    // Make the hot keys frequent.
+    for (int round = 0; round < 3; round++) {
+      for (int i = 0; i < kNumHotKeys; i++) {
+        lookup_or_insert("hot" + std::to_string(i));
+      }
+    }
+    // A scan of keys accessed only once, shorter than the period after which
+    // the sketch halves its counters.
+    for (int i = 0; i < kNumScanKeys; i++) {
+      lookup_or_insert("scan" + std::to_string(i));
+    }
+    ASSERT_LE(cache->GetUsage(), kNumHotKeys);
+
+    int num_hits = 0;
+    for (int i = 0; i < kNumHotKeys; i++) {
+      Cache::Handle* handle = cache->Lookup("hot" + std::to_string(i));
+      if (handle != nullptr) {
+        num_hits++;
+        cache->Release(handle);
+      }
+    }
+    if (use_policy) {
+      ASSERT_GE(num_hits, kNumHotKeys * 4 / 5);
+    } else {
+      ASSERT_EQ(num_hits, 0);
+    }
+  }
+}
+
+TEST(LRUCacheAdmissionTest, RejectedEntryWithHandle) {
+  LRUCacheOptions opts(1 /* capacity */, 0 /* num_shard_bits */,
+                       false /* strict_capacity_limit */,
+                       0.0 /* high_pri_pool_ratio */);
+  opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  opts.admission_policy = NewTinyLFUAdmissionPolicy(16);
+  std::shared_ptr<Cache> cache = NewLRUCache(opts);
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(nullptr, cache->Lookup("hot"));
+  }
+  ASSERT_OK(cache->Insert("hot", nullptr, &kNoopCacheItemHelper, 1));
+
+  // Rejected, but the handle is usable until released.
+  Cache::Handle* handle = nullptr;
+  ASSERT_OK(
+      cache->Insert("cold", nullptr, &kNoopCacheItemHelper, 1, &handle));
+  ASSERT_NE(nullptr, handle);
+  ASSERT_EQ(2, cache->GetUsage());
+  cache->Release(handle);
+  ASSERT_EQ(1, cache->GetUsage());
+  ASSERT_EQ(nullptr, cache->Lookup("cold"));
+
+  // High priority entries bypass the policy.
+  ASSERT_OK(cache->Insert("index", nullptr, &kNoopCacheItemHelper, 1,
+                          nullptr /* handle */, Cache::Priority::HIGH));
+  handle = cache->Lookup("index");
+  ASSERT_NE(nullptr, handle);
+  cache->Release(handle);
+  ASSERT_EQ(nullptr, cache->Lookup("hot"));
+}
+
+TEST(LRUCacheAdmissionTest, RejectedOverwriteErasesOldEntry) {
+  LRUCacheOptions opts(2 /* capacity */, 0 /* num_shard_bits */,
+                       false /* strict_capacity_limit */,
+                       0.0 /* high_pri_pool_ratio */);
+  opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  opts.admission_policy = NewTinyLFUAdmissionPolicy(16);
+  std::shared_ptr<Cache> cache = NewLRUCache(opts);
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(nullptr, cache->Lookup("hot"));
+  }
+  int old_value = 0;
+  int new_value = 0;
+  ASSERT_OK(cache->Insert("hot", nullptr, &kNoopCacheItemHelper, 1));
+  ASSERT_OK(cache->Insert("key", &old_value, &kNoopCacheItemHelper, 1));
+  ASSERT_EQ(2, cache->GetUsage());
+
+  // The new value of "key" is rejected in favor of "hot", and the old value
+  // must not be served anymore.
+  Status s = cache->Insert("key", &new_value, &kNoopCacheItemHelper, 1);
+  ASSERT_TRUE(s.IsOkOverwritten());
+  ASSERT_EQ(nullptr, cache->Lookup("key"));
+  ASSERT_EQ(1, cache->GetUsage());
+  Cache::Handle* handle = cache->Lookup("hot");
+  ASSERT_NE(nullptr, handle);
+  cache->Release(handle);
+
+  // Same when the old value is still referenced, and for a rejected entry
+  // returned through a handle.
+  ASSERT_OK(cache->Insert("key", &old_value, &kNoopCacheItemHelper, 1));
+  Cache::Handle* old_handle = cache->Lookup("key");
+  ASSERT_NE(nullptr, old_handle);
+  handle = nullptr;
+  s = cache->Insert("key", &new_value, &kNoopCacheItemHelper, 1, &handle);
+  ASSERT_TRUE(s.IsOkOverwritten());
+  ASSERT_NE(nullptr, handle);
+  ASSERT_EQ(&new_value, cache->Value(handle));
+  ASSERT_EQ(&old_value, cache->Value(old_handle));
+  cache->Release(handle);
+  cache->Release(old_handle);
+  ASSERT_EQ(nullptr, cache->Lookup("key"));
+  ASSERT_EQ(1, cache->GetUsage());
+}
+
+TEST(LRUCachePartitionTest, CallerQuotas) {
+  LRUCacheOptions opts(100 /* capacity */, 0 /* num_shard_bits */,
+                       false /* strict_capacity_limit */,
+                       0.0 /* high_pri_pool_ratio */);
+  opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  opts.caller_quota_ratios = {0.0, 0.5, 0.6};
+  ASSERT_EQ(nullptr, opts.MakeSharedCache());
+  opts.caller_quota_ratios.assign(
+      static_cast<size_t>(CacheCaller::kNumCallers) + 1, 0.0);
+  ASSERT_EQ(nullptr, opts.MakeSharedCache());
+  // kOther, kPointLookup, kScan
+  opts.caller_quota_ratios = {0.0, 0.5, 0.5};
+  std::shared_ptr<Cache> cache = opts.MakeSharedCache();
+  ASSERT_NE(nullptr, cache);
+
+  auto insert = [&](CacheCaller caller, const std::string& prefix, int begin,
+                    int end) {
+    CacheCallerScope scope(caller);
+    for (int i = begin; i < end; i++) {
+      ASSERT_OK(cache->Insert(prefix + std::to_string(i), nullptr,
+                              &kNoopCacheItemHelper, 1 /* charge */));
+    }
+  };
+  auto count = [&](const std::string& prefix, int begin, int end) {
+    int n = 0;
+    for (int i = begin; i < end; i++) {
+      Cache::Handle* handle = cache->Lookup(prefix + std::to_string(i));
+      if (handle != nullptr) {
+        n++;
+        cache->Release(handle);
+      }
+    }
+    return n;
+  };
+
+  // While point lookups are idle, a scan can use the whole cache.
+  insert(CacheCaller::kScan, "scan", 0, 200);
+  ASSERT_EQ(100, cache->GetUsage());
+  ASSERT_EQ(100, count("scan", 100, 200));
+
+  // Point lookups take back their quota from the scan.
+  insert(CacheCaller::kPointLookup, "point", 0, 100);
+  ASSERT_EQ(100, cache->GetUsage());
+  ASSERT_EQ(50, count("point", 50, 100));
+  ASSERT_EQ(50, count("scan", 150, 200));
+
+  // A long scan only evicts its own entries.
+  insert(CacheCaller::kScan, "scan", 200, 1200);
+  ASSERT_EQ(100, cache->GetUsage());
+  ASSERT_EQ(50, count("point", 50, 100));
+  ASSERT_EQ(50, count("scan", 1150, 1200));
+
+  // Without a scope, entries are charged to kOther, which has no quota, so
+  // it keeps evicting its own entries.
+  insert(CacheCaller::kOther, "other", 0, 10);
+  ASSERT_EQ(100, cache->GetUsage());
+  ASSERT_EQ(1, count("other", 0, 10));
+  ASSERT_EQ(99, count("point", 50, 100) + count("scan", 1150, 1200));
+}
+
 namespace clock_cache {
 
 template <class ClockCache>
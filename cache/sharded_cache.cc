@@ -62,6 +62,7 @@ ShardedCacheBase::ShardedCacheBase(const ShardedCacheOptions& opts)
       last_id_(1),
       shard_mask_((uint32_t{1} << opts.num_shard_bits) - 1),
       hash_seed_(DetermineSeed(opts.hash_seed)),
+      admission_policy_(opts.admission_policy),
       strict_capacity_limit_(opts.strict_capacity_limit),
       capacity_(opts.capacity) {}
 
@@ -122,6 +123,9 @@ std::string ShardedCacheBase::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    memory_allocator : %s\n",
            memory_allocator() ? memory_allocator()->Name() : "None");
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    admission_policy : %s\n",
+           admission_policy_ ? admission_policy_->Name() : "None");
+  ret.append(buffer);
   AppendPrintableOptions(ret);
   return ret;
 }
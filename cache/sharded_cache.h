@@ -117,6 +117,8 @@ class ShardedCacheBase : public Cache {
   std::atomic<uint64_t> last_id_;  // For NewId
   const uint32_t shard_mask_;
   const uint32_t hash_seed_;
+  // See ShardedCacheOptions::admission_policy
+  const std::shared_ptr<CacheAdmissionPolicy> admission_policy_;
 
   // Dynamic configuration parameters, guarded by config_mutex_
   bool strict_capacity_limit_;
@@ -0,0 +1,130 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "rocksdb/cache.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+// A count-min sketch with kDepth rows of 4-bit saturating counters, packed 16
+// per 64-bit word. Updates use relaxed atomics: a lost increment or halving
+// due to a race only makes an estimate slightly off, which is acceptable for
+// an admission heuristic.
+class TinyLFUAdmissionPolicy : public CacheAdmissionPolicy {
+ public:
+  explicit TinyLFUAdmissionPolicy(size_t expected_entries) {
+    // The number of entries, rounded up to a power of two, and capped so
+    // that the sketch takes at most 32MB.
+    const int entries_bits = std::min(
+        FloorLog2(std::max(expected_entries, size_t{16}) - 1) + 1, 22);
+    // Each row has 4 counters per entry, which keeps the overestimation due
+    // to the keys accessed since the last aging low.
+    width_bits_ = entries_bits + 2;
+    num_words_ = (size_t{kDepth} << width_bits_) / kCountersPerWord;
+    words_.reset(new std::atomic<uint64_t>[num_words_]);
+    for (size_t i = 0; i < num_words_; i++) {
+      words_[i].store(0, std::memory_order_relaxed);
+    }
+    // As in the TinyLFU paper, counters are halved after a number of
+    // accesses proportional to the number of cache entries.
+    sample_size_ = uint64_t{10} << entries_bits;
+  }
+
+  const char* Name() const override { return "TinyLFUAdmissionPolicy"; }
+
+  void RecordAccess(uint64_t key_hash) override {
+    bool incremented = false;
+    for (int row = 0; row < kDepth; row++) {
+      size_t index = CounterIndex(key_hash, row);
+      std::atomic<uint64_t>& word = words_[index / kCountersPerWord];
+      const int shift = static_cast<int>(index % kCountersPerWord) * 4;
+      uint64_t old_word = word.load(std::memory_order_relaxed);
+      while (((old_word >> shift) & kCounterMask) < kCounterMask) {
+        if (word.compare_exchange_weak(old_word,
+                                       old_word + (uint64_t{1} << shift),
+                                       std::memory_order_relaxed)) {
+          incremented = true;
+          break;
+        }
+      }
+    }
+    if (incremented &&
+        additions_.fetch_add(1, std::memory_order_relaxed) + 1 >=
+            sample_size_) {
+      Age();
+    }
+  }
+
+  bool Admit(uint64_t candidate_hash, uint64_t victim_hash) override {
+    return EstimateFrequency(candidate_hash) > EstimateFrequency(victim_hash);
+  }
+
+ private:
+  static constexpr int kDepth = 4;
+  static constexpr size_t kCountersPerWord = 16;
+  static constexpr uint64_t kCounterMask = 0xF;
+
+  // The counter of `key_hash` in `row`, as an index over all the counters.
+  // Each row remixes the hash differently, as the hash of some caches only
+  // has 32 significant bits.
+  size_t CounterIndex(uint64_t key_hash, int row) const {
+    uint64_t h = (key_hash + uint64_t{0x9E3779B97F4A7C15} * (row + 1)) *
+                 uint64_t{0xFF51AFD7ED558CCD};
+    h ^= h >> 32;
+    h *= uint64_t{0xC4CEB9FE1A85EC53};
+    return (static_cast<size_t>(row) << width_bits_) |
+           static_cast<size_t>(h >> (64 - width_bits_));
+  }
+
+  uint64_t EstimateFrequency(uint64_t key_hash) const {
+    uint64_t frequency = kCounterMask;
+    for (int row = 0; row < kDepth; row++) {
+      size_t index = CounterIndex(key_hash, row);
+      uint64_t word =
+          words_[index / kCountersPerWord].load(std::memory_order_relaxed);
+      frequency = std::min(
+          frequency, (word >> ((index % kCountersPerWord) * 4)) & kCounterMask);
+    }
+    return frequency;
+  }
+
+  // Halves all counters, so that the frequencies of past accesses decay.
+  void Age() {
+    uint64_t additions = additions_.load(std::memory_order_relaxed);
+    // Only one of the threads that reached the sample size does the aging.
+    if (additions < sample_size_ ||
+        !additions_.compare_exchange_strong(additions, additions / 2,
+                                            std::memory_order_relaxed)) {
+      return;
+    }
+    for (size_t i = 0; i < num_words_; i++) {
+      uint64_t word = words_[i].load(std::memory_order_relaxed);
+      words_[i].store((word >> 1) & uint64_t{0x7777777777777777},
+                      std::memory_order_relaxed);
+    }
+  }
+
+  int width_bits_;
+  size_t num_words_;
+  std::unique_ptr<std::atomic<uint64_t>[]> words_;
+  uint64_t sample_size_;
+  std::atomic<uint64_t> additions_{0};
+};
+
+}  // namespace
+
+std::shared_ptr<CacheAdmissionPolicy> NewTinyLFUAdmissionPolicy(
+    size_t expected_entries) {
+  return std::make_shared<TinyLFUAdmissionPolicy>(expected_entries);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -581,8 +581,9 @@ bool Compaction::IsTrivialMove() const {
       }
 
       if (partitioner.get() != nullptr) {
-        if (!partitioner->CanDoTrivialMove(file->smallest.user_key(),
-                                           file->largest.user_key())) {
+        if (!partitioner->CanDoTrivialMoveWithSize(file->smallest.user_key(),
+                                                   file->largest.user_key(),
+                                                   file->fd.GetFileSize())) {
           return false;
         }
       }
@@ -56,6 +56,97 @@ std::shared_ptr<SstPartitionerFactory> NewSstPartitionerFixedPrefixFactory(
   return std::make_shared<SstPartitionerFixedPrefixFactory>(prefix_len);
 }
 
+static std::unordered_map<std::string, OptionTypeInfo>
+    sst_boundaries_type_info = {
+        {"boundaries",
+         OptionTypeInfo::Vector<std::string>(
+             offsetof(struct SstPartitionerBoundariesOptions, boundaries),
+             OptionVerificationType::kNormal, OptionTypeFlags::kNone,
+             {0, OptionType::kEncodedString})},
+        {"min_file_size",
+         {offsetof(struct SstPartitionerBoundariesOptions, min_file_size),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"target_file_size",
+         {offsetof(struct SstPartitionerBoundariesOptions, target_file_size),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
+SstPartitionerBoundaries::SstPartitionerBoundaries(
+    const SstPartitionerBoundariesOptions& options,
+    const Slice& smallest_user_key, const Slice& largest_user_key)
+    : min_file_size_(options.min_file_size),
+      target_file_size_(options.target_file_size) {
+  for (const auto& boundary : options.boundaries) {
+    // Boundaries outside of the key range can never be crossed.
+    if ((smallest_user_key.empty() ||
+         smallest_user_key.compare(boundary) < 0) &&
+        (largest_user_key.empty() || largest_user_key.compare(boundary) >= 0)) {
+      boundaries_.push_back(boundary);
+    }
+  }
+  std::sort(boundaries_.begin(), boundaries_.end());
+}
+
+bool SstPartitionerBoundaries::CrossesBoundary(const Slice& prev_key,
+                                               const Slice& key) const {
+  auto it = std::upper_bound(
+      boundaries_.begin(), boundaries_.end(), prev_key,
+      [](const Slice& a, const std::string& b) { return a.compare(b) < 0; });
+  return it != boundaries_.end() && key.compare(*it) >= 0;
+}
+
+PartitionerResult SstPartitionerBoundaries::ShouldPartition(
+    const PartitionerRequest& request) {
+  if (request.current_output_file_size < min_file_size_) {
+    return kNotRequired;
+  }
+  if (target_file_size_ > 0 &&
+      request.current_output_file_size >= target_file_size_ &&
+      request.prev_user_key->compare(*request.current_user_key) != 0) {
+    return kRequired;
+  }
+  return CrossesBoundary(*request.prev_user_key, *request.current_user_key)
+             ? kRequired
+             : kNotRequired;
+}
+
+bool SstPartitionerBoundaries::CanDoTrivialMove(
+    const Slice& smallest_user_key, const Slice& largest_user_key) {
+  return !CrossesBoundary(smallest_user_key, largest_user_key);
+}
+
+bool SstPartitionerBoundaries::CanDoTrivialMoveWithSize(
+    const Slice& smallest_user_key, const Slice& largest_user_key,
+    uint64_t file_size) {
+  return file_size < min_file_size_ ||
+         CanDoTrivialMove(smallest_user_key, largest_user_key);
+}
+
+SstPartitionerBoundariesFactory::SstPartitionerBoundariesFactory(
+    const SstPartitionerBoundariesOptions& options)
+    : options_(options) {
+  RegisterOptions(&options_, &sst_boundaries_type_info);
+}
+
+std::unique_ptr<SstPartitioner>
+SstPartitionerBoundariesFactory::CreatePartitioner(
+    const SstPartitioner::Context& context) const {
+  return std::unique_ptr<SstPartitioner>(new SstPartitionerBoundaries(
+      options_, context.smallest_user_key, context.largest_user_key));
+}
+
+std::shared_ptr<SstPartitionerFactory> NewSstPartitionerBoundariesFactory(
+    std::vector<std::string> boundaries, uint64_t min_file_size,
+    uint64_t target_file_size) {
+  SstPartitionerBoundariesOptions options;
+  options.boundaries = std::move(boundaries);
+  options.min_file_size = min_file_size;
+  options.target_file_size = target_file_size;
+  return std::make_shared<SstPartitionerBoundariesFactory>(options);
+}
+
 namespace {
 static int RegisterSstPartitionerFactories(ObjectLibrary& library,
                                            const std::string& /*arg*/) {
@@ -67,7 +158,16 @@ static int RegisterSstPartitionerFactories(ObjectLibrary& library,
         guard->reset(new SstPartitionerFixedPrefixFactory(0));
         return guard->get();
       });
-  return 1;
+  library.AddFactory<SstPartitionerFactory>(
+      SstPartitionerBoundariesFactory::kClassName(),
+      [](const std::string& /*uri*/,
+         std::unique_ptr<SstPartitionerFactory>* guard,
+         std::string* /* errmsg */) {
+        guard->reset(new SstPartitionerBoundariesFactory(
+            SstPartitionerBoundariesOptions()));
+        return guard->get();
+      });
+  return 2;
 }
 }  // namespace
 
@@ -16,6 +16,7 @@
 #include "rocksdb/flush_block_policy.h"
 #include "rocksdb/merge_operator.h"
 #include "rocksdb/perf_context.h"
+#include "rocksdb/sst_file_writer.h"
 #include "rocksdb/table.h"
 #include "rocksdb/utilities/debug.h"
 #include "table/block_based/block_based_table_reader.h"
@@ -4594,6 +4595,90 @@ TEST_F(DBBasicTest, VerifyFileChecksumsReadahead) {
             (sst_size + alignment - 1) / (alignment));
 }
 
+namespace {
+class CountingCompressionWorkerPool : public CompressionWorkerPool {
+ public:
+  explicit CountingCompressionWorkerPool(
+      std::shared_ptr<CompressionWorkerPool> target)
+      : target_(std::move(target)) {}
+
+  void Submit(std::function<void()>&& task, size_t charge) override {
+    num_submitted_.fetch_add(1, std::memory_order_relaxed);
+    target_->Submit(std::move(task), charge);
+  }
+
+  int GetNumThreads() const override { return target_->GetNumThreads(); }
+
+  size_t GetInflightBytes() const override {
+    return target_->GetInflightBytes();
+  }
+
+  uint64_t num_submitted() const {
+    return num_submitted_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::shared_ptr<CompressionWorkerPool> target_;
+  std::atomic<uint64_t> num_submitted_{0};
+};
+}  // namespace
+
+TEST_F(DBBasicTest, SharedCompressionWorkerPool) {
+  auto pool = std::make_shared<CountingCompressionWorkerPool>(
+      NewCompressionWorkerPool(2, /*max_inflight_bytes=*/4096));
+  ASSERT_EQ(2, pool->GetNumThreads());
+
+  Options options = CurrentOptions();
+  options.compression_opts.parallel_threads = 4;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 256;
+  table_options.compression_worker_pool = pool;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  // Flushes of both column families use the pool.
+  const int kNumKeys = 500;
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeys);
+  for (int round = 0; round < 2; round++) {
+    for (int cf = 0; cf < 2; cf++) {
+      for (int i = 0; i < kNumKeys; i++) {
+        values[i] = rnd.RandomString(100);
+        ASSERT_OK(Put(cf, Key(i), values[i]));
+      }
+      ASSERT_OK(Flush(cf));
+    }
+  }
+  uint64_t num_submitted = pool->num_submitted();
+  ASSERT_GT(num_submitted, 0);
+
+  // So do compactions ...
+  for (int cf = 0; cf < 2; cf++) {
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), handles_[cf], nullptr,
+                                nullptr));
+  }
+  ASSERT_GT(pool->num_submitted(), num_submitted);
+  num_submitted = pool->num_submitted();
+
+  // ... and SstFileWriter.
+  std::string sst_file = dbname_ + "/ext.sst";
+  SstFileWriter sst_file_writer(EnvOptions(), options);
+  ASSERT_OK(sst_file_writer.Open(sst_file));
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(sst_file_writer.Put(Key(kNumKeys + i), values[i]));
+  }
+  ASSERT_OK(sst_file_writer.Finish());
+  ASSERT_GT(pool->num_submitted(), num_submitted);
+  ASSERT_OK(db_->IngestExternalFile({sst_file}, IngestExternalFileOptions()));
+
+  ASSERT_EQ(0, pool->GetInflightBytes());
+  ReopenWithColumnFamilies({"default", "pikachu"}, options);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(1, Key(i)));
+    ASSERT_EQ(values[i], Get(0, Key(kNumKeys + i)));
+  }
+}
+
 // TODO: re-enable after we provide finer-grained control for WAL tracking to
 // meet the needs of different use cases, durability levels and recovery modes.
 TEST_F(DBBasicTest, DISABLED_ManualWalSync) {
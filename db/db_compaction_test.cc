@@ -1192,6 +1192,79 @@ TEST_F(DBCompactionTest, CompactionSstPartitionerNonTrivial) {
   ASSERT_EQ("B", Get("bbbb1"));
 }
 
+TEST_F(DBCompactionTest, CompactionSstPartitionerBoundaries) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleLevel;
+  options.level0_file_num_compaction_trigger = 1;
+  // Every boundary cuts the output file.
+  options.sst_partitioner_factory =
+      NewSstPartitionerBoundariesFactory({"c", "b"}, 0 /* min_file_size */);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("a1", "A"));
+  ASSERT_OK(Put("b1", "B"));
+  ASSERT_OK(Put("c1", "C"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  std::vector<LiveFileMetaData> files;
+  dbfull()->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(3, files.size());
+
+  // Small partitions are merged, so the flushed file is moved as is.
+  int32_t trivial_move = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:TrivialMove",
+      [&](void* /*arg*/) { trivial_move++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  options.sst_partitioner_factory =
+      NewSstPartitionerBoundariesFactory({"b", "c"}, 1 << 20);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("a1", "A"));
+  ASSERT_OK(Put("b1", "B"));
+  ASSERT_OK(Put("c1", "C"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  files.clear();
+  dbfull()->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(1, files.size());
+  ASSERT_EQ(1, files[0].level);
+  ASSERT_EQ(1, trivial_move);
+  ASSERT_EQ("A", Get("a1"));
+  ASSERT_EQ("B", Get("b1"));
+  ASSERT_EQ("C", Get("c1"));
+
+  // Once the file is large enough, the next boundary cuts it, but the
+  // following small partition is merged into the new file.
+  options.sst_partitioner_factory =
+      NewSstPartitionerBoundariesFactory({"b", "c"}, 1 /* min_file_size */);
+  DestroyAndReopen(options);
+
+  const std::string value(64 << 10, 'v');
+  ASSERT_OK(Put("a1", value));
+  ASSERT_OK(Put("a2", value));
+  ASSERT_OK(Put("b1", value));
+  ASSERT_OK(Put("c1", value));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  files.clear();
+  dbfull()->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(2, files.size());
+  std::sort(files.begin(), files.end(),
+            [](const LiveFileMetaData& x, const LiveFileMetaData& y) {
+              return x.smallestkey < y.smallestkey;
+            });
+  ASSERT_EQ("a1", files[0].smallestkey);
+  ASSERT_EQ("a2", files[0].largestkey);
+  ASSERT_EQ("b1", files[1].smallestkey);
+  ASSERT_EQ("c1", files[1].largestkey);
+}
+
 TEST_F(DBCompactionTest, CompactionSstPartitionerNextLevel) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleLevel;
@@ -638,6 +638,7 @@ Status DBImpl::CloseHelper() {
       }
     }
     logs_.clear();
+    wal_streams_.clear();
   }
 
   // Table cache may have table handles holding blocks from the block cache.
@@ -1550,6 +1551,9 @@ Status DBImpl::SyncWAL() {
       auto& log = *it;
       log.PrepareForSync();
       logs_to_sync.push_back(log.writer);
+      for (auto* stream_writer : log.stream_writers) {
+        logs_to_sync.push_back(stream_writer);
+      }
     }
 
     need_log_dir_sync = !log_dir_synced_;
@@ -1718,6 +1722,7 @@ void DBImpl::MarkLogsSynced(uint64_t up_to, bool synced_dir,
       if (wal.GetPreSyncSize() == wal.writer->file()->GetFlushedSize()) {
         // Fully synced
         logs_to_free_.push_back(wal.ReleaseWriter());
+        wal.ReleaseStreamWriters(&logs_to_free_);
         it = logs_.erase(it);
       } else {
         assert(wal.GetPreSyncSize() < wal.writer->file()->GetFlushedSize());
@@ -4752,6 +4757,11 @@ Status DBImpl::GetUpdatesSince(
         "This API is not yet compatible with write-prepared/write-unprepared "
         "transactions");
   }
+  if (immutable_db_options_.num_wal_streams > 1) {
+    // WalManager only reads the first stream of each WAL.
+    return Status::NotSupported(
+        "This API is not yet compatible with num_wal_streams > 1");
+  }
   if (seq > versions_->LastSequence()) {
     return Status::NotFound("Requested sequence not yet written in the db");
   }
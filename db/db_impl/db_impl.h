@@ -1680,6 +1680,9 @@ class DBImpl : public DB {
     uint64_t number;
     uint64_t size = 0;
     bool getting_flushed = false;
+    // File numbers of the additional WAL streams of this log, which are
+    // obsolete together with it. See DBOptions::num_wal_streams.
+    std::vector<uint64_t> stream_numbers;
   };
 
   struct LogWriterNumber {
@@ -1692,10 +1695,24 @@ class DBImpl : public DB {
       writer = nullptr;
       return w;
     }
+    void ReleaseStreamWriters(autovector<log::Writer*>* writers) {
+      for (auto* w : stream_writers) {
+        writers->push_back(w);
+      }
+      stream_writers.clear();
+    }
     Status ClearWriter() {
       Status s = writer->WriteBuffer();
       delete writer;
       writer = nullptr;
+      for (auto* w : stream_writers) {
+        Status ss = w->WriteBuffer();
+        if (s.ok()) {
+          s = ss;
+        }
+        delete w;
+      }
+      stream_writers.clear();
       return s;
     }
 
@@ -1723,6 +1740,8 @@ class DBImpl : public DB {
     // Visual Studio doesn't support deque's member to be noncopyable because
     // of a std::unique_ptr as a member.
     log::Writer* writer;  // own
+    // Writers of the additional WAL streams of this log.
+    std::vector<log::Writer*> stream_writers;  // own
 
    private:
     // true for some prefix of logs_
@@ -1733,6 +1752,18 @@ class DBImpl : public DB {
     uint64_t pre_sync_size = 0;
   };
 
+  // One of the files the current WAL is striped over, the main WAL file
+  // included, see DBOptions::num_wal_streams. The writers of parallel write
+  // groups append to it under `mutex`.
+  struct WalStream {
+    explicit WalStream(log::Writer* _writer) : writer(_writer) {}
+    log::Writer* writer;
+    port::Mutex mutex;
+    // Bytes appended by parallel writers, accounted to the WAL in
+    // alive_log_files_ when it is switched.
+    uint64_t size = 0;
+  };
+
   struct LogContext {
     explicit LogContext(bool need_sync = false)
         : need_log_sync(need_sync), need_log_dir_sync(need_sync) {}
@@ -2104,6 +2135,16 @@ class DBImpl : public DB {
                       SequenceNumber sequence,
                       LogFileNumberSize& log_file_number_size);
 
+  // Appends the batch of `w` to one of the streams of the current WAL.
+  IOStatus WriteToWALStream(WriteThread::Writer* w);
+
+  // Writes a sequence skip batch to `log_writer` if `sequence`, the first
+  // sequence of the current write group, does not follow the last sequence
+  // written to the WAL. Only used with multiple WAL streams.
+  IOStatus MaybeWriteSequenceSkipToWAL(log::Writer* log_writer,
+                                       SequenceNumber sequence,
+                                       LogFileNumberSize& log_file_number_size);
+
   IOStatus ConcurrentWriteToWAL(const WriteThread::WriteGroup& write_group,
                                 uint64_t* log_used,
                                 SequenceNumber* last_sequence, size_t seq_inc);
@@ -2310,6 +2351,22 @@ class DBImpl : public DB {
   IOStatus CreateWAL(uint64_t log_file_num, uint64_t recycle_log_number,
                      size_t preallocate_block_size, log::Writer** new_log);
 
+  // Creates the additional streams of a new WAL if num_wal_streams > 1.
+  IOStatus CreateWALStreams(size_t preallocate_block_size,
+                            std::vector<uint64_t>* stream_numbers,
+                            std::vector<log::Writer*>* stream_writers);
+
+  // Points wal_streams_ to the files of logs_.back(), and accounts the bytes
+  // appended to the previous streams to their WAL.
+  // REQUIRES: log_write_mutex_ held, called from the write thread after a
+  // new WAL is added to logs_.
+  void ResetWALStreams();
+
+  // Trains wal_compression_dict_ from the records sampled by `log_writer`,
+  // once enough of them are collected. No-op if already trained.
+  // REQUIRES: called from the write thread, log_write_mutex_ not held.
+  void MaybeTrainWALCompressionDict(log::Writer* log_writer);
+
   // Validate self-consistency of DB options
   static Status ValidateOptions(const DBOptions& db_options);
   // Validate self-consistency of DB options and its consistency with cf options
@@ -2569,6 +2626,23 @@ class DBImpl : public DB {
   //  - it follows that the items with getting_synced=true can be safely read
   //  from the same thread that has set getting_synced=true
   std::deque<LogWriterNumber> logs_;
+  // The files of logs_.back() if num_wal_streams > 1, the main WAL file
+  // first. Only replaced from the write thread, so that the writers of a
+  // write group can access it without locking.
+  std::vector<std::unique_ptr<WalStream>> wal_streams_;
+  std::atomic<size_t> next_wal_stream_{0};
+  // With multiple WAL streams, the sequence number following the last one
+  // written to the WAL, or 0 if unknown. When the next write group starts
+  // after it, the sequence numbers in between were allocated without being
+  // logged, and a sequence skip batch is written first so that recovery does
+  // not mistake them for lost records. Only accessed by the write group
+  // leader, and during recovery.
+  SequenceNumber wal_next_sequence_ = 0;
+
+  // Compression dictionary of new WAL files, see
+  // DBOptions::wal_compression_dict_max_bytes. Set at most once, by the
+  // thread switching memtables, before the WAL files using it are created.
+  std::string wal_compression_dict_;
 
   // Signaled when getting_synced becomes false for some of the logs_.
   InstrumentedCondVar log_sync_cv_;
@@ -128,6 +128,9 @@ IOStatus DBImpl::SyncClosedLogs(JobContext* job_context,
     auto& log = *it;
     log.PrepareForSync();
     logs_to_sync.push_back(log.writer);
+    for (auto* stream_writer : log.stream_writers) {
+      logs_to_sync.push_back(stream_writer);
+    }
   }
 
   IOStatus io_s;
@@ -308,6 +308,9 @@ void DBImpl::FindObsoleteFiles(JobContext* job_context, bool force,
       } else {
         job_context->log_delete_files.push_back(earliest.number);
       }
+      for (auto stream_number : earliest.stream_numbers) {
+        job_context->log_delete_files.push_back(stream_number);
+      }
       if (job_context->size_log_to_delete == 0) {
         job_context->prev_total_log_size = total_log_size_;
         job_context->num_alive_log_files = num_alive_log_files;
@@ -333,6 +336,7 @@ void DBImpl::FindObsoleteFiles(JobContext* job_context, bool force,
         continue;
       }
       logs_to_free_.push_back(log.ReleaseWriter());
+      log.ReleaseStreamWriters(&logs_to_free_);
       logs_.pop_front();
     }
     // Current log cannot be obsolete.
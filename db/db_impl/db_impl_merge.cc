@@ -11,6 +11,34 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// Calls `fn` with every index in [0, n), using up to `max_threads` threads
+// including the calling one.
+void ParallelFor(size_t n, int max_threads,
+                 const std::function<void(size_t)>& fn) {
+  std::atomic<size_t> next_index{0};
+  auto worker = [&]() {
+    while (true) {
+      size_t i = next_index.fetch_add(1, std::memory_order_relaxed);
+      if (i >= n) {
+        break;
+      }
+      fn(i);
+    }
+  };
+  const size_t num_threads =
+      std::min(n, static_cast<size_t>(std::max(max_threads, 1)));
+  std::vector<port::Thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+}  // namespace
+
 /// A RAII-style helper used to block DB writes.
 class WriteBlocker {
  public:
@@ -46,7 +74,7 @@ Status DBImpl::ValidateForMerge(const MergeInstanceOptions& mopts,
       }
     }
   }
-  if (mopts.merge_memtable) {
+  if (mopts.merge_memtable && !mopts.adopt_memtables_with_wal) {
     if (rhs->total_log_size_ > 0) {
       return Status::InvalidArgument("DB WAL is not empty");
     }
@@ -125,6 +153,29 @@ Status DBImpl::MergeDisjointInstances(const MergeInstanceOptions& merge_options,
       return s;
     }
   }
+  const size_t num_dbs = all_db_impls.size();
+
+  // Memtables adopted with `adopt_memtables_with_wal` are flushed by the
+  // target and then dropped from their sources. Sources must not flush them
+  // meanwhile, so their background work is paused until then. See [C].
+  const bool flush_adopted =
+      merge_options.merge_memtable && merge_options.adopt_memtables_with_wal;
+  autovector<DBImpl*> paused_dbs;
+  std::shared_ptr<void> _resume(nullptr, [&](...) {
+    for (auto* db : paused_dbs) {
+      db->ContinueBackgroundWork().PermitUncheckedError();
+    }
+  });
+  if (flush_adopted) {
+    for (auto* db : db_impls) {
+      // Must be called before the write blockers acquire the DB mutexes.
+      s = db->PauseBackgroundWork();
+      if (!s.ok()) {
+        return s;
+      }
+      paused_dbs.push_back(db);
+    }
+  }
 
   // Block all writes.
   autovector<std::unique_ptr<WriteBlocker>> write_blockers;
@@ -132,50 +183,92 @@ Status DBImpl::MergeDisjointInstances(const MergeInstanceOptions& merge_options,
     write_blockers.emplace_back(new WriteBlocker(db));
   }
 
+  // Column families of all instances grouped by cf, in the order of
+  // `all_db_impls`. nullptr if the cf is missing.
+  std::vector<autovector<ColumnFamilyData*>> cf_db_cfds(num_cfs);
+  for (size_t cf_i = 0; cf_i < num_cfs; cf_i++) {
+    auto& name = this_cfds[cf_i]->GetName();
+    cf_db_cfds[cf_i].push_back(this_cfds[cf_i]);
+    for (auto* db : db_impls) {
+      auto cfd = db->versions_->GetColumnFamilySet()->GetColumnFamily(name);
+      cf_db_cfds[cf_i].push_back(cfd && !cfd->IsDropped() ? cfd : nullptr);
+    }
+  }
+
   // # Internal key range check
+  //
+  // Computing key ranges involves scanning memtables, so column families are
+  // processed in parallel. Their versions can't change meanwhile because the
+  // write blockers hold the DB mutexes.
   assert(s.ok());
-  for (auto* this_cfd : this_cfds) {
-    auto& name = this_cfd->GetName();
-    auto* comparator = this_cfd->user_comparator();
-    using CfRange = std::pair<PinnableSlice, PinnableSlice>;
-    std::vector<CfRange> db_ranges;
-    auto process_cf = [&](ColumnFamilyData* cfd) {
-      assert(cfd && s.ok());
-      PinnableSlice smallest, largest;
-      bool found = false;
-      s = cfd->GetUserKeyRange(&smallest, &largest, &found);
-      if (s.ok() && found) {
-        db_ranges.emplace_back(
-            std::make_pair(std::move(smallest), std::move(largest)));
-      }
-    };
-    process_cf(this_cfd);
-    if (!s.ok()) {
-      return s;
+  struct KeyRange {
+    PinnableSlice smallest;
+    PinnableSlice largest;
+    bool found = false;
+  };
+  std::vector<KeyRange> cf_db_ranges(num_cfs * num_dbs);
+  std::vector<Status> statuses(num_cfs * num_dbs);
+  ParallelFor(cf_db_ranges.size(), merge_options.max_threads, [&](size_t i) {
+    auto* cfd = cf_db_cfds[i / num_dbs][i % num_dbs];
+    if (cfd != nullptr) {
+      auto& range = cf_db_ranges[i];
+      statuses[i] =
+          cfd->GetUserKeyRange(&range.smallest, &range.largest, &range.found);
     }
-    for (auto* db : db_impls) {
-      auto cfd = db->versions_->GetColumnFamilySet()->GetColumnFamily(name);
-      if (cfd && !cfd->IsDropped()) {
-        process_cf(cfd);
-        if (!s.ok()) {
-          return s;
-        }
+  });
+  for (auto& status : statuses) {
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  for (size_t cf_i = 0; cf_i < num_cfs; cf_i++) {
+    auto* comparator = this_cfds[cf_i]->user_comparator();
+    std::vector<const KeyRange*> db_ranges;
+    for (size_t db_i = 0; db_i < num_dbs; db_i++) {
+      const auto& range = cf_db_ranges[cf_i * num_dbs + db_i];
+      if (range.found) {
+        db_ranges.push_back(&range);
       }
     }
     std::sort(db_ranges.begin(), db_ranges.end(),
-              [=](const CfRange& a, const CfRange& b) {
-                return comparator->Compare(a.first, b.first) < 0;
+              [=](const KeyRange* a, const KeyRange* b) {
+                return comparator->Compare(a->smallest, b->smallest) < 0;
               });
     Slice last_largest;
-    for (auto& range : db_ranges) {
+    for (auto* range : db_ranges) {
       if (last_largest.size() == 0 ||
-          comparator->Compare(last_largest, range.first) < 0) {
-        last_largest = range.second;
+          comparator->Compare(last_largest, range->smallest) < 0) {
+        last_largest = range->largest;
       } else {
         return Status::InvalidArgument("Source DBs have overlapping range");
       }
     }
   }
+  cf_db_ranges.clear();
+
+  // Seal the memtables of source instances through their own DB, so that a
+  // new WAL is created when the current one is not empty. The sealed
+  // memtables are then shared below like any other immutable memtable. This
+  // must happen before the log numbers are collected.
+  //
+  // The data of adopted memtables is only in the source WALs older than the
+  // one they are sealed into.
+  std::vector<uint64_t> sealed_log_numbers(db_impls.size(), 0);
+  if (flush_adopted) {
+    for (size_t db_i = 0; db_i < db_impls.size(); db_i++) {
+      for (size_t cf_i = 0; cf_i < num_cfs; cf_i++) {
+        auto* cfd = cf_db_cfds[cf_i][db_i + 1];
+        if (cfd != nullptr && !cfd->mem()->IsEmpty()) {
+          WriteContext write_context;
+          s = db_impls[db_i]->SwitchMemtable(cfd, &write_context);
+          if (!s.ok()) {
+            return s;
+          }
+        }
+      }
+      sealed_log_numbers[db_i] = db_impls[db_i]->logfile_number_;
+    }
+  }
 
   // # Handle transient states
   //
@@ -185,8 +278,16 @@ Status DBImpl::MergeDisjointInstances(const MergeInstanceOptions& merge_options,
   // snapshot
   //   to avoid the case where a memtable is flushed shortly after being
   //   merged, and the resulting L0 data is merged again as a table file.
+  //
+  // Source instances are processed one by one, and each of them resumes
+  // writing once its snapshots are taken and its memtables are added to the
+  // target instance. The target instance is unblocked last.
   assert(s.ok());
   autovector<MemTable*> to_delete;  // not used.
+  // Memtables adopted with `adopt_memtables_with_wal`, grouped by cf and
+  // source.
+  std::vector<std::vector<autovector<MemTable*>>> cf_db_adopted_mems(
+      num_cfs, std::vector<autovector<MemTable*>>(db_impls.size()));
   // Key-value freshness is determined by its sequence number. To avoid
   // incoming writes being shadowed by history data from other instances, we
   // must increment target instance's sequence number to be larger than all
@@ -205,17 +306,43 @@ Status DBImpl::MergeDisjointInstances(const MergeInstanceOptions& merge_options,
   // [A] Bump sequence number.
   versions_->SetLastAllocatedSequence(max_seq_number);
   versions_->SetLastSequence(max_seq_number);
+  // [B] Create a new WAL so that future memtable will use the correct log
+  // number as well.
+  auto bump_log_number = [&](DBImpl* db) {
+    if (max_log_number == db->logfile_number_) {
+      return Status::OK();
+    }
+    assert(max_log_number > db->logfile_number_);
+    log::Writer* new_log = nullptr;
+    Status ls = db->CreateWAL(max_log_number, 0 /*recycle_log_number*/,
+                              0 /*preallocate_block_size*/, &new_log);
+    if (!ls.ok()) {
+      return ls;
+    }
+    db->logfile_number_ = max_log_number;
+    assert(new_log != nullptr);
+    db->logs_.emplace_back(max_log_number, new_log);
+    {
+      // The new WAL is not striped, parallel WAL writes resume after the
+      // next switch.
+      InstrumentedMutexLock wl(&db->log_write_mutex_);
+      db->ResetWALStreams();
+    }
+    auto current = db->versions_->current_next_file_number();
+    if (current <= max_log_number) {
+      db->versions_->FetchAddFileNumber(max_log_number - current + 1);
+    }
+    return ls;
+  };
   cf_db_super_versions.resize(num_cfs);
-  for (size_t cf_i = 0; cf_i < num_cfs; cf_i++) {
-    cf_db_super_versions[cf_i].resize(db_impls.size());
-    auto* this_cfd = this_cfds[cf_i];
-    auto& cf_name = this_cfd->GetName();
-    autovector<MemTable*> mems;
-    for (size_t db_i = 0; db_i < db_impls.size(); db_i++) {
-      auto& db = db_impls[db_i];
-      auto cfd = db->versions_->GetColumnFamilySet()->GetColumnFamily(cf_name);
-      if (cfd == nullptr || cfd->IsDropped()) {
-        cf_db_super_versions[cf_i][db_i] = nullptr;
+  for (auto& db_super_versions : cf_db_super_versions) {
+    db_super_versions.resize(db_impls.size());
+    std::fill(db_super_versions.begin(), db_super_versions.end(), nullptr);
+  }
+  for (size_t db_i = 0; db_i < db_impls.size(); db_i++) {
+    for (size_t cf_i = 0; cf_i < num_cfs; cf_i++) {
+      auto* cfd = cf_db_cfds[cf_i][db_i + 1];
+      if (cfd == nullptr) {
         continue;
       }
 
@@ -234,42 +361,41 @@ Status DBImpl::MergeDisjointInstances(const MergeInstanceOptions& merge_options,
         // shared, it must still be larger than other shared immutable
         // memtables.
         cfd->mem()->SetNextLogNumber(max_log_number);
+        autovector<MemTable*> mems;
         cfd->imm()->ExportMemtables(&mems);
+        // The source may switch or flush these memtables as soon as it is
+        // unblocked, so they are adopted before that.
+        for (auto mem : mems) {
+          assert(mem != nullptr);
+          mem->Ref();
+          // [B] Bump log number for shared memtables.
+          mem->SetNextLogNumber(max_log_number);
+          this_cfds[cf_i]->imm()->Add(mem, &to_delete);
+          if (flush_adopted) {
+            cf_db_adopted_mems[cf_i][db_i].push_back(mem);
+          }
+        }
       }
 
       // Acquire super version.
       cf_db_super_versions[cf_i][db_i] = cfd->GetSuperVersion()->Ref();
     }
-    for (auto mem : mems) {
-      assert(mem != nullptr);
-      mem->Ref();
-      // [B] Bump log number for shared memtables.
-      mem->SetNextLogNumber(max_log_number);
-      this_cfd->imm()->Add(mem, &to_delete);
-    }
-    this_cfd->mem()->SetNextLogNumber(max_log_number);
-  }
-  for (size_t i = 0; i < all_db_impls.size(); i++) {
-    auto* db = all_db_impls[i];
-    bool check_log_number = (i == 0 || merge_options.allow_source_write) &&
-                            merge_options.merge_memtable;
-    if (check_log_number && max_log_number != db->logfile_number_) {
-      assert(max_log_number > db->logfile_number_);
-      // [B] Create a new WAL so that future memtable will use the correct log
-      // number as well.
-      log::Writer* new_log = nullptr;
-      s = db->CreateWAL(max_log_number, 0 /*recycle_log_number*/,
-                        0 /*preallocate_block_size*/, &new_log);
+    if (merge_options.allow_source_write && merge_options.merge_memtable) {
+      s = bump_log_number(db_impls[db_i]);
       if (!s.ok()) {
         return s;
       }
-      db->logfile_number_ = max_log_number;
-      assert(new_log != nullptr);
-      db->logs_.emplace_back(max_log_number, new_log);
-      auto current = db->versions_->current_next_file_number();
-      if (current <= max_log_number) {
-        db->versions_->FetchAddFileNumber(max_log_number - current + 1);
-      }
+    }
+    // Unblock writes to this source.
+    write_blockers[db_i + 1].reset();
+  }
+  for (auto* this_cfd : this_cfds) {
+    this_cfd->mem()->SetNextLogNumber(max_log_number);
+  }
+  if (merge_options.merge_memtable) {
+    s = bump_log_number(this);
+    if (!s.ok()) {
+      return s;
     }
   }
 
@@ -279,66 +405,92 @@ Status DBImpl::MergeDisjointInstances(const MergeInstanceOptions& merge_options,
   TEST_SYNC_POINT("DBImpl::MergeDisjointInstances:AfterMergeMemtable:1");
 
   // # Merge table files
+  //
+  // Table files of each (cf, source db) pair are linked in parallel, into
+  // separate version edits that are applied together.
   assert(s.ok());
-  autovector<VersionEdit> cf_edits;
-  cf_edits.resize(num_cfs);
-  for (size_t cf_i = 0; cf_i < num_cfs; cf_i++) {
+  const size_t edits_per_cf = std::max<size_t>(db_impls.size(), 1);
+  std::vector<VersionEdit> cf_edits(num_cfs * edits_per_cf);
+  for (size_t i = 0; i < cf_edits.size(); i++) {
+    cf_edits[i].SetColumnFamily(this_cfds[i / edits_per_cf]->GetID());
+  }
+  statuses.assign(num_cfs * db_impls.size(), Status::OK());
+  ParallelFor(statuses.size(), merge_options.max_threads, [&](size_t i) {
+    const size_t cf_i = i / db_impls.size();
+    const size_t db_i = i % db_impls.size();
     auto* this_cfd = this_cfds[cf_i];
-    auto& edit = cf_edits[cf_i];
-    edit.SetColumnFamily(this_cfd->GetID());
-    for (size_t db_i = 0; db_i < db_impls.size(); db_i++) {
-      auto* super_version = cf_db_super_versions[cf_i][db_i];
-      if (super_version == nullptr) {
-        continue;
+    auto& edit = cf_edits[cf_i * edits_per_cf + db_i];
+    auto* super_version = cf_db_super_versions[cf_i][db_i];
+    if (super_version == nullptr) {
+      return;
+    }
+    VersionStorageInfo& vsi = *super_version->current->storage_info();
+    auto& cf_paths = super_version->cfd->ioptions()->cf_paths;
+    auto SourcePath = [&](size_t path_id) {
+      // Matching `TableFileName()`.
+      if (path_id >= cf_paths.size()) {
+        assert(false);
+        return cf_paths.back().path;
+      } else {
+        return cf_paths[path_id].path;
       }
-      VersionStorageInfo& vsi = *super_version->current->storage_info();
-      auto& cf_paths = super_version->cfd->ioptions()->cf_paths;
-      auto SourcePath = [&](size_t path_id) {
-        // Matching `TableFileName()`.
-        if (path_id >= cf_paths.size()) {
-          assert(false);
-          return cf_paths.back().path;
-        } else {
-          return cf_paths[path_id].path;
-        }
-      };
-      const auto& target_path = this_cfd->ioptions()->cf_paths.front().path;
-      const uint64_t target_path_id = 0;
-      for (int level = 0; level < vsi.num_levels(); ++level) {
-        for (const auto& f : vsi.LevelFiles(level)) {
-          assert(f != nullptr);
-          const uint64_t source_file_number = f->fd.GetNumber();
-          const uint64_t target_file_number = versions_->FetchAddFileNumber(1);
-          std::string src = MakeTableFileName(SourcePath(f->fd.GetPathId()),
-                                              source_file_number);
-          std::string target =
-              MakeTableFileName(target_path, target_file_number);
-          s = GetEnv()->LinkFile(src, target);
-          if (!s.ok()) {
-            return s;
-          }
-          edit.AddFile(level, target_file_number, target_path_id,
-                       f->fd.GetFileSize(), f->smallest, f->largest,
-                       f->fd.smallest_seqno, f->fd.largest_seqno,
-                       f->marked_for_compaction, f->temperature,
-                       f->oldest_blob_file_number, f->oldest_ancester_time,
-                       f->file_creation_time, f->epoch_number, f->file_checksum,
-                       f->file_checksum_func_name, f->unique_id,
-                       f->compensated_range_deletion_size, f->tail_size,
-                       f->user_defined_timestamps_persisted);
+    };
+    const auto& target_path = this_cfd->ioptions()->cf_paths.front().path;
+    const uint64_t target_path_id = 0;
+    for (int level = 0; level < vsi.num_levels(); ++level) {
+      for (const auto& f : vsi.LevelFiles(level)) {
+        assert(f != nullptr);
+        const uint64_t source_file_number = f->fd.GetNumber();
+        const uint64_t target_file_number = versions_->FetchAddFileNumber(1);
+        std::string src = MakeTableFileName(SourcePath(f->fd.GetPathId()),
+                                            source_file_number);
+        std::string target = MakeTableFileName(target_path, target_file_number);
+        statuses[i] = GetEnv()->LinkFile(src, target);
+        if (!statuses[i].ok()) {
+          return;
         }
+        edit.AddFile(level, target_file_number, target_path_id,
+                     f->fd.GetFileSize(), f->smallest, f->largest,
+                     f->fd.smallest_seqno, f->fd.largest_seqno,
+                     f->marked_for_compaction, f->temperature,
+                     f->oldest_blob_file_number, f->oldest_ancester_time,
+                     f->file_creation_time, f->epoch_number, f->file_checksum,
+                     f->file_checksum_func_name, f->unique_id,
+                     f->compensated_range_deletion_size, f->tail_size,
+                     f->user_defined_timestamps_persisted);
+      }
+    }
+  });
+  for (auto& status : statuses) {
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  // Epoch numbers are tracked per target cf, so recover them serially.
+  for (size_t cf_i = 0; cf_i < num_cfs; cf_i++) {
+    for (auto* super_version : cf_db_super_versions[cf_i]) {
+      if (super_version != nullptr) {
+        super_version->current->storage_info()->RecoverEpochNumbers(
+            this_cfds[cf_i]);
       }
-      vsi.RecoverEpochNumbers(this_cfd);
     }
   }
 
   // # Apply version edits
   assert(s.ok());
+  // Adopted memtables whose data is only in the WAL of a source must be
+  // flushed before returning, since the target never replays that WAL.
+  std::vector<uint64_t> flush_memtable_ids(num_cfs, 0);
+  autovector<const uint64_t*> flush_memtable_id_ptrs;
   {
     autovector<autovector<VersionEdit*>> edit_ptrs;
     autovector<const MutableCFOptions*> cf_mopts;
     for (size_t i = 0; i < num_cfs; i++) {
-      edit_ptrs.push_back({&cf_edits[i]});
+      autovector<VersionEdit*> edits;
+      for (size_t j = 0; j < edits_per_cf; j++) {
+        edits.push_back(&cf_edits[i * edits_per_cf + j]);
+      }
+      edit_ptrs.push_back(edits);
       cf_mopts.push_back(this_cfds[i]->GetLatestMutableCFOptions());
     }
 
@@ -388,9 +540,86 @@ Status DBImpl::MergeDisjointInstances(const MergeInstanceOptions& merge_options,
     if (merge_options.max_preload_files >= 0) {
       table_cache_->SetCapacity(old_capacity);
     }
-  }
 
-  assert(s.ok());
+    if (flush_adopted) {
+      for (size_t i = 0; i < num_cfs; i++) {
+        flush_memtable_ids[i] = this_cfds[i]->imm()->GetLatestMemTableID(
+            false /* for_atomic_flush */);
+        flush_memtable_id_ptrs.push_back(&flush_memtable_ids[i]);
+      }
+    }
+  }
+  if (flush_adopted) {
+    s = WaitForFlushMemTables(this_cfds, flush_memtable_id_ptrs,
+                              false /* resuming_from_bg_err */);
+  }
+  // [C] Once the target has flushed the adopted memtables, the target owns
+  // their data. They are dropped from their sources, and the source WALs that
+  // hold them become obsolete. If the flush failed, sources keep them.
+  for (size_t db_i = 0; flush_adopted && s.ok() && db_i < db_impls.size();
+       db_i++) {
+    auto* db = db_impls[db_i];
+    autovector<ColumnFamilyData*> cfds;
+    autovector<const MutableCFOptions*> cf_mopts;
+    autovector<autovector<VersionEdit*>> edit_ptrs;
+    std::vector<VersionEdit> edits(num_cfs);
+    JobContext job_context(db->next_job_id_.fetch_add(1));
+    {
+      InstrumentedMutexLock lock(&db->mutex_);
+      for (size_t cf_i = 0; cf_i < num_cfs; cf_i++) {
+        auto* cfd = cf_db_cfds[cf_i][db_i + 1];
+        if (cfd == nullptr || cfd->IsDropped()) {
+          continue;
+        }
+        // All the unflushed data of a merged cf was either adopted, or written
+        // after the sealing.
+        edits[cf_i].SetColumnFamily(cfd->GetID());
+        edits[cf_i].SetLogNumber(
+            std::max(cfd->GetLogNumber(), sealed_log_numbers[db_i]));
+        cfds.push_back(cfd);
+        cf_mopts.push_back(cfd->GetLatestMutableCFOptions());
+        edit_ptrs.push_back({&edits[cf_i]});
+      }
+      if (!cfds.empty() && !db->immutable_db_options_.allow_2pc) {
+        // Like a flush, let the WALs older than the new log numbers go.
+        VersionEdit* last_edit = edit_ptrs.back().back();
+        const uint64_t min_wal_number_to_keep =
+            PrecomputeMinLogNumberToKeepNon2PC(db->versions_.get(), cfds,
+                                               edit_ptrs);
+        last_edit->SetMinLogNumberToKeep(min_wal_number_to_keep);
+        if (db->immutable_db_options_.track_and_verify_wals_in_manifest &&
+            min_wal_number_to_keep >
+                db->versions_->GetWalSet().GetMinWalNumberToKeep()) {
+          last_edit->DeleteWalsBefore(min_wal_number_to_keep);
+        }
+      }
+      if (!cfds.empty()) {
+        s = db->versions_->LogAndApply(cfds, cf_mopts, ReadOptions(),
+                                       edit_ptrs, &db->mutex_,
+                                       db->directories_.GetDbDir(), false);
+      }
+      if (s.ok()) {
+        for (size_t cf_i = 0; cf_i < num_cfs; cf_i++) {
+          auto* cfd = cf_db_cfds[cf_i][db_i + 1];
+          if (cfd == nullptr || cfd->IsDropped()) {
+            continue;
+          }
+          cfd->imm()->RemoveAdoptedMemTables(
+              cf_db_adopted_mems[cf_i][db_i], &job_context.memtables_to_free);
+          SuperVersionContext sv_context(/* create_superversion */ true);
+          db->InstallSuperVersionAndScheduleWork(
+              cfd, &sv_context, *cfd->GetLatestMutableCFOptions());
+          sv_context.Clean();
+        }
+        // Purges the source WALs that became obsolete.
+        db->FindObsoleteFiles(&job_context, false);
+      }
+    }  // lock released here
+    if (job_context.HaveSomethingToDelete()) {
+      db->PurgeObsoleteFiles(job_context);
+    }
+    job_context.Clean();
+  }
   return s;
 }
 }  // namespace ROCKSDB_NAMESPACE
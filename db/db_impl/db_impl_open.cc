@@ -209,6 +209,13 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src,
     ROCKS_LOG_WARN(result.info_log,
                    "wal_compression is disabled since only zstd is supported");
   }
+  if (result.wal_compression == kNoCompression ||
+      !ZSTD_TrainDictionarySupported()) {
+    result.wal_compression_dict_max_bytes = 0;
+  } else if (result.wal_compression_dict_max_bytes >
+             log::kMaxCompressionDictSize) {
+    result.wal_compression_dict_max_bytes = log::kMaxCompressionDictSize;
+  }
 
   if (!result.paranoid_checks) {
     result.skip_checking_sst_file_sizes_on_db_open = true;
@@ -314,6 +321,30 @@ Status DBImpl::ValidateOptions(const DBOptions& db_options) {
           "start_time and end_time cannot be the same");
     }
   }
+
+  if (db_options.num_wal_streams == 0) {
+    return Status::InvalidArgument("num_wal_streams must be greater than 0");
+  }
+  if (db_options.num_wal_streams > 1) {
+    if (!db_options.allow_concurrent_memtable_write) {
+      return Status::InvalidArgument(
+          "num_wal_streams > 1 requires allow_concurrent_memtable_write");
+    }
+    if (db_options.enable_pipelined_write || db_options.unordered_write ||
+        db_options.two_write_queues || db_options.enable_multi_batch_write) {
+      return Status::InvalidArgument(
+          "num_wal_streams > 1 is incompatible with enable_pipelined_write, "
+          "unordered_write, two_write_queues and enable_multi_batch_write");
+    }
+    if (db_options.allow_2pc || db_options.manual_wal_flush ||
+        db_options.recycle_log_file_num > 0 ||
+        db_options.track_and_verify_wals_in_manifest) {
+      return Status::InvalidArgument(
+          "num_wal_streams > 1 is incompatible with allow_2pc, "
+          "manual_wal_flush, recycle_log_file_num and "
+          "track_and_verify_wals_in_manifest");
+    }
+  }
   return Status::OK();
 }
 
@@ -783,6 +814,9 @@ Status DBImpl::Recover(
       if (corrupted_wal_found && recovered_seq != nullptr) {
         *recovered_seq = next_sequence;
       }
+      if (s.ok() && next_sequence != kMaxSequenceNumber) {
+        wal_next_sequence_ = next_sequence;
+      }
       if (!s.ok()) {
         // Clear memtables if recovery failed
         for (auto cfd : *versions_->GetColumnFamilySet()) {
@@ -1079,6 +1113,95 @@ bool DBImpl::InvokeWalFilterIfNeededOnWalRecord(uint64_t wal_number,
   return true;
 }
 
+namespace {
+// Reads the records of several WAL files in the order of their sequence
+// numbers. Used to replay the streams of a multi-stream WAL, whose records
+// are interleaved across files. See DBOptions::num_wal_streams.
+class WalStreamMerger {
+ public:
+  void AddReader(uint64_t wal_number,
+                 std::unique_ptr<log::Reader::Reporter>&& reporter,
+                 std::unique_ptr<log::Reader>&& reader) {
+    streams_.emplace_back(new Stream);
+    Stream* s = streams_.back().get();
+    s->wal_number = wal_number;
+    s->reporter = std::move(reporter);
+    s->reader = std::move(reader);
+  }
+
+  // Returns the record with the smallest sequence number among the next
+  // records of all files, or false if all files are exhausted.
+  bool ReadRecord(Slice* record, std::string* scratch,
+                  WALRecoveryMode wal_recovery_mode,
+                  uint64_t* record_checksum) {
+    if (!started_) {
+      for (auto& s : streams_) {
+        Advance(s.get(), wal_recovery_mode);
+      }
+      started_ = true;
+    }
+    // Empty batches take the sequence of the record following them, so they
+    // go first among records with the same sequence.
+    Stream* next = nullptr;
+    for (auto& s : streams_) {
+      if (s->valid &&
+          (next == nullptr || s->sequence < next->sequence ||
+           (s->sequence == next->sequence && s->empty && !next->empty))) {
+        next = s.get();
+      }
+    }
+    if (next == nullptr) {
+      return false;
+    }
+    scratch->assign(next->record.data(), next->record.size());
+    *record = Slice(*scratch);
+    *record_checksum = next->record_checksum;
+    current_ = next;
+    Advance(next, wal_recovery_mode);
+    return true;
+  }
+
+  // The file the last record returned by ReadRecord() belongs to.
+  uint64_t wal_number() const {
+    assert(current_ != nullptr);
+    return current_->wal_number;
+  }
+
+  const UnorderedMap<uint32_t, size_t>& GetRecordedTimestampSize() const {
+    assert(current_ != nullptr);
+    return current_->reader->GetRecordedTimestampSize();
+  }
+
+ private:
+  struct Stream {
+    uint64_t wal_number = 0;
+    std::unique_ptr<log::Reader::Reporter> reporter;
+    std::unique_ptr<log::Reader> reader;
+    std::string scratch;
+    Slice record;
+    uint64_t record_checksum = 0;
+    SequenceNumber sequence = 0;
+    bool empty = false;
+    bool valid = false;
+  };
+
+  void Advance(Stream* s, WALRecoveryMode wal_recovery_mode) {
+    s->valid = s->reader->ReadRecord(&s->record, &s->scratch,
+                                     wal_recovery_mode, &s->record_checksum);
+    // Records too small to hold a sequence are returned first, and rejected
+    // by the caller.
+    const bool has_header =
+        s->valid && s->record.size() >= WriteBatchInternal::kHeader;
+    s->sequence = has_header ? DecodeFixed64(s->record.data()) : 0;
+    s->empty = has_header && DecodeFixed32(s->record.data() + 8) == 0;
+  }
+
+  std::vector<std::unique_ptr<Stream>> streams_;
+  Stream* current_ = nullptr;
+  bool started_ = false;
+};
+}  // namespace
+
 // REQUIRES: wal_numbers are sorted in ascending order
 Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
                                SequenceNumber* next_sequence, bool read_only,
@@ -1134,7 +1257,39 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     min_wal_number =
         std::max(min_wal_number, versions_->MinLogNumberWithUnflushedData());
   }
-  for (auto wal_number : wal_numbers) {
+  auto open_wal = [this](const std::string& fname,
+                         std::unique_ptr<SequentialFileReader>* file_reader) {
+    std::unique_ptr<FSSequentialFile> file;
+    IOStatus io_s = fs_->NewSequentialFile(
+        fname, fs_->OptimizeForLogRead(file_options_), &file, nullptr);
+    if (io_s.ok()) {
+      file_reader->reset(new SequentialFileReader(
+          std::move(file), fname, immutable_db_options_.log_readahead_size,
+          io_tracer_));
+    }
+    return static_cast<Status>(io_s);
+  };
+  auto init_reporter = [this, &status](LogReporter* reporter,
+                                       const std::string& fname) {
+    reporter->env = env_;
+    reporter->info_log = immutable_db_options_.info_log.get();
+    reporter->fname = fname.c_str();
+    if (!immutable_db_options_.paranoid_checks ||
+        immutable_db_options_.wal_recovery_mode ==
+            WALRecoveryMode::kSkipAnyCorruptedRecords) {
+      reporter->status = nullptr;
+    } else {
+      reporter->status = &status;
+    }
+  };
+  // In multi-stream mode, the streams of a WAL are separate files whose
+  // records interleave, so all the WAL files are replayed in one pass merged
+  // by sequence number.
+  const bool merge_wal_streams = immutable_db_options_.num_wal_streams > 1;
+  // Names of the files being merged, referred to by their reporters.
+  std::deque<std::string> merged_fnames;
+  for (size_t wal_idx = 0; wal_idx < wal_numbers.size(); ++wal_idx) {
+    const uint64_t wal_number = wal_numbers[wal_idx];
     if (wal_number < min_wal_number) {
       ROCKS_LOG_INFO(immutable_db_options_.info_log,
                      "Skipping log #%" PRIu64
@@ -1167,43 +1322,60 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     }
 
     std::unique_ptr<SequentialFileReader> file_reader;
-    {
-      std::unique_ptr<FSSequentialFile> file;
-      status = fs_->NewSequentialFile(
-          fname, fs_->OptimizeForLogRead(file_options_), &file, nullptr);
+    status = open_wal(fname, &file_reader);
+    if (!status.ok()) {
+      MaybeIgnoreError(&status);
       if (!status.ok()) {
-        MaybeIgnoreError(&status);
-        if (!status.ok()) {
-          return status;
-        } else {
-          // Fail with one log file, but that's ok.
-          // Try next one.
-          continue;
-        }
+        return status;
+      } else {
+        // Fail with one log file, but that's ok.
+        // Try next one.
+        continue;
       }
-      file_reader.reset(new SequentialFileReader(
-          std::move(file), fname, immutable_db_options_.log_readahead_size,
-          io_tracer_));
     }
 
     // Create the log reader.
     LogReporter reporter;
-    reporter.env = env_;
-    reporter.info_log = immutable_db_options_.info_log.get();
-    reporter.fname = fname.c_str();
-    if (!immutable_db_options_.paranoid_checks ||
-        immutable_db_options_.wal_recovery_mode ==
-            WALRecoveryMode::kSkipAnyCorruptedRecords) {
-      reporter.status = nullptr;
-    } else {
-      reporter.status = &status;
-    }
+    init_reporter(&reporter, fname);
     // We intentially make log::Reader do checksumming even if
     // paranoid_checks==false so that corruptions cause entire commits
     // to be skipped instead of propagating bad information (like overly
     // large sequence numbers).
-    log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
-                       &reporter, true /*checksum*/, wal_number);
+    std::unique_ptr<log::Reader> reader(
+        new log::Reader(immutable_db_options_.info_log, std::move(file_reader),
+                        &reporter, true /*checksum*/, wal_number));
+
+    std::unique_ptr<WalStreamMerger> merger;
+    if (merge_wal_streams && wal_idx + 1 < wal_numbers.size()) {
+      merger.reset(new WalStreamMerger);
+      merger->AddReader(wal_number, nullptr, std::move(reader));
+      for (++wal_idx; wal_idx < wal_numbers.size(); ++wal_idx) {
+        const uint64_t stream_number = wal_numbers[wal_idx];
+        versions_->MarkFileNumberUsed(stream_number);
+        merged_fnames.push_back(
+            LogFileName(immutable_db_options_.GetWalDir(), stream_number));
+        ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                       "Recovering log #%" PRIu64 " merged with log #%" PRIu64,
+                       stream_number, wal_number);
+        status = open_wal(merged_fnames.back(), &file_reader);
+        if (!status.ok()) {
+          MaybeIgnoreError(&status);
+          if (!status.ok()) {
+            return status;
+          }
+          continue;
+        }
+        std::unique_ptr<LogReporter> stream_reporter(new LogReporter);
+        init_reporter(stream_reporter.get(), merged_fnames.back());
+        std::unique_ptr<log::Reader> stream_reader(new log::Reader(
+            immutable_db_options_.info_log, std::move(file_reader),
+            stream_reporter.get(), true /*checksum*/, stream_number));
+        merger->AddReader(stream_number, std::move(stream_reporter),
+                          std::move(stream_reader));
+      }
+    }
+    // The file the last replayed record was read from.
+    uint64_t replayed_wal_number = wal_number;
 
     // Determine if we should tolerate incomplete records at the tail end of the
     // Read all the records and add to a memtable
@@ -1217,15 +1389,52 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
                              /*arg=*/nullptr);
     uint64_t record_checksum;
     while (!stop_replay_by_wal_filter &&
-           reader.ReadRecord(&record, &scratch,
-                             immutable_db_options_.wal_recovery_mode,
-                             &record_checksum) &&
+           (merger ? merger->ReadRecord(&record, &scratch,
+                                        immutable_db_options_.wal_recovery_mode,
+                                        &record_checksum)
+                   : reader->ReadRecord(&record, &scratch,
+                                        immutable_db_options_.wal_recovery_mode,
+                                        &record_checksum)) &&
            status.ok()) {
       if (record.size() < WriteBatchInternal::kHeader) {
+        if (merger) {
+          replayed_wal_number = merger->wal_number();
+        }
         reporter.Corruption(record.size(),
                             Status::Corruption("log record too small"));
         continue;
       }
+      if (merger) {
+        // The streams are appended to in parallel, and the unsynced tail of
+        // one of them may be lost while later records of another survive.
+        // A sequence missing from all the streams is treated as the point of
+        // corruption, so that only a consistent prefix is recovered.
+        // Sequences allocated without being logged are covered by sequence
+        // skip batches.
+        const SequenceNumber record_sequence = DecodeFixed64(record.data());
+        if (*next_sequence != kMaxSequenceNumber &&
+            record_sequence != *next_sequence &&
+            immutable_db_options_.wal_recovery_mode !=
+                WALRecoveryMode::kSkipAnyCorruptedRecords) {
+          ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                         "Missing sequence #%" PRIu64
+                         " in WAL streams after log #%" PRIu64
+                         ", next record has sequence #%" PRIu64,
+                         *next_sequence, replayed_wal_number,
+                         record_sequence);
+          if (immutable_db_options_.wal_recovery_mode ==
+              WALRecoveryMode::kAbsoluteConsistency) {
+            return Status::Corruption("Missing sequence in WAL streams");
+          }
+          stop_replay_for_corruption = true;
+          corrupted_wal_number = replayed_wal_number;
+          if (corrupted_wal_found != nullptr) {
+            *corrupted_wal_found = true;
+          }
+          break;
+        }
+        replayed_wal_number = merger->wal_number();
+      }
       // We create a new batch and initialize with a valid prot_info_ to store
       // the data checksums
       WriteBatch batch;
@@ -1235,9 +1444,15 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       if (!status.ok()) {
         return status;
       }
+      SequenceNumber skip_to = 0;
+      if (merger && WriteBatchInternal::GetSequenceSkip(&batch, &skip_to)) {
+        *next_sequence = skip_to;
+        continue;
+      }
 
       const UnorderedMap<uint32_t, size_t>& record_ts_sz =
-          reader.GetRecordedTimestampSize();
+          merger ? merger->GetRecordedTimestampSize()
+                 : reader->GetRecordedTimestampSize();
       status = HandleWriteBatchTimestampSizeDifference(
           &batch, running_ts_sz, record_ts_sz,
           TimestampSizeConsistencyMode::kReconcileInconsistency, &new_batch);
@@ -1286,9 +1501,9 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
 
       // For the default case of wal_filter == nullptr, always performs no-op
       // and returns true.
-      if (!InvokeWalFilterIfNeededOnWalRecord(wal_number, fname, reporter,
-                                              status, stop_replay_by_wal_filter,
-                                              *batch_to_use)) {
+      if (!InvokeWalFilterIfNeededOnWalRecord(
+              replayed_wal_number, fname, reporter, status,
+              stop_replay_by_wal_filter, *batch_to_use)) {
         continue;
       }
 
@@ -1300,7 +1515,7 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       bool has_valid_writes = false;
       status = WriteBatchInternal::InsertInto(
           batch_to_use, column_family_memtables_.get(), &flush_scheduler_,
-          &trim_history_scheduler_, true, wal_number, 0, this,
+          &trim_history_scheduler_, true, replayed_wal_number, 0, this,
           false /* concurrent_memtable_writes */, next_sequence,
           &has_valid_writes, seq_per_batch_, batch_per_txn_);
       MaybeIgnoreError(&status);
@@ -1320,7 +1535,7 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
           cfd->UnrefAndTryDelete();
           // If this asserts, it means that InsertInto failed in
           // filtering updates to already-flushed column families
-          assert(cfd->GetLogNumber() <= wal_number);
+          assert(cfd->GetLogNumber() <= replayed_wal_number);
           auto iter = version_edits.find(cfd->GetID());
           assert(iter != version_edits.end());
           VersionEdit* edit = &iter->second;
@@ -1357,21 +1572,21 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
                           " seq #%" PRIu64
                           ". %s. This likely mean loss of synced WAL, "
                           "thus recovery fails.",
-                          wal_number, *next_sequence,
+                          replayed_wal_number, *next_sequence,
                           status.ToString().c_str());
           return status;
         }
         // We should ignore the error but not continue replaying
         status = Status::OK();
         stop_replay_for_corruption = true;
-        corrupted_wal_number = wal_number;
+        corrupted_wal_number = replayed_wal_number;
         if (corrupted_wal_found != nullptr) {
           *corrupted_wal_found = true;
         }
         ROCKS_LOG_INFO(immutable_db_options_.info_log,
                        "Point in time recovered to log #%" PRIu64
                        " seq #%" PRIu64,
-                       wal_number, *next_sequence);
+                       replayed_wal_number, *next_sequence);
       } else {
         assert(immutable_db_options_.wal_recovery_mode ==
                    WALRecoveryMode::kTolerateCorruptedTailRecords ||
@@ -1462,7 +1677,10 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
         // If flush happened in the middle of recovery (e.g. due to memtable
         // being full), we flush at the end. Otherwise we'll need to record
         // where we were on last flush, which make the logic complicated.
-        if (flushed || !immutable_db_options_.avoid_flush_during_recovery) {
+        // With multiple WAL streams, records after a missing sequence may
+        // remain in the WAL files, so they are made obsolete.
+        if (flushed || !immutable_db_options_.avoid_flush_during_recovery ||
+            (merge_wal_streams && stop_replay_for_corruption)) {
           status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
           if (!status.ok()) {
             // Recovery failed
@@ -1898,6 +2116,11 @@ Status DB::OpenAndTrimHistory(
   return s;
 }
 
+namespace {
+// Bytes of WAL records sampled per byte of trained compression dictionary.
+constexpr size_t kWALCompressionDictSampleFactor = 100;
+}  // anonymous namespace
+
 IOStatus DBImpl::CreateWAL(uint64_t log_file_num, uint64_t recycle_log_number,
                            size_t preallocate_block_size,
                            log::Writer** new_log) {
@@ -1938,12 +2161,104 @@ IOStatus DBImpl::CreateWAL(uint64_t log_file_num, uint64_t recycle_log_number,
     *new_log = new log::Writer(std::move(file_writer), log_file_num,
                                immutable_db_options_.recycle_log_file_num > 0,
                                immutable_db_options_.manual_wal_flush,
-                               immutable_db_options_.wal_compression);
-    io_s = (*new_log)->AddCompressionTypeRecord();
+                               immutable_db_options_.wal_compression, stats_);
+    io_s = (*new_log)->AddCompressionTypeRecord(wal_compression_dict_);
+    if (io_s.ok() && wal_compression_dict_.empty() &&
+        immutable_db_options_.wal_compression_dict_max_bytes > 0) {
+      (*new_log)->StartSamplingRecords(
+          immutable_db_options_.wal_compression_dict_max_bytes *
+          kWALCompressionDictSampleFactor);
+    }
+  }
+  return io_s;
+}
+
+void DBImpl::MaybeTrainWALCompressionDict(log::Writer* log_writer) {
+  if (!wal_compression_dict_.empty() || log_writer == nullptr) {
+    return;
+  }
+  // With two_write_queues, the WAL-only queue may still append to the log,
+  // and with it to the samples, so they are copied under log_write_mutex_.
+  std::string samples;
+  std::vector<size_t> sample_lens;
+  if (two_write_queues_) {
+    log_write_mutex_.Lock();
+  }
+  const bool samples_full = log_writer->SamplesFull();
+  if (samples_full) {
+    samples = log_writer->samples();
+    sample_lens = log_writer->sample_lens();
+  }
+  if (two_write_queues_) {
+    log_write_mutex_.Unlock();
+  }
+  if (!samples_full) {
+    return;
+  }
+  wal_compression_dict_ = ZSTD_TrainDictionary(
+      samples, sample_lens,
+      immutable_db_options_.wal_compression_dict_max_bytes);
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Trained WAL compression dictionary of %" ROCKSDB_PRIszt
+                 " bytes from WAL #%" PRIu64,
+                 wal_compression_dict_.size(), log_writer->get_log_number());
+}
+
+IOStatus DBImpl::CreateWALStreams(size_t preallocate_block_size,
+                                  std::vector<uint64_t>* stream_numbers,
+                                  std::vector<log::Writer*>* stream_writers) {
+  IOStatus io_s;
+  for (size_t i = 1; i < immutable_db_options_.num_wal_streams; ++i) {
+    uint64_t stream_number = versions_->NewFileNumber();
+    log::Writer* stream_writer = nullptr;
+    io_s = CreateWAL(stream_number, 0 /*recycle_log_number*/,
+                     preallocate_block_size, &stream_writer);
+    if (!io_s.ok()) {
+      delete stream_writer;
+      break;
+    }
+    // The compression dictionary is trained from the main WAL file only.
+    stream_writer->StartSamplingRecords(0);
+    stream_numbers->push_back(stream_number);
+    stream_writers->push_back(stream_writer);
+  }
+  if (!io_s.ok()) {
+    for (auto* stream_writer : *stream_writers) {
+      delete stream_writer;
+    }
+    stream_numbers->clear();
+    stream_writers->clear();
   }
   return io_s;
 }
 
+void DBImpl::ResetWALStreams() {
+  log_write_mutex_.AssertHeld();
+  if (immutable_db_options_.num_wal_streams <= 1) {
+    return;
+  }
+  if (!wal_streams_.empty()) {
+    // The parallel appends of the previous WAL were only counted in
+    // total_log_size_ so far.
+    const uint64_t prev_log_number = wal_streams_[0]->writer->get_log_number();
+    for (auto it = alive_log_files_.rbegin(); it != alive_log_files_.rend();
+         ++it) {
+      if (it->number == prev_log_number) {
+        for (auto& stream : wal_streams_) {
+          it->AddSize(stream->size);
+        }
+        break;
+      }
+    }
+    wal_streams_.clear();
+  }
+  auto& log = logs_.back();
+  wal_streams_.emplace_back(new WalStream(log.writer));
+  for (auto* stream_writer : log.stream_writers) {
+    wal_streams_.emplace_back(new WalStream(stream_writer));
+  }
+}
+
 Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
                     const std::vector<ColumnFamilyDescriptor>& column_families,
                     std::vector<ColumnFamilyHandle*>* handles, DB** dbptr,
@@ -2049,10 +2364,23 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
       assert(impl->logs_.empty());
       impl->logs_.emplace_back(new_log_number, new_log);
     }
+    std::vector<uint64_t> stream_numbers;
+    std::vector<log::Writer*> stream_writers;
+    if (s.ok()) {
+      s = impl->CreateWALStreams(preallocate_block_size, &stream_numbers,
+                                 &stream_writers);
+    }
 
     if (s.ok()) {
+      InstrumentedMutexLock wl(&impl->log_write_mutex_);
+      impl->logs_.back().stream_writers = std::move(stream_writers);
       impl->alive_log_files_.push_back(
           DBImpl::LogFileNumberSize(impl->logfile_number_));
+      impl->alive_log_files_.back().stream_numbers = std::move(stream_numbers);
+      impl->ResetWALStreams();
+    }
+
+    if (s.ok()) {
       // In WritePrepared there could be gap in sequence numbers. This breaks
       // the trick we use in kPointInTimeRecovery which assumes the first seq in
       // the log right after the corrupted log is one larger than the last seq
@@ -243,6 +243,10 @@ Status DBImpl::MultiBatchWrite(const WriteOptions& options,
 //      completed writers,
 //      the first unfinished writer encountered will become the new front.
 //
+// If `multi_batch_write_slice_size` is set, each WriteBatch larger than it is
+// further split into slices of that many records before joining the group,
+// so helpers in step 3.2 can share the work of a single huge WriteBatch.
+//
 Status DBImpl::MultiBatchWriteImpl(const WriteOptions& write_options,
                                    std::vector<WriteBatch*>&& my_batch,
                                    WriteCallback* callback, uint64_t* log_used,
@@ -255,6 +259,8 @@ Status DBImpl::MultiBatchWriteImpl(const WriteOptions& write_options,
                              log_ref, false /*disable_memtable*/,
                              /*pre_release_callback=*/nullptr,
                              /*post_memtable_callback=*/nullptr, post_callback);
+  writer.multi_batch.SplitIntoSubBatches(
+      immutable_db_options_.multi_batch_write_slice_size);
   CommitRequest request(&writer);
   writer.request = &request;
   write_thread_.JoinBatchGroup(&writer);
@@ -580,7 +586,18 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
   if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_WRITER) {
     // we are a non-leader in a parallel group
 
-    if (w.ShouldWriteToMemtable()) {
+    if (w.write_group->parallel_wal_write && !w.CallbackFailed()) {
+      PERF_TIMER_STOP(write_pre_and_post_process_time);
+      PERF_TIMER_GUARD(write_wal_time);
+      IOStatus io_s = WriteToWALStream(&w);
+      if (!io_s.ok()) {
+        IOStatusCheck(io_s);
+        w.status = io_s;
+      }
+      PERF_TIMER_START(write_pre_and_post_process_time);
+    }
+
+    if (w.status.ok() && w.ShouldWriteToMemtable()) {
       PERF_TIMER_STOP(write_pre_and_post_process_time);
       PERF_TIMER_GUARD(write_memtable_time);
 
@@ -592,6 +609,11 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
           write_options.ignore_missing_column_families, 0 /*log_number*/, this,
           true /*concurrent_memtable_writes*/, seq_per_batch_, w.batch_cnt,
           batch_per_txn_, write_options.memtable_insert_hint_per_batch);
+      if (w.write_group->parallel_wal_write) {
+        // The group status may also carry WAL errors, which have been
+        // handled by the writers that hit them.
+        MemTableInsertStatusCheck(w.status);
+      }
 
       PERF_TIMER_START(write_pre_and_post_process_time);
     }
@@ -610,8 +632,12 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
           assert(tmp_s.ok());
         }
       }
-      versions_->SetLastSequence(last_sequence);
-      MemTableInsertStatusCheck(w.status);
+      if (!w.write_group->parallel_wal_write) {
+        versions_->SetLastSequence(last_sequence);
+        MemTableInsertStatusCheck(w.status);
+      } else if (w.status.ok()) {
+        versions_->SetLastSequence(last_sequence);
+      }
       write_thread_.ExitAsBatchGroupFollower(&w);
     }
     assert(w.state == WriteThread::STATE_COMPLETED);
@@ -688,6 +714,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     size_t valid_batches = 0;
     size_t total_byte_size = 0;
     size_t pre_release_callback_cnt = 0;
+    bool wal_termination_point_set = false;
     for (auto* writer : write_group) {
       assert(writer);
       if (writer->CheckCallback(this)) {
@@ -703,8 +730,21 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         if (writer->pre_release_callback) {
           pre_release_callback_cnt++;
         }
+        if (!writer->multi_batch.batches[0]
+                 ->GetWalTerminationPoint()
+                 .is_cleared()) {
+          wal_termination_point_set = true;
+        }
       }
     }
+    // With multiple WAL streams, the writers of a parallel group append their
+    // own batches to the WAL once their sequences are assigned. Groups that
+    // need a sync, or whose WAL content depends on the whole group, are still
+    // written by the leader.
+    const bool parallel_wal_write =
+        parallel && !two_write_queues_ && !write_options.disableWAL &&
+        !log_context.need_log_sync && wal_streams_.size() > 1 &&
+        pre_release_callback_cnt == 0 && !wal_termination_point_set;
     // TODO: this use of operator bool on `tracer_` can avoid unnecessary lock
     // grabs but does not seem thread-safe.
     if (tracer_) {
@@ -761,11 +801,28 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         assert(log_context.log_file_number_size);
         LogFileNumberSize& log_file_number_size =
             *(log_context.log_file_number_size);
-        PERF_TIMER_GUARD(write_wal_time);
-        io_s =
-            WriteToWAL(write_group, log_context.writer, log_used,
-                       log_context.need_log_sync, log_context.need_log_dir_sync,
-                       last_sequence + 1, log_file_number_size);
+        if (immutable_db_options_.num_wal_streams > 1) {
+          PERF_TIMER_GUARD(write_wal_time);
+          io_s = MaybeWriteSequenceSkipToWAL(log_context.writer,
+                                             last_sequence + 1,
+                                             log_file_number_size);
+          wal_next_sequence_ = last_sequence + seq_inc + 1;
+        }
+        if (io_s.ok() && parallel_wal_write) {
+          log_empty_ = false;
+          for (auto* writer : write_group) {
+            writer->log_used = logfile_number_;
+          }
+          if (log_used != nullptr) {
+            *log_used = logfile_number_;
+          }
+        } else if (io_s.ok()) {
+          PERF_TIMER_GUARD(write_wal_time);
+          io_s = WriteToWAL(write_group, log_context.writer, log_used,
+                            log_context.need_log_sync,
+                            log_context.need_log_dir_sync, last_sequence + 1,
+                            log_file_number_size);
+        }
       }
     } else {
       if (status.ok() && !write_options.disableWAL) {
@@ -829,12 +886,19 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
             batch_per_txn_);
       } else {
         write_group.last_sequence = last_sequence;
+        write_group.parallel_wal_write = parallel_wal_write;
         write_thread_.LaunchParallelMemTableWriters(&write_group);
         in_parallel_group = true;
 
+        if (parallel_wal_write && !w.CallbackFailed()) {
+          io_s = WriteToWALStream(&w);
+          if (!io_s.ok()) {
+            status = w.status = io_s;
+          }
+        }
         // Each parallel follower is doing each own writes. The leader should
         // also do its own.
-        if (w.ShouldWriteToMemtable()) {
+        if (io_s.ok() && w.ShouldWriteToMemtable()) {
           ColumnFamilyMemTablesImpl column_family_memtables(
               versions_->GetColumnFamilySet());
           assert(w.sequence == current_sequence);
@@ -845,6 +909,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
               this, true /*concurrent_memtable_writes*/, seq_per_batch_,
               w.batch_cnt, batch_per_txn_,
               write_options.memtable_insert_hint_per_batch);
+          if (parallel_wal_write) {
+            MemTableInsertStatusCheck(w.status);
+          }
         }
       }
       if (seq_used != nullptr) {
@@ -903,6 +970,11 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     should_exit_batch_group = write_thread_.CompleteParallelMemTableWriter(&w);
   }
   if (should_exit_batch_group) {
+    if (write_group.parallel_wal_write && status.ok() && !w.status.ok()) {
+      // A failed writer fails the whole group, as its batch may be missing
+      // from the WAL.
+      status = w.status;
+    }
     if (status.ok()) {
       for (auto* tmp_w : write_group) {
         assert(tmp_w);
@@ -918,7 +990,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
       // we reacts to non-OK statuses here.
       versions_->SetLastSequence(last_sequence);
     }
-    MemTableInsertStatusCheck(w.status);
+    if (!write_group.parallel_wal_write) {
+      MemTableInsertStatusCheck(w.status);
+    }
     write_thread_.ExitAsBatchGroupLeader(write_group, status);
   }
 
@@ -1694,6 +1768,12 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
 
     for (auto& log : logs_) {
       io_s = log.writer->file()->Sync(immutable_db_options_.use_fsync);
+      for (auto* stream_writer : log.stream_writers) {
+        if (!io_s.ok()) {
+          break;
+        }
+        io_s = stream_writer->file()->Sync(immutable_db_options_.use_fsync);
+      }
       if (!io_s.ok()) {
         break;
       }
@@ -1730,6 +1810,70 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
   return io_s;
 }
 
+IOStatus DBImpl::MaybeWriteSequenceSkipToWAL(
+    log::Writer* log_writer, SequenceNumber sequence,
+    LogFileNumberSize& log_file_number_size) {
+  assert(immutable_db_options_.num_wal_streams > 1);
+  if (wal_next_sequence_ == 0 || wal_next_sequence_ >= sequence) {
+    return IOStatus::OK();
+  }
+  WriteBatch skip;
+  WriteBatchInternal::SetSequenceSkip(&skip, wal_next_sequence_, sequence);
+  uint64_t log_size = 0;
+  return WriteToWAL(skip, log_writer, nullptr /* log_used */, &log_size,
+                    Env::IO_TOTAL, log_file_number_size);
+}
+
+IOStatus DBImpl::WriteToWALStream(WriteThread::Writer* w) {
+  assert(wal_streams_.size() > 1);
+  WriteBatch* batch = w->multi_batch.batches[0];
+  WriteBatchInternal::SetSequence(batch, w->sequence);
+  Slice log_entry = WriteBatchInternal::Contents(batch);
+  TEST_SYNC_POINT_CALLBACK("DBImpl::WriteToWAL:log_entry", &log_entry);
+  auto s = batch->VerifyChecksum();
+  if (!s.ok()) {
+    return status_to_io_status(std::move(s));
+  }
+  StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE_WAL_TIME);
+  // Take the first idle stream, starting from a different one for each
+  // writer, and only wait for a busy one if all of them are busy.
+  const size_t num_streams = wal_streams_.size();
+  const size_t start =
+      next_wal_stream_.fetch_add(1, std::memory_order_relaxed) % num_streams;
+  WalStream* stream = nullptr;
+  for (size_t i = 0; i < num_streams; ++i) {
+    WalStream* candidate = wal_streams_[(start + i) % num_streams].get();
+    if (candidate->mutex.TryLock()) {
+      stream = candidate;
+      break;
+    }
+  }
+  if (stream == nullptr) {
+    stream = wal_streams_[start].get();
+    stream->mutex.Lock();
+  }
+  IOStatus io_s = stream->writer->MaybeAddUserDefinedTimestampSizeRecord(
+      versions_->GetColumnFamiliesTimestampSizeForRecord(),
+      w->rate_limiter_priority);
+  if (io_s.ok()) {
+    io_s = stream->writer->AddRecord(log_entry, w->rate_limiter_priority);
+  }
+  stream->size += log_entry.size();
+  stream->mutex.Unlock();
+  total_log_size_ += log_entry.size();
+
+  if (io_s.ok()) {
+    auto stats = default_cf_internal_stats_;
+    stats->AddDBStats(InternalStats::kIntStatsWalFileBytes, log_entry.size(),
+                      true /* concurrent */);
+    RecordTick(stats_, WAL_FILE_BYTES, log_entry.size());
+    stats->AddDBStats(InternalStats::kIntStatsWriteWithWal, 1,
+                      true /* concurrent */);
+    RecordTick(stats_, WRITE_WITH_WAL);
+  }
+  return io_s;
+}
+
 IOStatus DBImpl::ConcurrentWriteToWAL(
     const WriteThread::WriteGroup& write_group, uint64_t* log_used,
     SequenceNumber* last_sequence, size_t seq_inc) {
@@ -2318,6 +2462,7 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
     log_write_mutex_.Lock();
   }
   bool creating_new_log = !log_empty_;
+  log::Writer* prev_log_writer = logs_.empty() ? nullptr : logs_.back().writer;
   if (two_write_queues_) {
     log_write_mutex_.Unlock();
   }
@@ -2328,6 +2473,8 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
   }
   uint64_t new_log_number =
       creating_new_log ? versions_->NewFileNumber() : logfile_number_;
+  std::vector<uint64_t> new_stream_numbers;
+  std::vector<log::Writer*> new_stream_writers;
   const MutableCFOptions mutable_cf_options = *cfd->GetLatestMutableCFOptions();
 
   // Set memtable_info for memtable sealed callback
@@ -2345,10 +2492,17 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
       GetWalPreallocateBlockSize(mutable_cf_options.write_buffer_size);
   mutex_.Unlock();
   if (creating_new_log) {
+    if (immutable_db_options_.wal_compression_dict_max_bytes > 0) {
+      MaybeTrainWALCompressionDict(prev_log_writer);
+    }
     // TODO: Write buffer size passed in should be max of all CF's instead
     // of mutable_cf_options.write_buffer_size.
     io_s = CreateWAL(new_log_number, recycle_log_number, preallocate_block_size,
                      &new_log);
+    if (io_s.ok()) {
+      io_s = CreateWALStreams(preallocate_block_size, &new_stream_numbers,
+                              &new_stream_writers);
+    }
     if (s.ok()) {
       s = io_s;
     }
@@ -2403,6 +2557,9 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
       log_dir_synced_ = false;
       logs_.emplace_back(logfile_number_, new_log);
       alive_log_files_.push_back(LogFileNumberSize(logfile_number_));
+      logs_.back().stream_writers = std::move(new_stream_writers);
+      alive_log_files_.back().stream_numbers = std::move(new_stream_numbers);
+      ResetWALStreams();
     }
   }
 
@@ -2411,6 +2568,9 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
     assert(creating_new_log);
     delete new_mem;
     delete new_log;
+    for (auto* stream_writer : new_stream_writers) {
+      delete stream_writer;
+    }
     context->superversion_context.new_superversion.reset();
     // We may have lost data from the WritableFileBuffer in-memory buffer for
     // the current log, so treat it as a fatal error and set bg_error
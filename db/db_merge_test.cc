@@ -434,6 +434,63 @@ TEST_F(DBMergeTest, KeyOverlappedInstance) {
   VerifyKeyValue(3_db, 1_cf, "1", "NotFound");
 }
 
+TEST_F(DBMergeTest, ParallelMerge) {
+  FlushOptions fopts;
+  fopts.allow_write_stall = true;
+  WriteOptions wopts;
+  wopts.disableWAL = true;
+
+  for (int max_threads : {1, 3, 16}) {
+    MergeInstanceOptions mopts;
+    mopts.merge_memtable = true;
+    mopts.max_threads = max_threads;
+    std::unordered_map<std::string, std::string> kvs[3];
+    std::vector<uint32_t> sources;
+    for (uint32_t i = 0; i < 6; ++i) {
+      Open(i, {default_cf, 1_cf, 2_cf});
+      sources.push_back(i);
+      for (auto cf : {default_cf, 1_cf, 2_cf}) {
+        for (uint32_t k = 0; k < 10; ++k) {
+          auto key = std::to_string(cf) + std::to_string(i) + "-" +
+                     std::to_string(k);
+          ASSERT_OK(get_db(i)->Put(wopts, get_cf(i, cf), key, key));
+          kvs[cf][key] = key;
+          // Leave some keys in memtable.
+          if (k == 4) {
+            ASSERT_OK(get_db(i)->Flush(fopts, get_cf(i, cf)));
+          }
+        }
+      }
+    }
+    // Overlaps with the last source in one cf.
+    Open(6_db, {default_cf, 1_cf, 2_cf});
+    ASSERT_OK(get_db(6_db)->Put(wopts, get_cf(6_db, 2_cf), "25-0", "v"));
+    IsOverlapError(Merge(mopts, {0_db, 1_db, 2_db, 3_db, 4_db, 5_db}, 6_db));
+    Destroy(6_db);
+
+    ASSERT_OK(Merge(mopts, std::vector<uint32_t>(sources), 6_db,
+                    {default_cf, 1_cf, 2_cf}));
+    for (auto cf : {default_cf, 1_cf, 2_cf}) {
+      for (auto& kv : kvs[cf]) {
+        VerifyKeyValue(6_db, cf, kv.first, kv.second);
+      }
+    }
+    // Merged memtables are not in any WAL.
+    for (auto cf : {default_cf, 1_cf, 2_cf}) {
+      ASSERT_OK(get_db(6_db)->Flush(fopts, get_cf(6_db, cf)));
+    }
+    Open(6_db, {default_cf, 1_cf, 2_cf}, true /*reopen*/);
+    for (auto cf : {default_cf, 1_cf, 2_cf}) {
+      for (auto& kv : kvs[cf]) {
+        VerifyKeyValue(6_db, cf, kv.first, kv.second);
+      }
+    }
+    for (uint32_t i = 0; i <= 6; ++i) {
+      Destroy(i);
+    }
+  }
+}
+
 TEST_F(DBMergeTest, TombstoneOverlappedInstance) {
   WriteOptions wopts;
   wopts.disableWAL = true;
@@ -520,12 +577,76 @@ TEST_F(DBMergeTest, WithWAL) {
   mopts.merge_memtable = true;
   IsWALNotEmpty(Merge(mopts, {1_db, 2_db}, 3_db, {default_cf, 1_cf}));
 
+  // Adopt memtables whose data is still in WAL.
+  mopts.adopt_memtables_with_wal = true;
+  ASSERT_OK(Merge(mopts, {1_db, 2_db}, 3_db, {default_cf, 1_cf}));
+  VerifyKeyValue(3_db, 1_cf, "1", "v1");
+  VerifyKeyValue(3_db, 1_cf, "2", "v2");
+  // Adopted memtables are flushed by the merge.
+  uint64_t num_imm = 0;
+  ASSERT_TRUE(get_db(3_db)->GetIntProperty(
+      get_cf(3_db, 1_cf), DB::Properties::kNumImmutableMemTable, &num_imm));
+  ASSERT_EQ(0, num_imm);
+  // Source writes are not visible to the merged DB.
+  ASSERT_OK(get_db(1_db)->Put(wopts, get_cf(1_db, 1_cf), "1", "v1_new"));
+  VerifyKeyValue(3_db, 1_cf, "1", "v1");
+  Open(3_db, {default_cf, 1_cf}, true /*reopen*/);
+  VerifyKeyValue(3_db, 1_cf, "1", "v1");
+  VerifyKeyValue(3_db, 1_cf, "2", "v2");
+  // Sources still recover their own data from WAL.
+  Open(1_db, {default_cf, 1_cf}, true /*reopen*/);
+  VerifyKeyValue(1_db, 1_cf, "1", "v1_new");
+  Destroy(3_db);
+  mopts.adopt_memtables_with_wal = false;
+
   for (auto db : {1_db, 2_db}) {
     ASSERT_OK(get_db(db)->Flush(fopts, get_cf(db, 1_cf)));
   }
   ASSERT_OK(Merge(mopts, {1_db, 2_db}, 3_db, {default_cf, 1_cf}));
 }
 
+TEST_F(DBMergeTest, AdoptMemtablesWithWAL) {
+  WriteOptions wopts;
+  wopts.disableWAL = false;
+  FlushOptions fopts;
+  fopts.allow_write_stall = true;
+  MergeInstanceOptions mopts;
+  mopts.merge_memtable = true;
+  mopts.adopt_memtables_with_wal = true;
+  auto NumL0Files = [&](uint32_t db_id) {
+    std::string num;
+    EXPECT_TRUE(get_db(db_id)->GetProperty(
+        get_cf(db_id, 1_cf), "rocksdb.num-files-at-level0", &num));
+    return num;
+  };
+
+  Open(1_db, {default_cf, 1_cf});
+  Open(2_db, {default_cf, 1_cf});
+  ASSERT_OK(get_db(1_db)->Put(wopts, get_cf(1_db, 1_cf), "1", "v1"));
+  ASSERT_OK(get_db(2_db)->Put(wopts, get_cf(2_db, 1_cf), "2", "v2"));
+  ASSERT_OK(Merge(mopts, {1_db, 2_db}, 3_db, {default_cf, 1_cf}));
+  ASSERT_NE("0", NumL0Files(3_db));
+
+  // The adopted data is owned by the target, so sources don't flush it again.
+  for (auto db : {1_db, 2_db}) {
+    ASSERT_OK(get_db(db)->Flush(fopts, get_cf(db, 1_cf)));
+    ASSERT_EQ("0", NumL0Files(db));
+  }
+  VerifyKeyValue(1_db, 1_cf, "1", "NotFound");
+  VerifyKeyValue(2_db, 1_cf, "2", "NotFound");
+  // Nor do they replay it from their WALs.
+  ASSERT_OK(get_db(1_db)->Put(wopts, get_cf(1_db, 1_cf), "1", "v1_new"));
+  Open(1_db, {default_cf, 1_cf}, true /*reopen*/);
+  Open(2_db, {default_cf, 1_cf}, true /*reopen*/);
+  VerifyKeyValue(1_db, 1_cf, "1", "v1_new");
+  VerifyKeyValue(2_db, 1_cf, "2", "NotFound");
+  ASSERT_EQ("0", NumL0Files(2_db));
+
+  Open(3_db, {default_cf, 1_cf}, true /*reopen*/);
+  VerifyKeyValue(3_db, 1_cf, "1", "v1");
+  VerifyKeyValue(3_db, 1_cf, "2", "v2");
+}
+
 TEST_F(DBMergeTest, MemtableIsolation) {
   WriteOptions wopts;
   wopts.disableWAL = true;
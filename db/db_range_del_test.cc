@@ -271,6 +271,97 @@ TEST_F(DBRangeDelTest, FlushRangeDelsSameStartKey) {
   }
 }
 
+TEST_F(DBRangeDelTest, PersistFragmentedRangeDeletions) {
+  Options options = CurrentOptions();
+  BlockBasedTableOptions table_options;
+  table_options.persist_fragmented_range_deletions = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "val"));
+  }
+  // Overlapping range deletions, interleaved with writes.
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(10), Key(40)));
+  ASSERT_OK(Put(Key(20), "val2"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(30), Key(60)));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(50), Key(55)));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+
+  int num_fragmented_reads = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTable::ReadRangeDelBlock:Fragmented",
+      [&](void* /*arg*/) { num_fragmented_reads++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  Reopen(options);
+
+  for (int i = 0; i < 100; ++i) {
+    std::string value;
+    Status s = db_->Get(ReadOptions(), Key(i), &value);
+    if (i == 20) {
+      ASSERT_OK(s);
+      ASSERT_EQ("val2", value);
+    } else if (i >= 10 && i < 60) {
+      ASSERT_TRUE(s.IsNotFound());
+    } else {
+      ASSERT_OK(s);
+    }
+  }
+  ASSERT_EQ(1, num_fragmented_reads);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBRangeDelTest, PersistFragmentedRangeDeletionsIngested) {
+  Options options = CurrentOptions();
+  BlockBasedTableOptions table_options;
+  table_options.persist_fragmented_range_deletions = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "val"));
+  }
+  ASSERT_OK(Flush());
+
+  // The tombstones of the ingested file are written at sequence number 0, and
+  // the file is assigned a global sequence number above the existing keys.
+  std::string file_path = dbname_ + "/range_del_ingest.sst";
+  SstFileWriter sst_file_writer(EnvOptions(), options);
+  ASSERT_OK(sst_file_writer.Open(file_path));
+  ASSERT_OK(sst_file_writer.DeleteRange(Key(10), Key(40)));
+  ASSERT_OK(sst_file_writer.DeleteRange(Key(30), Key(60)));
+  ASSERT_OK(sst_file_writer.Finish());
+  ASSERT_OK(db_->IngestExternalFile({file_path}, IngestExternalFileOptions()));
+
+  int num_fragmented_reads = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTable::ReadRangeDelBlock:Fragmented",
+      [&](void* /*arg*/) { num_fragmented_reads++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  auto verify = [&]() {
+    for (int i = 0; i < 100; ++i) {
+      std::string value;
+      Status s = db_->Get(ReadOptions(), Key(i), &value);
+      if (i >= 10 && i < 60) {
+        ASSERT_TRUE(s.IsNotFound());
+      } else {
+        ASSERT_OK(s);
+      }
+    }
+  };
+  verify();
+  Reopen(options);
+  verify();
+  ASSERT_EQ(0, num_fragmented_reads);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBRangeDelTest, CompactRangeDelsSameStartKey) {
   ASSERT_OK(db_->Put(WriteOptions(), "unused",
                      "val"));  // prevents empty after compaction
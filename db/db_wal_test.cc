@@ -1472,6 +1472,203 @@ TEST_F(DBWALTest, SyncMultipleLogs) {
   ASSERT_OK(dbfull()->SyncWAL());
 }
 
+TEST_F(DBWALTest, MultiStreamWAL) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumRounds = 3;
+  Options options = CurrentOptions();
+  options.num_wal_streams = 4;
+  options.track_and_verify_wals_in_manifest = false;
+  options.avoid_flush_during_shutdown = true;
+
+  options.enable_pipelined_write = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.enable_pipelined_write = false;
+  DestroyAndReopen(options);
+
+  // Make all the writers of a round join the same write group, so that they
+  // append to the WAL streams in parallel.
+  std::atomic<int> ready_count{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "WriteThread::JoinBatchGroup:Wait", [&](void* arg) {
+        ready_count++;
+        auto* w = reinterpret_cast<WriteThread::Writer*>(arg);
+        if (w->state == WriteThread::STATE_GROUP_LEADER) {
+          while (ready_count < kNumThreads) {
+            // busy waiting
+          }
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+  std::string last_value;
+  for (int round = 0; round < kNumRounds; round++) {
+    ready_count = 0;
+    std::vector<port::Thread> threads;
+    for (int i = 0; i < kNumThreads; i++) {
+      threads.emplace_back([&, i]() {
+        WriteBatch batch;
+        std::string value = std::to_string(round) + "_" + std::to_string(i);
+        ASSERT_OK(batch.Put("key", value));
+        ASSERT_OK(batch.Put("key" + value, value));
+        ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    last_value = Get("key");
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  // A synced write goes through the group leader.
+  WriteOptions sync_write;
+  sync_write.sync = true;
+  ASSERT_OK(Put("synced", "v", sync_write));
+
+  VectorLogPtr log_files;
+  ASSERT_OK(dbfull()->GetSortedWalFiles(log_files));
+  ASSERT_GT(log_files.size(), 1);
+
+  // The overwrites of "key" are replayed in sequence order across streams.
+  Reopen(options);
+  ASSERT_EQ(last_value, Get("key"));
+  ASSERT_EQ("v", Get("synced"));
+  for (int round = 0; round < kNumRounds; round++) {
+    for (int i = 0; i < kNumThreads; i++) {
+      std::string value = std::to_string(round) + "_" + std::to_string(i);
+      ASSERT_EQ(value, Get("key" + value));
+    }
+  }
+
+  // Streams of flushed WALs are deleted with them.
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("after_flush", "v"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->GetSortedWalFiles(log_files));
+  ASSERT_LE(log_files.size(), options.num_wal_streams);
+  Reopen(options);
+  ASSERT_EQ(last_value, Get("key"));
+  ASSERT_EQ("v", Get("after_flush"));
+}
+
+TEST_F(DBWALTest, MultiStreamWALRecoverToSequenceGap) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumRounds = 3;
+  Options options = CurrentOptions();
+  options.num_wal_streams = 4;
+  options.track_and_verify_wals_in_manifest = false;
+  options.avoid_flush_during_shutdown = true;
+  options.avoid_flush_during_recovery = true;
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  DestroyAndReopen(options);
+
+  // Sequence numbers consumed without a WAL record do not stop the replay.
+  WriteOptions no_wal;
+  no_wal.disableWAL = true;
+  ASSERT_OK(Put("before_no_wal", "v"));
+  ASSERT_OK(Put("no_wal", "v", no_wal));
+  ASSERT_OK(Put("after_no_wal", "v"));
+  Reopen(options);
+  ASSERT_EQ("v", Get("before_no_wal"));
+  ASSERT_EQ("NOT_FOUND", Get("no_wal"));
+  ASSERT_EQ("v", Get("after_no_wal"));
+
+  std::atomic<int> ready_count{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "WriteThread::JoinBatchGroup:Wait", [&](void* arg) {
+        ready_count++;
+        auto* w = reinterpret_cast<WriteThread::Writer*>(arg);
+        if (w->state == WriteThread::STATE_GROUP_LEADER) {
+          while (ready_count < kNumThreads) {
+            // busy waiting
+          }
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+  for (int round = 0; round < kNumRounds; round++) {
+    ready_count = 0;
+    std::vector<port::Thread> threads;
+    for (int i = 0; i < kNumThreads; i++) {
+      threads.emplace_back([&, i]() {
+        ASSERT_OK(Put(Key(round * kNumThreads + i), "v"));
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  Close();
+
+  // Lose the tail of the stream holding the latest write.
+  std::vector<std::string> files;
+  ASSERT_OK(env_->GetChildren(dbname_, &files));
+  uint64_t last_wal_number = 0;
+  for (const auto& f : files) {
+    uint64_t number;
+    FileType type;
+    uint64_t size = 0;
+    if (ParseFileName(f, &number, &type) && type == kWalFile &&
+        env_->GetFileSize(LogFileName(dbname_, number), &size).ok() &&
+        size > 0) {
+      last_wal_number = std::max(last_wal_number, number);
+    }
+  }
+  ASSERT_GT(last_wal_number, 0);
+  ASSERT_OK(test::TruncateFile(env_, LogFileName(dbname_, last_wal_number),
+                               0 /* length */));
+
+  // Only a prefix of the writes in sequence order is recovered.
+  Reopen(options);
+  int recovered = 0;
+  for (int k = 0; k < kNumRounds * kNumThreads; k++) {
+    if (Get(Key(k)) == "v") {
+      recovered++;
+    }
+  }
+  ASSERT_LT(recovered, kNumRounds * kNumThreads);
+  ASSERT_EQ(dbfull()->GetLatestSequenceNumber(),
+            static_cast<SequenceNumber>(3 + recovered));
+
+  // The writes after the gap do not show up in later reopens either.
+  ASSERT_OK(Put("new", "v"));
+  Reopen(options);
+  ASSERT_EQ("v", Get("new"));
+  int recovered_again = 0;
+  for (int k = 0; k < kNumRounds * kNumThreads; k++) {
+    if (Get(Key(k)) == "v") {
+      recovered_again++;
+    }
+  }
+  ASSERT_EQ(recovered, recovered_again);
+}
+
+TEST_F(DBWALTest, MultiStreamWALUserLogData) {
+  Options options = CurrentOptions();
+  options.num_wal_streams = 4;
+  options.track_and_verify_wals_in_manifest = false;
+  options.avoid_flush_during_shutdown = true;
+  options.avoid_flush_during_recovery = true;
+  DestroyAndReopen(options);
+
+  // Log data is never read as a sequence skip, whatever its contents.
+  std::string blob = "rocksdb.wal.sequence_skip";
+  PutFixed64(&blob, 1000);
+  WriteBatch batch;
+  ASSERT_OK(batch.PutLogData(blob));
+  ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+  ASSERT_OK(Put("k1", "v"));
+  ASSERT_OK(Put("k2", "v"));
+  Reopen(options);
+  ASSERT_EQ("v", Get("k1"));
+  ASSERT_EQ("v", Get("k2"));
+  ASSERT_EQ(dbfull()->GetLatestSequenceNumber(), 2);
+
+  // The transaction log iterator does not read the other streams.
+  std::unique_ptr<TransactionLogIterator> iter;
+  ASSERT_TRUE(db_->GetUpdatesSince(1, &iter).IsNotSupported());
+}
+
 // Github issue 1339. Prior the fix we read sequence id from the first log to
 // a local variable, then keep increase the variable as we replay logs,
 // ignoring actual sequence id of the records. This is incorrect if some writes
@@ -2662,6 +2859,50 @@ TEST_F(DBWALTest, GetCompressedWalsAfterSync) {
   ASSERT_OK(s);
 }
 
+TEST_F(DBWALTest, WalCompressionDict) {
+  if (!StreamingCompressionTypeSupported(kZSTD) ||
+      !ZSTD_TrainDictionarySupported()) {
+    ROCKSDB_GTEST_BYPASS("ZSTD dictionary training not supported");
+    return;
+  }
+  Options options = CurrentOptions();
+  options.wal_compression = kZSTD;
+  options.wal_compression_dict_max_bytes = 1 << 10;
+  options.avoid_flush_during_recovery = true;
+  options.avoid_flush_during_shutdown = true;
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  // Fill the samples of the first WAL, which is compressed without a
+  // dictionary.
+  Random rnd(301);
+  const std::string common = rnd.RandomString(64);
+  const int kNumKeys = 2000;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), common + std::to_string(i)));
+  }
+  ASSERT_EQ(0, options.statistics->getTickerCount(
+                   WAL_COMPRESSION_DICT_BYTES_SAVED));
+
+  // The dictionary is trained when switching memtables, and used by the new
+  // WAL.
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  ASSERT_OK(Put("after_switch", common + "after_switch"));
+  ASSERT_GT(options.statistics->getTickerCount(
+                WAL_COMPRESSION_DICT_BYTES_SAVED),
+            0);
+
+  // Both WALs are recovered.
+  VectorLogPtr wals;
+  ASSERT_OK(dbfull()->GetSortedWalFiles(wals));
+  ASSERT_EQ(2, wals.size());
+  Reopen(options);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(common + std::to_string(i), Get(Key(i)));
+  }
+  ASSERT_EQ(common + "after_switch", Get("after_switch"));
+}
+
 TEST_F(DBWALTest, EmptyWalReopenTest) {
   Options options = CurrentOptions();
   options.env = env_;
@@ -10,6 +10,7 @@
 #include "db/db_test_util.h"
 #include "db/write_thread.h"
 #include "port/stack_trace.h"
+#include "test_util/mock_time_env.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -1293,6 +1294,126 @@ TEST_P(DBWriteBufferManagerTest, BackgroundWorkPaused) {
   }
 }
 
+TEST_P(DBWriteBufferManagerTest, WeightedQuotaFlushPolicy) {
+  Options options = CurrentOptions();
+  options.arena_block_size = 4096;
+  options.write_buffer_size = 500000;  // this is never hit
+  std::shared_ptr<Cache> cache = NewLRUCache(4 * 1024 * 1024, 2);
+  cost_cache_ = GetParam();
+
+  auto clock = std::make_shared<MockSystemClock>(SystemClock::Default());
+  clock->SetCurrentTime(100);
+
+  // Do not enable write stall.
+  std::shared_ptr<WriteBufferManager> wbm = std::make_shared<WriteBufferManager>(
+      100000, cost_cache_ ? cache : nullptr, 0.0, false, clock);
+  wbm->SetFlushPolicy(WriteBufferManager::FlushPolicy::kWeightedQuota);
+  options.write_buffer_manager = wbm;
+  CreateAndReopenWithCF({"cf1"}, options);
+
+  std::string other_name = test::PerThreadDBPath("db_shared_wb_other");
+  DB* other = nullptr;
+  ASSERT_OK(DestroyDB(other_name, options));
+  ASSERT_OK(DB::Open(options, other_name, &other));
+
+  // Both DBs get half of flush_size. In this DB, cf1 gets 3/4 of the half.
+  wbm->SetDBWeight(dbfull(), 2.0);
+  wbm->SetDBWeight(other, 2.0);
+  wbm->SetColumnFamilyWeight(handles_[1], 3.0);
+  std::vector<WriteBufferManager::ConsumerStats> stats;
+  wbm->GetConsumerStats(&stats);
+  ASSERT_EQ(3, stats.size());
+  for (auto& stat : stats) {
+    if (stat.db == other) {
+      ASSERT_EQ(50000, stat.soft_quota);
+    } else if (stat.cf == handles_[1]) {
+      ASSERT_EQ(37500, stat.soft_quota);
+    } else {
+      ASSERT_EQ(12500, stat.soft_quota);
+    }
+  }
+
+  WriteOptions wo;
+  wo.disableWAL = true;
+  // The other DB has the largest memtable, but it is within its quota. The
+  // default column family of this DB is the most over its quota.
+  ASSERT_OK(other->Put(wo, Key(1), DummyString(45000)));
+
+  // Write rates are sampled with the clock of the manager.
+  clock->MockSleepForSeconds(2);
+  std::vector<WriteBufferManager::ConsumerStats> new_stats;
+  wbm->GetConsumerStats(&new_stats);
+  ASSERT_EQ(3, new_stats.size());
+  for (size_t i = 0; i < new_stats.size(); i++) {
+    if (new_stats[i].db == other) {
+      uint64_t grown = new_stats[i].memory_usage - stats[i].memory_usage;
+      ASSERT_GT(grown, 45000);
+      // Half of the latest sample, taken over two seconds.
+      ASSERT_EQ(grown / 4, new_stats[i].write_rate);
+    } else {
+      ASSERT_EQ(0, new_stats[i].write_rate);
+    }
+  }
+  ASSERT_OK(Put(1, Key(1), DummyString(31000), wo));
+  ASSERT_OK(Put(0, Key(1), DummyString(25000), wo));
+  // Write another one to trigger the flush.
+  ASSERT_OK(Put(0, Key(2), DummyString(1), wo));
+
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable());
+  ASSERT_OK(
+      static_cast_with_check<DBImpl>(other)->TEST_WaitForFlushMemTable());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0, 0));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0, 1));
+  std::string property;
+  EXPECT_TRUE(other->GetProperty("rocksdb.num-files-at-level0", &property));
+  ASSERT_EQ(0, atoi(property.c_str()));
+
+  ASSERT_OK(other->Close());
+  delete other;
+  ASSERT_OK(DestroyDB(other_name, options));
+}
+
+TEST_P(DBWriteBufferManagerTest, WeightedQuotaMemTableAge) {
+  Options options = CurrentOptions();
+  options.arena_block_size = 4096;
+  options.write_buffer_size = 500000;  // this is never hit
+  std::shared_ptr<Cache> cache = NewLRUCache(4 * 1024 * 1024, 2);
+  cost_cache_ = GetParam();
+
+  // Memtable ages are measured with the clock of the DB. The clock of the
+  // manager never advances, so that no write rate is sampled.
+  auto db_clock = std::make_shared<MockSystemClock>(env_->GetSystemClock());
+  db_clock->SetCurrentTime(100);
+  auto mock_env = std::make_unique<CompositeEnvWrapper>(env_, db_clock);
+  auto wbm_clock = std::make_shared<MockSystemClock>(SystemClock::Default());
+  wbm_clock->SetCurrentTime(100);
+
+  // Do not enable write stall.
+  std::shared_ptr<WriteBufferManager> wbm = std::make_shared<WriteBufferManager>(
+      100000, cost_cache_ ? cache : nullptr, 0.0, false, wbm_clock);
+  wbm->SetFlushPolicy(WriteBufferManager::FlushPolicy::kWeightedQuota);
+  options.write_buffer_manager = wbm;
+  options.env = mock_env.get();
+  CreateAndReopenWithCF({"cf1"}, options);
+
+  WriteOptions wo;
+  wo.disableWAL = true;
+  // Both column families get half of flush_size. The default one stays
+  // below its quota, but its memtable gets an hour old before cf1 goes over
+  // its own quota.
+  ASSERT_OK(Put(0, Key(1), DummyString(46000), wo));
+  db_clock->MockSleepForSeconds(3600);
+  ASSERT_OK(Put(1, Key(1), DummyString(52000), wo));
+  // Write another one to trigger the flush.
+  ASSERT_OK(Put(1, Key(2), DummyString(1), wo));
+
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0, 0));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0, 1));
+
+  Destroy(options);
+}
+
 INSTANTIATE_TEST_CASE_P(DBWriteBufferManagerTest, DBWriteBufferManagerTest,
                         testing::Bool());
 
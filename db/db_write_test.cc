@@ -7,7 +7,9 @@
 #include <cstdint>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "db/db_test_util.h"
@@ -859,6 +861,63 @@ TEST_P(DBWriteTest, MultiThreadWrite) {
   Close();
 }
 
+TEST_P(DBWriteTest, MultiThreadWriteWithSlicedBatches) {
+  Options options = GetOptions();
+  if (!options.enable_multi_batch_write) {
+    return;
+  }
+  constexpr int kNumThreads = 4;
+  constexpr int kLargeBatchSize = 1000;
+  constexpr int kSmallBatchSize = 3;
+  options.multi_batch_write_slice_size = 7;
+  Reopen(options);
+  const SequenceNumber start_seq = dbfull()->GetLatestSequenceNumber();
+
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.push_back(port::Thread(
+        [&](int index) {
+          WriteOptions opt;
+          WriteBatch large;
+          WriteBatch small;
+          // Later records overwrite earlier ones across slice boundaries, so
+          // the slices must be numbered in batch order.
+          for (int k = 0; k < kLargeBatchSize; k++) {
+            ASSERT_OK(large.Put("large_" + std::to_string(index) + "_" +
+                                    std::to_string(k % 100),
+                                "value" + std::to_string(k)));
+          }
+          ASSERT_OK(large.Delete("large_" + std::to_string(index) + "_0"));
+          for (int k = 0; k < kSmallBatchSize; k++) {
+            ASSERT_OK(small.Put("small_" + std::to_string(index) + "_" +
+                                    std::to_string(k),
+                                "value" + std::to_string(k)));
+          }
+          ASSERT_OK(dbfull()->MultiBatchWrite(opt, {&small, &large}));
+        },
+        t));
+  }
+  for (int i = 0; i < kNumThreads; i++) {
+    threads[i].join();
+  }
+
+  ASSERT_EQ(start_seq + kNumThreads * (kLargeBatchSize + 1 + kSmallBatchSize),
+            dbfull()->GetLatestSequenceNumber());
+  for (int t = 0; t < kNumThreads; t++) {
+    ASSERT_EQ("NOT_FOUND", Get("large_" + std::to_string(t) + "_0"));
+    for (int k = 1; k < 100; k++) {
+      ASSERT_EQ("value" + std::to_string(kLargeBatchSize - 100 + k),
+                Get("large_" + std::to_string(t) + "_" + std::to_string(k)));
+    }
+    for (int k = 0; k < kSmallBatchSize; k++) {
+      ASSERT_EQ("value" + std::to_string(k),
+                Get("small_" + std::to_string(t) + "_" + std::to_string(k)));
+    }
+  }
+
+  Close();
+}
+
 class SimpleCallback : public PostWriteCallback {
   std::function<void(SequenceNumber)> f_;
 
@@ -939,6 +998,64 @@ TEST_P(DBWriteTest, PostWriteCallback) {
   }
 }
 
+TEST_P(DBWriteTest, PostWriteCallbackWithSlicedBatches) {
+  Options options = GetOptions();
+  if (!options.enable_multi_batch_write) {
+    return;
+  }
+  constexpr int kNumThreads = 4;
+  constexpr int kSliceSize = 7;
+  constexpr int kLargeBatchSize = 100 * kSliceSize;
+  options.multi_batch_write_slice_size = kSliceSize;
+  Reopen(options);
+
+  std::mutex mu;
+  std::unordered_map<const WriteBatch*, int> inserted_slices;
+  SyncPoint::GetInstance()->SetCallBack(
+      "WriteThread::Writer::ConsumeOne:Inserted", [&](void* arg) {
+        std::lock_guard<std::mutex> guard(mu);
+        inserted_slices[static_cast<const WriteBatch*>(arg)]++;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.push_back(port::Thread(
+        [&](int index) {
+          WriteBatch large;
+          WriteBatch small;
+          for (int k = 0; k < kLargeBatchSize; k++) {
+            ASSERT_OK(large.Put("large_" + std::to_string(index) + "_" +
+                                    std::to_string(k),
+                                "value"));
+          }
+          ASSERT_OK(small.Put("small_" + std::to_string(index), "value"));
+          std::atomic<int> calls(0);
+          SimpleCallback callback([&](SequenceNumber seq) {
+            ASSERT_NE(seq, 0);
+            if (calls.fetch_add(1) + 1 == 2) {
+              // Both batches are reported only after every slice of the large
+              // batch has been inserted, whichever writer inserted it.
+              std::lock_guard<std::mutex> guard(mu);
+              ASSERT_EQ(kLargeBatchSize / kSliceSize, inserted_slices[&large]);
+              ASSERT_EQ(1, inserted_slices[&small]);
+            }
+          });
+          ASSERT_OK(
+              dbfull()->MultiBatchWrite(WriteOptions(), {&small, &large},
+                                        &callback));
+          ASSERT_EQ(2, calls.load());
+        },
+        t));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  Close();
+}
+
 TEST_P(DBWriteTest, PostWriteCallbackEmptyBatch) {
   Options options = GetOptions();
   if (options.two_write_queues) {
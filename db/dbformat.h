@@ -80,6 +80,7 @@ enum ValueType : unsigned char {
   // Titan. See comments above for more details.
   kTypeColumnFamilyBlobIndex = 0x18,  // RocksDB native Blob DB only
   kTypeBlobIndex = 0x19,              // RocksDB native Blob DB only
+  kTypeSequenceSkip = 0x1A,           // WAL only.
   kTypeMaxValid,    // Should be after the last valid type, only used for
                     // validation
   kMaxValue = 0x7F  // Not used for storing records.
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "rocksdb/rocksdb_namespace.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -39,8 +41,15 @@ enum RecordType {
   // User-defined timestamp sizes
   kUserDefinedTimestampSizeType = 10,
   kRecyclableUserDefinedTimestampSizeType = 11,
+
+  // Compression dictionary, follows kSetCompressionType
+  kSetCompressionDictType = 12,
 };
-constexpr int kMaxRecordType = kRecyclableUserDefinedTimestampSizeType;
+constexpr int kMaxRecordType = kSetCompressionDictType;
+
+// Upper bound of the kSetCompressionDictType record payload, which must fit
+// in the first block together with the kSetCompressionType record.
+constexpr size_t kMaxCompressionDictSize = 16 * 1024;
 
 constexpr unsigned int kBlockSize = 32768;
 
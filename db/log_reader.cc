@@ -186,6 +186,20 @@ bool Reader::ReadRecord(Slice* record, std::string* scratch,
         }
         break;
       }
+      case kSetCompressionDictType: {
+        if (!compression_type_record_read_ || first_record_read_) {
+          ReportCorruption(fragment.size(),
+                           "SetCompressionDict not following compression type");
+        }
+        prospective_record_offset = physical_record_offset;
+        scratch->clear();
+        last_record_offset_ = prospective_record_offset;
+        if (!InitCompressionDict(fragment)) {
+          ReportCorruption(fragment.size(),
+                           "could not load WAL compression dictionary");
+        }
+        break;
+      }
       case kUserDefinedTimestampSizeType:
       case kRecyclableUserDefinedTimestampSizeType: {
         if (in_fragmented_record && !scratch->empty()) {
@@ -534,6 +548,7 @@ unsigned int Reader::ReadPhysicalRecord(Slice* result, size_t* drop_size,
     buffer_.remove_prefix(header_size + length);
 
     if (!uncompress_ || type == kSetCompressionType ||
+        type == kSetCompressionDictType ||
         type == kUserDefinedTimestampSizeType ||
         type == kRecyclableUserDefinedTimestampSizeType) {
       *result = Slice(header + header_size, length);
@@ -602,6 +617,11 @@ void Reader::InitCompression(const CompressionTypeRecord& compression_record) {
   assert(uncompressed_buffer_);
 }
 
+bool Reader::InitCompressionDict(const Slice& compression_dict) {
+  return uncompress_ != nullptr &&
+         uncompress_->LoadDictionary(compression_dict);
+}
+
 Status Reader::UpdateRecordedTimestampSize(
     const std::vector<std::pair<uint32_t, size_t>>& cf_to_ts_sz) {
   for (const auto& [cf, ts_sz] : cf_to_ts_sz) {
@@ -714,6 +734,22 @@ bool FragmentBufferedReader::ReadRecord(Slice* record, std::string* scratch,
         break;
       }
 
+      case kSetCompressionDictType: {
+        if (!compression_type_record_read_ || first_record_read_) {
+          ReportCorruption(fragment.size(),
+                           "SetCompressionDict not following compression type");
+        }
+        fragments_.clear();
+        prospective_record_offset = physical_record_offset;
+        last_record_offset_ = prospective_record_offset;
+        in_fragmented_record_ = false;
+        if (!InitCompressionDict(fragment)) {
+          ReportCorruption(fragment.size(),
+                           "could not load WAL compression dictionary");
+        }
+        break;
+      }
+
       case kUserDefinedTimestampSizeType:
       case kRecyclableUserDefinedTimestampSizeType: {
         if (in_fragmented_record_ && !scratch->empty()) {
@@ -906,6 +942,7 @@ bool FragmentBufferedReader::TryReadFragment(
   buffer_.remove_prefix(header_size + length);
 
   if (!uncompress_ || type == kSetCompressionType ||
+      type == kSetCompressionDictType ||
       type == kUserDefinedTimestampSizeType ||
       type == kRecyclableUserDefinedTimestampSizeType) {
     *fragment = Slice(header + header_size, length);
@@ -204,6 +204,8 @@ class Reader {
   void ReportDrop(size_t bytes, const Status& reason);
 
   void InitCompression(const CompressionTypeRecord& compression_record);
+  // Loads the dictionary of a kSetCompressionDictType record.
+  bool InitCompressionDict(const Slice& compression_dict);
 
   Status UpdateRecordedTimestampSize(
       const std::vector<std::pair<uint32_t, size_t>>& cf_to_ts_sz);
@@ -1128,6 +1128,62 @@ TEST_P(CompressionLogTest, AlignedFragmentation) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(CompressionLogTest, ReadWriteWithDictionary) {
+  CompressionType compression_type = std::get<2>(GetParam());
+  if (compression_type == kNoCompression ||
+      !StreamingCompressionTypeSupported(compression_type) ||
+      !ZSTD_TrainDictionarySupported()) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression dictionary");
+    return;
+  }
+  Random rnd(301);
+  std::vector<std::string> wal_entries;
+  std::string samples;
+  std::vector<size_t> sample_lens;
+  for (int i = 0; i < 2000; i++) {
+    wal_entries.push_back("key" + NumberString(i) + "value" +
+                          rnd.RandomString(16));
+    samples.append(wal_entries.back());
+    sample_lens.push_back(wal_entries.back().size());
+  }
+  const std::string dict = ZSTD_TrainDictionary(samples, sample_lens, 1024);
+  ASSERT_FALSE(dict.empty());
+
+  ASSERT_OK(writer_->AddCompressionTypeRecord(dict));
+  // The dictionary record follows the compression type record.
+  const int header_size =
+      std::get<0>(GetParam()) ? kRecyclableHeaderSize : kHeaderSize;
+  ASSERT_EQ(kHeaderSize + 4 + kHeaderSize + dict.size(), WrittenBytes());
+  for (const std::string& wal_entry : wal_entries) {
+    Write(wal_entry);
+  }
+  // Compressed with the dictionary, each record is much smaller than itself.
+  ASSERT_LT(WrittenBytes(), samples.size() + wal_entries.size() * header_size);
+  for (const std::string& wal_entry : wal_entries) {
+    ASSERT_EQ(wal_entry, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+}
+
+TEST_P(CompressionLogTest, SampleRecords) {
+  CompressionType compression_type = std::get<2>(GetParam());
+  if (!StreamingCompressionTypeSupported(compression_type)) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  ASSERT_OK(SetupTestEnv());
+  writer_->StartSamplingRecords(10);
+  Write("foo");
+  Write("");
+  ASSERT_FALSE(writer_->SamplesFull());
+  Write("barbaz");
+  Write("xxxx");
+  ASSERT_TRUE(writer_->SamplesFull());
+  Write("yyyy");
+  ASSERT_EQ("foobarbazxxxx", writer_->samples());
+  ASSERT_EQ((std::vector<size_t>{3, 6, 4}), writer_->sample_lens());
+}
+
 INSTANTIATE_TEST_CASE_P(
     Compression, CompressionLogTest,
     ::testing::Combine(::testing::Values(0, 1), ::testing::Bool(),
@@ -12,6 +12,7 @@
 #include <cstdint>
 
 #include "file/writable_file_writer.h"
+#include "monitoring/statistics_impl.h"
 #include "rocksdb/env.h"
 #include "rocksdb/io_status.h"
 #include "util/coding.h"
@@ -23,14 +24,15 @@ namespace log {
 
 Writer::Writer(std::unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
                bool recycle_log_files, bool manual_flush,
-               CompressionType compression_type)
+               CompressionType compression_type, Statistics* stats)
     : dest_(std::move(dest)),
       block_offset_(0),
       log_number_(log_number),
       recycle_log_files_(recycle_log_files),
       manual_flush_(manual_flush),
       compression_type_(compression_type),
-      compress_(nullptr) {
+      compress_(nullptr),
+      stats_(stats) {
   for (int i = 0; i <= kMaxRecordType; i++) {
     char t = static_cast<char>(i);
     type_crc_[i] = crc32c::Value(&t, 1);
@@ -77,10 +79,15 @@ IOStatus Writer::AddRecord(const Slice& slice,
   bool begin = true;
   int compress_remaining = 0;
   bool compress_start = false;
+  size_t compressed_size = 0;
   if (compress_) {
     compress_->Reset();
     compress_start = true;
   }
+  if (samples_.size() < max_sample_bytes_ && !slice.empty()) {
+    samples_.append(slice.data(), slice.size());
+    sample_lens_.push_back(slice.size());
+  }
 
   IOStatus s;
   do {
@@ -128,6 +135,7 @@ IOStatus Writer::AddRecord(const Slice& slice,
       }
       compress_start = false;
       ptr = compressed_buffer_.get();
+      compressed_size += left;
     }
 
     const size_t fragment_length = (left < avail) ? left : avail;
@@ -155,11 +163,18 @@ IOStatus Writer::AddRecord(const Slice& slice,
       s = dest_->Flush(rate_limiter_priority);
     }
   }
+  if (s.ok() && compress_ && compressed_size < slice.size()) {
+    const uint64_t saved = slice.size() - compressed_size;
+    RecordTick(stats_, WAL_COMPRESSION_BYTES_SAVED, saved);
+    if (compress_with_dict_) {
+      RecordTick(stats_, WAL_COMPRESSION_DICT_BYTES_SAVED, saved);
+    }
+  }
 
   return s;
 }
 
-IOStatus Writer::AddCompressionTypeRecord() {
+IOStatus Writer::AddCompressionTypeRecord(const Slice& compression_dict) {
   // Should be the first record
   assert(block_offset_ == 0);
 
@@ -189,6 +204,18 @@ IOStatus Writer::AddCompressionTypeRecord() {
     compressed_buffer_ =
         std::unique_ptr<char[]>(new char[max_output_buffer_len]);
     assert(compressed_buffer_);
+    // The dictionary is a single physical record in the first block. It is
+    // skipped if it does not fit, or the compression type cannot use it.
+    if (s.ok() && !compression_dict.empty() &&
+        block_offset_ + kHeaderSize + compression_dict.size() <= kBlockSize &&
+        compress_->LoadDictionary(compression_dict)) {
+      s = EmitPhysicalRecord(kSetCompressionDictType, compression_dict.data(),
+                             compression_dict.size());
+      if (s.ok() && !manual_flush_) {
+        s = dest_->Flush();
+      }
+      compress_with_dict_ = true;
+    }
   } else {
     // Disable compression if the record could not be added.
     compression_type_ = kNoCompression;
@@ -239,7 +266,7 @@ IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n,
 
   uint32_t crc = type_crc_[t];
   if (t < kRecyclableFullType || t == kSetCompressionType ||
-      t == kUserDefinedTimestampSizeType) {
+      t == kUserDefinedTimestampSizeType || t == kSetCompressionDictType) {
     // Legacy record format
     assert(block_offset_ + kHeaderSize + n <= kBlockSize);
     header_size = kHeaderSize;
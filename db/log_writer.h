@@ -24,6 +24,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class Statistics;
 class WritableFileWriter;
 
 namespace log {
@@ -79,7 +80,8 @@ class Writer {
   explicit Writer(std::unique_ptr<WritableFileWriter>&& dest,
                   uint64_t log_number, bool recycle_log_files,
                   bool manual_flush = false,
-                  CompressionType compressionType = kNoCompression);
+                  CompressionType compressionType = kNoCompression,
+                  Statistics* stats = nullptr);
   // No copying allowed
   Writer(const Writer&) = delete;
   void operator=(const Writer&) = delete;
@@ -88,7 +90,22 @@ class Writer {
 
   IOStatus AddRecord(const Slice& slice,
                      Env::IOPriority rate_limiter_priority = Env::IO_TOTAL);
-  IOStatus AddCompressionTypeRecord();
+  // If `compression_dict` is not empty and supported by the compression
+  // type, it is persisted in a kSetCompressionDictType record following the
+  // compression type, and used to compress all the records of the file.
+  IOStatus AddCompressionTypeRecord(const Slice& compression_dict = Slice());
+
+  // Keeps copies of the records added from now on, up to `max_bytes` in
+  // total, as samples to train a compression dictionary from.
+  void StartSamplingRecords(size_t max_bytes) {
+    max_sample_bytes_ = max_bytes;
+  }
+  // Returns true once `max_bytes` of samples have been collected.
+  bool SamplesFull() const {
+    return max_sample_bytes_ > 0 && samples_.size() >= max_sample_bytes_;
+  }
+  const std::string& samples() const { return samples_; }
+  const std::vector<size_t>& sample_lens() const { return sample_lens_; }
 
   // If there are column families in `cf_to_ts_sz` not included in
   // `recorded_cf_to_ts_sz_` and its user-defined timestamp size is non-zero,
@@ -134,6 +151,14 @@ class Writer {
   StreamingCompress* compress_;
   // Reusable compressed output buffer
   std::unique_ptr<char[]> compressed_buffer_;
+  // Whether records are compressed with a dictionary.
+  bool compress_with_dict_ = false;
+  Statistics* stats_;
+
+  // Samples of the added records, see StartSamplingRecords().
+  size_t max_sample_bytes_ = 0;
+  std::string samples_;
+  std::vector<size_t> sample_lens_;
 
   // The recorded user-defined timestamp size that have been written so far.
   // Since the user-defined timestamp size cannot be changed while the DB is
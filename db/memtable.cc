@@ -333,6 +333,12 @@ int MemTable::KeyComparator::operator()(
   return comparator.CompareKeySeq(a, key);
 }
 
+bool MemTable::KeyComparator::IsUserKeyPrefixOrdered() const {
+  // Timestamps are compared separately from the rest of the user key, so
+  // only the plain bytewise comparator qualifies.
+  return comparator.user_comparator() == BytewiseComparator();
+}
+
 void MemTableRep::InsertConcurrently(KeyHandle /*handle*/) {
   throw std::runtime_error("concurrent insert not supported");
 }
@@ -94,6 +94,7 @@ class MemTable {
                            const char* prefix_len_key2) const override;
     virtual int operator()(const char* prefix_len_key,
                            const DecodedType& key) const override;
+    virtual bool IsUserKeyPrefixOrdered() const override;
   };
 
   // MemTables are reference counted.  The initial reference count
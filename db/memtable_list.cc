@@ -1035,4 +1035,26 @@ void MemTableList::RemoveOldMemTables(uint64_t log_number,
   ResetTrimHistoryNeeded();
 }
 
+void MemTableList::RemoveAdoptedMemTables(const autovector<MemTable*>& mems,
+                                          autovector<MemTable*>* to_delete) {
+  assert(to_delete != nullptr);
+  if (mems.empty()) {
+    return;
+  }
+  InstallNewVersion();
+  for (MemTable* mem : mems) {
+    assert(std::find(current_->memlist_.begin(), current_->memlist_.end(),
+                     mem) != current_->memlist_.end());
+    current_->Remove(mem, to_delete);
+    assert(num_flush_not_started_ > 0);
+    --num_flush_not_started_;
+  }
+  if (0 == num_flush_not_started_) {
+    imm_flush_needed.store(false, std::memory_order_release);
+  }
+
+  UpdateCachedValuesFromMemTableListVersion();
+  ResetTrimHistoryNeeded();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
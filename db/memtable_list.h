@@ -448,6 +448,13 @@ class MemTableList {
   void RemoveOldMemTables(uint64_t log_number,
                           autovector<MemTable*>* to_delete);
 
+  // Used by DBImpl::MergeDisjointInstances after the memtables were adopted
+  // and flushed by another DB. Removes `mems` without flushing them. None of
+  // them must have been picked for a flush by this list. The memtables are
+  // not freed, but put into a vector for future deref and reclamation.
+  void RemoveAdoptedMemTables(const autovector<MemTable*>& mems,
+                              autovector<MemTable*>* to_delete);
+
  private:
   friend Status InstallMemtableAtomicFlushResults(
       const autovector<MemTableList*>* imm_lists,
@@ -262,11 +262,99 @@ void ReverseRangeDelIterator::Invalidate() {
   inactive_iters_.clear();
 }
 
+RangeTombstoneIndex::RangeTombstoneIndex(
+    const InternalKeyComparator* icmp,
+    const std::vector<std::unique_ptr<TruncatedRangeDelIterator>>& iters)
+    : icmp_(icmp) {
+  struct Boundary {
+    std::string key;
+    SequenceNumber seq;
+    bool is_start;
+  };
+  std::vector<Boundary> boundaries;
+  for (const auto& iter : iters) {
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ParsedInternalKey start = iter->start_key();
+      ParsedInternalKey end = iter->end_key();
+      if (icmp_->Compare(start, end) >= 0) {
+        continue;
+      }
+      boundaries.emplace_back();
+      AppendInternalKey(&boundaries.back().key, start);
+      boundaries.back().seq = iter->seq();
+      boundaries.back().is_start = true;
+      boundaries.emplace_back();
+      AppendInternalKey(&boundaries.back().key, end);
+      boundaries.back().seq = iter->seq();
+      boundaries.back().is_start = false;
+    }
+  }
+  std::sort(boundaries.begin(), boundaries.end(),
+            [this](const Boundary& a, const Boundary& b) {
+              return icmp_->Compare(a.key, b.key) < 0;
+            });
+
+  // Sweep over the boundaries, keeping the sequence numbers of the
+  // tombstones covering the range up to the next boundary.
+  std::multiset<SequenceNumber> active_seqnums;
+  for (size_t i = 0; i < boundaries.size();) {
+    size_t next = i;
+    for (; next < boundaries.size() &&
+           icmp_->Compare(boundaries[next].key, boundaries[i].key) == 0;
+         ++next) {
+      if (boundaries[next].is_start) {
+        active_seqnums.insert(boundaries[next].seq);
+      } else {
+        active_seqnums.erase(active_seqnums.find(boundaries[next].seq));
+      }
+    }
+    if (next < boundaries.size() && !active_seqnums.empty()) {
+      const SequenceNumber seq = *active_seqnums.rbegin();
+      if (!fragments_.empty() && fragments_.back().seq == seq &&
+          fragments_.back().end == boundaries[i].key) {
+        fragments_.back().end = boundaries[next].key;
+      } else {
+        fragments_.push_back({boundaries[i].key, boundaries[next].key, seq});
+      }
+    }
+    i = next;
+  }
+  assert(active_seqnums.empty());
+}
+
+std::vector<RangeTombstoneIndex::Fragment>::const_iterator
+RangeTombstoneIndex::FindFragment(const ParsedInternalKey& ikey) const {
+  return std::upper_bound(fragments_.begin(), fragments_.end(), ikey,
+                          [this](const ParsedInternalKey& key,
+                                 const Fragment& fragment) {
+                            return icmp_->Compare(key, fragment.end) < 0;
+                          });
+}
+
+bool RangeTombstoneIndex::ShouldDelete(const ParsedInternalKey& parsed) const {
+  auto it = FindFragment(parsed);
+  return it != fragments_.end() && icmp_->Compare(it->start, parsed) <= 0 &&
+         it->seq > parsed.sequence;
+}
+
+bool RangeTombstoneIndex::IsRangeOverlapped(const Slice& start,
+                                            const Slice& end) const {
+  // See StripeRep::IsRangeOverlapped() for the choice of internal keys.
+  ParsedInternalKey start_ikey(start, kMaxSequenceNumber,
+                               static_cast<ValueType>(0));
+  ParsedInternalKey end_ikey(end, 0, static_cast<ValueType>(0));
+  auto it = FindFragment(start_ikey);
+  return it != fragments_.end() && icmp_->Compare(it->start, end_ikey) <= 0;
+}
+
 bool RangeDelAggregator::StripeRep::ShouldDelete(
     const ParsedInternalKey& parsed, RangeDelPositioningMode mode) {
   if (!InStripe(parsed.sequence) || IsEmpty()) {
     return false;
   }
+  if (const RangeTombstoneIndex* index = GetIndex()) {
+    return index->ShouldDelete(parsed);
+  }
   switch (mode) {
     case RangeDelPositioningMode::kForwardTraversal:
       InvalidateReverseIter();
@@ -298,6 +386,9 @@ bool RangeDelAggregator::StripeRep::ShouldDelete(
 
 bool RangeDelAggregator::StripeRep::IsRangeOverlapped(const Slice& start,
                                                       const Slice& end) {
+  if (const RangeTombstoneIndex* index = GetIndex()) {
+    return index->IsRangeOverlapped(start, end);
+  }
   Invalidate();
 
   // Set the internal start/end keys so that:
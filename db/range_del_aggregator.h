@@ -94,6 +94,10 @@ class TruncatedRangeDelIterator {
 
   SequenceNumber lower_bound() const { return iter_->lower_bound(); }
 
+  uint64_t num_unfragmented_tombstones() const {
+    return iter_->num_unfragmented_tombstones();
+  }
+
  private:
   std::unique_ptr<FragmentedRangeTombstoneIterator> iter_;
   const InternalKeyComparator* icmp_;
@@ -284,6 +288,39 @@ class ReverseRangeDelIterator {
   BinaryHeap<TruncatedRangeDelIterator*, EndKeyMaxComparator> inactive_iters_;
 };
 
+// A merged, fully fragmented view of the range tombstones of several
+// TruncatedRangeDelIterators: a sorted list of non-overlapping internal key
+// ranges, each with the highest sequence number covering it. Lookups are a
+// single binary search regardless of how many tombstones overlap.
+class RangeTombstoneIndex {
+ public:
+  RangeTombstoneIndex(
+      const InternalKeyComparator* icmp,
+      const std::vector<std::unique_ptr<TruncatedRangeDelIterator>>& iters);
+
+  bool ShouldDelete(const ParsedInternalKey& parsed) const;
+
+  // Same semantics as RangeDelAggregator::StripeRep::IsRangeOverlapped().
+  bool IsRangeOverlapped(const Slice& start, const Slice& end) const;
+
+  size_t num_fragments() const { return fragments_.size(); }
+
+ private:
+  struct Fragment {
+    // Encoded internal keys, covering [start, end).
+    std::string start;
+    std::string end;
+    SequenceNumber seq;
+  };
+
+  // Returns the first fragment ending after `ikey`, or fragments_.end().
+  std::vector<Fragment>::const_iterator FindFragment(
+      const ParsedInternalKey& ikey) const;
+
+  const InternalKeyComparator* icmp_;
+  std::vector<Fragment> fragments_;
+};
+
 enum class RangeDelPositioningMode { kForwardTraversal, kBackwardTraversal };
 class RangeDelAggregator {
  public:
@@ -322,16 +359,28 @@ class RangeDelAggregator {
  protected:
   class StripeRep {
    public:
+    static constexpr uint64_t kIndexMinTombstones = 64;
+    static constexpr uint64_t kIndexMinLookups = 8;
+
+    // If `use_index` is true, lookups over more than one iterator go
+    // through a RangeTombstoneIndex instead of advancing the iterators of
+    // all the levels. As building the index sorts all the tombstones, it is
+    // only built once there are enough of them, and enough lookups to
+    // amortize it. Aggregators used for a single lookup never build it.
     StripeRep(const InternalKeyComparator* icmp, SequenceNumber upper_bound,
-              SequenceNumber lower_bound)
+              SequenceNumber lower_bound, bool use_index = false)
         : icmp_(icmp),
           forward_iter_(icmp),
           reverse_iter_(icmp),
           upper_bound_(upper_bound),
-          lower_bound_(lower_bound) {}
+          lower_bound_(lower_bound),
+          use_index_(use_index) {}
 
     void AddTombstones(std::unique_ptr<TruncatedRangeDelIterator> input_iter) {
+      num_tombstones_ += input_iter->num_unfragmented_tombstones();
       iters_.push_back(std::move(input_iter));
+      index_.reset();
+      num_lookups_ = 0;
     }
 
     bool IsEmpty() const { return iters_.empty(); }
@@ -359,12 +408,35 @@ class RangeDelAggregator {
 
     void InvalidateReverseIter() { reverse_iter_.Invalidate(); }
 
+    // Returns the index if lookups should use it, building it if needed.
+    const RangeTombstoneIndex* GetIndex() {
+      if (!use_index_ || iters_.size() <= 1 ||
+          num_tombstones_ < kIndexMinTombstones) {
+        return nullptr;
+      }
+      if (index_ == nullptr) {
+        if (++num_lookups_ <= kIndexMinLookups) {
+          return nullptr;
+        }
+        // Building the index moves the iterators.
+        Invalidate();
+        index_.reset(new RangeTombstoneIndex(icmp_, iters_));
+      }
+      return index_.get();
+    }
+
     const InternalKeyComparator* icmp_;
     std::vector<std::unique_ptr<TruncatedRangeDelIterator>> iters_;
     ForwardRangeDelIterator forward_iter_;
     ReverseRangeDelIterator reverse_iter_;
     SequenceNumber upper_bound_;
     SequenceNumber lower_bound_;
+    bool use_index_;
+    std::unique_ptr<RangeTombstoneIndex> index_;
+    // Tombstones of iters_, before fragmentation.
+    uint64_t num_tombstones_ = 0;
+    // Lookups made without the index since tombstones were last added.
+    uint64_t num_lookups_ = 0;
   };
 
   const InternalKeyComparator* icmp_;
@@ -378,7 +450,7 @@ class ReadRangeDelAggregator final : public RangeDelAggregator {
   ReadRangeDelAggregator(const InternalKeyComparator* icmp,
                          SequenceNumber upper_bound)
       : RangeDelAggregator(icmp),
-        rep_(icmp, upper_bound, 0 /* lower_bound */) {}
+        rep_(icmp, upper_bound, 0 /* lower_bound */, true /* use_index */) {}
   ~ReadRangeDelAggregator() override {}
 
   using RangeDelAggregator::ShouldDelete;
@@ -536,6 +536,52 @@ TEST_F(RangeDelAggregatorTest, MultipleTruncatedItersInAggregatorSameLevel) {
                                            {"zz", "zzz", false}});
 }
 
+TEST_F(RangeDelAggregatorTest, ManyOverlappingItersInAggregator) {
+  // Every level has tombstones overlapping the ones of all other levels.
+  std::vector<std::string> keys;
+  for (int k = 0; k < 140; k++) {
+    keys.push_back(DBTestBase::Key(k));
+  }
+  Random rnd(301);
+  std::vector<std::vector<RangeTombstone>> range_dels_list;
+  for (int level = 0; level < 20; level++) {
+    std::vector<RangeTombstone> range_dels;
+    for (int i = 0; i < 10; i++) {
+      int start = static_cast<int>(rnd.Uniform(100));
+      int end = start + 1 + static_cast<int>(rnd.Uniform(30));
+      range_dels.emplace_back(keys[start], keys[end], 1 + rnd.Uniform(100));
+    }
+    range_dels_list.push_back(std::move(range_dels));
+  }
+  auto fragment_lists = MakeFragmentedTombstoneLists(range_dels_list);
+
+  ReadRangeDelAggregator range_del_agg(&bytewise_icmp, 80);
+  for (const auto& fragment_list : fragment_lists) {
+    std::unique_ptr<FragmentedRangeTombstoneIterator> input_iter(
+        new FragmentedRangeTombstoneIterator(fragment_list.get(), bytewise_icmp,
+                                             80 /* snapshot */));
+    range_del_agg.AddTombstones(std::move(input_iter));
+  }
+
+  std::vector<ShouldDeleteTestCase> test_cases;
+  for (const auto& key : keys) {
+    for (SequenceNumber seq : {1, 20, 50, 79, 80}) {
+      bool expected = false;
+      for (const auto& range_dels : range_dels_list) {
+        for (const auto& range_del : range_dels) {
+          if (range_del.seq_ <= 80 && range_del.seq_ > seq &&
+              range_del.start_key_.compare(key) <= 0 &&
+              range_del.end_key_.compare(key) > 0) {
+            expected = true;
+          }
+        }
+      }
+      test_cases.push_back({InternalValue(key, seq), expected});
+    }
+  }
+  VerifyShouldDelete(&range_del_agg, test_cases);
+}
+
 TEST_F(RangeDelAggregatorTest, CompactionAggregatorNoSnapshots) {
   auto fragment_lists = MakeFragmentedTombstoneLists(
       {{{"a", "e", 10}, {"c", "g", 8}},
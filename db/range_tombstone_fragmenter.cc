@@ -12,6 +12,7 @@
 #include <set>
 
 #include "util/autovector.h"
+#include "util/coding.h"
 #include "util/kv_map.h"
 #include "util/vector_iterator.h"
 
@@ -266,6 +267,76 @@ bool FragmentedRangeTombstoneList::ContainsRange(SequenceNumber lower,
   return seq_it != seq_set_.end() && *seq_it <= upper;
 }
 
+// Encoded format:
+//   num_unfragmented_tombstones: varint64
+//   total_tombstone_payload_bytes: varint64
+//   number of stacks: varint64
+//   number of sequence numbers: varint64
+//   sequence numbers: fixed64 each
+//   stacks: length-prefixed start key, length-prefixed end key and the
+//     exclusive end index of the stack's sequence numbers (varint64)
+void FragmentedRangeTombstoneList::EncodeTo(std::string* dst) const {
+  assert(tombstone_timestamps_.empty());
+  PutVarint64(dst, num_unfragmented_tombstones_);
+  PutVarint64(dst, total_tombstone_payload_bytes_);
+  PutVarint64(dst, tombstones_.size());
+  PutVarint64(dst, tombstone_seqs_.size());
+  for (SequenceNumber seq : tombstone_seqs_) {
+    PutFixed64(dst, seq);
+  }
+  for (const auto& tombstone : tombstones_) {
+    PutLengthPrefixedSlice(dst, tombstone.start_key);
+    PutLengthPrefixedSlice(dst, tombstone.end_key);
+    PutVarint64(dst, tombstone.seq_end_idx);
+  }
+}
+
+Status FragmentedRangeTombstoneList::DecodeFrom(
+    std::string&& encoded,
+    std::unique_ptr<FragmentedRangeTombstoneList>* list) {
+  assert(list != nullptr);
+  std::unique_ptr<FragmentedRangeTombstoneList> result(
+      new FragmentedRangeTombstoneList());
+  result->pinned_slices_.emplace_back(std::move(encoded));
+  Slice input(result->pinned_slices_.back());
+
+  uint64_t num_stacks = 0;
+  uint64_t num_seqs = 0;
+  if (!GetVarint64(&input, &result->num_unfragmented_tombstones_) ||
+      !GetVarint64(&input, &result->total_tombstone_payload_bytes_) ||
+      !GetVarint64(&input, &num_stacks) || !GetVarint64(&input, &num_seqs) ||
+      num_seqs > input.size() / sizeof(uint64_t)) {
+    return Status::Corruption("Bad fragmented range tombstones header");
+  }
+  result->tombstone_seqs_.reserve(static_cast<size_t>(num_seqs));
+  for (uint64_t i = 0; i < num_seqs; ++i) {
+    result->tombstone_seqs_.push_back(DecodeFixed64(input.data()));
+    input.remove_prefix(sizeof(uint64_t));
+  }
+  result->tombstones_.reserve(static_cast<size_t>(num_stacks));
+  uint64_t seq_start_idx = 0;
+  for (uint64_t i = 0; i < num_stacks; ++i) {
+    Slice start_key;
+    Slice end_key;
+    uint64_t seq_end_idx = 0;
+    if (!GetLengthPrefixedSlice(&input, &start_key) ||
+        !GetLengthPrefixedSlice(&input, &end_key) ||
+        !GetVarint64(&input, &seq_end_idx) || seq_end_idx <= seq_start_idx ||
+        seq_end_idx > num_seqs) {
+      return Status::Corruption("Bad fragmented range tombstone");
+    }
+    result->tombstones_.emplace_back(start_key, end_key,
+                                     static_cast<size_t>(seq_start_idx),
+                                     static_cast<size_t>(seq_end_idx));
+    seq_start_idx = seq_end_idx;
+  }
+  if (!input.empty() || seq_start_idx != num_seqs) {
+    return Status::Corruption("Bad fragmented range tombstones length");
+  }
+  *list = std::move(result);
+  return Status::OK();
+}
+
 FragmentedRangeTombstoneIterator::FragmentedRangeTombstoneIterator(
     FragmentedRangeTombstoneList* tombstones, const InternalKeyComparator& icmp,
     SequenceNumber _upper_bound, const Slice* ts_upper_bound,
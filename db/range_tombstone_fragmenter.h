@@ -96,7 +96,20 @@ struct FragmentedRangeTombstoneList {
     return total_tombstone_payload_bytes_;
   }
 
+  // Serializes the fragmented tombstones, so that DecodeFrom() can restore
+  // them without fragmenting again. Not supported with user-defined
+  // timestamps.
+  void EncodeTo(std::string* dst) const;
+
+  // Restores a list serialized by EncodeTo(). The keys of the restored list
+  // point into `encoded`, which is kept alive by the list.
+  static Status DecodeFrom(std::string&& encoded,
+                           std::unique_ptr<FragmentedRangeTombstoneList>* list);
+
  private:
+  FragmentedRangeTombstoneList()
+      : num_unfragmented_tombstones_(0), total_tombstone_payload_bytes_(0) {}
+
   // Given an ordered range tombstone iterator unfragmented_tombstones,
   // "fragment" the tombstones into non-overlapping pieces. Each
   // "non-overlapping piece" is a RangeTombstoneStack in tombstones_, which
@@ -143,6 +143,41 @@ TEST_F(RangeTombstoneFragmenterTest, OverlappingTombstones) {
                                    {{"a", 10}, {"c", 15}, {"e", 15}, {"g", 0}});
 }
 
+TEST_F(RangeTombstoneFragmenterTest, EncodeDecode) {
+  auto range_del_iter = MakeRangeDelIter(
+      {{"a", "e", 10}, {"c", "g", 15}, {"c", "g", 8}, {"x", "z", 4}});
+
+  FragmentedRangeTombstoneList fragment_list(std::move(range_del_iter),
+                                             bytewise_icmp);
+  std::string encoded;
+  fragment_list.EncodeTo(&encoded);
+
+  std::unique_ptr<FragmentedRangeTombstoneList> decoded_list;
+  ASSERT_OK(FragmentedRangeTombstoneList::DecodeFrom(std::string(encoded),
+                                                     &decoded_list));
+  ASSERT_NE(nullptr, decoded_list);
+  ASSERT_EQ(fragment_list.num_unfragmented_tombstones(),
+            decoded_list->num_unfragmented_tombstones());
+  ASSERT_EQ(fragment_list.total_tombstone_payload_bytes(),
+            decoded_list->total_tombstone_payload_bytes());
+  FragmentedRangeTombstoneIterator iter(decoded_list.get(), bytewise_icmp,
+                                        kMaxSequenceNumber);
+  VerifyFragmentedRangeDels(&iter, {{"a", "c", 10},
+                                    {"c", "e", 15},
+                                    {"c", "e", 10},
+                                    {"c", "e", 8},
+                                    {"e", "g", 15},
+                                    {"e", "g", 8},
+                                    {"x", "z", 4}});
+  VerifyMaxCoveringTombstoneSeqnum(
+      &iter, {{"a", 10}, {"c", 15}, {"e", 15}, {"g", 0}, {"y", 4}});
+
+  // Truncated input is rejected.
+  ASSERT_TRUE(FragmentedRangeTombstoneList::DecodeFrom(
+                  encoded.substr(0, encoded.size() - 1), &decoded_list)
+                  .IsCorruption());
+}
+
 TEST_F(RangeTombstoneFragmenterTest, ContiguousTombstones) {
   auto range_del_iter = MakeRangeDelIter(
       {{"a", "c", 10}, {"c", "e", 20}, {"c", "e", 5}, {"e", "g", 15}});
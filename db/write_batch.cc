@@ -32,6 +32,7 @@
 //    kTypeWideColumnEntity varstring varstring
 //    kTypeColumnFamilyWideColumnEntity varint32 varstring varstring
 //    kTypeNoop
+//    kTypeSequenceSkip varstring
 // varstring :=
 //    len: varint32
 //    data: uint8[len]
@@ -436,6 +437,12 @@ Status ReadRecordFromWriteBatch(Slice* input, char* tag,
         return Status::Corruption("bad WriteBatch Blob");
       }
       break;
+    case kTypeSequenceSkip:
+      assert(blob != nullptr);
+      if (!GetLengthPrefixedSlice(input, blob)) {
+        return Status::Corruption("bad WriteBatch SequenceSkip");
+      }
+      break;
     case kTypeNoop:
     case kTypeBeginPrepareXID:
       // This indicates that the prepared batch is also persisted in the db.
@@ -711,6 +718,9 @@ Status WriteBatchInternal::Iterate(const WriteBatch* wb,
         assert(s.ok());
         empty_batch = true;
         break;
+      case kTypeSequenceSkip:
+        // Only read by WAL recovery, see WriteBatchInternal::SetSequenceSkip.
+        break;
       case kTypeWideColumnEntity:
       case kTypeColumnFamilyWideColumnEntity:
         assert(wb->content_flags_.load(std::memory_order_relaxed) &
@@ -1794,6 +1804,7 @@ Status WriteBatch::VerifyChecksum() const {
       case kTypeBeginUnprepareXID:
       case kTypeDeletionWithTimestamp:
       case kTypeCommitXIDAndTimestamp:
+      case kTypeSequenceSkip:
         checksum_protected = false;
         break;
       case kTypeColumnFamilyWideColumnEntity:
@@ -3094,6 +3105,25 @@ Status WriteBatchInternal::InsertInto(
   return s;
 }
 
+Status WriteBatchInternal::InsertRangeInto(
+    const WriteBatch* batch, size_t begin, size_t end, SequenceNumber sequence,
+    ColumnFamilyMemTables* memtables, FlushScheduler* flush_scheduler,
+    TrimHistoryScheduler* trim_history_scheduler,
+    bool ignore_missing_column_families, uint64_t log_ref, DB* db,
+    bool concurrent_memtable_writes) {
+  MemTableInserter inserter(sequence, memtables, flush_scheduler,
+                            trim_history_scheduler,
+                            ignore_missing_column_families, 0 /*log_number*/,
+                            db, concurrent_memtable_writes,
+                            nullptr /*prot_info*/, nullptr /*has_valid_writes*/);
+  inserter.set_log_number_ref(log_ref);
+  Status s = Iterate(batch, &inserter, begin, end);
+  if (concurrent_memtable_writes) {
+    inserter.PostProcess();
+  }
+  return s;
+}
+
 namespace {
 
 // This class updates protection info for a WriteBatch.
@@ -3189,6 +3219,39 @@ Status WriteBatchInternal::SetContents(WriteBatch* b, const Slice& contents) {
   return Status::OK();
 }
 
+void WriteBatchInternal::SetSequenceSkip(WriteBatch* b, SequenceNumber sequence,
+                                         SequenceNumber next_sequence) {
+  assert(next_sequence > sequence);
+  b->Clear();
+  SetSequence(b, sequence);
+  // The next sequence is fixed64 encoded in a varstring, so that the record
+  // can be extended.
+  char buf[sizeof(uint64_t)];
+  EncodeFixed64(buf, next_sequence);
+  b->rep_.push_back(static_cast<char>(kTypeSequenceSkip));
+  PutLengthPrefixedSlice(&b->rep_, Slice(buf, sizeof(buf)));
+}
+
+bool WriteBatchInternal::GetSequenceSkip(const WriteBatch* b,
+                                         SequenceNumber* next_sequence) {
+  if (Count(b) != 0 || b->rep_.size() <= kHeader ||
+      b->rep_[kHeader] != static_cast<char>(kTypeSequenceSkip)) {
+    return false;
+  }
+  Slice input(b->rep_);
+  input.remove_prefix(kHeader);
+  char tag = 0;
+  uint32_t column_family = 0;
+  Slice key, value, blob, xid;
+  Status s = ReadRecordFromWriteBatch(&input, &tag, &column_family, &key,
+                                      &value, &blob, &xid);
+  if (!s.ok() || !input.empty() || blob.size() < sizeof(uint64_t)) {
+    return false;
+  }
+  *next_sequence = DecodeFixed64(blob.data());
+  return true;
+}
+
 Status WriteBatchInternal::AppendContents(WriteBatch* dst,
                                           const Slice& content) {
   size_t src_len = content.size() - WriteBatchInternal::kHeader;
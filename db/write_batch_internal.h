@@ -168,6 +168,19 @@ class WriteBatchInternal {
 
   static Status SetContents(WriteBatch* batch, const Slice& contents);
 
+  // Makes `batch` an empty batch starting at `sequence` that tells WAL
+  // recovery that the sequence numbers in [sequence, next_sequence) were
+  // allocated without being written to the WAL. Only written when the WAL is
+  // striped over several streams, see DBOptions::num_wal_streams. The batch
+  // holds a single kTypeSequenceSkip record, which Iterate() ignores.
+  static void SetSequenceSkip(WriteBatch* batch, SequenceNumber sequence,
+                              SequenceNumber next_sequence);
+
+  // Returns true and sets `next_sequence` if `batch` was made by
+  // SetSequenceSkip().
+  static bool GetSequenceSkip(const WriteBatch* batch,
+                              SequenceNumber* next_sequence);
+
   static Status CheckSlicePartsLength(const SliceParts& key,
                                       const SliceParts& value);
 
@@ -208,6 +221,18 @@ class WriteBatchInternal {
       SequenceNumber* next_seq = nullptr, bool* has_valid_writes = nullptr,
       bool seq_per_batch = false, bool batch_per_txn = true);
 
+  // Inserts only the records in the byte range [begin, end) of `batch` into
+  // the memtables, numbering them from `sequence`. `begin` and `end` must be
+  // record boundaries. Used to insert one slice of a large batch while other
+  // threads insert the rest of it, so protection info is not verified.
+  static Status InsertRangeInto(
+      const WriteBatch* batch, size_t begin, size_t end,
+      SequenceNumber sequence, ColumnFamilyMemTables* memtables,
+      FlushScheduler* flush_scheduler,
+      TrimHistoryScheduler* trim_history_scheduler,
+      bool ignore_missing_column_families = false, uint64_t log_ref = 0,
+      DB* db = nullptr, bool concurrent_memtable_writes = false);
+
   static Status InsertInto(WriteThread::Writer* writer, SequenceNumber sequence,
                            ColumnFamilyMemTables* memtables,
                            FlushScheduler* flush_scheduler,
@@ -9,6 +9,7 @@
 #include <thread>
 
 #include "db/column_family.h"
+#include "db/write_batch_internal.h"
 #include "monitoring/perf_context_imp.h"
 #include "port/port.h"
 #include "test_util/sync_point.h"
@@ -654,9 +655,11 @@ void WriteThread::ExitAsBatchGroupFollower(Writer* w) {
   auto* write_group = w->write_group;
 
   assert(w->state == STATE_PARALLEL_MEMTABLE_WRITER);
-  assert(write_group->status.ok());
+  // The status is only non-ok if a writer failed to append its own batch to
+  // the WAL, see WriteGroup::parallel_wal_write.
+  assert(write_group->status.ok() || write_group->parallel_wal_write);
   ExitAsBatchGroupLeader(*write_group, write_group->status);
-  assert(w->status.ok());
+  assert(w->status.ok() || write_group->parallel_wal_write);
   assert(w->state == STATE_COMPLETED);
   SetState(write_group->leader, STATE_COMPLETED);
 }
@@ -862,7 +865,7 @@ void RequestQueue::CommitSequenceAwait(CommitRequest* req,
     auto front = requests_.front()->writer;
     if (front->ConsumableOnOtherThreads()) {
       auto claimed = front->Claim();
-      if (claimed < front->multi_batch.batches.size()) {
+      if (claimed < front->multi_batch.sub_batches.size()) {
         guard.unlock();
         front->ConsumeOne(claimed);
         guard.lock();
@@ -892,18 +895,154 @@ void RequestQueue::CommitSequenceAwait(CommitRequest* req,
   }
 }
 
+WriteThread::MultiBatch::MultiBatch(std::vector<WriteBatch*>&& _batch)
+    : batches(std::move(_batch)),
+      claimed_cnt(0),
+      pending_wb_cnt(batches.size()),
+      version_set(nullptr),
+      flush_scheduler(nullptr),
+      trim_history_scheduler(nullptr),
+      ignore_missing_column_families(false),
+      db(nullptr) {
+  sub_batches.reserve(batches.size());
+  for (size_t i = 0; i < batches.size(); i++) {
+    sub_batches.push_back(
+        {batches[i], WriteBatchInternal::kHeader, batches[i]->GetDataSize(), 0,
+         i});
+  }
+}
+
+void WriteThread::MultiBatch::SplitIntoSubBatches(size_t slice_size) {
+  assert(claimed_cnt.load(std::memory_order_relaxed) == 0);
+  if (slice_size == 0) {
+    return;
+  }
+  std::vector<SubBatch> result;
+  std::unique_ptr<BatchProgress[]> progress(new BatchProgress[batches.size()]);
+  bool any_split = false;
+  for (size_t i = 0; i < batches.size(); i++) {
+    WriteBatch* b = batches[i];
+    if (WriteBatchInternal::Count(b) <= slice_size ||
+        b->GetProtectionBytesPerKey() > 0) {
+      result.push_back(
+          {b, WriteBatchInternal::kHeader, b->GetDataSize(), 0, i});
+      progress[i].pending_slices.store(1, std::memory_order_relaxed);
+      continue;
+    }
+    const size_t first = result.size();
+    Slice input(b->Data());
+    input.remove_prefix(WriteBatchInternal::kHeader);
+    size_t begin = WriteBatchInternal::kHeader;
+    uint64_t seq_offset = 0;
+    size_t records = 0;
+    bool splittable = true;
+    Slice key, value, blob, xid;
+    char tag = 0;
+    uint32_t column_family = 0;
+    while (splittable && !input.empty()) {
+      Status s = ReadRecordFromWriteBatch(&input, &tag, &column_family, &key,
+                                          &value, &blob, &xid);
+      if (!s.ok()) {
+        // Leave it to the memtable insertion to report the corruption.
+        s.PermitUncheckedError();
+        splittable = false;
+        break;
+      }
+      switch (tag) {
+        case kTypeColumnFamilyValue:
+        case kTypeValue:
+        case kTypeColumnFamilyDeletion:
+        case kTypeDeletion:
+        case kTypeColumnFamilySingleDeletion:
+        case kTypeSingleDeletion:
+        case kTypeColumnFamilyRangeDeletion:
+        case kTypeRangeDeletion:
+        case kTypeColumnFamilyMerge:
+        case kTypeMerge:
+        case kTypeColumnFamilyBlobIndex:
+        case kTypeBlobIndex:
+        case kTypeTitanColumnFamilyBlobIndex:
+        case kTypeTitanBlobIndex:
+        case kTypeColumnFamilyWideColumnEntity:
+        case kTypeWideColumnEntity:
+          // Each of these records consumes one sequence number.
+          records++;
+          break;
+        case kTypeLogData:
+          break;
+        default:
+          // Transaction markers change how sequence numbers are assigned.
+          splittable = false;
+          break;
+      }
+      if (records == slice_size) {
+        size_t end = b->GetDataSize() - input.size();
+        result.push_back({b, begin, end, seq_offset, i});
+        begin = end;
+        seq_offset += records;
+        records = 0;
+      }
+    }
+    if (!splittable) {
+      result.resize(first);
+      result.push_back(
+          {b, WriteBatchInternal::kHeader, b->GetDataSize(), 0, i});
+    } else if (begin < b->GetDataSize()) {
+      result.push_back({b, begin, b->GetDataSize(), seq_offset, i});
+    }
+    const size_t slices = result.size() - first;
+    progress[i].pending_slices.store(slices, std::memory_order_relaxed);
+    any_split = any_split || slices > 1;
+  }
+  if (any_split) {
+    batch_progress = std::move(progress);
+  }
+  sub_batches.swap(result);
+  pending_wb_cnt.store(sub_batches.size(), std::memory_order_release);
+}
+
 void WriteThread::Writer::ConsumeOne(size_t claimed) {
-  assert(claimed < multi_batch.batches.size());
+  assert(claimed < multi_batch.sub_batches.size());
+  const MultiBatch::SubBatch& sub_batch = multi_batch.sub_batches[claimed];
+  const bool whole_batch = sub_batch.begin == WriteBatchInternal::kHeader &&
+                           sub_batch.end == sub_batch.batch->GetDataSize();
   ColumnFamilyMemTablesImpl memtables(multi_batch.version_set);
-  Status s = WriteBatchInternal::InsertInto(
-      multi_batch.batches[claimed], &memtables, multi_batch.flush_scheduler,
-      multi_batch.trim_history_scheduler,
-      multi_batch.ignore_missing_column_families, 0, this->log_ref,
-      multi_batch.db, true);
+  Status s;
+  if (whole_batch) {
+    s = WriteBatchInternal::InsertInto(
+        sub_batch.batch, &memtables, multi_batch.flush_scheduler,
+        multi_batch.trim_history_scheduler,
+        multi_batch.ignore_missing_column_families, 0, this->log_ref,
+        multi_batch.db, true);
+  } else {
+    s = WriteBatchInternal::InsertRangeInto(
+        sub_batch.batch, sub_batch.begin, sub_batch.end,
+        WriteBatchInternal::Sequence(sub_batch.batch) + sub_batch.seq_offset,
+        &memtables, multi_batch.flush_scheduler,
+        multi_batch.trim_history_scheduler,
+        multi_batch.ignore_missing_column_families, this->log_ref,
+        multi_batch.db, true);
+  }
   if (!s.ok()) {
     std::lock_guard<SpinMutex> guard(this->status_lock);
     this->status = s;
-  } else if (post_callback) {
+  }
+  TEST_SYNC_POINT_CALLBACK("WriteThread::Writer::ConsumeOne:Inserted",
+                           sub_batch.batch);
+  bool batch_done = s.ok();
+  if (multi_batch.batch_progress) {
+    // Other writers may still be inserting earlier sub-batches of the same
+    // batch, so only the one finishing last reports the batch as written.
+    MultiBatch::BatchProgress& progress =
+        multi_batch.batch_progress[sub_batch.batch_index];
+    if (!s.ok()) {
+      progress.failed.store(true, std::memory_order_relaxed);
+    }
+    batch_done = progress.pending_slices.fetch_sub(
+                     1, std::memory_order_acq_rel) == 1 &&
+                 !progress.failed.load(std::memory_order_relaxed);
+  }
+  if (batch_done && post_callback) {
     post_callback->Callback(sequence);
   }
   multi_batch.pending_wb_cnt.fetch_sub(1, std::memory_order_acq_rel);
@@ -11,6 +11,7 @@
 #include <condition_variable>
 #include <cstdint>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <type_traits>
 #include <vector>
@@ -106,6 +107,9 @@ class WriteThread {
     Status status;
     std::atomic<size_t> running;
     size_t size = 0;
+    // Set by the leader if the parallel memtable writers also append their
+    // own batches to the WAL, instead of the leader writing the whole group.
+    bool parallel_wal_write = false;
 
     struct Iterator {
       Writer* writer;
@@ -136,7 +140,34 @@ class WriteThread {
   };
 
   struct MultiBatch {
+    // A range of records [begin, end) of `batch`, inserted into memtables as
+    // one unit of work. Any writer waiting in the commit queue can claim it.
+    struct SubBatch {
+      WriteBatch* batch;
+      size_t begin;
+      size_t end;
+      // Number of sequence numbers used by the records of `batch` before
+      // `begin`.
+      uint64_t seq_offset;
+      // Index of `batch` in `batches`.
+      size_t batch_index;
+    };
+
+    // Completion state of a batch that was split into several sub-batches.
+    struct BatchProgress {
+      // Sub-batches of the batch that have not finished inserting yet.
+      std::atomic<size_t> pending_slices{0};
+      std::atomic<bool> failed{false};
+    };
+
     std::vector<WriteBatch*> batches;
+    // Work items claimed by index through claimed_cnt. By default there is
+    // one sub-batch for each whole batch.
+    std::vector<SubBatch> sub_batches;
+    // One entry per batch in `batches`, only allocated when some batch was
+    // split. The post callback of a batch runs once all of its sub-batches
+    // have been inserted.
+    std::unique_ptr<BatchProgress[]> batch_progress;
     std::atomic<size_t> claimed_cnt;
     std::atomic<size_t> pending_wb_cnt;
     ColumnFamilySet* version_set;
@@ -154,15 +185,14 @@ class WriteThread {
           ignore_missing_column_families(false),
           db(nullptr) {}
 
-    explicit MultiBatch(std::vector<WriteBatch*>&& _batch)
-        : batches(_batch),
-          claimed_cnt(0),
-          pending_wb_cnt(_batch.size()),
-          version_set(nullptr),
-          flush_scheduler(nullptr),
-          trim_history_scheduler(nullptr),
-          ignore_missing_column_families(false),
-          db(nullptr) {}
+    explicit MultiBatch(std::vector<WriteBatch*>&& _batch);
+
+    // Splits every batch with more than `slice_size` records into sub-batches
+    // of `slice_size` records, so that a single large batch can be inserted
+    // by several writers. Batches with protection info or with transaction
+    // markers are kept whole. Must be called before the writer joins a batch
+    // group.
+    void SplitIntoSubBatches(size_t slice_size);
 
     void SetContext(ColumnFamilySet* _version_set,
                     FlushScheduler* _flush_scheduler,
@@ -375,7 +405,7 @@ class WriteThread {
 
     bool ConsumeOne() {
       auto claimed = Claim();
-      if (claimed < multi_batch.batches.size()) {
+      if (claimed < multi_batch.sub_batches.size()) {
         ConsumeOne(claimed);
         return true;
       }
@@ -12,6 +12,7 @@
 #include "file/filename.h"
 #include "port/port.h"
 #include "test_util/sync_point.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace encryption {
@@ -61,22 +62,49 @@ void PutBigEndian64(uint64_t value, unsigned char* buf) {
 // * SO answer for random access: https://stackoverflow.com/a/57147140/11014942
 // *
 // https://medium.com/@amit.kulkarni/encrypting-decrypting-a-file-using-openssl-evp-b26e0e4d28d4
-Status AESCTRCipherStream::Cipher(uint64_t file_offset, char* data,
-                                  size_t data_size, bool is_encrypt) {
-#if OPENSSL_VERSION_NUMBER < 0x01000200f
-  (void)file_offset;
-  (void)data;
-  (void)data_size;
-  (void)is_encrypt;
-  return Status::NotSupported("OpenSSL version < 1.0.2");
-#else
-  int ret = 1;
-  EVP_CIPHER_CTX* ctx = nullptr;
-  InitCipherContext(ctx);
+AESCTRCipherStream::~AESCTRCipherStream() {
+  for (EVP_CIPHER_CTX* ctx : ctx_pool_) {
+    EVP_CIPHER_CTX_free(ctx);
+  }
+}
+
+EVP_CIPHER_CTX* AESCTRCipherStream::AcquireContext() {
+  {
+    MutexLock l(&ctx_pool_mutex_);
+    if (!ctx_pool_.empty()) {
+      EVP_CIPHER_CTX* ctx = ctx_pool_.back();
+      ctx_pool_.pop_back();
+      return ctx;
+    }
+  }
+  EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
   if (ctx == nullptr) {
-    return Status::IOError("Failed to create cipher context.");
+    return nullptr;
   }
+  // Expand the key once. The IV is set by each CipherWithContext() call. CTR
+  // mode only uses the encryption key schedule, so the context is always
+  // initialized for encryption.
+  //
+  // Disable padding. Output size will always be equal to input size.
+  if (EVP_CipherInit_ex(ctx, cipher_, nullptr,
+                        reinterpret_cast<const unsigned char*>(key_.data()),
+                        nullptr, 1 /*enc*/) != 1 ||
+      EVP_CIPHER_CTX_set_padding(ctx, 0) != 1) {
+    EVP_CIPHER_CTX_free(ctx);
+    return nullptr;
+  }
+  return ctx;
+}
+
+void AESCTRCipherStream::ReleaseContext(EVP_CIPHER_CTX* ctx) {
+  assert(ctx != nullptr);
+  MutexLock l(&ctx_pool_mutex_);
+  ctx_pool_.push_back(ctx);
+}
 
+Status AESCTRCipherStream::CipherWithContext(EVP_CIPHER_CTX* ctx,
+                                             uint64_t file_offset, char* data,
+                                             size_t data_size) {
   const size_t block_size = BlockSize();
 
   uint64_t block_index = file_offset / block_size;
@@ -97,106 +125,97 @@ Status AESCTRCipherStream::Cipher(uint64_t file_offset, char* data,
   PutBigEndian64(iv_high, iv);
   PutBigEndian64(iv_low, iv + sizeof(uint64_t));
 
-  ret = EVP_CipherInit(ctx, cipher_,
-                       reinterpret_cast<const unsigned char*>(key_.data()), iv,
-                       (is_encrypt ? 1 : 0));
+  // Only reset the IV. Cipher and key set up in AcquireContext() are kept.
+  int ret = EVP_CipherInit_ex(ctx, nullptr, nullptr, nullptr, iv, -1);
   if (ret != 1) {
     return Status::IOError("Failed to init cipher.");
   }
 
-  // Disable padding. After disabling padding, data size should always be
-  // multiply of block size.
-  ret = EVP_CIPHER_CTX_set_padding(ctx, 0);
-  if (ret != 1) {
-    FreeCipherContext(ctx);
-    return Status::IOError("Failed to disable padding for cipher context.");
-  }
-
-  uint64_t data_offset = 0;
-  size_t remaining_data_size = data_size;
+  // OpenSSL runs CTR mode as a stream cipher, keeping track of the position
+  // inside the current key stream block, so data doesn't need to be a
+  // multiple of block size. For a partial block at the beginning, the key
+  // stream before `block_offset` is consumed and discarded first. The
+  // remaining data is then ciphered with a single call, in place.
   int output_size = 0;
-  unsigned char partial_block[block_size];
-
-  // In the following we assume EVP_CipherUpdate allow in and out buffer are
-  // the same, to save one memcpy. This is not specified in official man page.
-
-  // Handle partial block at the beginning. The parital block is copied to
-  // buffer to fake a full block.
   if (block_offset > 0) {
-    size_t partial_block_size =
-        std::min<size_t>(block_size - block_offset, remaining_data_size);
-    memcpy(partial_block + block_offset, data, partial_block_size);
-    ret = EVP_CipherUpdate(ctx, partial_block, &output_size, partial_block,
-                           static_cast<int>(block_size));
-    if (ret != 1) {
-      FreeCipherContext(ctx);
+    unsigned char skipped[block_size];
+    memset(skipped, 0, block_size);
+    ret = EVP_CipherUpdate(ctx, skipped, &output_size, skipped,
+                           static_cast<int>(block_offset));
+    if (ret != 1 || output_size != static_cast<int>(block_offset)) {
       return Status::IOError("Crypter failed for first block, offset " +
                              std::to_string(file_offset));
     }
-    if (output_size != static_cast<int>(block_size)) {
-      FreeCipherContext(ctx);
-      return Status::IOError(
-          "Unexpected crypter output size for first block, expected " +
-          std::to_string(block_size) + " vs actual " +
-          std::to_string(output_size));
-    }
-    memcpy(data, partial_block + block_offset, partial_block_size);
-    data_offset += partial_block_size;
-    remaining_data_size -= partial_block_size;
-  }
-
-  // Handle full blocks in the middle.
-  if (remaining_data_size >= block_size) {
-    size_t actual_data_size =
-        remaining_data_size - remaining_data_size % block_size;
-    unsigned char* full_blocks =
-        reinterpret_cast<unsigned char*>(data) + data_offset;
-    ret = EVP_CipherUpdate(ctx, full_blocks, &output_size, full_blocks,
-                           static_cast<int>(actual_data_size));
+  }
+
+  if (data_size > 0) {
+    unsigned char* buf = reinterpret_cast<unsigned char*>(data);
+    ret = EVP_CipherUpdate(ctx, buf, &output_size, buf,
+                           static_cast<int>(data_size));
     if (ret != 1) {
-      FreeCipherContext(ctx);
       return Status::IOError("Crypter failed at offset " +
-                             std::to_string(file_offset + data_offset));
+                             std::to_string(file_offset));
     }
-    if (output_size != static_cast<int>(actual_data_size)) {
-      FreeCipherContext(ctx);
+    if (output_size != static_cast<int>(data_size)) {
       return Status::IOError("Unexpected crypter output size, expected " +
-                             std::to_string(actual_data_size) + " vs actual " +
+                             std::to_string(data_size) + " vs actual " +
                              std::to_string(output_size));
     }
-    data_offset += actual_data_size;
-    remaining_data_size -= actual_data_size;
-  }
-
-  // Handle partial block at the end. The parital block is copied to buffer to
-  // fake a full block.
-  if (remaining_data_size > 0) {
-    assert(remaining_data_size < block_size);
-    memcpy(partial_block, data + data_offset, remaining_data_size);
-    ret = EVP_CipherUpdate(ctx, partial_block, &output_size, partial_block,
-                           static_cast<int>(block_size));
-    if (ret != 1) {
-      FreeCipherContext(ctx);
-      return Status::IOError("Crypter failed for last block, offset " +
-                             std::to_string(file_offset + data_offset));
-    }
-    if (output_size != static_cast<int>(block_size)) {
-      FreeCipherContext(ctx);
-      return Status::IOError(
-          "Unexpected crypter output size for last block, expected " +
-          std::to_string(block_size) + " vs actual " +
-          std::to_string(output_size));
-    }
-    memcpy(data + data_offset, partial_block, remaining_data_size);
   }
 
-  // Since padding is disabled, and the cipher flow always passes a multiply
-  // of block size data while each EVP_CipherUpdate, there is no need to call
-  // EVP_CipherFinal_ex to finish the last block cipher.
+  // Since padding is disabled and CTR mode never buffers input, there is no
+  // need to call EVP_CipherFinal_ex to finish the cipher.
   // Reference to the implement of EVP_CipherFinal_ex:
   // https://github.com/openssl/openssl/blob/OpenSSL_1_1_1-stable/crypto/evp/evp_enc.c#L219
-  FreeCipherContext(ctx);
   return Status::OK();
+}
+
+Status AESCTRCipherStream::Cipher(uint64_t file_offset, char* data,
+                                  size_t data_size) {
+#if OPENSSL_VERSION_NUMBER < 0x01000200f
+  (void)file_offset;
+  (void)data;
+  (void)data_size;
+  return Status::NotSupported("OpenSSL version < 1.0.2");
+#else
+  EVP_CIPHER_CTX* ctx = AcquireContext();
+  if (ctx == nullptr) {
+    return Status::IOError("Failed to create cipher context.");
+  }
+  Status s = CipherWithContext(ctx, file_offset, data, data_size);
+  if (s.ok()) {
+    ReleaseContext(ctx);
+  } else {
+    // Don't reuse a context left in an unknown state.
+    EVP_CIPHER_CTX_free(ctx);
+  }
+  return s;
+#endif
+}
+
+Status AESCTRCipherStream::DecryptMulti(CipherBuffer* buffers,
+                                        size_t num_buffers) {
+#if OPENSSL_VERSION_NUMBER < 0x01000200f
+  (void)buffers;
+  (void)num_buffers;
+  return Status::NotSupported("OpenSSL version < 1.0.2");
+#else
+  assert(buffers != nullptr || num_buffers == 0);
+  EVP_CIPHER_CTX* ctx = AcquireContext();
+  if (ctx == nullptr) {
+    return Status::IOError("Failed to create cipher context.");
+  }
+  Status s;
+  for (size_t i = 0; i < num_buffers && s.ok(); ++i) {
+    s = CipherWithContext(ctx, buffers[i].file_offset, buffers[i].data,
+                          buffers[i].data_size);
+  }
+  if (s.ok()) {
+    ReleaseContext(ctx);
+  } else {
+    EVP_CIPHER_CTX_free(ctx);
+  }
+  return s;
 #endif
 }
 
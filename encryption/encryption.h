@@ -6,7 +6,9 @@
 #include <openssl/evp.h>
 
 #include <string>
+#include <vector>
 
+#include "port/port.h"
 #include "rocksdb/encryption.h"
 #include "rocksdb/env_encryption.h"
 #include "util/string_util.h"
@@ -45,6 +47,10 @@ namespace encryption {
 // https://github.com/openssl/openssl/blob/OpenSSL_1_1_1-stable/include/crypto/sm4.h#L24
 #define SM4_BLOCK_SIZE 16
 
+// AESCTRCipherStream keeps a pool of cipher contexts with the key schedule
+// already set up. Each Cipher() call borrows a context and only resets its IV,
+// so concurrent readers of the same file don't pay for context creation and
+// key expansion on every block.
 class AESCTRCipherStream : public BlockAccessCipherStream {
  public:
   AESCTRCipherStream(const EVP_CIPHER* cipher, const std::string& key,
@@ -54,7 +60,7 @@ class AESCTRCipherStream : public BlockAccessCipherStream {
         initial_iv_high_(iv_high),
         initial_iv_low_(iv_low) {}
 
-  ~AESCTRCipherStream() = default;
+  ~AESCTRCipherStream();
 
   size_t BlockSize() override {
     // Openssl support SM4 after 1.1.1 release version.
@@ -66,14 +72,19 @@ class AESCTRCipherStream : public BlockAccessCipherStream {
     return AES_BLOCK_SIZE;  // 16
   }
 
+  // In CTR mode encryption and decryption are the same operation: XOR with
+  // the key stream.
   Status Encrypt(uint64_t file_offset, char* data, size_t data_size) override {
-    return Cipher(file_offset, data, data_size, true /*is_encrypt*/);
+    return Cipher(file_offset, data, data_size);
   }
 
   Status Decrypt(uint64_t file_offset, char* data, size_t data_size) override {
-    return Cipher(file_offset, data, data_size, false /*is_encrypt*/);
+    return Cipher(file_offset, data, data_size);
   }
 
+  // Decrypt all buffers with a single borrowed cipher context.
+  Status DecryptMulti(CipherBuffer* buffers, size_t num_buffers) override;
+
  protected:
   // Following methods required by BlockAccessCipherStream is unused.
 
@@ -93,13 +104,25 @@ class AESCTRCipherStream : public BlockAccessCipherStream {
   }
 
  private:
-  Status Cipher(uint64_t file_offset, char* data, size_t data_size,
-                bool is_encrypt);
+  Status Cipher(uint64_t file_offset, char* data, size_t data_size);
+
+  // Cipher `data` in place with a context previously returned by
+  // AcquireContext().
+  Status CipherWithContext(EVP_CIPHER_CTX* ctx, uint64_t file_offset,
+                           char* data, size_t data_size);
+
+  // Returns a cipher context with the key set up, or nullptr on failure. The
+  // context must be handed back with ReleaseContext().
+  EVP_CIPHER_CTX* AcquireContext();
+  void ReleaseContext(EVP_CIPHER_CTX* ctx);
 
   const EVP_CIPHER* cipher_;
   const std::string key_;
   const uint64_t initial_iv_high_;
   const uint64_t initial_iv_low_;
+
+  port::Mutex ctx_pool_mutex_;
+  std::vector<EVP_CIPHER_CTX*> ctx_pool_;
 };
 
 extern Status NewAESCTRCipherStream(
@@ -151,6 +151,41 @@ TEST_P(EncryptionTest, EncryptionTest) {
   EXPECT_TRUE(TestEncryption(16, 16 * 2, IV_OVERFLOW_FULL));
 }
 
+TEST_P(EncryptionTest, DecryptMulti) {
+  if (!std::get<0>(GetParam())) {
+    // DecryptMulti is decrypt only.
+    return;
+  }
+  GenerateCiphertext(IV_RANDOM);
+
+  EncryptionMethod method = std::get<1>(GetParam());
+  std::string key_str(reinterpret_cast<const char*>(KEY), KeySize(method));
+  std::string iv_str(reinterpret_cast<const char*>(IV_RANDOM), 16);
+  std::unique_ptr<AESCTRCipherStream> cipher_stream;
+  ASSERT_OK(NewAESCTRCipherStream(method, key_str, iv_str, &cipher_stream));
+
+  // Discontiguous ranges, out of order, with partial blocks at both ends.
+  const std::vector<std::pair<size_t, size_t>> ranges = {
+      {16 * 5 + 1, 16 * 8 + 15}, {0, 16}, {16 * 9 + 4, 16 * 9 + 5}, {17, 40}};
+  std::string data(reinterpret_cast<const char*>(ciphertext), MAX_SIZE);
+  std::vector<CipherBuffer> buffers;
+  for (const auto& range : ranges) {
+    buffers.push_back(
+        {range.first, &data[range.first], range.second - range.first});
+  }
+  // Run twice so that the second round reuses pooled cipher contexts.
+  for (int round = 0; round < 2; ++round) {
+    if (round == 1) {
+      data.assign(reinterpret_cast<const char*>(ciphertext), MAX_SIZE);
+    }
+    ASSERT_OK(cipher_stream->DecryptMulti(buffers.data(), buffers.size()));
+    for (const auto& range : ranges) {
+      ASSERT_EQ(0, memcmp(plaintext + range.first, data.data() + range.first,
+                          range.second - range.first));
+    }
+  }
+}
+
 // Openssl support SM4 after 1.1.1 release version.
 #if OPENSSL_VERSION_NUMBER < 0x1010100fL || defined(OPENSSL_NO_SM4)
 INSTANTIATE_TEST_CASE_P(
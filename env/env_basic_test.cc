@@ -360,6 +360,34 @@ TEST_P(EnvBasicTestWithParam, ReadWrite) {
   ASSERT_TRUE(rand_file->Read(1000, 5, &result, scratch).ok());
 }
 
+TEST_P(EnvBasicTestWithParam, MultiRead) {
+  std::unique_ptr<WritableFile> writable_file;
+  std::unique_ptr<RandomAccessFile> rand_file;
+
+  ASSERT_OK(env_->NewWritableFile(test_dir_ + "/f", &writable_file, soptions_));
+  ASSERT_OK(writable_file->Append("hello world"));
+  ASSERT_OK(writable_file->Close());
+  writable_file.reset();
+
+  ASSERT_OK(env_->NewRandomAccessFile(test_dir_ + "/f", &rand_file, soptions_));
+  const uint64_t offsets[] = {6, 0, 10, 1000};
+  const size_t lens[] = {5, 5, 100, 5};
+  const char* expected[] = {"world", "hello", "d", ""};
+  std::vector<std::string> scratches(4);
+  std::vector<ReadRequest> reqs(4);
+  for (size_t i = 0; i < reqs.size(); ++i) {
+    scratches[i].resize(lens[i]);
+    reqs[i].offset = offsets[i];
+    reqs[i].len = lens[i];
+    reqs[i].scratch = &scratches[i][0];
+  }
+  ASSERT_OK(rand_file->MultiRead(reqs.data(), reqs.size()));
+  for (size_t i = 0; i < reqs.size(); ++i) {
+    ASSERT_OK(reqs[i].status);
+    ASSERT_EQ(0, reqs[i].result.compare(expected[i]));
+  }
+}
+
 TEST_P(EnvBasicTestWithParam, Misc) {
   std::unique_ptr<WritableFile> writable_file;
   ASSERT_OK(env_->NewWritableFile(test_dir_ + "/b", &writable_file, soptions_));
@@ -10,6 +10,7 @@
 #include <cassert>
 #include <cctype>
 #include <iostream>
+#include <vector>
 
 #include "env/composite_env_wrapper.h"
 #include "env/env_encryption_ctr.h"
@@ -109,6 +110,40 @@ IOStatus EncryptedRandomAccessFile::Read(uint64_t offset, size_t n,
   return io_s;
 }
 
+IOStatus EncryptedRandomAccessFile::MultiRead(FSReadRequest* reqs,
+                                              size_t num_reqs,
+                                              const IOOptions& options,
+                                              IODebugContext* dbg) {
+  assert(reqs != nullptr);
+  for (size_t i = 0; i < num_reqs; ++i) {
+    reqs[i].offset += prefixLength_;
+  }
+  auto io_s = file_->MultiRead(reqs, num_reqs, options, dbg);
+  std::vector<CipherBuffer> buffers;
+  if (io_s.ok()) {
+    buffers.reserve(num_reqs);
+    for (size_t i = 0; i < num_reqs; ++i) {
+      const FSReadRequest& req = reqs[i];
+      if (req.status.ok() && req.result.size() > 0) {
+        buffers.push_back({req.offset, const_cast<char*>(req.result.data()),
+                           req.result.size()});
+      }
+    }
+  }
+  for (size_t i = 0; i < num_reqs; ++i) {
+    reqs[i].offset -= prefixLength_;
+  }
+  if (!io_s.ok() || buffers.empty()) {
+    return io_s;
+  }
+  {
+    PERF_TIMER_GUARD(decrypt_data_nanos);
+    io_s = status_to_io_status(
+        stream_->DecryptMulti(buffers.data(), buffers.size()));
+  }
+  return io_s;
+}
+
 IOStatus EncryptedRandomAccessFile::Prefetch(uint64_t offset, size_t n,
                                              const IOOptions& options,
                                              IODebugContext* dbg) {
@@ -859,6 +894,18 @@ Status BlockAccessCipherStream::Encrypt(uint64_t fileOffset, char* data,
   }
 }
 
+Status BlockAccessCipherStream::DecryptMulti(CipherBuffer* buffers,
+                                             size_t num_buffers) {
+  for (size_t i = 0; i < num_buffers; ++i) {
+    Status s = Decrypt(buffers[i].file_offset, buffers[i].data,
+                       buffers[i].data_size);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
 Status BlockAccessCipherStream::Decrypt(uint64_t fileOffset, char* data,
                                         size_t dataSize) {
   // Calculate block index
@@ -124,14 +124,55 @@ class InspectedRandomAccessFile : public RandomAccessFileWrapper {
     return s;
   }
 
-  // TODO: support parallel MultiRead
+  // Consults the inspector for the whole batch and forwards requests to the
+  // underlying file's MultiRead, so that parallel reads (e.g. io_uring) are
+  // preserved. When the inspector grants less than the batch size, the
+  // longest prefix of requests covered by the granted quota is issued first.
   Status MultiRead(ReadRequest* reqs, size_t num_reqs) override {
+    assert(inspector_);
     assert(reqs != nullptr);
+    size_t remaining = 0;
     for (size_t i = 0; i < num_reqs; ++i) {
-      ReadRequest& req = reqs[i];
-      req.status = Read(req.offset, req.len, &req.result, req.scratch);
+      remaining += reqs[i].len;
     }
-    return Status::OK();
+    Status s;
+    size_t granted = 0;
+    size_t next = 0;
+    while (next < num_reqs) {
+      size_t end = next;
+      size_t batch_bytes = 0;
+      while (end < num_reqs && batch_bytes + reqs[end].len <= granted) {
+        batch_bytes += reqs[end].len;
+        ++end;
+      }
+      if (end == next) {
+        size_t allowed = 0;
+        s = inspector_->Read(remaining - granted, &allowed);
+        if (!s.ok()) {
+          return s;
+        }
+        assert(allowed <= remaining - granted);
+        granted += allowed;
+        continue;
+      }
+      s = RandomAccessFileWrapper::MultiRead(reqs + next, end - next);
+      if (!s.ok()) {
+        return s;
+      }
+      for (size_t i = next; i < end; ++i) {
+        ReadRequest& req = reqs[i];
+        if (req.status.ok() && req.result.size() > 0 &&
+            req.result.data() != req.scratch) {
+          memmove(req.scratch, req.result.data(), req.result.size());
+          req.result = Slice(req.scratch, req.result.size());
+          assert(false);
+        }
+      }
+      granted -= batch_bytes;
+      remaining -= batch_bytes;
+      next = end;
+    }
+    return s;
   }
 
  private:
@@ -278,6 +278,184 @@ TEST_P(PrefetchTest, Basic) {
   Close();
 }
 
+// Verifies that with compaction_async_io, compaction reads its input through
+// the asynchronous prefetch path, even when the file system supports
+// Prefetch(), and the compaction output is correct.
+TEST_P(PrefetchTest, CompactionAsyncIO) {
+  bool support_prefetch =
+      std::get<0>(GetParam()) &&
+      test::IsPrefetchSupported(env_->GetFileSystem(), dbname_);
+  std::shared_ptr<MockFS> fs =
+      std::make_shared<MockFS>(env_->GetFileSystem(), support_prefetch);
+  bool use_direct_io = std::get<1>(GetParam());
+
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+  Options options;
+  SetGenericOptions(env.get(), use_direct_io, options);
+  options.compaction_async_io = true;
+  options.compaction_readahead_size = 16 * 1024;
+  options.rate_limiter.reset(NewGenericRateLimiter(
+      1 << 30 /* rate_bytes_per_sec */, 100 * 1000 /* refill_period_us */,
+      10 /* fairness */, RateLimiter::Mode::kReadsOnly));
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  const int kNumKeys = 1100;
+  for (int j = 0; j < 3; j++) {
+    WriteBatch batch;
+    for (int i = j; i < kNumKeys; i += 2) {
+      ASSERT_OK(batch.Put(BuildKey(i), "v" + std::to_string(j)));
+    }
+    ASSERT_OK(db_->Write(WriteOptions(), &batch));
+    ASSERT_OK(db_->Flush(FlushOptions()));
+  }
+
+  int async_prefetch_count = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "FilePrefetchBuffer::PrefetchAsyncInternal:Start",
+      [&](void*) { async_prefetch_count++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  TablePropertiesCollection input_props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&input_props));
+  uint64_t input_data_size = 0;
+  for (const auto& props : input_props) {
+    input_data_size += props.second->data_size;
+  }
+  const int64_t charged_before =
+      options.rate_limiter->GetTotalBytesThrough(Env::IO_LOW);
+
+  fs->ClearPrefetchCount();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(async_prefetch_count, 0);
+  // The asynchronous reads are charged to the rate limiter too.
+  ASSERT_GE(options.rate_limiter->GetTotalBytesThrough(Env::IO_LOW) -
+                charged_before,
+            static_cast<int64_t>(input_data_size));
+  if (support_prefetch && !use_direct_io) {
+    // Only the tail of the compaction output is prefetched through the file
+    // system.
+    ASSERT_LE(fs->GetPrefetchCount(), 1);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  {
+    auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ReadOptions()));
+    int num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      num_keys++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, num_keys);
+  }
+  ASSERT_EQ("v2", Get(BuildKey(2)));
+  ASSERT_EQ("v1", Get(BuildKey(1)));
+  Close();
+}
+
+// A file system that does not support ReadAsync.
+class NoAsyncIOFS : public FileSystemWrapper {
+ public:
+  explicit NoAsyncIOFS(const std::shared_ptr<FileSystem>& wrapped)
+      : FileSystemWrapper(wrapped) {}
+
+  static const char* kClassName() { return "NoAsyncIOFS"; }
+  const char* Name() const override { return kClassName(); }
+
+  void SupportedOps(int64_t& supported_ops) override {
+    target()->SupportedOps(supported_ops);
+    supported_ops &= ~(1 << FSSupportedOps::kAsyncIO);
+  }
+
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& opts,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override {
+    class NoAsyncIOFile : public FSRandomAccessFileOwnerWrapper {
+     public:
+      NoAsyncIOFile(std::unique_ptr<FSRandomAccessFile>&& file,
+                    std::atomic_int& read_async_count)
+          : FSRandomAccessFileOwnerWrapper(std::move(file)),
+            read_async_count_(read_async_count) {}
+
+      IOStatus ReadAsync(
+          FSReadRequest& /*req*/, const IOOptions& /*opts*/,
+          std::function<void(const FSReadRequest&, void*)> /*cb*/,
+          void* /*cb_arg*/, void** /*io_handle*/, IOHandleDeleter* /*del_fn*/,
+          IODebugContext* /*dbg*/) override {
+        read_async_count_.fetch_add(1);
+        return IOStatus::NotSupported("ReadAsync");
+      }
+
+     private:
+      std::atomic_int& read_async_count_;
+    };
+
+    std::unique_ptr<FSRandomAccessFile> file;
+    IOStatus s = target()->NewRandomAccessFile(fname, opts, &file, dbg);
+    if (s.ok()) {
+      result->reset(new NoAsyncIOFile(std::move(file), read_async_count_));
+    }
+    return s;
+  }
+
+  int GetReadAsyncCount() const { return read_async_count_.load(); }
+
+ private:
+  std::atomic_int read_async_count_{0};
+};
+
+TEST_P(PrefetchTest, CompactionAsyncIONotSupported) {
+  std::shared_ptr<NoAsyncIOFS> fs =
+      std::make_shared<NoAsyncIOFS>(env_->GetFileSystem());
+  bool use_direct_io = std::get<1>(GetParam());
+
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+  Options options;
+  SetGenericOptions(env.get(), use_direct_io, options);
+  options.compaction_async_io = true;
+  options.compaction_readahead_size = 16 * 1024;
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  const int kNumKeys = 1100;
+  for (int j = 0; j < 2; j++) {
+    WriteBatch batch;
+    for (int i = j; i < kNumKeys; i += 2) {
+      ASSERT_OK(batch.Put(BuildKey(i), "v" + std::to_string(j)));
+    }
+    ASSERT_OK(db_->Write(WriteOptions(), &batch));
+    ASSERT_OK(db_->Flush(FlushOptions()));
+  }
+
+  // Compaction reads synchronously instead of failing.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, fs->GetReadAsyncCount());
+  ASSERT_EQ("v0", Get(BuildKey(0)));
+  ASSERT_EQ("v1", Get(BuildKey(1)));
+  Close();
+}
+
 class PrefetchTailTest : public PrefetchTest {
  public:
   bool SupportPrefetch() const {
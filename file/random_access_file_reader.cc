@@ -506,6 +506,22 @@ IOStatus RandomAccessFileReader::ReadAsync(
                     (uintptr_t(req.scratch) & (alignment - 1)) == 0;
   read_async_info->is_aligned_ = is_aligned;
 
+  if (opts.rate_limiter_priority != Env::IO_TOTAL && rate_limiter_ != nullptr) {
+    // The whole request is charged before it is submitted, like in
+    // MultiRead().
+    size_t remaining_bytes = use_direct_io() && is_aligned == false
+                                 ? Align(req, alignment).len
+                                 : req.len;
+    while (remaining_bytes > 0) {
+      size_t request_bytes = std::min(
+          static_cast<size_t>(rate_limiter_->GetSingleBurstBytes()),
+          remaining_bytes);
+      rate_limiter_->Request(request_bytes, opts.rate_limiter_priority,
+                             nullptr /* stats */, RateLimiter::OpType::kRead);
+      remaining_bytes -= request_bytes;
+    }
+  }
+
   uint64_t elapsed = 0;
   if (use_direct_io() && is_aligned == false) {
     FSReadRequest aligned_req = Align(req, alignment);
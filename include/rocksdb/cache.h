@@ -15,10 +15,12 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/compression_type.h"
 #include "rocksdb/data_structure.h"
 #include "rocksdb/memory_allocator.h"
+#include "rocksdb/types.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -123,6 +125,36 @@ enum CacheMetadataChargePolicy {
 const CacheMetadataChargePolicy kDefaultCacheMetadataChargePolicy =
     kFullChargeCacheMetadata;
 
+// EXPERIMENTAL
+// Decides whether a new cache entry may displace the entry that a full
+// cache would evict to make room for it, so that entries accessed only once
+// (e.g. by a scan) do not flush frequently used ones. Entries are identified
+// by a hash of their key, computed by the cache. An instance may be shared by
+// all shards of a cache, so implementations must be thread-safe.
+class CacheAdmissionPolicy {
+ public:
+  virtual ~CacheAdmissionPolicy() = default;
+
+  virtual const char* Name() const = 0;
+
+  // Called on every Lookup() of the cache, whether the key is found or not.
+  virtual void RecordAccess(uint64_t key_hash) = 0;
+
+  // Returns true if the entry with `candidate_hash` should be inserted
+  // although that requires evicting the entry with `victim_hash`.
+  virtual bool Admit(uint64_t candidate_hash, uint64_t victim_hash) = 0;
+};
+
+// Creates a TinyLFU admission policy: the access frequency of keys is
+// estimated with a count-min sketch of 4-bit counters, which are periodically
+// halved so that the estimates follow changes of the working set, and a new
+// entry is only admitted if its key was accessed more often than the key of
+// the eviction victim. `expected_entries` sizes the sketch, about 8 bytes per
+// entry, and should be the typical number of entries in the cache, e.g. the
+// capacity divided by the block size.
+extern std::shared_ptr<CacheAdmissionPolicy> NewTinyLFUAdmissionPolicy(
+    size_t expected_entries);
+
 // Options shared betweeen various cache implementations that
 // divide the key space into shards using hashing.
 struct ShardedCacheOptions {
@@ -160,6 +192,17 @@ struct ShardedCacheOptions {
   // this option must be kept as default empty.
   std::shared_ptr<SecondaryCache> secondary_cache;
 
+  // EXPERIMENTAL
+  // If set, an insertion that requires an eviction only proceeds if the
+  // policy prefers the new entry over the eviction victim. A rejected entry
+  // is treated as if it was inserted and immediately evicted: a handle
+  // requested for it is still returned, but the entry is freed on release.
+  // Entries with Priority::HIGH, and inserts into a cache with
+  // strict_capacity_limit, bypass the policy. Currently only supported by
+  // LRUCache, and ignored by HyperClockCache, as clock eviction has no single
+  // eviction victim to compare with.
+  std::shared_ptr<CacheAdmissionPolicy> admission_policy;
+
   // See hash_seed comments below
   static constexpr int32_t kQuasiRandomHashSeed = -1;
   static constexpr int32_t kHostHashSeed = -2;
@@ -243,6 +286,28 @@ struct LRUCacheOptions : public ShardedCacheOptions {
   // -DROCKSDB_DEFAULT_TO_ADAPTIVE_MUTEX, false otherwise.
   bool use_adaptive_mutex = kDefaultToAdaptiveMutex;
 
+  // EXPERIMENTAL
+  // If non-empty, each shard keeps a separate LRU list per CacheCaller, and
+  // caller_quota_ratios[i] is the share of capacity reserved for the entries
+  // inserted by CacheCaller(i). Callers past the end of the vector reserve
+  // nothing. Valid values are between 0 and 1 (inclusive), and the sum of the
+  // values cannot exceed 1.
+  //
+  // When the cache is full, the entry to evict is the least recently used one
+  // of the caller that exceeds its quota by the most. A caller can borrow the
+  // capacity left unused by idle callers, and gives it back first once they
+  // need it. For example, with quotas of 0.6 for kPointLookup and 0.2 for
+  // kScan, a long scan can still use the whole cache while there are no point
+  // lookups, but only evicts its own blocks once the point lookups use their
+  // 60%.
+  //
+  // An entry stays charged to the caller that inserted it, even when other
+  // callers hit it. The high- and low-priority pools apply within the list of
+  // each caller, relative to its quota. Block-based tables set the caller from
+  // ReadOptions::cache_caller; other users of the cache insert as
+  // CacheCaller::kOther.
+  std::vector<double> caller_quota_ratios;
+
   LRUCacheOptions() {}
   LRUCacheOptions(size_t _capacity, int _num_shard_bits,
                   bool _strict_capacity_limit, double _high_pri_pool_ratio,
@@ -310,6 +375,23 @@ struct CompressedSecondaryCacheOptions : LRUCacheOptions {
   // (Filter blocks are essentially non-compressible but others usually are.)
   CacheEntryRoleSet do_not_compress_roles = {CacheEntryRole::kFilterBlock};
 
+  // EXPERIMENTAL
+  // Kinds of entries compressed with LZ4 rather than compression_type, as LZ4
+  // decompresses several times faster than e.g. ZSTD. Useful for entries
+  // whose promotion to the primary cache is on the critical path of reads,
+  // such as index blocks, while the bulk of data blocks uses a stronger
+  // compression_type. Ignored if LZ4 is not supported.
+  CacheEntryRoleSet fast_compression_roles;
+
+  // EXPERIMENTAL
+  // If non-zero and compression_type is kZSTD, a ZSTD dictionary of up to
+  // this many bytes is trained from the first entries compressed by the
+  // cache, and all later entries are compressed with it. Blocks are small
+  // and similar to each other, so a shared dictionary improves their
+  // compression ratio. The dictionary is trained once, from samples of about
+  // 100 times its size. Not supported with enable_custom_split_merge.
+  uint32_t max_dict_bytes = 0;
+
   CompressedSecondaryCacheOptions() {}
   CompressedSecondaryCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -549,7 +631,7 @@ struct TieredCacheOptions {
   double compressed_secondary_ratio = 0.0;
   // An optional secondary cache that will serve as the persistent cache
   // tier. If present, compressed blocks will be written to this
-  // secondary cache.
+  // secondary cache. See NewLocalFlashSecondaryCache().
   std::shared_ptr<SecondaryCache> nvm_sec_cache;
 };
 
@@ -27,6 +27,14 @@ std::shared_ptr<FileSystem> NewEncryptedFS(
     const std::shared_ptr<FileSystem>& base_fs,
     const std::shared_ptr<EncryptionProvider>& provider);
 
+// A buffer to be ciphered in place, located at `file_offset` in the file.
+// Used to batch multiple discontiguous buffers into one cipher call.
+struct CipherBuffer {
+  uint64_t file_offset = 0;
+  char* data = nullptr;
+  size_t data_size = 0;
+};
+
 // BlockAccessCipherStream is the base class for any cipher stream that
 // supports random access at block level (without requiring data from other
 // blocks). E.g. CTR (Counter operation mode) supports this requirement.
@@ -45,6 +53,11 @@ class BlockAccessCipherStream {
   // Length of data is given in dataSize.
   virtual Status Decrypt(uint64_t fileOffset, char* data, size_t dataSize);
 
+  // Decrypt a batch of discontiguous buffers. The default implementation
+  // calls Decrypt() on each buffer in turn; implementations may override it
+  // to amortize per-call setup across the batch.
+  virtual Status DecryptMulti(CipherBuffer* buffers, size_t num_buffers);
+
  protected:
   // Allocate scratch space which is passed to EncryptBlock/DecryptBlock.
   virtual void AllocateScratch(std::string&) = 0;
@@ -229,6 +242,9 @@ class EncryptedRandomAccessFile : public FSRandomAccessFile {
                 Slice* result, char* scratch,
                 IODebugContext* dbg) const override;
 
+  IOStatus MultiRead(FSReadRequest* reqs, size_t num_reqs,
+                     const IOOptions& options, IODebugContext* dbg) override;
+
   IOStatus Prefetch(uint64_t offset, size_t n, const IOOptions& options,
                     IODebugContext* dbg) override;
 
@@ -980,6 +980,19 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   size_t compaction_readahead_size = 2 * 1024 * 1024;
 
+  // If true, compaction reads its input files through the asynchronous
+  // prefetch path of ReadOptions::async_io: while the compaction consumes
+  // the current compaction_readahead_size / 2 bytes of a file, the next chunk
+  // is read into a second buffer with FileSystem::ReadAsync, so the merge
+  // does not stall on every readahead. Has no effect when
+  // compaction_readahead_size is 0. Compaction reads synchronously when the
+  // file system does not report FSSupportedOps::kAsyncIO in SupportedOps().
+  // The background reads are charged to `rate_limiter` before they are
+  // submitted.
+  //
+  // Default: false
+  bool compaction_async_io = false;
+
   // This is a maximum buffer size that is used by WinMmapReadableFile in
   // unbuffered disk I/O mode. We need to maintain an aligned buffer for
   // reads. We allow the buffer to grow until the specified value and then
@@ -1153,6 +1166,43 @@ struct DBOptions {
   // Default: false
   bool enable_multi_batch_write = false;
 
+  // Only used when enable_multi_batch_write is true. If non-zero, every
+  // WriteBatch passed to MultiBatchWrite with more than this many records is
+  // split into slices of this many records before joining the write group.
+  // Writers waiting for their turn to commit can claim slices of the front
+  // writer, so a single huge batch no longer leaves the other writers idle
+  // while its owner inserts it into the memtable alone.
+  //
+  // Batches with protection info or transaction markers are never split.
+  //
+  // Default: 0 (disabled)
+  size_t multi_batch_write_slice_size = 0;
+
+  // If greater than 1, every WAL is striped over this many files. Writers of
+  // a write group that is inserted into memtables in parallel append their
+  // own batches to the stripes concurrently, instead of the group leader
+  // writing the whole group to a single file. Recovery merges the records of
+  // all stripes by sequence number. Groups that need to sync the WAL still
+  // go through the leader, and the sync covers all stripes.
+  //
+  // As the unsynced tail of one stripe may be lost while later records of
+  // another survive, a sequence number missing from all the stripes is
+  // handled as a corrupted record according to wal_recovery_mode, and
+  // recovery does not replay the records after it except with
+  // kSkipAnyCorruptedRecords.
+  //
+  // Requires allow_concurrent_memtable_write, and is incompatible with
+  // enable_pipelined_write, unordered_write, two_write_queues,
+  // enable_multi_batch_write, allow_2pc, manual_wal_flush,
+  // recycle_log_file_num and track_and_verify_wals_in_manifest.
+  // DB::GetUpdatesSince() returns NotSupported when it is greater than 1.
+  //
+  // Only lower this value after all WAL files have been flushed, e.g. via
+  // `DB::Close()` with avoid_flush_during_shutdown=false.
+  //
+  // Default: 1
+  size_t num_wal_streams = 1;
+
   // If true, allow multi-writers to update mem tables in parallel.
   // Only some memtable_factory-s support concurrent writes; currently it
   // is implemented only for SkipListFactory.  Concurrent memtable writes
@@ -1296,6 +1346,15 @@ struct DBOptions {
   // versions regardless of the wal_compression settings.
   CompressionType wal_compression = kNoCompression;
 
+  // If non-zero and wal_compression is enabled, a compression dictionary of
+  // up to this many bytes is trained from the records written to the first
+  // WAL file, and then used for all later WAL files. Every WAL file stores
+  // the dictionary it is compressed with, right after its compression type
+  // record, so it can be read on its own. Values larger than 16KB are
+  // sanitized to 16KB, so the dictionary always fits in the first block.
+  // Requires ZSTD dictionary trainer support, otherwise ignored.
+  size_t wal_compression_dict_max_bytes = 0;
+
   // If true, RocksDB supports flushing multiple column families and committing
   // their results atomically to MANIFEST. Note that it is not
   // necessary to set atomic_flush to true if WAL is always enabled since WAL
@@ -1622,6 +1681,17 @@ struct ReadOptions {
   // block cache.
   bool fill_cache = true;
 
+  // EXPERIMENTAL
+  //
+  // The caller that blocks loaded into the block cache by this read are
+  // charged to, if the block cache is partitioned with
+  // `LRUCacheOptions::caller_quota_ratios`. With the default, kOther, the
+  // caller is derived from the operation: Get, MultiGet and GetEntity are
+  // point lookups, iterators are scans, and flush and compaction reads are
+  // compactions. Set it explicitly to tell apart reads of the same kind, e.g.
+  // kBackup for the iterators of a backup job.
+  CacheCaller cache_caller = CacheCaller::kOther;
+
   // If true, range tombstones handling will be skipped in key lookup paths.
   // For DB instances that don't use DeleteRange() calls, this setting can
   // be used to optimize the read performance.
@@ -2235,11 +2305,22 @@ struct MergeInstanceOptions {
   // Whether to merge memtable. WAL must be empty to perform a memtable merge.
   // Either write with disableWAL=true, or flush memtables before merge.
   bool merge_memtable = false;
+  // Only used when `merge_memtable` is true. Allows merging source DBs whose
+  // WAL is not empty. Their memtables are sealed and linked into the target
+  // as immutable memtables without copying. The target never replays the WAL
+  // of a source, so the merge waits for these memtables to be flushed by the
+  // target before returning. The memtables are then dropped from the sources,
+  // which no longer see their data. Background work of the sources is paused
+  // during the merge.
+  bool adopt_memtables_with_wal = false;
   // Whether or not writes to source DBs are still allowed after the merge.
   // Some optimizations are possible only with this flag set to false.
   bool allow_source_write = true;
   // No limit if negative.
   int max_preload_files = 16;
+  // Maximum number of threads, including the calling one, used to check the
+  // key ranges of source DBs and to link their table files.
+  int max_threads = 4;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
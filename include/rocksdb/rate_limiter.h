@@ -171,11 +171,20 @@ extern RateLimiter* NewGenericRateLimiter(
     RateLimiter::Mode mode = RateLimiter::Mode::kWritesOnly,
     bool auto_tuned = false);
 
+// Create a RateLimiter whose write limit is auto-tuned from the write
+// amplification of flush and compaction.
+// @read_rate_bytes_per_sec: when non-zero, background reads such as compaction
+// inputs are limited separately from writes, regardless of `mode`. The read
+// limit is tuned within `[read_rate_bytes_per_sec / 20,
+// read_rate_bytes_per_sec]`: it is lowered when the p99 latency of `Get`
+// recorded in the `Statistics` passed with the requests degrades, and raised
+// otherwise. Foreground reads are never throttled.
 extern RateLimiter* NewWriteAmpBasedRateLimiter(
     int64_t rate_bytes_per_sec, int64_t refill_period_us = 100 * 1000,
     int32_t fairness = 10,
     RateLimiter::Mode mode = RateLimiter::Mode::kWritesOnly,
     bool auto_tuned = false, int tune_per_sec = 1,
-    size_t smooth_window_size = 300, size_t recent_window_size = 30);
+    size_t smooth_window_size = 300, size_t recent_window_size = 30,
+    int64_t read_rate_bytes_per_sec = 0);
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -219,4 +219,38 @@ class SecondaryCacheWrapper : public SecondaryCache {
 // secondary cache, such as compressed blocks
 extern const Cache::CacheItemHelper kSliceCacheItemHelper;
 
+// EXPERIMENTAL
+// Options for a SecondaryCache on local flash, such as a NVMe drive in front
+// of slower network storage. Entries are appended to a sequence of cache
+// files, and located through an in-memory hash index. When the files exceed
+// the capacity, the oldest file is deleted along with all its entries.
+struct LocalFlashSecondaryCacheOptions {
+  // Directory of the cache files. It should be dedicated to this cache. The
+  // entries in the files left by a previous instance are recovered.
+  std::string path;
+
+  // Env whose FileSystem holds the cache files. Lookups use asynchronous
+  // reads if the FileSystem supports them (FSSupportedOps::kAsyncIO).
+  Env* env = Env::Default();
+
+  // Total size of the cache files.
+  uint64_t capacity = 0;
+
+  // Size of each cache file, which is also the unit of eviction. It should
+  // be a small fraction of the capacity.
+  uint64_t file_size = 64 << 20;
+
+  // Inserted entries are buffered in memory, and written to the current
+  // cache file once the buffer reaches this size.
+  size_t write_buffer_size = 1 << 20;
+};
+
+// EXPERIMENTAL
+// Create a SecondaryCache on local flash. It admits all entries inserted
+// into it, so it is meant to be used as TieredCacheOptions::nvm_sec_cache,
+// where TieredSecondaryCache decides what goes to the flash tier.
+extern Status NewLocalFlashSecondaryCache(
+    const LocalFlashSecondaryCacheOptions& opts,
+    std::shared_ptr<SecondaryCache>* result);
+
 }  // namespace ROCKSDB_NAMESPACE
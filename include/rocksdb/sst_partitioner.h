@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/customizable.h"
 #include "rocksdb/rocksdb_namespace.h"
@@ -62,6 +63,15 @@ class SstPartitioner {
   virtual bool CanDoTrivialMove(const Slice& smallest_user_key,
                                 const Slice& largest_user_key) = 0;
 
+  // Same as above, but also given the size of the file. Partitioners that
+  // merge small partitions into one file can use it to allow moving files
+  // that span a partition boundary.
+  virtual bool CanDoTrivialMoveWithSize(const Slice& smallest_user_key,
+                                        const Slice& largest_user_key,
+                                        uint64_t /*file_size*/) {
+    return CanDoTrivialMove(smallest_user_key, largest_user_key);
+  }
+
   struct Segment {
     Segment(uint64_t size_diff, Slice until)
         : size_in_this_segment(size_diff), segment_until_user_key(until) {}
@@ -180,4 +190,79 @@ class SstPartitionerFixedPrefixFactory : public SstPartitionerFactory {
 extern std::shared_ptr<SstPartitionerFactory>
 NewSstPartitionerFixedPrefixFactory(size_t prefix_len);
 
+struct SstPartitionerBoundariesOptions {
+  static const char* kName() { return "SstPartitionerBoundariesOptions"; }
+
+  // User keys at which a new partition starts, compared bytewise.
+  std::vector<std::string> boundaries;
+  // A boundary only cuts the output file once the file has reached this
+  // size, so that adjacent small partitions end up in a single file.
+  uint64_t min_file_size = 0;
+  // If non-zero, output files are also cut within a partition once they
+  // reach this size.
+  uint64_t target_file_size = 0;
+};
+
+/*
+ * Partitioner that splits the output SST files at user supplied boundaries
+ * while keeping their sizes balanced, see SstPartitionerBoundariesOptions.
+ */
+class SstPartitionerBoundaries : public SstPartitioner {
+ public:
+  // Only boundaries within (smallest_user_key, largest_user_key] are kept.
+  // Empty keys leave the corresponding side unbounded.
+  SstPartitionerBoundaries(const SstPartitionerBoundariesOptions& options,
+                           const Slice& smallest_user_key,
+                           const Slice& largest_user_key);
+
+  ~SstPartitionerBoundaries() override {}
+
+  const char* Name() const override { return "SstPartitionerBoundaries"; }
+
+  PartitionerResult ShouldPartition(const PartitionerRequest& request) override;
+
+  // Allows the move if the file lies within a single partition.
+  bool CanDoTrivialMove(const Slice& smallest_user_key,
+                        const Slice& largest_user_key) override;
+
+  // Also allows the move if the file spans several partitions but is smaller
+  // than `min_file_size`, which is what a compaction would have produced.
+  bool CanDoTrivialMoveWithSize(const Slice& smallest_user_key,
+                                const Slice& largest_user_key,
+                                uint64_t file_size) override;
+
+ private:
+  // Returns true if a boundary b satisfies prev_key < b <= key.
+  bool CrossesBoundary(const Slice& prev_key, const Slice& key) const;
+
+  std::vector<std::string> boundaries_;
+  uint64_t min_file_size_;
+  uint64_t target_file_size_;
+};
+
+/*
+ * Factory for size-balanced boundary partitioner.
+ */
+class SstPartitionerBoundariesFactory : public SstPartitionerFactory {
+ public:
+  explicit SstPartitionerBoundariesFactory(
+      const SstPartitionerBoundariesOptions& options);
+
+  ~SstPartitionerBoundariesFactory() override {}
+
+  static const char* kClassName() { return "SstPartitionerBoundariesFactory"; }
+  const char* Name() const override { return kClassName(); }
+
+  std::unique_ptr<SstPartitioner> CreatePartitioner(
+      const SstPartitioner::Context& context) const override;
+
+ private:
+  SstPartitionerBoundariesOptions options_;
+};
+
+extern std::shared_ptr<SstPartitionerFactory>
+NewSstPartitionerBoundariesFactory(std::vector<std::string> boundaries,
+                                   uint64_t min_file_size,
+                                   uint64_t target_file_size = 0);
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -537,6 +537,19 @@ enum Tickers : uint32_t {
   COMPRESSED_SECONDARY_CACHE_PROMOTIONS,
   COMPRESSED_SECONDARY_CACHE_PROMOTION_SKIPS,
 
+  // Bytes saved by WAL compression, i.e. uncompressed minus compressed size
+  // of the records written to the WAL.
+  WAL_COMPRESSION_BYTES_SAVED,
+  // Part of WAL_COMPRESSION_BYTES_SAVED of WAL files compressed with a
+  // dictionary, see DBOptions::wal_compression_dict_max_bytes.
+  WAL_COMPRESSION_DICT_BYTES_SAVED,
+
+  // Size of the values created from CompressedSecondaryCache hits, and the
+  // size that they were stored in. Their ratio is the effective capacity
+  // gain from compression for the entries that are actually used.
+  COMPRESSED_SECONDARY_CACHE_HIT_BYTES,
+  COMPRESSED_SECONDARY_CACHE_HIT_COMPRESSED_BYTES,
+
   TICKER_ENUM_MAX
 };
 
@@ -667,6 +680,10 @@ enum Histograms : uint32_t {
   // system's prefetch) from the end of SST table during block based table open
   TABLE_OPEN_PREFETCH_TAIL_READ_BYTES,
 
+  // Time to decompress and create the value of a CompressedSecondaryCache
+  // hit, i.e. the latency it adds to promoting an entry to the primary cache
+  COMPRESSED_SECONDARY_CACHE_HIT_MICROS,
+
   HISTOGRAM_ENUM_MAX
 };
 
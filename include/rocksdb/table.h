@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -32,6 +33,7 @@ namespace ROCKSDB_NAMESPACE {
 
 // -- Block-based Table
 class Cache;
+class CompressionWorkerPool;
 class FilterPolicy;
 class FlushBlockPolicyFactory;
 class PersistentCache;
@@ -232,6 +234,16 @@ struct BlockBasedTableOptions {
     // Makes the index significantly bigger (2x or more), especially when keys
     // are long.
     kBinarySearchWithFirstKey = 0x03,
+
+    // Like kBinarySearch, but the table also stores a piecewise-linear model
+    // that maps a key to the approximate position of its index entry, within
+    // a small error bound. Index seeks then binary search only the predicted
+    // range of the index block instead of the whole block. Best suited for
+    // large index blocks with fixed-width, evenly distributed keys (e.g.
+    // big-endian integers or timestamps). Requires BytewiseComparator and no
+    // user-defined timestamp; otherwise the model is not written and seeks
+    // fall back to kBinarySearch.
+    kLearnedSearch = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
@@ -248,6 +260,29 @@ struct BlockBasedTableOptions {
   // kDataBlockBinaryAndHash.
   double data_block_hash_table_util_ratio = 0.75;
 
+  // If true, data blocks that are too large for the data block hash index
+  // (more than 253 restart intervals or 64KiB) get a wide hash index instead
+  // of none, with 16-bit buckets and a secondary bucket per key to resolve
+  // most collisions. This keeps point lookups off the binary search for
+  // large block_size or small block_restart_interval. It is valid only when
+  // data_block_index_type is kDataBlockBinaryAndHash.
+  //
+  // Data blocks written with a wide hash index cannot be read by versions of
+  // RocksDB that do not support it.
+  bool data_block_hash_index_wide = false;
+
+  // If true, each data block also stores the first 8 bytes of every restart
+  // key in a fixed-width array after the restart array. Seeks within the block
+  // first search this compact array, which narrows the search down to the
+  // restart points sharing the target's prefix before any key is decoded.
+  // Costs 8 bytes per restart point, so it pays off most with small
+  // block_restart_interval or large blocks.
+  //
+  // Only takes effect with BytewiseComparator and no user-defined timestamps.
+  // Data blocks written with this option cannot be read by versions of
+  // RocksDB that do not support it.
+  bool data_block_restart_key_prefixes = false;
+
   // Option hash_index_allow_collision is now deleted.
   // It will behave as if hash_index_allow_collision=true.
 
@@ -269,6 +304,15 @@ struct BlockBasedTableOptions {
   // IF NULL, no page cache is used
   std::shared_ptr<PersistentCache> persistent_cache = nullptr;
 
+  // If non-NULL, table builders with CompressionOptions::parallel_threads > 1
+  // compress their data blocks on this pool instead of starting
+  // parallel_threads compression threads of their own. parallel_threads then
+  // only limits how many data blocks each builder has in flight. Sharing one
+  // pool among column families (and SstFileWriter) bounds the compression
+  // threads of all flushes and (sub)compactions together.
+  // See NewCompressionWorkerPool().
+  std::shared_ptr<CompressionWorkerPool> compression_worker_pool = nullptr;
+
   // Approximate size of user data packed per block.  Note that the
   // block size specified here corresponds to uncompressed data.  The
   // actual size of the unit read from disk may be smaller if
@@ -528,6 +572,14 @@ struct BlockBasedTableOptions {
   // Align data blocks on lesser of page size and block size
   bool block_align = false;
 
+  // If true, the range deletions of a table file are also stored in their
+  // fragmented form, in an additional meta block. Opening the file then
+  // restores the fragmented range deletions from it instead of fragmenting
+  // the range deletion block again, which saves CPU and latency for files
+  // with many range deletions. Files without the block, or written with
+  // user-defined timestamps, are read as before.
+  bool persist_fragmented_range_deletions = false;
+
   // This enum allows trading off increased index size for improved iterator
   // seek performance in some situations, particularly when block cache is
   // disabled (ReadOptions::fill_cache = false) and direct IO is
@@ -677,6 +729,30 @@ struct BlockBasedTablePropertyNames {
 extern TableFactory* NewBlockBasedTableFactory(
     const BlockBasedTableOptions& table_options = BlockBasedTableOptions());
 
+// A pool of threads that block-based table builders hand their data blocks
+// to for compression. See BlockBasedTableOptions::compression_worker_pool.
+class CompressionWorkerPool {
+ public:
+  virtual ~CompressionWorkerPool() {}
+
+  // Runs `task` on one of the pool's threads. `charge` is the number of bytes
+  // of memory the task holds until it has run. Blocks the caller while
+  // accepting the task would exceed the pool's in-flight memory limit.
+  virtual void Submit(std::function<void()>&& task, size_t charge) = 0;
+
+  virtual int GetNumThreads() const = 0;
+
+  // Returns the total charge of the tasks that are queued or running.
+  virtual size_t GetInflightBytes() const = 0;
+};
+
+// Creates a CompressionWorkerPool with `num_threads` threads. Each thread has
+// its own task queue, and idle threads steal tasks from the queues of busy
+// ones. Submit() blocks while tasks with a total charge of more than
+// `max_inflight_bytes` are queued or running; 0 means no limit. A task is
+// always accepted when nothing else is in flight.
+extern std::shared_ptr<CompressionWorkerPool> NewCompressionWorkerPool(
+    int num_threads, size_t max_inflight_bytes = 64 << 20);
 
 enum EncodingType : char {
   // Always write full keys without any special encoding.
@@ -40,6 +40,19 @@ enum class BlobFileCreationReason {
   kRecovery,
 };
 
+// The kinds of reads that load blocks into the block cache. An LRUCache can
+// reserve a share of its capacity for each of them; see
+// LRUCacheOptions::caller_quota_ratios.
+enum class CacheCaller : uint8_t {
+  // Reads not attributed to any of the callers below, e.g. on DB open.
+  kOther = 0,
+  kPointLookup,
+  kScan,
+  kCompaction,
+  kBackup,
+  kNumCallers,  // Keep last
+};
+
 // The types of files RocksDB uses in a DB directory. (Available for
 // advanced options.)
 enum FileType {
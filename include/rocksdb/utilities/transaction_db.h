@@ -162,6 +162,16 @@ struct TransactionDBOptions {
   // separate mutex.
   size_t num_stripes = 16;
 
+  // EXPERIMENTAL
+  // If positive, each lock table stripe also gets this many slots of a
+  // lock-free table. A transaction without expiration then takes an
+  // uncontended exclusive lock on a key of up to 55 bytes, and releases it,
+  // with a single compare-and-swap on the slot of the key instead of taking
+  // the stripe mutex. Shared locks, and the keys of a slot that is taken or
+  // has waiters, use the stripe mutex as before. Ignored if max_num_locks is
+  // positive.
+  size_t fast_lock_slots_per_stripe = 0;
+
   // If positive, specifies the default wait timeout in milliseconds when
   // a transaction attempts to lock a key if not specified by
   // TransactionOptions::lock_timeout.
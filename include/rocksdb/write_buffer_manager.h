@@ -17,6 +17,8 @@
 #include <cstddef>
 #include <list>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "rocksdb/cache.h"
 
@@ -24,6 +26,7 @@ namespace ROCKSDB_NAMESPACE {
 class CacheReservationManager;
 class DB;
 class ColumnFamilyHandle;
+class SystemClock;
 
 // Interface to block and signal DB instances, intended for RocksDB
 // internal use only. Each DB instance contains ptr to StallInterface.
@@ -38,6 +41,65 @@ class StallInterface {
 
 class WriteBufferManager final {
  public:
+  // How a column family is picked to be frozen and flushed when `flush_size`
+  // is exceeded.
+  enum class FlushPolicy : uint8_t {
+    // Freeze the largest mutable memtable.
+    kLargestFirst,
+    // Freeze the mutable memtable with the oldest key.
+    kOldestFirst,
+    // Every registered column family gets a soft quota, which is its share of
+    // `flush_size` according to the weight of its DB (see `SetDBWeight`) and
+    // its own weight among the column families of that DB (see
+    // `SetColumnFamilyWeight`). Candidates are scored by their memory usage
+    // relative to their quota, boosted by their recent write rate and, mildly,
+    // by the age of their memtable. A rarely written column family below its
+    // quota is therefore unlikely to be flushed because of another busy one.
+    kWeightedQuota,
+  };
+
+  // Memory usage of one registered column family.
+  struct ConsumerStats {
+    DB* db = nullptr;
+    ColumnFamilyHandle* cf = nullptr;
+    // Approximate memory used by the mutable memtable.
+    uint64_t memory_usage = 0;
+    // Time of the oldest key in the mutable memtable, in seconds of the
+    // clock of the DB, as reported by `DB::GetApproximateActiveMemTableStats`.
+    uint64_t oldest_key_time = 0;
+    // Share of `flush_size` assigned by the weights. Only meaningful when
+    // `flush_size` is non-zero.
+    uint64_t soft_quota = 0;
+    // Weight of the DB and of the column family inside the DB.
+    double db_weight = 1.0;
+    double cf_weight = 1.0;
+    // Smoothed growth rate of the mutable memtable in bytes per second,
+    // sampled whenever flush victims are picked or stats are queried.
+    uint64_t write_rate = 0;
+  };
+
+  // State of predictive flush triggering, see `SetPredictiveFlush`. The limit
+  // is the stall size when stall is enabled, `flush_size` otherwise.
+  struct FlushPredictionStats {
+    // Smoothed rate at which memtable memory is reserved, in bytes per second.
+    uint64_t allocation_rate = 0;
+    // Smoothed rate at which flushes release memtable memory, in bytes per
+    // second. Only sampled while there is memory waiting to be flushed.
+    uint64_t flush_rate = 0;
+    // Mutable memtable usage at which a flush is triggered. Equals
+    // `flush_size` when predictive flush is disabled or has no data yet.
+    uint64_t trigger_size = 0;
+    // Time for the total memory usage to reach the limit at the current
+    // rates. Zero if the usage is not expected to grow.
+    uint64_t predicted_time_to_limit_micros = 0;
+    // The prediction made when the usage last started growing towards the
+    // limit, and how long it actually took to reach it.
+    uint64_t last_predicted_time_to_limit_micros = 0;
+    uint64_t last_actual_time_to_limit_micros = 0;
+    // Number of times the total memory usage reached the limit.
+    uint64_t limit_reached_count = 0;
+  };
+
   // Parameters:
   // - flush_size: When the total size of mutable memtables exceeds this limit,
   // the largest one will be frozen and scheduled for flush. Disabled when 0.
@@ -54,15 +116,21 @@ class WriteBufferManager final {
   //
   // - flush_oldest_first: By default we freeze the largest mutable memtable
   // when `flush_size` is triggered. By enabling this flag, the oldest mutable
-  // memtable will be frozen instead.
+  // memtable will be frozen instead. See also `SetFlushPolicy`.
   //
   // - cache: if `cache` is provided, memtable memory will be charged as a
   // dummy entry This is useful to keep the memory sum of both memtable and
   // block cache under control.
+  //
+  // - clock: used for the write rates of `FlushPolicy::kWeightedQuota` and,
+  // unless another one is given to `SetPredictiveFlush`, for predictive
+  // flush. `SystemClock::Default()` if not provided. Memtable ages are
+  // measured with the clock of the DB that owns the memtable instead.
   explicit WriteBufferManager(size_t flush_size,
                               std::shared_ptr<Cache> cache = {},
                               float stall_ratio = 0.0,
-                              bool flush_oldest_first = false);
+                              bool flush_oldest_first = false,
+                              std::shared_ptr<SystemClock> clock = nullptr);
   // No copying allowed
   WriteBufferManager(const WriteBufferManager&) = delete;
   WriteBufferManager& operator=(const WriteBufferManager&) = delete;
@@ -98,9 +166,45 @@ class WriteBufferManager final {
   void SetFlushSize(size_t new_size);
 
   void SetFlushOldestFirst(bool v) {
-    flush_oldest_first_.store(v, std::memory_order_relaxed);
+    SetFlushPolicy(v ? FlushPolicy::kOldestFirst : FlushPolicy::kLargestFirst);
+  }
+
+  void SetFlushPolicy(FlushPolicy policy) {
+    flush_policy_.store(policy, std::memory_order_relaxed);
   }
 
+  FlushPolicy flush_policy() const {
+    return flush_policy_.load(std::memory_order_relaxed);
+  }
+
+  // Sets the weight of `db` when dividing `flush_size` into soft quotas. All
+  // DBs have a weight of 1 by default. Only used by
+  // `FlushPolicy::kWeightedQuota`. `weight` must be positive.
+  void SetDBWeight(DB* db, double weight);
+
+  // Sets the weight of column family `cf` when dividing the quota of its DB.
+  // All column families have a weight of 1 by default. Only used by
+  // `FlushPolicy::kWeightedQuota`. `weight` must be positive.
+  void SetColumnFamilyWeight(ColumnFamilyHandle* cf, double weight);
+
+  // Returns memory usage, soft quota and write rate of every registered
+  // column family.
+  void GetConsumerStats(std::vector<ConsumerStats>* stats);
+
+  // When enabled, the recent allocation rate and flush throughput are used to
+  // trigger flushes before mutable memtables reach `flush_size`, early enough
+  // that the memory allocated while flushes catch up stays below the limit.
+  // The trigger is lowered, but never below half of `flush_size`. `clock` is
+  // used for sampling the rates, the clock of the manager if not provided.
+  void SetPredictiveFlush(bool enabled,
+                          std::shared_ptr<SystemClock> clock = nullptr);
+
+  bool predictive_flush() const {
+    return predictive_flush_.load(std::memory_order_relaxed);
+  }
+
+  void GetFlushPredictionStats(FlushPredictionStats* stats);
+
   // Below functions should be called by RocksDB internally.
 
   // This handle is the same as the one created by `DB::Open` or
@@ -142,6 +246,12 @@ class WriteBufferManager final {
   // Whether the DB writer should call `MaybeFlush` before write.
   bool ShouldFlush() {
     size_t local_size = flush_size();
+    if (local_size > 0 && predictive_flush()) {
+      size_t trigger_size = trigger_size_.load(std::memory_order_relaxed);
+      if (trigger_size > 0 && trigger_size < local_size) {
+        local_size = trigger_size;
+      }
+    }
     return local_size > 0 && mutable_memtable_memory_usage() >= local_size;
   }
 
@@ -184,9 +294,17 @@ class WriteBufferManager final {
   struct WriteBufferSentinel {
     DB* db;
     ColumnFamilyHandle* cf;
+    double weight = 1.0;
+    // Used to estimate the write rate.
+    uint64_t last_memory_bytes = 0;
+    uint64_t last_sample_micros = 0;
+    double write_rate = 0;
   };
+  const std::shared_ptr<SystemClock> clock_;
   // Protected by `sentinels_mu_`.
   std::list<std::shared_ptr<WriteBufferSentinel>> sentinels_;
+  // Weights set by `SetDBWeight`. Protected by `sentinels_mu_`.
+  std::unordered_map<DB*, double> db_weights_;
   std::mutex sentinels_mu_;
 
   // Shared by flush_size limit and cache charging.
@@ -196,7 +314,7 @@ class WriteBufferManager final {
   std::atomic<size_t> flush_size_;
   // Only used when flush_size is non-zero.
   std::atomic<size_t> memory_active_;
-  std::atomic<bool> flush_oldest_first_;
+  std::atomic<FlushPolicy> flush_policy_;
 
   const bool allow_stall_;
   const float stall_ratio_;
@@ -212,7 +330,37 @@ class WriteBufferManager final {
   // Protects cache_res_mgr_
   std::mutex cache_res_mgr_mu_;
 
+  std::atomic<bool> predictive_flush_;
+  // Early flush trigger computed by predictive flush, 0 if not available.
+  std::atomic<size_t> trigger_size_;
+  // Cumulative bytes reserved and freed, only counted when predictive flush
+  // is enabled.
+  std::atomic<uint64_t> total_reserved_;
+  std::atomic<uint64_t> total_freed_;
+  // Protects the fields below.
+  std::mutex prediction_mu_;
+  std::shared_ptr<SystemClock> prediction_clock_;
+  uint64_t last_sample_micros_ = 0;
+  uint64_t last_reserved_ = 0;
+  uint64_t last_freed_ = 0;
+  double allocation_rate_ = 0;
+  double flush_rate_ = 0;
+  bool limit_reached_ = false;
+  // Start and predicted length of the current run towards the limit.
+  uint64_t growth_start_micros_ = 0;
+  uint64_t growth_predicted_micros_ = 0;
+  FlushPredictionStats prediction_stats_;
+
   void ReserveMemWithCache(size_t mem);
   void FreeMemWithCache(size_t mem);
+
+  // Resamples the rates and recomputes the early flush trigger, at most once
+  // per sampling interval unless the limit has just been reached or left.
+  void MaybeUpdatePrediction();
+  void UpdatePredictionLocked(uint64_t now);
+
+  // Samples the memtable of every sentinel, updates their write rates and
+  // fills `stats` in the order of `sentinels_`. Requires `sentinels_mu_`.
+  void CollectConsumerStatsLocked(std::vector<ConsumerStats>* stats);
 };
 }  // namespace ROCKSDB_NAMESPACE
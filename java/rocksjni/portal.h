@@ -5184,6 +5184,15 @@ class TickerTypeJni {
       case ROCKSDB_NAMESPACE::Tickers::
           COMPRESSED_SECONDARY_CACHE_PROMOTION_SKIPS:
         return -0x46;
+      case ROCKSDB_NAMESPACE::Tickers::WAL_COMPRESSION_BYTES_SAVED:
+        return -0x47;
+      case ROCKSDB_NAMESPACE::Tickers::WAL_COMPRESSION_DICT_BYTES_SAVED:
+        return -0x48;
+      case ROCKSDB_NAMESPACE::Tickers::COMPRESSED_SECONDARY_CACHE_HIT_BYTES:
+        return -0x49;
+      case ROCKSDB_NAMESPACE::Tickers::
+          COMPRESSED_SECONDARY_CACHE_HIT_COMPRESSED_BYTES:
+        return -0x4A;
       case ROCKSDB_NAMESPACE::Tickers::TICKER_ENUM_MAX:
         // 0x5F was the max value in the initial copy of tickers to Java.
         // Since these values are exposed directly to Java clients, we keep
@@ -5570,6 +5579,15 @@ class TickerTypeJni {
       case -0x46:
         return ROCKSDB_NAMESPACE::Tickers::
             COMPRESSED_SECONDARY_CACHE_PROMOTION_SKIPS;
+      case -0x47:
+        return ROCKSDB_NAMESPACE::Tickers::WAL_COMPRESSION_BYTES_SAVED;
+      case -0x48:
+        return ROCKSDB_NAMESPACE::Tickers::WAL_COMPRESSION_DICT_BYTES_SAVED;
+      case -0x49:
+        return ROCKSDB_NAMESPACE::Tickers::COMPRESSED_SECONDARY_CACHE_HIT_BYTES;
+      case -0x4A:
+        return ROCKSDB_NAMESPACE::Tickers::
+            COMPRESSED_SECONDARY_CACHE_HIT_COMPRESSED_BYTES;
       case 0x5F:
         // 0x5F was the max value in the initial copy of tickers to Java.
         // Since these values are exposed directly to Java clients, we keep
@@ -5716,6 +5734,8 @@ class HistogramTypeJni {
       case ROCKSDB_NAMESPACE::Histograms::
           FILE_READ_VERIFY_FILE_CHECKSUMS_MICROS:
         return 0x41;
+      case ROCKSDB_NAMESPACE::Histograms::COMPRESSED_SECONDARY_CACHE_HIT_MICROS:
+        return 0x42;
       case ROCKSDB_NAMESPACE::Histograms::HISTOGRAM_ENUM_MAX:
         // 0x1F for backwards compatibility on current minor version.
         return 0x1F;
@@ -5853,6 +5873,9 @@ class HistogramTypeJni {
       case 0x41:
         return ROCKSDB_NAMESPACE::Histograms::
             FILE_READ_VERIFY_FILE_CHECKSUMS_MICROS;
+      case 0x42:
+        return ROCKSDB_NAMESPACE::Histograms::
+            COMPRESSED_SECONDARY_CACHE_HIT_MICROS;
       case 0x1F:
         // 0x1F for backwards compatibility on current minor version.
         return ROCKSDB_NAMESPACE::Histograms::HISTOGRAM_ENUM_MAX;
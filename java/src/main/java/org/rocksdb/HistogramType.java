@@ -185,6 +185,8 @@ public enum HistogramType {
 
   FILE_READ_VERIFY_FILE_CHECKSUMS_MICROS((byte) 0x41),
 
+  COMPRESSED_SECONDARY_CACHE_HIT_MICROS((byte) 0x42),
+
   // 0x1F for backwards compatibility on current minor version.
   HISTOGRAM_ENUM_MAX((byte) 0x1F);
 
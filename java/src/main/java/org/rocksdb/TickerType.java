@@ -776,6 +776,22 @@ public enum TickerType {
 
     PREFETCH_HITS((byte) -0x42),
 
+    COMPRESSED_SECONDARY_CACHE_DUMMY_HITS((byte) -0x43),
+
+    COMPRESSED_SECONDARY_CACHE_HITS((byte) -0x44),
+
+    COMPRESSED_SECONDARY_CACHE_PROMOTIONS((byte) -0x45),
+
+    COMPRESSED_SECONDARY_CACHE_PROMOTION_SKIPS((byte) -0x46),
+
+    WAL_COMPRESSION_BYTES_SAVED((byte) -0x47),
+
+    WAL_COMPRESSION_DICT_BYTES_SAVED((byte) -0x48),
+
+    COMPRESSED_SECONDARY_CACHE_HIT_BYTES((byte) -0x49),
+
+    COMPRESSED_SECONDARY_CACHE_HIT_COMPRESSED_BYTES((byte) -0x4A),
+
     TICKER_ENUM_MAX((byte) 0x5F);
 
     private final byte value;
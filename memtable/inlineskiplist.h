@@ -137,6 +137,18 @@ class InlineSkipList {
   template <bool UseCAS>
   bool Insert(const char* key, Splice* splice, bool allow_partial_splice_fix);
 
+  // Maps a key to an integer such that key_prefix(a) < key_prefix(b) implies
+  // a < b, e.g. the leading 8 bytes of a bytewise ordered key read as a
+  // big-endian integer.
+  using KeyPrefixFunc = uint64_t (*)(const DecodedKey& key);
+
+  // Caches key_prefix(key) in 8 bytes in front of every key, so that searches
+  // mostly compare two integers and only call the comparator for keys that
+  // share the same prefix. This pays off when keys are long or the comparator
+  // is expensive, and costs 8 bytes per entry.
+  // REQUIRES: no key has been allocated yet.
+  void EnableKeyPrefixCache(KeyPrefixFunc key_prefix);
+
   // Returns true iff an entry that compares equal to key is in the list.
   bool Contains(const char* key) const;
 
@@ -205,6 +217,10 @@ class InlineSkipList {
   // Immutable after construction
   Comparator const compare_;
   Node* const head_;
+  // Non-null if the prefix cache is enabled, in which case key_offset_ bytes
+  // in front of every key hold the cached prefix.
+  KeyPrefixFunc key_prefix_;
+  size_t key_offset_;
 
   // Modified only by Insert().  Read racily by readers, but stale
   // values are ok.
@@ -223,6 +239,30 @@ class InlineSkipList {
 
   Node* AllocateNode(size_t key_size, int height);
 
+  const char* NodeKey(const Node* n) const { return n->Key() + key_offset_; }
+
+  Node* KeyToNode(const char* key) const {
+    return reinterpret_cast<Node*>(const_cast<char*>(key) - key_offset_) - 1;
+  }
+
+  uint64_t GetKeyPrefix(const DecodedKey& key) const {
+    return key_prefix_ != nullptr ? key_prefix_(key) : 0;
+  }
+
+  // Compares the key of "n" with key, whose prefix is key_prefix. The cached
+  // prefix of "n" decides the order unless both prefixes are equal.
+  int CompareNode(const Node* n, const DecodedKey& key,
+                  uint64_t key_prefix) const {
+    if (key_prefix_ != nullptr) {
+      uint64_t node_prefix;
+      memcpy(&node_prefix, n->Key(), sizeof(node_prefix));
+      if (node_prefix != key_prefix) {
+        return node_prefix < key_prefix ? -1 : 1;
+      }
+    }
+    return compare_(NodeKey(n), key);
+  }
+
   bool Equal(const char* a, const char* b) const {
     return (compare_(a, b) == 0);
   }
@@ -235,6 +275,8 @@ class InlineSkipList {
   // is considered infinite.  n should not be head_.
   bool KeyIsAfterNode(const char* key, Node* n) const;
   bool KeyIsAfterNode(const DecodedKey& key, Node* n) const;
+  bool KeyIsAfterNode(const DecodedKey& key, uint64_t key_prefix,
+                      Node* n) const;
 
   // Returns the earliest node with a key >= key.
   // Return nullptr if there is no such node.
@@ -267,13 +309,14 @@ class InlineSkipList {
   // a node that is after the key.  after should be nullptr if a good after
   // node isn't conveniently available.
   template <bool prefetch_before>
-  void FindSpliceForLevel(const DecodedKey& key, Node* before, Node* after,
-                          int level, Node** out_prev, Node** out_next);
+  void FindSpliceForLevel(const DecodedKey& key, uint64_t key_prefix,
+                          Node* before, Node* after, int level,
+                          Node** out_prev, Node** out_next);
 
   // Recomputes Splice levels from highest_level (inclusive) down to
   // lowest_level (inclusive).
-  void RecomputeSpliceLevels(const DecodedKey& key, Splice* splice,
-                             int recompute_level);
+  void RecomputeSpliceLevels(const DecodedKey& key, uint64_t key_prefix,
+                             Splice* splice, int recompute_level);
 };
 
 // Implementation details follow
@@ -383,7 +426,7 @@ inline bool InlineSkipList<Comparator>::Iterator::Valid() const {
 template <class Comparator>
 inline const char* InlineSkipList<Comparator>::Iterator::key() const {
   assert(Valid());
-  return node_->Key();
+  return list_->NodeKey(node_);
 }
 
 template <class Comparator>
@@ -397,7 +440,7 @@ inline void InlineSkipList<Comparator>::Iterator::Prev() {
   // Instead of using explicit "prev" links, we just search for the
   // last node that falls before key.
   assert(Valid());
-  node_ = list_->FindLessThan(node_->Key());
+  node_ = list_->FindLessThan(list_->NodeKey(node_));
   if (node_ == list_->head_) {
     node_ = nullptr;
   }
@@ -459,7 +502,7 @@ bool InlineSkipList<Comparator>::KeyIsAfterNode(const char* key,
                                                 Node* n) const {
   // nullptr n is considered infinite
   assert(n != head_);
-  return (n != nullptr) && (compare_(n->Key(), key) < 0);
+  return (n != nullptr) && (compare_(NodeKey(n), key) < 0);
 }
 
 template <class Comparator>
@@ -467,7 +510,16 @@ bool InlineSkipList<Comparator>::KeyIsAfterNode(const DecodedKey& key,
                                                 Node* n) const {
   // nullptr n is considered infinite
   assert(n != head_);
-  return (n != nullptr) && (compare_(n->Key(), key) < 0);
+  return (n != nullptr) && (compare_(NodeKey(n), key) < 0);
+}
+
+template <class Comparator>
+bool InlineSkipList<Comparator>::KeyIsAfterNode(const DecodedKey& key,
+                                                uint64_t key_prefix,
+                                                Node* n) const {
+  // nullptr n is considered infinite
+  assert(n != head_);
+  return (n != nullptr) && (CompareNode(n, key, key_prefix) < 0);
 }
 
 template <class Comparator>
@@ -482,18 +534,19 @@ InlineSkipList<Comparator>::FindGreaterOrEqual(const char* key) const {
   int level = GetMaxHeight() - 1;
   Node* last_bigger = nullptr;
   const DecodedKey key_decoded = compare_.decode_key(key);
+  const uint64_t key_prefix = GetKeyPrefix(key_decoded);
   while (true) {
     Node* next = x->Next(level);
     if (next != nullptr) {
       PREFETCH(next->Next(level), 0, 1);
     }
     // Make sure the lists are sorted
-    assert(x == head_ || next == nullptr || KeyIsAfterNode(next->Key(), x));
+    assert(x == head_ || next == nullptr || KeyIsAfterNode(NodeKey(next), x));
     // Make sure we haven't overshot during our search
     assert(x == head_ || KeyIsAfterNode(key_decoded, x));
     int cmp = (next == nullptr || next == last_bigger)
                   ? 1
-                  : compare_(next->Key(), key_decoded);
+                  : CompareNode(next, key_decoded, key_prefix);
     if (cmp == 0 || (cmp > 0 && level == 0)) {
       return next;
     } else if (cmp < 0) {
@@ -524,15 +577,17 @@ InlineSkipList<Comparator>::FindLessThan(const char* key, Node** prev,
   // KeyIsAfter(key, last_not_after) is definitely false
   Node* last_not_after = nullptr;
   const DecodedKey key_decoded = compare_.decode_key(key);
+  const uint64_t key_prefix = GetKeyPrefix(key_decoded);
   while (true) {
     assert(x != nullptr);
     Node* next = x->Next(level);
     if (next != nullptr) {
       PREFETCH(next->Next(level), 0, 1);
     }
-    assert(x == head_ || next == nullptr || KeyIsAfterNode(next->Key(), x));
+    assert(x == head_ || next == nullptr || KeyIsAfterNode(NodeKey(next), x));
     assert(x == head_ || KeyIsAfterNode(key_decoded, x));
-    if (next != last_not_after && KeyIsAfterNode(key_decoded, next)) {
+    if (next != last_not_after &&
+        KeyIsAfterNode(key_decoded, key_prefix, next)) {
       // Keep searching in this list
       assert(next != nullptr);
       x = next;
@@ -620,13 +675,14 @@ uint64_t InlineSkipList<Comparator>::EstimateCount(const char* key) const {
   Node* x = head_;
   int level = GetMaxHeight() - 1;
   const DecodedKey key_decoded = compare_.decode_key(key);
+  const uint64_t key_prefix = GetKeyPrefix(key_decoded);
   while (true) {
-    assert(x == head_ || compare_(x->Key(), key_decoded) < 0);
+    assert(x == head_ || compare_(NodeKey(x), key_decoded) < 0);
     Node* next = x->Next(level);
     if (next != nullptr) {
       PREFETCH(next->Next(level), 0, 1);
     }
-    if (next == nullptr || compare_(next->Key(), key_decoded) >= 0) {
+    if (next == nullptr || CompareNode(next, key_decoded, key_prefix) >= 0) {
       if (level == 0) {
         return count;
       } else {
@@ -652,6 +708,8 @@ InlineSkipList<Comparator>::InlineSkipList(const Comparator cmp,
       allocator_(allocator),
       compare_(cmp),
       head_(AllocateNode(0, max_height)),
+      key_prefix_(nullptr),
+      key_offset_(0),
       max_height_(1),
       seq_splice_(AllocateSplice()) {
   assert(max_height > 0 && kMaxHeight_ == static_cast<uint32_t>(max_height));
@@ -664,9 +722,20 @@ InlineSkipList<Comparator>::InlineSkipList(const Comparator cmp,
   }
 }
 
+template <class Comparator>
+void InlineSkipList<Comparator>::EnableKeyPrefixCache(
+    KeyPrefixFunc key_prefix) {
+  assert(key_prefix != nullptr);
+  // head_ holds no key, so it is the only node allocated without the prefix.
+  assert(head_->Next(0) == nullptr);
+  key_prefix_ = key_prefix;
+  key_offset_ = sizeof(uint64_t);
+}
+
 template <class Comparator>
 char* InlineSkipList<Comparator>::AllocateKey(size_t key_size) {
-  return const_cast<char*>(AllocateNode(key_size, RandomHeight())->Key());
+  return const_cast<char*>(
+      NodeKey(AllocateNode(key_offset_ + key_size, RandomHeight())));
 }
 
 template <class Comparator>
@@ -758,10 +827,9 @@ bool InlineSkipList<Comparator>::InsertWithHintConcurrently(const char* key,
 
 template <class Comparator>
 template <bool prefetch_before>
-void InlineSkipList<Comparator>::FindSpliceForLevel(const DecodedKey& key,
-                                                    Node* before, Node* after,
-                                                    int level, Node** out_prev,
-                                                    Node** out_next) {
+void InlineSkipList<Comparator>::FindSpliceForLevel(
+    const DecodedKey& key, uint64_t key_prefix, Node* before, Node* after,
+    int level, Node** out_prev, Node** out_next) {
   while (true) {
     Node* next = before->Next(level);
     if (next != nullptr) {
@@ -773,9 +841,9 @@ void InlineSkipList<Comparator>::FindSpliceForLevel(const DecodedKey& key,
       }
     }
     assert(before == head_ || next == nullptr ||
-           KeyIsAfterNode(next->Key(), before));
+           KeyIsAfterNode(NodeKey(next), before));
     assert(before == head_ || KeyIsAfterNode(key, before));
-    if (next == after || !KeyIsAfterNode(key, next)) {
+    if (next == after || !KeyIsAfterNode(key, key_prefix, next)) {
       // found it
       *out_prev = before;
       *out_next = next;
@@ -787,13 +855,15 @@ void InlineSkipList<Comparator>::FindSpliceForLevel(const DecodedKey& key,
 
 template <class Comparator>
 void InlineSkipList<Comparator>::RecomputeSpliceLevels(const DecodedKey& key,
+                                                       uint64_t key_prefix,
                                                        Splice* splice,
                                                        int recompute_level) {
   assert(recompute_level > 0);
   assert(recompute_level <= splice->height_);
   for (int i = recompute_level - 1; i >= 0; --i) {
-    FindSpliceForLevel<true>(key, splice->prev_[i + 1], splice->next_[i + 1], i,
-                             &splice->prev_[i], &splice->next_[i]);
+    FindSpliceForLevel<true>(key, key_prefix, splice->prev_[i + 1],
+                             splice->next_[i + 1], i, &splice->prev_[i],
+                             &splice->next_[i]);
   }
 }
 
@@ -801,8 +871,13 @@ template <class Comparator>
 template <bool UseCAS>
 bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
                                         bool allow_partial_splice_fix) {
-  Node* x = reinterpret_cast<Node*>(const_cast<char*>(key)) - 1;
+  Node* x = KeyToNode(key);
   const DecodedKey key_decoded = compare_.decode_key(key);
+  const uint64_t key_prefix = GetKeyPrefix(key_decoded);
+  if (key_prefix_ != nullptr) {
+    // The node is not linked yet, so it is fine to fill in the prefix here.
+    memcpy(const_cast<char*>(x->Key()), &key_prefix, sizeof(key_prefix));
+  }
   int height = x->UnstashHeight();
   assert(height >= 1 && height <= kMaxHeight_);
 
@@ -870,7 +945,7 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
         // our chances of success.
         ++recompute_height;
       } else if (splice->prev_[recompute_height] != head_ &&
-                 !KeyIsAfterNode(key_decoded,
+                 !KeyIsAfterNode(key_decoded, key_prefix,
                                  splice->prev_[recompute_height])) {
         // key is from before splice
         if (allow_partial_splice_fix) {
@@ -883,7 +958,8 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
           // we're pessimistic, recompute everything
           recompute_height = max_height;
         }
-      } else if (KeyIsAfterNode(key_decoded, splice->next_[recompute_height])) {
+      } else if (KeyIsAfterNode(key_decoded, key_prefix,
+                                splice->next_[recompute_height])) {
         // key is from after splice
         if (allow_partial_splice_fix) {
           Node* bad = splice->next_[recompute_height];
@@ -901,7 +977,7 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
   }
   assert(recompute_height <= max_height);
   if (recompute_height > 0) {
-    RecomputeSpliceLevels(key_decoded, splice, recompute_height);
+    RecomputeSpliceLevels(key_decoded, key_prefix, splice, recompute_height);
   }
 
   bool splice_is_valid = true;
@@ -910,19 +986,19 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
       while (true) {
         // Checking for duplicate keys on the level 0 is sufficient
         if (UNLIKELY(i == 0 && splice->next_[i] != nullptr &&
-                     compare_(x->Key(), splice->next_[i]->Key()) >= 0)) {
+                     compare_(NodeKey(x), NodeKey(splice->next_[i])) >= 0)) {
           // duplicate key
           return false;
         }
         if (UNLIKELY(i == 0 && splice->prev_[i] != head_ &&
-                     compare_(splice->prev_[i]->Key(), x->Key()) >= 0)) {
+                     compare_(NodeKey(splice->prev_[i]), NodeKey(x)) >= 0)) {
           // duplicate key
           return false;
         }
         assert(splice->next_[i] == nullptr ||
-               compare_(x->Key(), splice->next_[i]->Key()) < 0);
+               compare_(NodeKey(x), NodeKey(splice->next_[i])) < 0);
         assert(splice->prev_[i] == head_ ||
-               compare_(splice->prev_[i]->Key(), x->Key()) < 0);
+               compare_(NodeKey(splice->prev_[i]), NodeKey(x)) < 0);
         x->NoBarrier_SetNext(i, splice->next_[i]);
         if (splice->prev_[i]->CASNext(i, splice->next_[i], x)) {
           // success
@@ -933,8 +1009,9 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
         // search, because it should be unlikely that lots of nodes have
         // been inserted between prev[i] and next[i]. No point in using
         // next[i] as the after hint, because we know it is stale.
-        FindSpliceForLevel<false>(key_decoded, splice->prev_[i], nullptr, i,
-                                  &splice->prev_[i], &splice->next_[i]);
+        FindSpliceForLevel<false>(key_decoded, key_prefix, splice->prev_[i],
+                                  nullptr, i, &splice->prev_[i],
+                                  &splice->next_[i]);
 
         // Since we've narrowed the bracket for level i, we might have
         // violated the Splice constraint between i and i-1.  Make sure
@@ -948,24 +1025,25 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
     for (int i = 0; i < height; ++i) {
       if (i >= recompute_height &&
           splice->prev_[i]->Next(i) != splice->next_[i]) {
-        FindSpliceForLevel<false>(key_decoded, splice->prev_[i], nullptr, i,
-                                  &splice->prev_[i], &splice->next_[i]);
+        FindSpliceForLevel<false>(key_decoded, key_prefix, splice->prev_[i],
+                                  nullptr, i, &splice->prev_[i],
+                                  &splice->next_[i]);
       }
       // Checking for duplicate keys on the level 0 is sufficient
       if (UNLIKELY(i == 0 && splice->next_[i] != nullptr &&
-                   compare_(x->Key(), splice->next_[i]->Key()) >= 0)) {
+                   compare_(NodeKey(x), NodeKey(splice->next_[i])) >= 0)) {
         // duplicate key
         return false;
       }
       if (UNLIKELY(i == 0 && splice->prev_[i] != head_ &&
-                   compare_(splice->prev_[i]->Key(), x->Key()) >= 0)) {
+                   compare_(NodeKey(splice->prev_[i]), NodeKey(x)) >= 0)) {
         // duplicate key
         return false;
       }
       assert(splice->next_[i] == nullptr ||
-             compare_(x->Key(), splice->next_[i]->Key()) < 0);
+             compare_(NodeKey(x), NodeKey(splice->next_[i])) < 0);
       assert(splice->prev_[i] == head_ ||
-             compare_(splice->prev_[i]->Key(), x->Key()) < 0);
+             compare_(NodeKey(splice->prev_[i]), NodeKey(x)) < 0);
       assert(splice->prev_[i]->Next(i) == splice->next_[i]);
       x->NoBarrier_SetNext(i, splice->next_[i]);
       splice->prev_[i]->SetNext(i, x);
@@ -979,17 +1057,17 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
     assert(splice->next_[splice->height_] == nullptr);
     for (int i = 0; i < splice->height_; ++i) {
       assert(splice->next_[i] == nullptr ||
-             compare_(key, splice->next_[i]->Key()) < 0);
+             compare_(key, NodeKey(splice->next_[i])) < 0);
       assert(splice->prev_[i] == head_ ||
-             compare_(splice->prev_[i]->Key(), key) <= 0);
+             compare_(NodeKey(splice->prev_[i]), key) <= 0);
       assert(splice->prev_[i + 1] == splice->prev_[i] ||
              splice->prev_[i + 1] == head_ ||
-             compare_(splice->prev_[i + 1]->Key(), splice->prev_[i]->Key()) <
-                 0);
+             compare_(NodeKey(splice->prev_[i + 1]),
+                      NodeKey(splice->prev_[i])) < 0);
       assert(splice->next_[i + 1] == splice->next_[i] ||
              splice->next_[i + 1] == nullptr ||
-             compare_(splice->next_[i]->Key(), splice->next_[i + 1]->Key()) <
-                 0);
+             compare_(NodeKey(splice->next_[i]),
+                      NodeKey(splice->next_[i + 1])) < 0);
     }
   } else {
     splice->height_ = 0;
@@ -1000,7 +1078,7 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
 template <class Comparator>
 bool InlineSkipList<Comparator>::Contains(const char* key) const {
   Node* x = FindGreaterOrEqual(key);
-  if (x != nullptr && Equal(key, x->Key())) {
+  if (x != nullptr && Equal(key, NodeKey(x))) {
     return true;
   } else {
     return false;
@@ -1023,7 +1101,8 @@ void InlineSkipList<Comparator>::TEST_Validate() const {
     if (l0_next == nullptr) {
       break;
     }
-    assert(nodes[0] == head_ || compare_(nodes[0]->Key(), l0_next->Key()) < 0);
+    assert(nodes[0] == head_ ||
+           compare_(NodeKey(nodes[0]), NodeKey(l0_next)) < 0);
     nodes[0] = l0_next;
 
     int i = 1;
@@ -1032,7 +1111,7 @@ void InlineSkipList<Comparator>::TEST_Validate() const {
       if (next == nullptr) {
         break;
       }
-      auto cmp = compare_(nodes[0]->Key(), next->Key());
+      auto cmp = compare_(NodeKey(nodes[0]), NodeKey(next));
       assert(cmp <= 0);
       if (cmp == 0) {
         assert(next == nodes[0]);
@@ -213,6 +213,51 @@ TEST_F(InlineSkipTest, InsertAndLookup) {
   }
 }
 
+TEST_F(InlineSkipTest, KeyPrefixCache) {
+  const int N = 2000;
+  const int R = 5000;
+  Random rnd(301);
+  Arena arena;
+  TestComparator cmp;
+  TestInlineSkipList list(cmp, &arena);
+  // Coarse prefixes so that both the prefix and the comparator decide.
+  list.EnableKeyPrefixCache([](const Key& key) { return key >> 4; });
+  std::set<Key> keys;
+  void* hint = nullptr;
+  for (int i = 0; i < N; i++) {
+    Key key = rnd.Next() % R;
+    if (keys.insert(key).second) {
+      if (i % 2 == 0) {
+        Insert(&list, key);
+      } else {
+        ASSERT_TRUE(InsertWithHint(&list, key, &hint));
+      }
+    }
+  }
+  Validate(&list);
+
+  for (Key i = 0; i < R; i++) {
+    ASSERT_EQ(keys.count(i) > 0, list.Contains(Encode(&i)));
+    TestInlineSkipList::Iterator iter(&list);
+    iter.Seek(Encode(&i));
+    auto model_iter = keys.lower_bound(i);
+    if (model_iter == keys.end()) {
+      ASSERT_FALSE(iter.Valid());
+    } else {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*model_iter, Decode(iter.key()));
+    }
+    iter.SeekForPrev(Encode(&i));
+    model_iter = keys.upper_bound(i);
+    if (model_iter == keys.begin()) {
+      ASSERT_FALSE(iter.Valid());
+    } else {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*--model_iter, Decode(iter.key()));
+    }
+  }
+}
+
 TEST_F(InlineSkipTest, InsertWithHint_Sequential) {
   const int N = 100000;
   Arena arena;
@@ -114,6 +114,9 @@ DEFINE_int32(item_size, 100, "Number of bytes each item should be");
 DEFINE_int32(prefix_length, 8,
              "Prefix length to pass into NewFixedPrefixTransform");
 
+DEFINE_bool(skiplist_key_prefix_cache, false,
+            "key_prefix_cache parameter to pass into SkipListFactory");
+
 /* VectorRep settings */
 DEFINE_int64(vectorrep_count, 0,
              "Number of entries to reserve on VectorRep initialization");
@@ -578,7 +581,8 @@ int main(int argc, char** argv) {
 
   std::unique_ptr<ROCKSDB_NAMESPACE::MemTableRepFactory> factory;
   if (FLAGS_memtablerep == "skiplist") {
-    factory.reset(new ROCKSDB_NAMESPACE::SkipListFactory);
+    factory.reset(new ROCKSDB_NAMESPACE::SkipListFactory(
+        0 /* lookahead */, FLAGS_skiplist_key_prefix_cache));
   } else if (FLAGS_memtablerep == "vector") {
     factory.reset(new ROCKSDB_NAMESPACE::VectorRepFactory);
   } else if (FLAGS_memtablerep == "hashskiplist" ||
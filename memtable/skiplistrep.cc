@@ -10,11 +10,33 @@
 #include "memtable/doubly_skiplist.h"
 #include "memtable/inlineskiplist.h"
 #include "rocksdb/utilities/options_type.h"
+#include "util/math.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace {
 
+// Reads the leading 8 bytes of the user key of a decoded memtable key as a
+// big-endian integer, padding shorter user keys with zeros.
+uint64_t UserKeyPrefix(const Slice& internal_key) {
+  assert(internal_key.size() >= 8);
+  const size_t user_key_size = internal_key.size() - 8;
+  uint64_t prefix = 0;
+  memcpy(&prefix, internal_key.data(),
+         std::min(user_key_size, sizeof(prefix)));
+  return port::kLittleEndian ? EndianSwapValue(prefix) : prefix;
+}
+
+template <class SkipListType>
+void EnableKeyPrefixCache(SkipListType* /*skip_list*/) {
+  // Only InlineSkipList supports the prefix cache.
+}
+
+void EnableKeyPrefixCache(
+    InlineSkipList<const MemTableRep::KeyComparator&>* skip_list) {
+  skip_list->EnableKeyPrefixCache(&UserKeyPrefix);
+}
+
 template <template <typename U> class SkipList>
 class SkipListRep : public MemTableRep {
   SkipList<const MemTableRep::KeyComparator&> skip_list_;
@@ -27,12 +49,16 @@ class SkipListRep : public MemTableRep {
  public:
   explicit SkipListRep(const MemTableRep::KeyComparator& compare,
                        Allocator* allocator, const SliceTransform* transform,
-                       const size_t lookahead)
+                       const size_t lookahead, bool key_prefix_cache = false)
       : MemTableRep(allocator),
         skip_list_(compare, allocator),
         cmp_(compare),
         transform_(transform),
-        lookahead_(lookahead) {}
+        lookahead_(lookahead) {
+    if (key_prefix_cache && compare.IsUserKeyPrefixOrdered()) {
+      EnableKeyPrefixCache(&skip_list_);
+    }
+  }
 
   KeyHandle Allocate(const size_t len, char** buf) override {
     *buf = skip_list_.AllocateKey(len);
@@ -347,9 +373,19 @@ static std::unordered_map<std::string, OptionTypeInfo> skiplist_factory_info = {
       OptionTypeFlags::kDontSerialize /*Since it is part of the ID*/}},
 };
 
-SkipListFactory::SkipListFactory(size_t lookahead) : lookahead_(lookahead) {
+static std::unordered_map<std::string, OptionTypeInfo>
+    skiplist_key_prefix_cache_info = {
+        {"key_prefix_cache",
+         {0, OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kDontSerialize /*Only affects performance*/}},
+};
+
+SkipListFactory::SkipListFactory(size_t lookahead, bool key_prefix_cache)
+    : lookahead_(lookahead), key_prefix_cache_(key_prefix_cache) {
   RegisterOptions("SkipListFactoryOptions", &lookahead_,
                   &skiplist_factory_info);
+  RegisterOptions("SkipListFactoryKeyPrefixCache", &key_prefix_cache_,
+                  &skiplist_key_prefix_cache_info);
 }
 
 std::string SkipListFactory::GetId() const {
@@ -364,7 +400,7 @@ MemTableRep* SkipListFactory::CreateMemTableRep(
     const MemTableRep::KeyComparator& compare, Allocator* allocator,
     const SliceTransform* transform, Logger* /*logger*/) {
   return new SkipListRep<InlineSkipList>(compare, allocator, transform,
-                                         lookahead_);
+                                         lookahead_, key_prefix_cache_);
 }
 
 MemTableRep* DoublySkipListFactory::CreateMemTableRep(
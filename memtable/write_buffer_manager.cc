@@ -17,21 +17,29 @@
 #include "logging/logging.h"
 #include "rocksdb/options.h"
 #include "rocksdb/status.h"
+#include "rocksdb/system_clock.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
 WriteBufferManager::WriteBufferManager(size_t _flush_size,
                                        std::shared_ptr<Cache> cache,
                                        float stall_ratio,
-                                       bool flush_oldest_first)
-    : memory_used_(0),
+                                       bool flush_oldest_first,
+                                       std::shared_ptr<SystemClock> clock)
+    : clock_(clock ? std::move(clock) : SystemClock::Default()),
+      memory_used_(0),
       flush_size_(_flush_size),
       memory_active_(0),
-      flush_oldest_first_(flush_oldest_first),
+      flush_policy_(flush_oldest_first ? FlushPolicy::kOldestFirst
+                                       : FlushPolicy::kLargestFirst),
       allow_stall_(stall_ratio >= 1.0),
       stall_ratio_(stall_ratio),
       stall_active_(false),
-      cache_res_mgr_(nullptr) {
+      cache_res_mgr_(nullptr),
+      predictive_flush_(false),
+      trigger_size_(0),
+      total_reserved_(0),
+      total_freed_(0) {
   if (cache) {
     // Memtable's memory usage tends to fluctuate frequently
     // therefore we set delayed_decrease = true to save some dummy entry
@@ -58,6 +66,8 @@ std::size_t WriteBufferManager::dummy_entries_in_cache_usage() const {
 }
 
 void WriteBufferManager::SetFlushSize(size_t new_size) {
+  // The early trigger was derived from the old size.
+  trigger_size_.store(0, std::memory_order_relaxed);
   if (flush_size_.exchange(new_size, std::memory_order_relaxed) > new_size) {
     // Threshold is decreased. We must make sure all outstanding memtables
     // are flushed.
@@ -87,6 +97,7 @@ void WriteBufferManager::UnregisterDB(DB* db) {
   sentinels_.remove_if([=](const std::shared_ptr<WriteBufferSentinel>& s) {
     return s->db == db;
   });
+  db_weights_.erase(db);
   MaybeFlushLocked();
 }
 
@@ -98,6 +109,214 @@ void WriteBufferManager::UnregisterColumnFamily(ColumnFamilyHandle* cf) {
   MaybeFlushLocked();
 }
 
+void WriteBufferManager::SetDBWeight(DB* db, double weight) {
+  assert(db != nullptr);
+  assert(weight > 0);
+  std::lock_guard<std::mutex> lock(sentinels_mu_);
+  db_weights_[db] = weight;
+}
+
+void WriteBufferManager::SetColumnFamilyWeight(ColumnFamilyHandle* cf,
+                                               double weight) {
+  assert(cf != nullptr);
+  assert(weight > 0);
+  std::lock_guard<std::mutex> lock(sentinels_mu_);
+  for (auto& s : sentinels_) {
+    if (s->cf == cf) {
+      s->weight = weight;
+    }
+  }
+}
+
+void WriteBufferManager::GetConsumerStats(std::vector<ConsumerStats>* stats) {
+  assert(stats != nullptr);
+  std::lock_guard<std::mutex> lock(sentinels_mu_);
+  CollectConsumerStatsLocked(stats);
+}
+
+void WriteBufferManager::CollectConsumerStatsLocked(
+    std::vector<ConsumerStats>* stats) {
+  // Smoothing factor of the write rate, the weight of the latest sample.
+  constexpr double kRateAlpha = 0.5;
+  const uint64_t now = clock_->NowMicros();
+  stats->clear();
+  stats->reserve(sentinels_.size());
+  std::unordered_map<DB*, double> cf_weight_sums;
+  double db_weight_sum = 0;
+  for (auto& s : sentinels_) {
+    ConsumerStats stat;
+    stat.db = s->db;
+    stat.cf = s->cf;
+    stat.cf_weight = s->weight;
+    auto db_weight = db_weights_.find(s->db);
+    if (db_weight != db_weights_.end()) {
+      stat.db_weight = db_weight->second;
+    }
+    auto inserted = cf_weight_sums.emplace(s->db, 0.0);
+    if (inserted.second) {
+      db_weight_sum += stat.db_weight;
+    }
+    inserted.first->second += s->weight;
+
+    uint64_t memory_bytes = 0;
+    uint64_t oldest_time = std::numeric_limits<uint64_t>::max();
+    s->db->GetApproximateActiveMemTableStats(s->cf, &memory_bytes,
+                                             &oldest_time);
+    stat.memory_usage = memory_bytes;
+    stat.oldest_key_time = oldest_time;
+    if (s->last_sample_micros > 0 && now > s->last_sample_micros) {
+      // A smaller memtable means it was switched in between, the new one has
+      // grown from empty.
+      uint64_t grown = memory_bytes >= s->last_memory_bytes
+                           ? memory_bytes - s->last_memory_bytes
+                           : memory_bytes;
+      double rate = static_cast<double>(grown) * 1000000 /
+                    static_cast<double>(now - s->last_sample_micros);
+      s->write_rate = kRateAlpha * rate + (1 - kRateAlpha) * s->write_rate;
+    }
+    s->last_memory_bytes = memory_bytes;
+    s->last_sample_micros = now;
+    stat.write_rate = static_cast<uint64_t>(s->write_rate);
+    stats->push_back(stat);
+  }
+  const double local_flush_size = static_cast<double>(flush_size());
+  for (auto& stat : *stats) {
+    stat.soft_quota = static_cast<uint64_t>(
+        local_flush_size * stat.db_weight / db_weight_sum * stat.cf_weight /
+        cf_weight_sums[stat.db]);
+  }
+}
+
+void WriteBufferManager::SetPredictiveFlush(
+    bool enabled, std::shared_ptr<SystemClock> clock) {
+  std::lock_guard<std::mutex> lock(prediction_mu_);
+  prediction_clock_ = clock ? std::move(clock) : clock_;
+  last_sample_micros_ = 0;
+  last_reserved_ = total_reserved_.load(std::memory_order_relaxed);
+  last_freed_ = total_freed_.load(std::memory_order_relaxed);
+  allocation_rate_ = 0;
+  flush_rate_ = 0;
+  limit_reached_ = false;
+  growth_start_micros_ = 0;
+  growth_predicted_micros_ = 0;
+  prediction_stats_ = FlushPredictionStats();
+  trigger_size_.store(0, std::memory_order_relaxed);
+  predictive_flush_.store(enabled, std::memory_order_relaxed);
+}
+
+void WriteBufferManager::GetFlushPredictionStats(FlushPredictionStats* stats) {
+  assert(stats != nullptr);
+  if (predictive_flush()) {
+    MaybeUpdatePrediction();
+  }
+  std::lock_guard<std::mutex> lock(prediction_mu_);
+  *stats = prediction_stats_;
+  size_t local_size = flush_size();
+  size_t trigger_size = trigger_size_.load(std::memory_order_relaxed);
+  if (predictive_flush() && trigger_size > 0 && trigger_size < local_size) {
+    local_size = trigger_size;
+  }
+  stats->trigger_size = local_size;
+}
+
+void WriteBufferManager::MaybeUpdatePrediction() {
+  // Sampling interval of the allocation and flush rates.
+  constexpr uint64_t kSampleIntervalMicros = 100 * 1000;
+  // Writers must not queue up behind each other here.
+  std::unique_lock<std::mutex> lock(prediction_mu_, std::try_to_lock);
+  if (!lock.owns_lock() || prediction_clock_ == nullptr) {
+    return;
+  }
+  const size_t limit = allow_stall_ ? stall_size() : flush_size();
+  const bool at_limit = limit > 0 && memory_usage() >= limit;
+  const uint64_t now = prediction_clock_->NowMicros();
+  if (at_limit != limit_reached_ || last_sample_micros_ == 0 ||
+      now >= last_sample_micros_ + kSampleIntervalMicros) {
+    UpdatePredictionLocked(now);
+  }
+}
+
+void WriteBufferManager::UpdatePredictionLocked(uint64_t now) {
+  // Smoothing factor of the rates, the weight of the latest sample.
+  constexpr double kRateAlpha = 0.3;
+  // The trigger is never lowered below this fraction of `flush_size`.
+  constexpr double kMinTriggerRatio = 0.5;
+  const uint64_t reserved = total_reserved_.load(std::memory_order_relaxed);
+  const uint64_t freed = total_freed_.load(std::memory_order_relaxed);
+  const size_t local_flush_size = flush_size();
+  const size_t limit = allow_stall_ ? stall_size() : local_flush_size;
+  const size_t used = memory_usage();
+  const size_t active = mutable_memtable_memory_usage();
+  const size_t pending = used > active ? used - active : 0;
+
+  if (last_sample_micros_ > 0 && now > last_sample_micros_) {
+    const double seconds =
+        static_cast<double>(now - last_sample_micros_) / 1000000;
+    allocation_rate_ =
+        kRateAlpha * static_cast<double>(reserved - last_reserved_) / seconds +
+        (1 - kRateAlpha) * allocation_rate_;
+    // Flush throughput is only observable while there is something to flush.
+    if (pending > 0 || freed > last_freed_) {
+      flush_rate_ =
+          kRateAlpha * static_cast<double>(freed - last_freed_) / seconds +
+          (1 - kRateAlpha) * flush_rate_;
+    }
+  }
+  last_sample_micros_ = now;
+  last_reserved_ = reserved;
+  last_freed_ = freed;
+
+  // A flush triggered at mutable usage T releases memory only after the
+  // pending memtables and itself are flushed, i.e. after (pending + T) /
+  // flush_rate. Meanwhile allocation_rate times that is reserved on top, and
+  // the sum must stay below the limit:
+  //   T <= limit / (1 + allocation_rate / flush_rate) - pending
+  size_t trigger_size = 0;
+  if (local_flush_size > 0 && allocation_rate_ > 0 && flush_rate_ > 0) {
+    double trigger = static_cast<double>(limit) /
+                         (1 + allocation_rate_ / flush_rate_) -
+                     static_cast<double>(pending);
+    trigger = std::max(trigger,
+                       kMinTriggerRatio * static_cast<double>(local_flush_size));
+    trigger_size = static_cast<size_t>(
+        std::min(trigger, static_cast<double>(local_flush_size)));
+  }
+  trigger_size_.store(trigger_size, std::memory_order_relaxed);
+
+  uint64_t predicted = 0;
+  const double growth_rate = allocation_rate_ - (pending > 0 ? flush_rate_ : 0);
+  if (used < limit && growth_rate > 0) {
+    // Never rounded down to 0, which stands for not growing.
+    predicted = std::max<uint64_t>(
+        1, static_cast<uint64_t>(static_cast<double>(limit - used) /
+                                 growth_rate * 1000000));
+  }
+  const bool at_limit = limit > 0 && used >= limit;
+  if (at_limit) {
+    if (!limit_reached_) {
+      prediction_stats_.limit_reached_count++;
+      if (growth_start_micros_ > 0) {
+        prediction_stats_.last_predicted_time_to_limit_micros =
+            growth_predicted_micros_;
+        prediction_stats_.last_actual_time_to_limit_micros =
+            now - growth_start_micros_;
+      }
+    }
+    growth_start_micros_ = 0;
+  } else if (predicted == 0) {
+    // Not growing anymore, the current run is abandoned.
+    growth_start_micros_ = 0;
+  } else if (growth_start_micros_ == 0) {
+    growth_start_micros_ = now;
+    growth_predicted_micros_ = predicted;
+  }
+  limit_reached_ = at_limit;
+
+  prediction_stats_.allocation_rate = static_cast<uint64_t>(allocation_rate_);
+  prediction_stats_.flush_rate = static_cast<uint64_t>(flush_rate_);
+  prediction_stats_.predicted_time_to_limit_micros = predicted;
+}
+
 void WriteBufferManager::ReserveMem(size_t mem) {
   size_t local_size = flush_size();
   if (cache_res_mgr_ != nullptr) {
@@ -108,6 +327,10 @@ void WriteBufferManager::ReserveMem(size_t mem) {
   if (local_size > 0) {
     memory_active_.fetch_add(mem, std::memory_order_relaxed);
   }
+  if (predictive_flush()) {
+    total_reserved_.fetch_add(mem, std::memory_order_relaxed);
+    MaybeUpdatePrediction();
+  }
 }
 
 // Should only be called from write thread
@@ -141,6 +364,10 @@ void WriteBufferManager::FreeMem(size_t mem) {
   } else if (flush_size() > 0) {
     memory_used_.fetch_sub(mem, std::memory_order_relaxed);
   }
+  if (predictive_flush()) {
+    total_freed_.fetch_add(mem, std::memory_order_relaxed);
+    MaybeUpdatePrediction();
+  }
   // Check if stall is active and can be ended.
   MaybeEndWriteStall();
 }
@@ -175,16 +402,53 @@ void WriteBufferManager::MaybeFlushLocked(DB* this_db) {
   };
   std::set<Candidate, decltype(cmp)> candidates(cmp);
 
+  const FlushPolicy policy = flush_policy();
+  std::vector<ConsumerStats> stats;
+  CollectConsumerStatsLocked(&stats);
+  uint64_t max_write_rate = 0;
+  for (auto& stat : stats) {
+    max_write_rate = std::max(max_write_rate, stat.write_rate);
+  }
+
+  size_t index = 0;
   for (auto& s : sentinels_) {
+    const ConsumerStats& stat = stats[index++];
     // TODO: move this calculation to a callback.
     uint64_t current_score = 0;
-    uint64_t current_memory_bytes = std::numeric_limits<uint64_t>::max();
-    uint64_t oldest_time = std::numeric_limits<uint64_t>::max();
-    s->db->GetApproximateActiveMemTableStats(s->cf, &current_memory_bytes,
-                                             &oldest_time);
-    if (flush_oldest_first_.load(std::memory_order_relaxed)) {
+    uint64_t current_memory_bytes = stat.memory_usage;
+    uint64_t oldest_time = stat.oldest_key_time;
+    if (policy == FlushPolicy::kOldestFirst) {
       // Convert oldest to highest score.
       current_score = std::numeric_limits<uint64_t>::max() - oldest_time;
+    } else if (policy == FlushPolicy::kWeightedQuota) {
+      // Usage relative to the soft quota dominates. Heavy writers get up to a
+      // 2x boost, and old memtables a small bonus so that they are eventually
+      // flushed when nobody else is over quota.
+      constexpr double kScoreScale = 1 << 20;
+      constexpr double kMaxAgeSeconds = 3600;
+      constexpr double kAgeBonus = 0.25;
+      double usage = static_cast<double>(current_memory_bytes) /
+                     static_cast<double>(std::max<uint64_t>(stat.soft_quota, 1));
+      double rate = max_write_rate > 0
+                        ? static_cast<double>(stat.write_rate) /
+                              static_cast<double>(max_write_rate)
+                        : 0;
+      // The oldest key time is stamped by the clock of the DB, so the age
+      // is measured with the same clock.
+      int64_t now_seconds = 0;
+      double age = 0;
+      if (current_memory_bytes > 0 &&
+          s->db->GetEnv()->GetSystemClock()->GetCurrentTime(&now_seconds)
+              .ok()) {
+        uint64_t now = static_cast<uint64_t>(now_seconds);
+        if (oldest_time < now) {
+          age = std::min(static_cast<double>(now - oldest_time) /
+                             kMaxAgeSeconds,
+                         1.0);
+        }
+      }
+      current_score = static_cast<uint64_t>(
+          (usage * (1 + rate) + kAgeBonus * age) * kScoreScale);
     } else {
       current_score = current_memory_bytes;
     }
@@ -10,6 +10,7 @@
 #include "rocksdb/write_buffer_manager.h"
 
 #include "rocksdb/advanced_cache.h"
+#include "test_util/mock_time_env.h"
 #include "test_util/testharness.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -40,6 +41,67 @@ TEST_F(WriteBufferManagerTest, ShouldFlush) {
   ASSERT_FALSE(wbf->ShouldFlush());
 }
 
+TEST_F(WriteBufferManagerTest, PredictiveFlush) {
+  constexpr size_t kMB = 1024 * 1024;
+  auto clock = std::make_shared<MockSystemClock>(SystemClock::Default());
+  clock->SetCurrentTime(100);
+  // Flush at 100MB, stall at 120MB.
+  std::unique_ptr<WriteBufferManager> wbf(
+      new WriteBufferManager(100 * kMB, {}, 1.2f));
+  wbf->SetPredictiveFlush(true, clock);
+
+  WriteBufferManager::FlushPredictionStats stats;
+  // Without any flush there is nothing to predict from.
+  for (int i = 0; i < 4; i++) {
+    wbf->ReserveMem(10 * kMB);
+    clock->MockSleepForSeconds(1);
+  }
+  wbf->GetFlushPredictionStats(&stats);
+  ASSERT_GT(stats.allocation_rate, 0);
+  ASSERT_EQ(stats.flush_rate, 0);
+  ASSERT_EQ(stats.trigger_size, 100 * kMB);
+  ASSERT_GT(stats.predicted_time_to_limit_micros, 0);
+
+  // Flush 20MB at 10MB/s while writing at 10MB/s.
+  wbf->ScheduleFreeMem(20 * kMB);
+  for (int i = 0; i < 2; i++) {
+    clock->MockSleepForSeconds(1);
+    wbf->ReserveMem(10 * kMB);
+    wbf->FreeMem(10 * kMB);
+  }
+  wbf->GetFlushPredictionStats(&stats);
+  ASSERT_GT(stats.flush_rate, 0);
+  // Flushes are triggered early to leave room for the writes issued while
+  // they are in progress, but never below half of flush_size.
+  ASSERT_LT(stats.trigger_size, 100 * kMB);
+  ASSERT_GE(stats.trigger_size, 50 * kMB);
+  // 40MB mutable, 40MB in total.
+  ASSERT_FALSE(wbf->ShouldFlush());
+  wbf->ReserveMem(stats.trigger_size - 40 * kMB);
+  ASSERT_TRUE(wbf->ShouldFlush());
+  ASSERT_EQ(stats.limit_reached_count, 0);
+
+  // Keep writing without flushing until the stall limit is reached.
+  while (wbf->memory_usage() < wbf->stall_size()) {
+    clock->MockSleepForSeconds(1);
+    wbf->ReserveMem(10 * kMB);
+  }
+  wbf->GetFlushPredictionStats(&stats);
+  ASSERT_EQ(stats.limit_reached_count, 1);
+  ASSERT_EQ(stats.predicted_time_to_limit_micros, 0);
+  ASSERT_GT(stats.last_predicted_time_to_limit_micros, 0);
+  ASSERT_GT(stats.last_actual_time_to_limit_micros, 0);
+
+  // Changing flush_size drops the early trigger until the next sample.
+  wbf->SetFlushSize(200 * kMB);
+  ASSERT_FALSE(wbf->ShouldFlush());
+
+  wbf->SetPredictiveFlush(false);
+  wbf->GetFlushPredictionStats(&stats);
+  ASSERT_EQ(stats.trigger_size, 200 * kMB);
+  ASSERT_EQ(stats.limit_reached_count, 0);
+}
+
 class ChargeWriteBufferTest : public testing::Test {};
 
 TEST_F(ChargeWriteBufferTest, Basic) {
@@ -271,6 +271,13 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
      "rocksdb.compressed.secondary.cache.promotions"},
     {COMPRESSED_SECONDARY_CACHE_PROMOTION_SKIPS,
      "rocksdb.compressed.secondary.cache.promotion.skips"},
+    {WAL_COMPRESSION_BYTES_SAVED, "rocksdb.wal.compression.bytes.saved"},
+    {WAL_COMPRESSION_DICT_BYTES_SAVED,
+     "rocksdb.wal.compression.dict.bytes.saved"},
+    {COMPRESSED_SECONDARY_CACHE_HIT_BYTES,
+     "rocksdb.compressed.secondary.cache.hit.bytes"},
+    {COMPRESSED_SECONDARY_CACHE_HIT_COMPRESSED_BYTES,
+     "rocksdb.compressed.secondary.cache.hit.compressed.bytes"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -340,6 +347,8 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {ASYNC_PREFETCH_ABORT_MICROS, "rocksdb.async.prefetch.abort.micros"},
     {TABLE_OPEN_PREFETCH_TAIL_READ_BYTES,
      "rocksdb.table.open.prefetch.tail.read.bytes"},
+    {COMPRESSED_SECONDARY_CACHE_HIT_MICROS,
+     "rocksdb.compressed.secondary.cache.hit.micros"},
 };
 
 static int RegisterBuiltinStatistics(ObjectLibrary& library,
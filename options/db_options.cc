@@ -331,6 +331,14 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, enable_multi_batch_write),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"multi_batch_write_slice_size",
+         {offsetof(struct ImmutableDBOptions, multi_batch_write_slice_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"num_wal_streams",
+         {offsetof(struct ImmutableDBOptions, num_wal_streams),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"unordered_write",
          {offsetof(struct ImmutableDBOptions, unordered_write),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -399,6 +407,14 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, wal_compression),
           OptionType::kCompressionType, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"wal_compression_dict_max_bytes",
+         {offsetof(struct ImmutableDBOptions, wal_compression_dict_max_bytes),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"compaction_async_io",
+         {offsetof(struct ImmutableDBOptions, compaction_async_io),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"seq_per_batch",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
@@ -736,6 +752,8 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       enable_pipelined_write(options.enable_pipelined_write),
       unordered_write(options.unordered_write),
       enable_multi_batch_write(options.enable_multi_batch_write),
+      multi_batch_write_slice_size(options.multi_batch_write_slice_size),
+      num_wal_streams(options.num_wal_streams),
       allow_concurrent_memtable_write(options.allow_concurrent_memtable_write),
       enable_write_thread_adaptive_yield(
           options.enable_write_thread_adaptive_yield),
@@ -755,8 +773,10 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       two_write_queues(options.two_write_queues),
       manual_wal_flush(options.manual_wal_flush),
       wal_compression(options.wal_compression),
+      wal_compression_dict_max_bytes(options.wal_compression_dict_max_bytes),
       atomic_flush(options.atomic_flush),
       avoid_unnecessary_blocking_io(options.avoid_unnecessary_blocking_io),
+      compaction_async_io(options.compaction_async_io),
       persist_stats_to_disk(options.persist_stats_to_disk),
       write_dbid_to_manifest(options.write_dbid_to_manifest),
       log_readahead_size(options.log_readahead_size),
@@ -889,6 +909,12 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    unordered_write);
   ROCKS_LOG_HEADER(log, "              Options.enable_multi_batch_write: %d",
                    enable_multi_batch_write);
+  ROCKS_LOG_HEADER(
+      log, "          Options.multi_batch_write_slice_size: %" ROCKSDB_PRIszt,
+      multi_batch_write_slice_size);
+  ROCKS_LOG_HEADER(log,
+                   "                 Options.num_wal_streams: %" ROCKSDB_PRIszt,
+                   num_wal_streams);
   ROCKS_LOG_HEADER(log, "        Options.allow_concurrent_memtable_write: %d",
                    allow_concurrent_memtable_write);
   ROCKS_LOG_HEADER(log, "     Options.enable_write_thread_adaptive_yield: %d",
@@ -921,10 +947,16 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    manual_wal_flush);
   ROCKS_LOG_HEADER(log, "            Options.wal_compression: %d",
                    wal_compression);
+  ROCKS_LOG_HEADER(log,
+                   "            Options.wal_compression_dict_max_bytes: "
+                   "%" ROCKSDB_PRIszt,
+                   wal_compression_dict_max_bytes);
   ROCKS_LOG_HEADER(log, "            Options.atomic_flush: %d", atomic_flush);
   ROCKS_LOG_HEADER(log,
                    "            Options.avoid_unnecessary_blocking_io: %d",
                    avoid_unnecessary_blocking_io);
+  ROCKS_LOG_HEADER(log, "                Options.compaction_async_io: %d",
+                   compaction_async_io);
   ROCKS_LOG_HEADER(log, "                Options.persist_stats_to_disk: %u",
                    persist_stats_to_disk);
   ROCKS_LOG_HEADER(log, "                Options.write_dbid_to_manifest: %d",
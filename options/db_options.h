@@ -69,6 +69,8 @@ struct ImmutableDBOptions {
   bool enable_pipelined_write;
   bool unordered_write;
   bool enable_multi_batch_write;
+  size_t multi_batch_write_slice_size;
+  size_t num_wal_streams;
   bool allow_concurrent_memtable_write;
   bool enable_write_thread_adaptive_yield;
   uint64_t write_thread_max_yield_usec;
@@ -86,8 +88,10 @@ struct ImmutableDBOptions {
   bool two_write_queues;
   bool manual_wal_flush;
   CompressionType wal_compression;
+  size_t wal_compression_dict_max_bytes;
   bool atomic_flush;
   bool avoid_unnecessary_blocking_io;
+  bool compaction_async_io;
   bool persist_stats_to_disk;
   bool write_dbid_to_manifest;
   size_t log_readahead_size;
@@ -135,6 +135,9 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.enable_pipelined_write = immutable_db_options.enable_pipelined_write;
   options.enable_multi_batch_write =
       immutable_db_options.enable_multi_batch_write;
+  options.multi_batch_write_slice_size =
+      immutable_db_options.multi_batch_write_slice_size;
+  options.num_wal_streams = immutable_db_options.num_wal_streams;
   options.unordered_write = immutable_db_options.unordered_write;
   options.allow_concurrent_memtable_write =
       immutable_db_options.allow_concurrent_memtable_write;
@@ -165,9 +168,12 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.two_write_queues = immutable_db_options.two_write_queues;
   options.manual_wal_flush = immutable_db_options.manual_wal_flush;
   options.wal_compression = immutable_db_options.wal_compression;
+  options.wal_compression_dict_max_bytes =
+      immutable_db_options.wal_compression_dict_max_bytes;
   options.atomic_flush = immutable_db_options.atomic_flush;
   options.avoid_unnecessary_blocking_io =
       immutable_db_options.avoid_unnecessary_blocking_io;
+  options.compaction_async_io = immutable_db_options.compaction_async_io;
   options.log_readahead_size = immutable_db_options.log_readahead_size;
   options.file_checksum_gen_factory =
       immutable_db_options.file_checksum_gen_factory;
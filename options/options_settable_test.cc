@@ -125,6 +125,8 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
        sizeof(std::shared_ptr<Cache>)},
       {offsetof(struct BlockBasedTableOptions, persistent_cache),
        sizeof(std::shared_ptr<PersistentCache>)},
+      {offsetof(struct BlockBasedTableOptions, compression_worker_pool),
+       sizeof(std::shared_ptr<CompressionWorkerPool>)},
       {offsetof(struct BlockBasedTableOptions, cache_usage_options),
        sizeof(CacheUsageOptions)},
       {offsetof(struct BlockBasedTableOptions, filter_policy),
@@ -185,6 +187,8 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "data_block_index_type=kDataBlockBinaryAndHash;"
       "index_shortening=kNoShortening;"
       "data_block_hash_table_util_ratio=0.75;"
+      "data_block_hash_index_wide=true;"
+      "data_block_restart_key_prefixes=true;"
       "checksum=kxxHash;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;"
       "block_size_deviation=8;block_restart_interval=4; "
@@ -198,6 +202,7 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "verify_compression=true;read_amp_bytes_per_bit=0;"
       "enable_index_compression=false;"
       "block_align=true;"
+      "persist_fragmented_range_deletions=true;"
       "max_auto_readahead_size=0;"
       "prepopulate_block_cache=kDisable;"
       "initial_auto_readahead_size=0;"
@@ -339,6 +344,8 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "fail_if_options_file_error=false;"
                              "enable_pipelined_write=false;"
                              "enable_multi_batch_write=false;"
+                             "multi_batch_write_slice_size=0;"
+                             "num_wal_streams=1;"
                              "unordered_write=false;"
                              "allow_concurrent_memtable_write=true;"
                              "wal_recovery_mode=kPointInTimeRecovery;"
@@ -356,9 +363,11 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "two_write_queues=false;"
                              "manual_wal_flush=false;"
                              "wal_compression=kZSTD;"
+                             "wal_compression_dict_max_bytes=0;"
                              "seq_per_batch=false;"
                              "atomic_flush=false;"
                              "avoid_unnecessary_blocking_io=false;"
+                             "compaction_async_io=false;"
                              "log_readahead_size=0;"
                              "write_dbid_to_manifest=false;"
                              "best_efforts_recovery=false;"
@@ -9,10 +9,12 @@ LIB_SOURCES =                                                   \
   cache/clock_cache.cc                                          \
   cache/lru_cache.cc                                            \
   cache/compressed_secondary_cache.cc                           \
+  cache/local_flash_secondary_cache.cc                          \
   cache/secondary_cache.cc                                      \
   cache/secondary_cache_adapter.cc                              \
   cache/sharded_cache.cc                                        \
   cache/tiered_secondary_cache.cc				\
+  cache/tiny_lfu_admission_policy.cc                            \
   db/arena_wrapped_db_iter.cc                                   \
   db/blob/blob_contents.cc                                      \
   db/blob/blob_fetcher.cc                                       \
@@ -182,8 +184,10 @@ LIB_SOURCES =                                                   \
   table/block_based/block_based_table_reader.cc                 \
   table/block_based/block_builder.cc                            \
   table/block_based/block_cache.cc                              \
+  table/block_based/block_learned_index.cc                      \
   table/block_based/block_prefetcher.cc                         \
   table/block_based/block_prefix_index.cc                       \
+  table/block_based/compression_worker_pool.cc                  \
   table/block_based/data_block_hash_index.cc                    \
   table/block_based/data_block_footer.cc                        \
   table/block_based/filter_block_reader_common.cc               \
@@ -193,6 +197,7 @@ LIB_SOURCES =                                                   \
   table/block_based/hash_index_reader.cc                        \
   table/block_based/index_builder.cc                            \
   table/block_based/index_reader_common.cc                      \
+  table/block_based/learned_index_reader.cc                     \
   table/block_based/parsed_full_filter_block.cc                 \
   table/block_based/partitioned_filter_block.cc                 \
   table/block_based/partitioned_index_iterator.cc               \
@@ -441,6 +446,7 @@ TEST_MAIN_SOURCES =                                                     \
   cache/cache_test.cc                                                   \
   cache/cache_reservation_manager_test.cc                               \
   cache/compressed_secondary_cache_test.cc                              \
+  cache/local_flash_secondary_cache_test.cc                             \
   cache/lru_cache_test.cc                                               \
   cache/tiered_secondary_cache_test.cc					\
   db/blob/blob_counting_iterator_test.cc                                \
@@ -647,6 +653,7 @@ TEST_MAIN_SOURCES_C = \
 MICROBENCH_SOURCES =                                          \
   microbench/ribbon_bench.cc                                  \
   microbench/db_basic_bench.cc                                  \
+  microbench/encryption_bench.cc                                \
 
 JNI_NATIVE_SOURCES =                                          \
   java/rocksjni/backupenginejni.cc                            \
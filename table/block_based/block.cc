@@ -12,6 +12,7 @@
 #include "table/block_based/block.h"
 
 #include <algorithm>
+#include <limits>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -20,10 +21,16 @@
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "rocksdb/comparator.h"
+#include "table/block_based/block_learned_index.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_footer.h"
 #include "table/format.h"
 #include "util/coding.h"
+#include "util/math.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -307,7 +314,9 @@ void DataBlockIter::SeekImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = restart_key_prefixes_
+                ? RestartKeyPrefixSeek(seek_key, &index, &skip_linear_scan)
+                : BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
 
   if (!ok) {
     return;
@@ -358,66 +367,88 @@ void MetaBlockIter::SeekImpl(const Slice& target) {
 bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   Slice target_user_key = ExtractUserKey(target);
   uint32_t map_offset = restarts_ + num_restarts_ * sizeof(uint32_t);
-  uint8_t entry =
-      data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
+  if (restart_key_prefixes_ != nullptr) {
+    map_offset += num_restarts_ * static_cast<uint32_t>(sizeof(uint64_t));
+  }
+  uint32_t restart_index;
+  // With a wide hash index, the key may instead be in the restart interval
+  // of its secondary bucket.
+  bool has_secondary = false;
+  bool secondary_collision = false;
+  uint32_t secondary_restart_index = 0;
+  if (data_block_hash_index_->IsWide()) {
+    uint16_t primary, secondary;
+    data_block_hash_index_->LookupWide(data_, map_offset, target_user_key,
+                                       &primary, &secondary);
+    if (primary == kWideCollision) {
+      // HashSeek not effective, falling back
+      SeekImpl(target);
+      return true;
+    }
+    if (primary == kWideNoEntry) {
+      // See kNoEntry below.
+      restart_index = num_restarts_ - 1;
+    } else {
+      restart_index = primary;
+      if (secondary == kWideCollision) {
+        secondary_collision = true;
+      } else if (secondary != kWideNoEntry && secondary != primary) {
+        has_secondary = true;
+        secondary_restart_index = secondary;
+      }
+    }
+  } else {
+    uint8_t entry =
+        data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
 
-  if (entry == kCollision) {
-    // HashSeek not effective, falling back
-    SeekImpl(target);
-    return true;
-  }
+    if (entry == kCollision) {
+      // HashSeek not effective, falling back
+      SeekImpl(target);
+      return true;
+    }
 
-  if (entry == kNoEntry) {
-    // Even if we cannot find the user_key in this block, the result may
-    // exist in the next block. Consider this example:
-    //
-    // Block N:    [aab@100, ... , app@120]
-    // boundary key: axy@50 (we make minimal assumption about a boundary key)
-    // Block N+1:  [axy@10, ...   ]
-    //
-    // If seek_key = axy@60, the search will start from Block N.
-    // Even if the user_key is not found in the hash map, the caller still
-    // have to continue searching the next block.
-    //
-    // In this case, we pretend the key is in the last restart interval.
-    // The while-loop below will search the last restart interval for the
-    // key. It will stop at the first key that is larger than the seek_key,
-    // or to the end of the block if no one is larger.
-    entry = static_cast<uint8_t>(num_restarts_ - 1);
+    if (entry == kNoEntry) {
+      // Even if we cannot find the user_key in this block, the result may
+      // exist in the next block. Consider this example:
+      //
+      // Block N:    [aab@100, ... , app@120]
+      // boundary key: axy@50 (we make minimal assumption about a boundary
+      // key)
+      // Block N+1:  [axy@10, ...   ]
+      //
+      // If seek_key = axy@60, the search will start from Block N.
+      // Even if the user_key is not found in the hash map, the caller still
+      // have to continue searching the next block.
+      //
+      // In this case, we pretend the key is in the last restart interval.
+      // The while-loop below will search the last restart interval for the
+      // key. It will stop at the first key that is larger than the
+      // seek_key, or to the end of the block if no one is larger.
+      entry = static_cast<uint8_t>(num_restarts_ - 1);
+    }
+    restart_index = entry;
   }
 
-  uint32_t restart_index = entry;
-
-  // check if the key is in the restart_interval
-  assert(restart_index < num_restarts_);
-  SeekToRestartPoint(restart_index);
-  current_ = GetRestartPoint(restart_index);
-  cur_entry_idx_ =
-      static_cast<int32_t>(restart_index * block_restart_interval_) - 1;
-
-  uint32_t limit = restarts_;
-  if (restart_index + 1 < num_restarts_) {
-    limit = GetRestartPoint(restart_index + 1);
+  if (restart_index >= num_restarts_ ||
+      (has_secondary && secondary_restart_index >= num_restarts_)) {
+    // Corrupted hash index
+    SeekImpl(target);
+    return true;
   }
-  while (current_ < limit) {
-    ++cur_entry_idx_;
-    bool shared;
-    // Here we only linear seek the target key inside the restart interval.
-    // If a key does not exist inside a restart interval, we avoid
-    // further searching the block content across restart interval boundary.
-    //
-    // TODO(fwu): check the left and right boundary of the restart interval
-    // to avoid linear seek a target key that is out of range.
-    if (!ParseNextDataKey(&shared) || CompareCurrentKey(target) >= 0) {
-      // we stop at the first potential matching user key.
-      break;
+  SeekForGetInRestartInterval(target, restart_index);
+
+  if ((has_secondary || secondary_collision) &&
+      (current_ == restarts_ ||
+       icmp_->user_comparator()->Compare(raw_key_.GetUserKey(),
+                                         target_user_key) != 0)) {
+    if (current_ == restarts_ || secondary_collision) {
+      // Reaching the end of the block does not tell whether the key is in
+      // the secondary restart interval (see below), and a collision in the
+      // secondary bucket means it may be anywhere.
+      SeekImpl(target);
+      return true;
     }
-    // If the loop exits due to CompareCurrentKey(target) >= 0, then current key
-    // exists, and its checksum verification will be done in UpdateKey() called
-    // in SeekForGet().
-    // TODO(cbi): If this loop exits with current_ == restart_, per key-value
-    //  checksum will not be verified in UpdateKey() since Valid()
-    //  will return false.
+    SeekForGetInRestartInterval(target, secondary_restart_index);
   }
 
   if (current_ == restarts_) {
@@ -461,6 +492,41 @@ bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   return true;
 }
 
+void DataBlockIter::SeekForGetInRestartInterval(const Slice& target,
+                                                uint32_t restart_index) {
+  // check if the key is in the restart_interval
+  assert(restart_index < num_restarts_);
+  SeekToRestartPoint(restart_index);
+  current_ = GetRestartPoint(restart_index);
+  cur_entry_idx_ =
+      static_cast<int32_t>(restart_index * block_restart_interval_) - 1;
+
+  uint32_t limit = restarts_;
+  if (restart_index + 1 < num_restarts_) {
+    limit = GetRestartPoint(restart_index + 1);
+  }
+  while (current_ < limit) {
+    ++cur_entry_idx_;
+    bool shared;
+    // Here we only linear seek the target key inside the restart interval.
+    // If a key does not exist inside a restart interval, we avoid
+    // further searching the block content across restart interval boundary.
+    //
+    // TODO(fwu): check the left and right boundary of the restart interval
+    // to avoid linear seek a target key that is out of range.
+    if (!ParseNextDataKey(&shared) || CompareCurrentKey(target) >= 0) {
+      // we stop at the first potential matching user key.
+      break;
+    }
+    // If the loop exits due to CompareCurrentKey(target) >= 0, then current key
+    // exists, and its checksum verification will be done in UpdateKey() called
+    // in SeekForGet().
+    // TODO(cbi): If this loop exits with current_ == restart_, per key-value
+    //  checksum will not be verified in UpdateKey() since Valid()
+    //  will return false.
+  }
+}
+
 void IndexBlockIter::SeekImpl(const Slice& target) {
 #ifndef NDEBUG
   if (TEST_Corrupt_Callback("IndexBlockIter::SeekImpl")) {
@@ -493,6 +559,8 @@ void IndexBlockIter::SeekImpl(const Slice& target) {
     // restart interval must be one when hash search is enabled so the binary
     // search simply lands at the right place.
     skip_linear_scan = true;
+  } else if (learned_index_) {
+    ok = LearnedSeek(seek_key, &index, &skip_linear_scan);
   } else if (value_delta_encoded_) {
     ok = BinarySeek<DecodeKeyV4>(seek_key, &index, &skip_linear_scan);
   } else {
@@ -513,7 +581,9 @@ void DataBlockIter::SeekForPrevImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = restart_key_prefixes_
+                ? RestartKeyPrefixSeek(seek_key, &index, &skip_linear_scan)
+                : BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
 
   if (!ok) {
     return;
@@ -837,6 +907,17 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
     return false;
   }
 
+  return BinarySeek<DecodeKeyFunc>(target, -1, num_restarts_ - 1, index,
+                                   skip_linear_scan);
+}
+
+template <class TValue>
+template <typename DecodeKeyFunc>
+bool BlockIter<TValue>::BinarySeek(const Slice& target, int64_t left,
+                                   int64_t right, uint32_t* index,
+                                   bool* skip_linear_scan) {
+  assert(restarts_ != 0);
+  assert(left >= -1 && left <= right && right < num_restarts_);
   *skip_linear_scan = false;
   // Loop invariants:
   // - Restart key at index `left` is less than or equal to the target key. The
@@ -844,7 +925,6 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   //   keys.
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
-  int64_t left = -1, right = num_restarts_ - 1;
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -884,6 +964,80 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   return true;
 }
 
+namespace {
+// Returns the number of entries of the sorted array of RestartKeyPrefix()
+// `prefixes[0, n)` that are less than `target`, or not greater than `target`
+// if `or_equal`. A branch-free binary search narrows the candidates down to a
+// few adjacent entries, which are then compared at once.
+inline uint32_t CountRestartKeyPrefixesBelow(const char* prefixes, uint32_t n,
+                                             uint64_t target, bool or_equal) {
+  constexpr uint32_t kMaxCandidates = 8;
+  uint32_t base = 0;
+  uint32_t len = n;
+  // Invariant: the result is in [base, base + len].
+  while (len > kMaxCandidates) {
+    uint32_t half = len / 2;
+    uint64_t probe =
+        DecodeFixed64(prefixes + (base + half - 1) * sizeof(uint64_t));
+    bool below = or_equal ? probe <= target : probe < target;
+    base = below ? base + half : base;
+    len -= half;
+  }
+  const char* candidates = prefixes + base * sizeof(uint64_t);
+  uint32_t count = base;
+  uint32_t i = 0;
+#ifdef __AVX2__
+  // Unsigned 64-bit compares, by flipping the sign bit for signed compares.
+  const __m256i sign_bit =
+      _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+  const __m256i target_vec = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<int64_t>(target)), sign_bit);
+  for (; i + 4 <= len; i += 4) {
+    __m256i vec = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+            candidates + i * sizeof(uint64_t))),
+        sign_bit);
+    if (or_equal) {
+      // Count entries not greater than the target.
+      int greater = _mm256_movemask_pd(
+          _mm256_castsi256_pd(_mm256_cmpgt_epi64(vec, target_vec)));
+      count += 4 - static_cast<uint32_t>(BitsSetToOne(greater));
+    } else {
+      int less = _mm256_movemask_pd(
+          _mm256_castsi256_pd(_mm256_cmpgt_epi64(target_vec, vec)));
+      count += static_cast<uint32_t>(BitsSetToOne(less));
+    }
+  }
+#endif  // __AVX2__
+  for (; i < len; i++) {
+    uint64_t prefix = DecodeFixed64(candidates + i * sizeof(uint64_t));
+    count += (or_equal ? prefix <= target : prefix < target) ? 1 : 0;
+  }
+  return count;
+}
+}  // namespace
+
+bool DataBlockIter::RestartKeyPrefixSeek(const Slice& target, uint32_t* index,
+                                         bool* skip_linear_scan) {
+  assert(restart_key_prefixes_ != nullptr);
+  if (restarts_ == 0) {
+    // See the comment in BinarySeek().
+    return false;
+  }
+  const uint64_t target_prefix = RestartKeyPrefix(ExtractUserKey(target));
+  // Restart keys with a smaller prefix are less than `target`, and those
+  // with a greater prefix are greater than `target`. Only the ones sharing
+  // the prefix need a full key comparison.
+  const uint32_t num_less = CountRestartKeyPrefixesBelow(
+      restart_key_prefixes_, num_restarts_, target_prefix, false);
+  const uint32_t num_not_greater = CountRestartKeyPrefixesBelow(
+      restart_key_prefixes_, num_restarts_, target_prefix, true);
+  assert(num_less <= num_not_greater && num_not_greater <= num_restarts_);
+  return BinarySeek<DecodeKey>(target, int64_t{num_less} - 1,
+                               int64_t{num_not_greater} - 1, index,
+                               skip_linear_scan);
+}
+
 // Compare target key and the block key of the block of `block_index`.
 // Return -1 if error.
 int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
@@ -904,6 +1058,62 @@ int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
   return CompareCurrentKey(target);
 }
 
+bool IndexBlockIter::LearnedSeek(const Slice& target, uint32_t* index,
+                                 bool* skip_linear_scan) {
+  assert(learned_index_);
+  if (restarts_ == 0) {
+    // See the comment in BinarySeek().
+    return false;
+  }
+  uint32_t first = 0;
+  uint32_t last = 0;
+  learned_index_->GetRestartRange(
+      raw_key_.IsUserKey() ? target : ExtractUserKey(target), num_restarts_,
+      &first, &last);
+  assert(first <= last && last < num_restarts_);
+
+  // Same invariants as in BinarySeek().
+  int64_t left = -1;
+  int64_t right = num_restarts_ - 1;
+  if (first > 0) {
+    int cmp = CompareBlockKey(first, target);
+    if (!status_.ok()) {
+      return false;
+    }
+    if (cmp == 0) {
+      *index = first;
+      *skip_linear_scan = true;
+      return true;
+    }
+    if (cmp < 0) {
+      left = first;
+    } else {
+      right = first - 1;
+    }
+  }
+  if (right > last && last + 1 < num_restarts_) {
+    int cmp = CompareBlockKey(last + 1, target);
+    if (!status_.ok()) {
+      return false;
+    }
+    if (cmp == 0) {
+      *index = last + 1;
+      *skip_linear_scan = true;
+      return true;
+    }
+    if (cmp > 0) {
+      right = last;
+    } else {
+      left = last + 1;
+    }
+  }
+  if (value_delta_encoded_) {
+    return BinarySeek<DecodeKeyV4>(target, left, right, index,
+                                   skip_linear_scan);
+  }
+  return BinarySeek<DecodeKey>(target, left, right, index, skip_linear_scan);
+}
+
 // Binary search in block_ids to find the first block
 // with a key >= target
 bool IndexBlockIter::BinaryBlockIndexSeek(const Slice& target,
@@ -1018,19 +1228,11 @@ uint32_t Block::NumRestarts() const {
   assert(size_ >= 2 * sizeof(uint32_t));
   uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
   uint32_t num_restarts = block_footer;
-  if (size_ > kMaxBlockSizeSupportedByHashIndex) {
-    // In BlockBuilder, we have ensured a block with HashIndex is less than
-    // kMaxBlockSizeSupportedByHashIndex (64KiB).
-    //
-    // Therefore, if we encounter a block with a size > 64KiB, the block
-    // cannot have HashIndex. So the footer will directly interpreted as
-    // num_restarts.
-    //
-    // Such check is for backward compatibility. We can ensure legacy block
-    // with a vary large num_restarts i.e. >= 0x80000000 can be interpreted
-    // correctly as no HashIndex even if the MSB of num_restarts is set.
-    return num_restarts;
-  }
+  // Blocks larger than kMaxBlockSizeSupportedByHashIndex (64KiB) used to have
+  // the footer directly interpreted as num_restarts, as they could not have a
+  // narrow HashIndex. No block can have 2^30 restarts or more though, so the
+  // two flag bits are interpreted the same way for any block size, which
+  // allows large blocks to have a wide HashIndex.
   BlockBasedTableOptions::DataBlockIndexType index_type;
   UnPackIndexTypeAndNumRestarts(block_footer, &index_type, &num_restarts);
   return num_restarts;
@@ -1038,10 +1240,7 @@ uint32_t Block::NumRestarts() const {
 
 BlockBasedTableOptions::DataBlockIndexType Block::IndexType() const {
   assert(size_ >= 2 * sizeof(uint32_t));
-  if (size_ > kMaxBlockSizeSupportedByHashIndex) {
-    // The check is for the same reason as that in NumRestarts()
-    return BlockBasedTableOptions::kDataBlockBinarySearch;
-  }
+  // See NumRestarts() for large blocks.
   uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
   uint32_t num_restarts = block_footer;
   BlockBasedTableOptions::DataBlockIndexType index_type;
@@ -1086,11 +1285,14 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
           break;
         }
 
-        uint16_t map_offset;
-        data_block_hash_index_.Initialize(
-            data_, static_cast<uint16_t>(size_ - sizeof(uint32_t)), /*chop off
-                                                                NUM_RESTARTS*/
-            &map_offset);
+        uint32_t map_offset;
+        // Chop off NUM_RESTARTS.
+        if (!data_block_hash_index_.Initialize(
+                data_, static_cast<uint32_t>(size_ - sizeof(uint32_t)),
+                &map_offset)) {
+          size_ = 0;
+          break;
+        }
 
         restart_offset_ = map_offset - num_restarts_ * sizeof(uint32_t);
 
@@ -1104,6 +1306,20 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
       default:
         size_ = 0;  // Error marker
     }
+    if (size_ != 0 &&
+        (DecodeFixed32(data_ + size_ - sizeof(uint32_t)) &
+         kRestartKeyPrefixesFlag)) {
+      // The restart key prefixes are between the restart array and what
+      // follows it, so the restart array starts that much earlier.
+      const size_t prefixes_size = size_t{num_restarts_} * sizeof(uint64_t);
+      if (restart_offset_ < prefixes_size) {
+        size_ = 0;
+      } else {
+        restart_offset_ -= static_cast<uint32_t>(prefixes_size);
+        restart_key_prefixes_ =
+            data_ + restart_offset_ + num_restarts_ * sizeof(uint32_t);
+      }
+    }
   }
   if (read_amp_bytes_per_bit != 0 && statistics && size_ != 0) {
     read_amp_bitmap_.reset(new BlockReadAmpBitmap(
@@ -1278,7 +1494,8 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
         read_amp_bitmap_.get(), block_contents_pinned,
         user_defined_timestamps_persisted,
         data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+        protection_bytes_per_key_, kv_checksum_, block_restart_interval_,
+        restart_key_prefixes_);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -1295,7 +1512,7 @@ IndexBlockIter* Block::NewIndexIterator(
     IndexBlockIter* iter, Statistics* /*stats*/, bool total_order_seek,
     bool have_first_key, bool key_includes_seq, bool value_is_full,
     bool block_contents_pinned, bool user_defined_timestamps_persisted,
-    BlockPrefixIndex* prefix_index) {
+    BlockPrefixIndex* prefix_index, const BlockLearnedIndex* learned_index) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -1317,7 +1534,8 @@ IndexBlockIter* Block::NewIndexIterator(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
         prefix_index_ptr, have_first_key, key_includes_seq, value_is_full,
         block_contents_pinned, user_defined_timestamps_persisted,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+        protection_bytes_per_key_, kv_checksum_, block_restart_interval_,
+        learned_index);
   }
 
   return ret_iter;
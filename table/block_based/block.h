@@ -38,6 +38,7 @@ class BlockIter;
 class DataBlockIter;
 class IndexBlockIter;
 class MetaBlockIter;
+class BlockLearnedIndex;
 class BlockPrefixIndex;
 
 // BlockReadAmpBitmap is a bitmap that map the ROCKSDB_NAMESPACE::Block data
@@ -227,6 +228,9 @@ class Block {
   // If `prefix_index` is not nullptr this block will do hash lookup for the key
   // prefix. If total_order_seek is true, prefix_index_ is ignored.
   //
+  // If `learned_index` is not nullptr, seeks start with a binary search in the
+  // range of restart points that it predicts for the key.
+  //
   // `have_first_key` controls whether IndexValue will contain
   // first_internal_key. It affects data serialization format, so the same value
   // have_first_key must be used when writing and reading index.
@@ -239,7 +243,8 @@ class Block {
       bool have_first_key, bool key_includes_seq, bool value_is_full,
       bool block_contents_pinned = false,
       bool user_defined_timestamps_persisted = true,
-      BlockPrefixIndex* prefix_index = nullptr);
+      BlockPrefixIndex* prefix_index = nullptr,
+      const BlockLearnedIndex* learned_index = nullptr);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -288,6 +293,8 @@ class Block {
   uint32_t block_restart_interval_{0};
   uint8_t protection_bytes_per_key_{0};
   DataBlockHashIndex data_block_hash_index_;
+  // Points into data_ if the block has restart key prefixes.
+  const char* restart_key_prefixes_{nullptr};
 };
 
 // A `BlockIter` iterates over the entries in a `Block`'s data buffer. The
@@ -675,6 +682,14 @@ class BlockIter : public InternalIteratorBase<TValue> {
   inline bool BinarySeek(const Slice& target, uint32_t* index,
                          bool* is_index_key_result);
 
+  // Same as above, but only searches restart points in (`left`, `right`]. The
+  // caller guarantees that the restart key at `left` is less than `target`
+  // (or `left` is -1), and that the restart key at `right + 1` is greater
+  // than `target` (or does not exist).
+  template <typename DecodeKeyFunc>
+  inline bool BinarySeek(const Slice& target, int64_t left, int64_t right,
+                         uint32_t* index, bool* is_index_key_result);
+
   // Find the first key in restart interval `index` that is >= `target`.
   // If there is no such key, iterator is positioned at the first key in
   // restart interval `index + 1`.
@@ -700,7 +715,8 @@ class DataBlockIter final : public BlockIter<Slice> {
                   bool user_defined_timestamps_persisted,
                   DataBlockHashIndex* data_block_hash_index,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
-                  uint32_t block_restart_interval) {
+                  uint32_t block_restart_interval,
+                  const char* restart_key_prefixes = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts, global_seqno,
                    block_contents_pinned, user_defined_timestamps_persisted,
                    protection_bytes_per_key, kv_checksum,
@@ -709,6 +725,7 @@ class DataBlockIter final : public BlockIter<Slice> {
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    restart_key_prefixes_ = restart_key_prefixes;
   }
 
   Slice value() const override {
@@ -785,8 +802,21 @@ class DataBlockIter final : public BlockIter<Slice> {
   int32_t prev_entries_idx_ = -1;
 
   DataBlockHashIndex* data_block_hash_index_;
+  // The array of RestartKeyPrefix() of each restart key, or nullptr if the
+  // block does not have one.
+  const char* restart_key_prefixes_ = nullptr;
 
   bool SeekForGetImpl(const Slice& target);
+  // Linear seek for `target` within the restart interval `restart_index`,
+  // stopping at the first key not less than `target`, which may be the first
+  // key of the next restart interval.
+  void SeekForGetInRestartInterval(const Slice& target,
+                                   uint32_t restart_index);
+  // Same contract as BinarySeek(), but first narrows the range of restart
+  // points with `restart_key_prefixes_`, so that only restart keys sharing
+  // the prefix of `target` are decoded and compared.
+  bool RestartKeyPrefixSeek(const Slice& target, uint32_t* index,
+                            bool* skip_linear_scan);
 };
 
 // Iterator over MetaBlocks.  MetaBlocks are similar to Data Blocks and
@@ -831,7 +861,8 @@ class MetaBlockIter final : public BlockIter<Slice> {
 
 class IndexBlockIter final : public BlockIter<IndexValue> {
  public:
-  IndexBlockIter() : BlockIter(), prefix_index_(nullptr) {}
+  IndexBlockIter()
+      : BlockIter(), prefix_index_(nullptr), learned_index_(nullptr) {}
 
   // key_includes_seq, default true, means that the keys are in internal key
   // format.
@@ -844,13 +875,15 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                   bool value_is_full, bool block_contents_pinned,
                   bool user_defined_timestamps_persisted,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
-                  uint32_t block_restart_interval) {
+                  uint32_t block_restart_interval,
+                  const BlockLearnedIndex* learned_index = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts,
                    kDisableGlobalSequenceNumber, block_contents_pinned,
                    user_defined_timestamps_persisted, protection_bytes_per_key,
                    kv_checksum, block_restart_interval);
     raw_key_.SetIsUserKey(!key_includes_seq);
     prefix_index_ = prefix_index;
+    learned_index_ = learned_index;
     value_delta_encoded_ = !value_is_full;
     have_first_key_ = have_first_key;
     if (have_first_key_ && global_seqno != kDisableGlobalSequenceNumber) {
@@ -920,6 +953,7 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   bool value_delta_encoded_;
   bool have_first_key_;  // value includes first_internal_key
   BlockPrefixIndex* prefix_index_;
+  const BlockLearnedIndex* learned_index_;
   // Whether the value is delta encoded. In that case the value is assumed to be
   // BlockHandle. The first value in each restart interval is the full encoded
   // BlockHandle; the restart of encoded size part of the BlockHandle. The
@@ -958,6 +992,11 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                             uint32_t left, uint32_t right, uint32_t* index,
                             bool* prefix_may_exist);
   inline int CompareBlockKey(uint32_t block_index, const Slice& target);
+  // Like BinarySeek(), but starts from the range of restart points predicted
+  // by `learned_index_`. The restart keys just outside of the range are
+  // checked first, so a wrong prediction only widens the search.
+  bool LearnedSeek(const Slice& target, uint32_t* index,
+                   bool* skip_linear_scan);
 
   inline bool ParseNextIndexKey();
 
@@ -11,7 +11,9 @@
 
 #include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <cstdio>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -26,6 +28,7 @@
 #include "cache/cache_key.h"
 #include "cache/cache_reservation_manager.h"
 #include "db/dbformat.h"
+#include "db/range_tombstone_fragmenter.h"
 #include "index_builder.h"
 #include "logging/logging.h"
 #include "memory/memory_allocator_impl.h"
@@ -52,6 +55,7 @@
 #include "util/compression.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
+#include "util/vector_iterator.h"
 #include "util/work_queue.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -289,6 +293,11 @@ struct BlockBasedTableBuilder::Rep {
   // compressing any data blocks.
   std::vector<std::string> data_block_buffers;
   BlockBuilder range_del_block;
+  // Copies of the range_del_block entries, to be fragmented for the
+  // fragmented range deletion block. See
+  // BlockBasedTableOptions::persist_fragmented_range_deletions.
+  std::vector<std::string> range_del_keys;
+  std::vector<std::string> range_del_values;
 
   InternalKeySliceTransform internal_prefix_transform;
   std::unique_ptr<IndexBuilder> index_builder;
@@ -458,7 +467,12 @@ struct BlockBasedTableBuilder::Rep {
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
                    table_options.data_block_hash_table_util_ratio, ts_sz,
-                   persist_user_defined_timestamps),
+                   persist_user_defined_timestamps, false /* is_user_key */,
+                   table_options.data_block_restart_key_prefixes &&
+                       ts_sz == 0 &&
+                       tbo.internal_comparator.user_comparator() ==
+                           BytewiseComparator(),
+                   table_options.data_block_hash_index_wide),
         range_del_block(
             1 /* block_restart_interval */, true /* use_delta_encoding */,
             false /* use_value_delta_encoding */,
@@ -722,6 +736,16 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
   CompressQueue compress_queue;
   std::vector<port::Thread> compress_thread_pool;
 
+  // Set instead of compress_thread_pool when blocks are compressed on
+  // BlockBasedTableOptions::compression_worker_pool. compress_fn compresses
+  // one block and passes it to the write thread.
+  CompressionWorkerPool* worker_pool = nullptr;
+  std::function<void(BlockRep*)> compress_fn;
+  // Number of blocks submitted to worker_pool whose task has not returned.
+  size_t worker_pool_tasks = 0;
+  std::mutex worker_pool_mutex;
+  std::condition_variable worker_pool_cond;
+
   // Write queue will pass references to BlockRep::slot in block_rep_buf,
   // and those references are always valid before the corresponding
   // BlockRep::slot is destructed, which is before the destruction of
@@ -899,7 +923,9 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
     if (!write_queue.push(block_rep->slot.get())) {
       return;
     }
-    if (!compress_queue.push(block_rep)) {
+    if (worker_pool != nullptr) {
+      SubmitToWorkerPool(block_rep);
+    } else if (!compress_queue.push(block_rep)) {
       return;
     }
 
@@ -924,7 +950,30 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
     }
   }
 
+  // Wait until all the tasks submitted to worker_pool have returned, since
+  // they refer to this object.
+  void WaitForWorkerPoolTasks() {
+    std::unique_lock<std::mutex> lock(worker_pool_mutex);
+    worker_pool_cond.wait(lock, [this] { return worker_pool_tasks == 0; });
+  }
+
  private:
+  void SubmitToWorkerPool(BlockRep* block_rep) {
+    {
+      std::lock_guard<std::mutex> lock(worker_pool_mutex);
+      ++worker_pool_tasks;
+    }
+    worker_pool->Submit(
+        [this, block_rep] {
+          compress_fn(block_rep);
+          std::lock_guard<std::mutex> lock(worker_pool_mutex);
+          if (--worker_pool_tasks == 0) {
+            worker_pool_cond.notify_all();
+          }
+        },
+        block_rep->data->size());
+  }
+
   BlockRep* PrepareBlockInternal(CompressionType compression_type,
                                  const Slice* first_key_in_next_block) {
     BlockRep* block_rep = nullptr;
@@ -1072,6 +1121,11 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
   } else if (value_type == kTypeRangeDeletion) {
     // TODO(yuzhangyu): handle range deletion entries for UDT in memtable only.
     r->range_del_block.Add(key, value);
+    if (r->table_options.persist_fragmented_range_deletions &&
+        r->ts_sz == 0) {
+      r->range_del_keys.emplace_back(key.data(), key.size());
+      r->range_del_values.emplace_back(value.data(), value.size());
+    }
     // TODO offset passed in is not accurate for parallel compression case
     NotifyCollectTableCollectorsOnAdd(key, value, r->get_offset(),
                                       r->table_properties_collectors,
@@ -1468,13 +1522,30 @@ void BlockBasedTableBuilder::BGWorkWriteMaybeCompressedBlock() {
 void BlockBasedTableBuilder::StartParallelCompression() {
   rep_->pc_rep.reset(
       new ParallelCompressionRep(rep_->compression_opts.parallel_threads));
-  rep_->pc_rep->compress_thread_pool.reserve(
-      rep_->compression_opts.parallel_threads);
-  for (uint32_t i = 0; i < rep_->compression_opts.parallel_threads; i++) {
-    rep_->pc_rep->compress_thread_pool.emplace_back([this, i] {
-      BGWorkCompression(*(rep_->compression_ctxs[i]),
-                        rep_->verify_ctxs[i].get());
-    });
+  if (rep_->table_options.compression_worker_pool) {
+    // Each BlockRep is compressed by at most one task at a time, so it can
+    // use the compression context with the same index.
+    rep_->pc_rep->worker_pool =
+        rep_->table_options.compression_worker_pool.get();
+    rep_->pc_rep->compress_fn = [this](ParallelCompressionRep::BlockRep* b) {
+      const size_t i =
+          static_cast<size_t>(b - rep_->pc_rep->block_rep_buf.data());
+      CompressAndVerifyBlock(b->contents, true, /* is_data_block*/
+                             *(rep_->compression_ctxs[i]),
+                             rep_->verify_ctxs[i].get(),
+                             b->compressed_data.get(), &b->compressed_contents,
+                             &(b->compression_type), &b->status);
+      b->slot->Fill(b);
+    };
+  } else {
+    rep_->pc_rep->compress_thread_pool.reserve(
+        rep_->compression_opts.parallel_threads);
+    for (uint32_t i = 0; i < rep_->compression_opts.parallel_threads; i++) {
+      rep_->pc_rep->compress_thread_pool.emplace_back([this, i] {
+        BGWorkCompression(*(rep_->compression_ctxs[i]),
+                          rep_->verify_ctxs[i].get());
+      });
+    }
   }
   rep_->pc_rep->write_thread.reset(
       new port::Thread([this] { BGWorkWriteMaybeCompressedBlock(); }));
@@ -1487,6 +1558,7 @@ void BlockBasedTableBuilder::StopParallelCompression() {
   }
   rep_->pc_rep->write_queue.finish();
   rep_->pc_rep->write_thread->join();
+  rep_->pc_rep->WaitForWorkerPoolTasks();
 }
 
 Status BlockBasedTableBuilder::status() const { return rep_->GetStatus(); }
@@ -1782,6 +1854,23 @@ void BlockBasedTableBuilder::WriteRangeDelBlock(
                               BlockType::kRangeDeletion);
     meta_index_builder->Add(kRangeDelBlockName, range_del_block_handle);
   }
+  if (ok() && !rep_->range_del_keys.empty()) {
+    auto iter = std::make_unique<VectorIterator>(
+        std::move(rep_->range_del_keys), std::move(rep_->range_del_values),
+        &rep_->internal_comparator);
+    FragmentedRangeTombstoneList fragmented_range_dels(
+        std::move(iter), rep_->internal_comparator);
+    std::string encoded;
+    fragmented_range_dels.EncodeTo(&encoded);
+    BlockHandle fragmented_range_del_block_handle;
+    WriteMaybeCompressedBlock(encoded, kNoCompression,
+                              &fragmented_range_del_block_handle,
+                              BlockType::kFragmentedRangeDeletion);
+    if (ok()) {
+      meta_index_builder->Add(kFragmentedRangeDelBlockName,
+                              fragmented_range_del_block_handle);
+    }
+  }
 }
 
 void BlockBasedTableBuilder::WriteFooter(BlockHandle& metaindex_block_handle,
@@ -181,7 +181,8 @@ static std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kTwoLevelIndexSearch",
          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
         {"kBinarySearchWithFirstKey",
-         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey}};
+         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey},
+        {"kLearnedSearch", BlockBasedTableOptions::IndexType::kLearnedSearch}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::DataBlockIndexType>
@@ -269,6 +270,15 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    data_block_hash_table_util_ratio),
           OptionType::kDouble, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"data_block_hash_index_wide",
+         {offsetof(struct BlockBasedTableOptions, data_block_hash_index_wide),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"data_block_restart_key_prefixes",
+         {offsetof(struct BlockBasedTableOptions,
+                   data_block_restart_key_prefixes),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"checksum",
          {offsetof(struct BlockBasedTableOptions, checksum),
           OptionType::kChecksumType, OptionVerificationType::kNormal,
@@ -366,6 +376,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct BlockBasedTableOptions, enable_index_compression),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"persist_fragmented_range_deletions",
+         {offsetof(struct BlockBasedTableOptions,
+                   persist_fragmented_range_deletions),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"block_align",
          {offsetof(struct BlockBasedTableOptions, block_align),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -753,6 +768,12 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  data_block_hash_table_util_ratio: %lf\n",
            table_options_.data_block_hash_table_util_ratio);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_hash_index_wide: %d\n",
+           table_options_.data_block_hash_index_wide);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_restart_key_prefixes: %d\n",
+           table_options_.data_block_restart_key_prefixes);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  checksum: %d\n", table_options_.checksum);
   ret.append(buffer);
   snprintf(buffer, kBufferSize, "  no_block_cache: %d\n",
@@ -779,6 +800,9 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
     ret.append(buffer);
     ret.append(table_options_.persistent_cache->GetPrintableOptions());
   }
+  snprintf(buffer, kBufferSize, "  compression_worker_pool: %p\n",
+           static_cast<void*>(table_options_.compression_worker_pool.get()));
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  block_size: %" PRIu64 "\n",
            table_options_.block_size);
   ret.append(buffer);
@@ -823,6 +847,9 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  block_align: %d\n",
            table_options_.block_align);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  persist_fragmented_range_deletions: %d\n",
+           table_options_.persist_fragmented_range_deletions);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize,
            "  max_auto_readahead_size: %" ROCKSDB_PRIszt "\n",
            table_options_.max_auto_readahead_size);
@@ -958,6 +985,7 @@ const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kLearnedIndexBlock = "rocksdb.learnedindex";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
@@ -97,6 +97,7 @@ class BlockBasedTableFactory : public TableFactory {
 
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexBlock;
 extern const std::string kPropTrue;
 extern const std::string kPropFalse;
 }  // namespace ROCKSDB_NAMESPACE
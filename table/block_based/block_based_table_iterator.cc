@@ -133,7 +133,11 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
   } else {
     // Need to use the data block.
     if (!same_block) {
-      if (read_options_.async_io && async_prefetch) {
+      // Compaction input iterators do not retry a Seek() that returns
+      // TryAgain, so compaction only prefetches asynchronously in
+      // InitDataBlock().
+      if (read_options_.async_io && async_prefetch &&
+          lookup_context_.caller != TableReaderCaller::kCompaction) {
         AsyncInitDataBlock(/*is_first_pass=*/true);
         if (async_read_in_progress_) {
           // Status::TryAgain indicates asynchronous request for retrieval of
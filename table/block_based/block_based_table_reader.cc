@@ -21,6 +21,7 @@
 
 #include "block_cache.h"
 #include "cache/cache_entry_roles.h"
+#include "cache/cache_helpers.h"
 #include "cache/cache_key.h"
 #include "db/compaction/compaction_picker.h"
 #include "db/dbformat.h"
@@ -56,6 +57,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/hash_index_reader.h"
+#include "table/block_based/learned_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
 #include "table/block_fetcher.h"
@@ -83,6 +85,28 @@ CacheAllocationPtr CopyBufferToHeap(MemoryAllocator* allocator, Slice& buf) {
   memcpy(heap_buf.get(), buf.data(), buf.size());
   return heap_buf;
 }
+
+// The caller that blocks loaded into the block cache by a read are charged
+// to. See ReadOptions::cache_caller.
+CacheCaller GetCacheCaller(const ReadOptions& ro) {
+  if (ro.cache_caller != CacheCaller::kOther) {
+    return ro.cache_caller;
+  }
+  switch (ro.io_activity) {
+    case Env::IOActivity::kGet:
+    case Env::IOActivity::kMultiGet:
+    case Env::IOActivity::kGetEntity:
+    case Env::IOActivity::kMultiGetEntity:
+      return CacheCaller::kPointLookup;
+    case Env::IOActivity::kDBIterator:
+      return CacheCaller::kScan;
+    case Env::IOActivity::kFlush:
+    case Env::IOActivity::kCompaction:
+      return CacheCaller::kCompaction;
+    default:
+      return CacheCaller::kOther;
+  }
+}
 }  // namespace
 
 // Explicitly instantiate templates for each "blocklike" type we use (and
@@ -134,6 +158,7 @@ namespace ROCKSDB_NAMESPACE {
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexBlock;
 
 BlockBasedTable::~BlockBasedTable() { delete rep_; }
 
@@ -986,6 +1011,40 @@ Status BlockBasedTable::ReadRangeDelBlock(
     const InternalKeyComparator& internal_comparator,
     BlockCacheLookupContext* lookup_context) {
   Status s;
+  BlockHandle fragmented_range_del_handle;
+  s = FindOptionalMetaBlock(meta_iter, kFragmentedRangeDelBlockName,
+                            &fragmented_range_del_handle);
+  // The persisted fragments carry the sequence numbers the file was built
+  // with, so they are not used for files assigned a global sequence number.
+  if (s.ok() && !fragmented_range_del_handle.IsNull() &&
+      internal_comparator.user_comparator()->timestamp_size() == 0 &&
+      rep_->global_seqno == kDisableGlobalSequenceNumber) {
+    // The range deletions were fragmented when the file was built. Fall back
+    // to fragmenting the range deletion block on any error.
+    BlockContents contents;
+    Status tmp_status =
+        BlockFetcher(rep_->file.get(), prefetch_buffer, rep_->footer,
+                     read_options, fragmented_range_del_handle, &contents,
+                     rep_->ioptions, false /* decompress */,
+                     false /*maybe_compressed*/,
+                     BlockType::kFragmentedRangeDeletion,
+                     UncompressionDict::GetEmptyDict(),
+                     rep_->persistent_cache_options)
+            .ReadBlockContents();
+    std::unique_ptr<FragmentedRangeTombstoneList> fragmented_range_dels;
+    if (tmp_status.ok()) {
+      tmp_status = FragmentedRangeTombstoneList::DecodeFrom(
+          contents.data.ToString(), &fragmented_range_dels);
+    }
+    if (tmp_status.ok()) {
+      TEST_SYNC_POINT("BlockBasedTable::ReadRangeDelBlock:Fragmented");
+      rep_->fragmented_range_dels = std::move(fragmented_range_dels);
+      return tmp_status;
+    }
+    ROCKS_LOG_WARN(rep_->ioptions.logger,
+                   "Failed to read fragmented range deletion block: %s",
+                   tmp_status.ToString().c_str());
+  }
   BlockHandle range_del_handle;
   s = FindOptionalMetaBlock(meta_iter, kRangeDelBlockName, &range_del_handle);
   if (!s.ok()) {
@@ -1548,6 +1607,9 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
   const bool no_io = (ro.read_tier == kBlockCacheTier);
   BlockCacheInterface<TBlocklike> block_cache{
       rep_->table_options.block_cache.get()};
+  // Blocks inserted below, including the ones promoted from a secondary
+  // cache by the lookup, are charged to the caller of the read.
+  CacheCallerScope caller_scope(GetCacheCaller(ro));
   // First, try to get the block from the cache
   //
   // If either block cache is enabled, we'll try to read from it.
@@ -2552,6 +2614,10 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kRangeDeletion;
   }
 
+  if (meta_block_name == kFragmentedRangeDelBlockName) {
+    return BlockType::kFragmentedRangeDeletion;
+  }
+
   if (meta_block_name == kHashIndexPrefixesBlock) {
     return BlockType::kHashIndexPrefixes;
   }
@@ -2560,6 +2626,10 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kHashIndexMetadata;
   }
 
+  if (meta_block_name == kLearnedIndexBlock) {
+    return BlockType::kLearnedIndex;
+  }
+
   if (meta_block_name == kIndexBlockName) {
     return BlockType::kIndex;
   }
@@ -2709,6 +2779,11 @@ Status BlockBasedTable::CreateIndexReader(
                                        index_reader);
       }
     }
+    case BlockBasedTableOptions::kLearnedSearch: {
+      return LearnedIndexReader::Create(this, ro, prefetch_buffer, meta_iter,
+                                        use_cache, prefetch, pin,
+                                        lookup_context, index_reader);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + std::to_string(rep_->index_type);
@@ -2946,6 +3021,9 @@ Status BlockBasedTable::DumpTable(WritableFile* out_file) {
       } else if (metaindex_iter->key() == kRangeDelBlockName) {
         out_stream << "  Range deletion block handle: "
                    << metaindex_iter->value().ToString(true) << "\n";
+      } else if (metaindex_iter->key() == kFragmentedRangeDelBlockName) {
+        out_stream << "  Fragmented range deletion block handle: "
+                   << metaindex_iter->value().ToString(true) << "\n";
       }
     }
     out_stream << "\n";
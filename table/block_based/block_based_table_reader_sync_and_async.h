@@ -491,6 +491,8 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
         }
 
         if (block_cache) {
+          // Entries promoted from a secondary cache are inserted here.
+          CacheCallerScope caller_scope(GetCacheCaller(read_options));
           block_cache.get()->WaitAll(&async_handles[0], cache_lookup_count);
         }
         size_t lookup_idx = 0;
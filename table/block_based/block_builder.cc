@@ -28,8 +28,12 @@
 //
 // The trailer of the block has the form:
 //     restarts: uint32[num_restarts]
+//     restart_key_prefixes: uint64[num_restarts] (optional)
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+// restart_key_prefixes[i], if present, is RestartKeyPrefix() of the user key
+// at the ith restart point. The data block hash index, if any, follows the
+// restart key prefixes.
 
 #include "table/block_based/block_builder.h"
 
@@ -48,12 +52,14 @@ BlockBuilder::BlockBuilder(
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
     double data_block_hash_table_util_ratio, size_t ts_sz,
-    bool persist_user_defined_timestamps, bool is_user_key)
+    bool persist_user_defined_timestamps, bool is_user_key,
+    bool restart_key_prefixes, bool data_block_hash_index_wide)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
       strip_ts_sz_(persist_user_defined_timestamps ? 0 : ts_sz),
       is_user_key_(is_user_key),
+      restart_key_prefixes_enabled_(restart_key_prefixes),
       restarts_(1, 0),  // First restart point is at offset 0
       counter_(0),
       finished_(false) {
@@ -62,7 +68,7 @@ BlockBuilder::BlockBuilder(
       break;
     case BlockBasedTableOptions::kDataBlockBinaryAndHash:
       data_block_hash_index_builder_.Initialize(
-          data_block_hash_table_util_ratio);
+          data_block_hash_table_util_ratio, data_block_hash_index_wide);
       break;
     default:
       assert(0);
@@ -75,6 +81,7 @@ void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.resize(1);  // First restart point is at offset 0
   assert(restarts_[0] == 0);
+  restart_key_prefixes_.clear();
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
   counter_ = 0;
   finished_ = false;
@@ -110,6 +117,9 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
 
   if (counter_ >= block_restart_interval_) {
     estimate += sizeof(uint32_t);  // a new restart entry.
+    if (restart_key_prefixes_enabled_) {
+      estimate += sizeof(uint64_t);
+    }
   }
 
   estimate += sizeof(int32_t);  // varint for shared prefix length.
@@ -130,16 +140,28 @@ Slice BlockBuilder::Finish() {
   }
 
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  const bool has_restart_key_prefixes = !restart_key_prefixes_.empty();
+  if (has_restart_key_prefixes) {
+    assert(restart_key_prefixes_.size() == restarts_.size());
+    for (uint64_t prefix : restart_key_prefixes_) {
+      PutFixed64(&buffer_, prefix);
+    }
+  }
   BlockBasedTableOptions::DataBlockIndexType index_type =
       BlockBasedTableOptions::kDataBlockBinarySearch;
-  if (data_block_hash_index_builder_.Valid() &&
-      CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
-    data_block_hash_index_builder_.Finish(buffer_);
-    index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  if (data_block_hash_index_builder_.Valid()) {
+    const bool wide =
+        data_block_hash_index_builder_.RequiresWide() ||
+        CurrentSizeEstimate() > kMaxBlockSizeSupportedByHashIndex;
+    if (!wide || data_block_hash_index_builder_.AllowWide()) {
+      data_block_hash_index_builder_.Finish(buffer_, wide);
+      index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
+    }
   }
 
   // footer is a packed format of data_block_index_type and num_restarts
-  uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  uint32_t block_footer = PackIndexTypeAndNumRestarts(
+      index_type, num_restarts, has_restart_key_prefixes);
 
   PutFixed32(&buffer_, block_footer);
   finished_ = true;
@@ -214,6 +236,14 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
 
   const size_t non_shared = key_to_persist.size() - shared;
 
+  if (restart_key_prefixes_enabled_ && counter_ == 0) {
+    // This key starts a restart interval.
+    assert(!is_user_key_);
+    restart_key_prefixes_.push_back(
+        RestartKeyPrefix(ExtractUserKey(key_to_persist)));
+    estimate_ += sizeof(uint64_t);
+  }
+
   if (use_value_delta_encoding_) {
     // Add "<shared><non_shared>" to buffer_
     PutVarint32Varint32(&buffer_, static_cast<uint32_t>(shared),
@@ -75,6 +75,8 @@ const std::array<const Cache::CacheItemHelper*,
         nullptr,  // kHashIndexMetadata
         nullptr,  // kMetaIndex (not yet stored in block cache)
         BlockCacheInterface<Block_kIndex>::GetFullHelper(),
+        nullptr,  // kFragmentedRangeDeletion (read once on open)
+        nullptr,  // kLearnedIndex
         nullptr,  // kInvalid
     }};
 
@@ -92,6 +94,8 @@ const std::array<const Cache::CacheItemHelper*,
         nullptr,  // kHashIndexMetadata
         nullptr,  // kMetaIndex (not yet stored in block cache)
         BlockCacheInterface<Block_kIndex>::GetBasicHelper(),
+        nullptr,  // kFragmentedRangeDeletion (read once on open)
+        nullptr,  // kLearnedIndex
         nullptr,  // kInvalid
     }};
 }  // namespace
@@ -0,0 +1,174 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/block_learned_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+uint64_t BlockLearnedIndex::KeyToPosition(const Slice& prefix,
+                                          const Slice& user_key) {
+  const size_t n = std::min(prefix.size(), user_key.size());
+  int cmp = memcmp(user_key.data(), prefix.data(), n);
+  if (cmp < 0 || (cmp == 0 && user_key.size() < prefix.size())) {
+    return 0;
+  }
+  if (cmp > 0) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  uint64_t position = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    size_t offset = prefix.size() + i;
+    uint8_t byte = offset < user_key.size()
+                       ? static_cast<uint8_t>(user_key.data()[offset])
+                       : 0;
+    position = (position << 8) | byte;
+  }
+  return position;
+}
+
+void BlockLearnedIndex::Builder::Finish(std::string* contents) {
+  contents->clear();
+  if (keys_.empty()) {
+    return;
+  }
+  const Slice first(keys_.front());
+  const Slice last(keys_.back());
+  size_t prefix_len = 0;
+  const size_t max_prefix_len = std::min(first.size(), last.size());
+  while (prefix_len < max_prefix_len && first[prefix_len] == last[prefix_len]) {
+    prefix_len++;
+  }
+  const Slice prefix(first.data(), prefix_len);
+
+  // Fit the segments with a shrinking cone: a segment is extended as long as
+  // some slope through its first point keeps every point within
+  // `error_bound_` entries of its prediction.
+  std::vector<Segment> segments;
+  double slope_lo = 0;
+  double slope_hi = std::numeric_limits<double>::infinity();
+  uint64_t prev_position = 0;
+  for (size_t i = 0; i < keys_.size(); i++) {
+    uint64_t position = KeyToPosition(prefix, keys_[i]);
+    if (!segments.empty() && position == prev_position) {
+      // Keys that only differ beyond the modeled bytes map to the first of
+      // their entries.
+      continue;
+    }
+    prev_position = position;
+    const uint32_t entry = static_cast<uint32_t>(i);
+    if (!segments.empty()) {
+      const Segment& seg = segments.back();
+      double dx = static_cast<double>(position - seg.first_position);
+      double dy = static_cast<double>(entry - seg.first_entry);
+      double lo = std::max(slope_lo, (dy - error_bound_) / dx);
+      double hi = std::min(slope_hi, (dy + error_bound_) / dx);
+      if (lo <= hi) {
+        slope_lo = lo;
+        slope_hi = hi;
+        continue;
+      }
+      segments.back().slope =
+          slope_hi == std::numeric_limits<double>::infinity()
+              ? slope_lo
+              : (slope_lo + slope_hi) / 2;
+    }
+    segments.push_back({position, entry, 0});
+    slope_lo = 0;
+    slope_hi = std::numeric_limits<double>::infinity();
+  }
+  segments.back().slope = slope_hi == std::numeric_limits<double>::infinity()
+                              ? slope_lo
+                              : (slope_lo + slope_hi) / 2;
+
+  PutVarint32(contents, restart_interval_);
+  PutVarint32(contents, error_bound_);
+  PutVarint32(contents, static_cast<uint32_t>(keys_.size()));
+  PutLengthPrefixedSlice(contents, prefix);
+  PutVarint32(contents, static_cast<uint32_t>(segments.size()));
+  for (const Segment& seg : segments) {
+    PutFixed64(contents, seg.first_position);
+    PutFixed32(contents, seg.first_entry);
+    uint64_t slope_bits;
+    static_assert(sizeof(slope_bits) == sizeof(seg.slope), "");
+    memcpy(&slope_bits, &seg.slope, sizeof(slope_bits));
+    PutFixed64(contents, slope_bits);
+  }
+}
+
+Status BlockLearnedIndex::Create(
+    const Slice& contents, std::unique_ptr<BlockLearnedIndex>* learned_index) {
+  Slice input = contents;
+  std::unique_ptr<BlockLearnedIndex> result(new BlockLearnedIndex());
+  Slice prefix;
+  uint32_t num_segments = 0;
+  if (!GetVarint32(&input, &result->restart_interval_) ||
+      !GetVarint32(&input, &result->error_bound_) ||
+      !GetVarint32(&input, &result->num_entries_) ||
+      !GetLengthPrefixedSlice(&input, &prefix) ||
+      !GetVarint32(&input, &num_segments) || result->restart_interval_ == 0 ||
+      num_segments == 0 || input.size() != num_segments * size_t{20}) {
+    return Status::Corruption("Corrupted learned index block");
+  }
+  result->prefix_.assign(prefix.data(), prefix.size());
+  result->segments_.reserve(num_segments);
+  for (uint32_t i = 0; i < num_segments; i++) {
+    Segment seg;
+    seg.first_position = DecodeFixed64(input.data());
+    seg.first_entry = DecodeFixed32(input.data() + 8);
+    uint64_t slope_bits = DecodeFixed64(input.data() + 12);
+    memcpy(&seg.slope, &slope_bits, sizeof(seg.slope));
+    input.remove_prefix(20);
+    if (!result->segments_.empty() &&
+        (seg.first_position <= result->segments_.back().first_position ||
+         seg.first_entry <= result->segments_.back().first_entry)) {
+      return Status::Corruption("Corrupted learned index block");
+    }
+    result->segments_.push_back(seg);
+  }
+  *learned_index = std::move(result);
+  return Status::OK();
+}
+
+void BlockLearnedIndex::GetRestartRange(const Slice& user_key,
+                                        uint32_t num_restarts, uint32_t* first,
+                                        uint32_t* last) const {
+  assert(num_restarts > 0);
+  const uint64_t position = KeyToPosition(prefix_, user_key);
+  auto it = std::upper_bound(segments_.begin(), segments_.end(), position,
+                             [](uint64_t p, const Segment& seg) {
+                               return p < seg.first_position;
+                             });
+  double predicted = 0;
+  if (it != segments_.begin()) {
+    const Segment& seg = *(it - 1);
+    predicted =
+        seg.first_entry +
+        seg.slope * static_cast<double>(position - seg.first_position);
+    // A segment never predicts past the first entry of the next one.
+    double next_entry = it == segments_.end() ? num_entries_ : it->first_entry;
+    predicted = std::min(predicted, next_entry);
+  }
+  // One extra entry on each side covers keys between two modeled entries,
+  // whose result is the entry after the predicted one.
+  const double margin = static_cast<double>(error_bound_) + 1;
+  double lo = std::max(predicted - margin, 0.0);
+  double hi = std::max(predicted + margin, 0.0);
+  uint64_t lo_restart = static_cast<uint64_t>(lo) / restart_interval_;
+  uint64_t hi_restart =
+      std::min(static_cast<uint64_t>(std::min(hi, 4294967295.0)) /
+                   restart_interval_,
+               uint64_t{num_restarts} - 1);
+  *first = static_cast<uint32_t>(std::min(lo_restart, hi_restart));
+  *last = static_cast<uint32_t>(hi_restart);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,102 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A piecewise-linear model of the index block of a table, used by
+// BlockBasedTableOptions::kLearnedSearch. It maps a user key to the position
+// of its entry in the index block, with a bounded error, so that a seek only
+// needs to binary search a small range of restart points.
+//
+// A key is mapped to a number by skipping the prefix shared by all index
+// keys, and reading the next 8 bytes as a big-endian integer. This preserves
+// the bytewise order, so the model only applies to tables with
+// BytewiseComparator, and works best with fixed-width keys whose distinct
+// bytes are within the first 8 bytes after the common prefix, e.g. encoded
+// timestamps or row ids.
+//
+// The prediction is only a hint. IndexBlockIter checks the restart keys at
+// both ends of the predicted range, so a bad prediction costs comparisons,
+// never correctness.
+//
+// Format:
+//   restart interval: varint32
+//   error bound: varint32
+//   number of index entries: varint32
+//   common prefix: varint32 length + bytes
+//   number of segments: varint32
+//   per segment, in order of key:
+//     first key position: fixed64
+//     first entry: fixed32
+//     slope: fixed64 (bits of a double)
+class BlockLearnedIndex {
+ public:
+  class Builder {
+   public:
+    Builder(uint32_t restart_interval, uint32_t error_bound)
+        : restart_interval_(restart_interval), error_bound_(error_bound) {}
+
+    // Adds the user key of the next index entry. Keys must be added in
+    // ascending order.
+    void Add(const Slice& user_key) {
+      keys_.emplace_back(user_key.data(), user_key.size());
+    }
+
+    // Trains the model on the added keys and encodes it into `*contents`.
+    // Leaves `*contents` empty if no key was added.
+    void Finish(std::string* contents);
+
+   private:
+    const uint32_t restart_interval_;
+    const uint32_t error_bound_;
+    std::vector<std::string> keys_;
+  };
+
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<BlockLearnedIndex>* learned_index);
+
+  // Sets [*first, *last] to the range of restart points that is expected to
+  // contain the last restart point with a key less than or equal to
+  // `user_key`.
+  void GetRestartRange(const Slice& user_key, uint32_t num_restarts,
+                       uint32_t* first, uint32_t* last) const;
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(BlockLearnedIndex) + prefix_.capacity() +
+           segments_.capacity() * sizeof(Segment);
+  }
+
+  // Exposed for testing.
+  size_t NumSegments() const { return segments_.size(); }
+
+ private:
+  struct Segment {
+    uint64_t first_position;
+    uint32_t first_entry;
+    double slope;
+  };
+
+  BlockLearnedIndex() = default;
+
+  static uint64_t KeyToPosition(const Slice& prefix, const Slice& user_key);
+
+  uint32_t restart_interval_ = 1;
+  uint32_t error_bound_ = 0;
+  uint32_t num_entries_ = 0;
+  std::string prefix_;
+  std::vector<Segment> segments_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -20,7 +20,11 @@ void BlockPrefetcher::PrefetchIfNeeded(
   const size_t len = BlockBasedTable::BlockSizeWithTrailer(handle);
   const size_t offset = handle.offset();
   if (is_for_compaction) {
-    if (!rep->file->use_direct_io() && compaction_readahead_size_ > 0) {
+    // With async_io, the internal prefetch buffer is used so that the next
+    // readahead chunk is read in the background while the current one is
+    // consumed.
+    if (!rep->file->use_direct_io() && compaction_readahead_size_ > 0 &&
+        !read_options.async_io) {
       // If FS supports prefetching (readahead_limit_ will be non zero in that
       // case) and current block exists in prefetch buffer then return.
       if (offset + len <= readahead_limit_) {
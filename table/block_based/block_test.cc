@@ -286,6 +286,99 @@ TEST_P(BlockTest, IndexHashWithSharedPrefix) {
                      shouldPersistUDT());
 }
 
+TEST_P(BlockTest, RestartKeyPrefixes) {
+  if (isUDTEnabled()) {
+    // Restart key prefixes are only written for bytewise ordered keys.
+    return;
+  }
+  Random rnd(301);
+  // Large blocks do not get a hash index, small ones may.
+  for (int num_keys : {300, 30000}) {
+    for (int restart_interval : {1, 16}) {
+      SCOPED_TRACE("num_keys=" + std::to_string(num_keys) +
+                   " restart_interval=" + std::to_string(restart_interval));
+      std::vector<std::string> keys;
+      std::vector<std::string> values;
+      // Groups of keys share the first 8 bytes, so some seeks need to
+      // compare full keys among restart keys with the same prefix.
+      GenerateRandomKVs(&keys, &values, 0, num_keys, 2 /* step */,
+                        4 /* padding_size */, 3 /* keys_share_prefix */);
+
+      std::string raw_blocks[2];
+      for (int with_prefixes = 0; with_prefixes < 2; with_prefixes++) {
+        BlockBuilder builder(restart_interval, keyUseDeltaEncoding(),
+                             false /* use_value_delta_encoding */,
+                             dataBlockIndexType(),
+                             0.75 /* data_block_hash_table_util_ratio */,
+                             0 /* ts_sz */, true /* persist_udt */,
+                             false /* is_user_key */, with_prefixes != 0);
+        for (size_t i = 0; i < keys.size(); i++) {
+          builder.Add(keys[i], values[i]);
+        }
+        raw_blocks[with_prefixes] = builder.Finish().ToString();
+      }
+      Block plain_block{BlockContents(raw_blocks[0])};
+      Block prefixed_block{BlockContents(raw_blocks[1])};
+      ASSERT_EQ(plain_block.NumRestarts(), prefixed_block.NumRestarts());
+      ASSERT_EQ(plain_block.IndexType(), prefixed_block.IndexType());
+      ASSERT_EQ(raw_blocks[0].size() +
+                    plain_block.NumRestarts() * sizeof(uint64_t),
+                raw_blocks[1].size());
+
+      std::unique_ptr<DataBlockIter> plain_iter(plain_block.NewDataIterator(
+          BytewiseComparator(), kDisableGlobalSequenceNumber));
+      std::unique_ptr<DataBlockIter> prefixed_iter(
+          prefixed_block.NewDataIterator(BytewiseComparator(),
+                                         kDisableGlobalSequenceNumber));
+
+      // Same contents.
+      size_t count = 0;
+      for (prefixed_iter->SeekToFirst(); prefixed_iter->Valid();
+           prefixed_iter->Next()) {
+        ASSERT_EQ(keys[count], prefixed_iter->key());
+        ASSERT_EQ(values[count], prefixed_iter->value());
+        count++;
+      }
+      ASSERT_OK(prefixed_iter->status());
+      ASSERT_EQ(keys.size(), count);
+      for (const auto& key : keys) {
+        ASSERT_TRUE(prefixed_iter->SeekForGet(key));
+        ASSERT_TRUE(prefixed_iter->Valid());
+        ASSERT_EQ(key, prefixed_iter->key());
+      }
+
+      // Same seek results, for existing and missing keys, including ones
+      // that only differ beyond the first 8 bytes.
+      std::vector<std::string> targets = {
+          GenerateInternalKey(-1, 0, 0, nullptr),
+          GenerateInternalKey(num_keys + 1, 0, 0, nullptr)};
+      for (int i = 0; i < 2000; i++) {
+        int id = static_cast<int>(rnd.Uniform(num_keys + 2)) - 1;
+        targets.push_back(GenerateInternalKey(
+            id, static_cast<int>(rnd.Uniform(4)), 0, nullptr));
+        targets.push_back(keys[rnd.Uniform(static_cast<int>(keys.size()))]);
+      }
+      for (const auto& target : targets) {
+        plain_iter->Seek(target);
+        prefixed_iter->Seek(target);
+        ASSERT_OK(prefixed_iter->status());
+        ASSERT_EQ(plain_iter->Valid(), prefixed_iter->Valid());
+        if (plain_iter->Valid()) {
+          ASSERT_EQ(plain_iter->key(), prefixed_iter->key());
+        }
+
+        plain_iter->SeekForPrev(target);
+        prefixed_iter->SeekForPrev(target);
+        ASSERT_OK(prefixed_iter->status());
+        ASSERT_EQ(plain_iter->Valid(), prefixed_iter->Valid());
+        if (plain_iter->Valid()) {
+          ASSERT_EQ(plain_iter->key(), prefixed_iter->key());
+        }
+      }
+    }
+  }
+}
+
 // Param 0: key use delta encoding
 // Param 1: user-defined timestamp test mode
 // Param 2: data block index type. User-defined timestamp feature is not
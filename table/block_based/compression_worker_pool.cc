@@ -0,0 +1,160 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/table.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+class CompressionWorkerPoolImpl : public CompressionWorkerPool {
+ public:
+  CompressionWorkerPoolImpl(int num_threads, size_t max_inflight_bytes)
+      : max_inflight_bytes_(max_inflight_bytes) {
+    const size_t n = static_cast<size_t>(std::max(num_threads, 1));
+    queues_.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+      queues_.emplace_back(new WorkerQueue());
+    }
+    threads_.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+      threads_.emplace_back([this, i] { WorkerLoop(i); });
+    }
+  }
+
+  // Runs the tasks that are still queued, then joins the threads.
+  ~CompressionWorkerPoolImpl() override {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      shutdown_ = true;
+    }
+    work_cv_.notify_all();
+    space_cv_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void Submit(std::function<void()>&& task, size_t charge) override {
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      space_cv_.wait(lock, [&] {
+        return shutdown_ || max_inflight_bytes_ == 0 || inflight_bytes_ == 0 ||
+               inflight_bytes_ + charge <= max_inflight_bytes_;
+      });
+      inflight_bytes_ += charge;
+    }
+    // Spread tasks over the queues. A queue whose owner is busy is drained
+    // by the other threads.
+    WorkerQueue* queue =
+        queues_[next_queue_.fetch_add(1, std::memory_order_relaxed) %
+                queues_.size()]
+            .get();
+    {
+      std::lock_guard<std::mutex> lock(queue->mu);
+      queue->tasks.push_back(Task{std::move(task), charge});
+    }
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      ++pending_;
+    }
+    work_cv_.notify_one();
+  }
+
+  int GetNumThreads() const override {
+    return static_cast<int>(threads_.size());
+  }
+
+  size_t GetInflightBytes() const override {
+    std::lock_guard<std::mutex> lock(mu_);
+    return inflight_bytes_;
+  }
+
+ private:
+  struct Task {
+    std::function<void()> fn;
+    size_t charge;
+  };
+
+  struct WorkerQueue {
+    std::mutex mu;
+    std::deque<Task> tasks;
+  };
+
+  // Takes the oldest task of the worker's own queue, or else the oldest task
+  // of another queue. Oldest first keeps the blocks of each table builder
+  // close to the order in which its write thread consumes them.
+  bool TryPop(size_t worker, Task* task) {
+    for (size_t i = 0; i < queues_.size(); i++) {
+      WorkerQueue* queue = queues_[(worker + i) % queues_.size()].get();
+      std::lock_guard<std::mutex> lock(queue->mu);
+      if (!queue->tasks.empty()) {
+        *task = std::move(queue->tasks.front());
+        queue->tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void WorkerLoop(size_t worker) {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        work_cv_.wait(lock, [this] { return pending_ > 0 || shutdown_; });
+        if (pending_ == 0) {
+          return;
+        }
+        // Reserve one of the queued tasks. Tasks are queued before pending_
+        // is incremented, so there is always one left to pop.
+        --pending_;
+      }
+      Task task;
+      while (!TryPop(worker, &task)) {
+      }
+      task.fn();
+      {
+        std::lock_guard<std::mutex> lock(mu_);
+        inflight_bytes_ -= task.charge;
+      }
+      space_cv_.notify_all();
+    }
+  }
+
+  const size_t max_inflight_bytes_;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<port::Thread> threads_;
+  std::atomic<size_t> next_queue_{0};
+
+  // Protects the fields below. Idle workers wait on work_cv_, and submitters
+  // blocked by the in-flight limit wait on space_cv_.
+  mutable std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable space_cv_;
+  // Number of queued tasks not yet reserved by a worker.
+  size_t pending_ = 0;
+  size_t inflight_bytes_ = 0;
+  bool shutdown_ = false;
+};
+
+}  // namespace
+
+std::shared_ptr<CompressionWorkerPool> NewCompressionWorkerPool(
+    int num_threads, size_t max_inflight_bytes) {
+  return std::make_shared<CompressionWorkerPoolImpl>(num_threads,
+                                                     max_inflight_bytes);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -9,17 +9,39 @@
 
 #pragma once
 
+#include "rocksdb/slice.h"
 #include "rocksdb/table.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+// Set in the block footer when the restart array is followed by an array of
+// restart key prefixes, see
+// BlockBasedTableOptions::data_block_restart_key_prefixes. Like the index
+// type, this bit is valid for any block size, as no block can have 2^30
+// restarts.
+extern const uint32_t kRestartKeyPrefixesFlag;
+
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts);
+    uint32_t num_restarts, bool has_restart_key_prefixes = false);
 
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts);
+    uint32_t* num_restarts, bool* has_restart_key_prefixes = nullptr);
+
+// The first 8 bytes of `user_key` as a big-endian integer, zero-padded. For
+// bytewise ordered keys, a < b implies RestartKeyPrefix(a) <=
+// RestartKeyPrefix(b).
+inline uint64_t RestartKeyPrefix(const Slice& user_key) {
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(prefix); i++) {
+    prefix <<= 8;
+    if (i < user_key.size()) {
+      prefix |= static_cast<uint8_t>(user_key[i]);
+    }
+  }
+  return prefix;
+}
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -9,26 +9,50 @@
 
 #include "rocksdb/slice.h"
 #include "util/coding.h"
+#include "util/fastrange.h"
 #include "util/hash.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// The buckets of a key in the wide format. The secondary bucket comes from
+// remixing the same hash, so that it is independent of the primary one.
+inline void GetWideBuckets(uint32_t hash_value, uint32_t num_buckets,
+                           uint32_t* primary, uint32_t* secondary) {
+  *primary = hash_value % num_buckets;
+  *secondary = FastRange32(hash_value * 0x9E3779B9U, num_buckets);
+  if (*secondary == *primary) {
+    *secondary = (*primary + 1) % num_buckets;
+  }
+}
+}  // namespace
+
 void DataBlockHashIndexBuilder::Add(const Slice& key,
                                     const size_t restart_index) {
   assert(Valid());
-  if (restart_index > kMaxRestartSupportedByHashIndex) {
+  if (restart_index > (allow_wide_ ? kMaxRestartSupportedByWideHashIndex
+                                   : kMaxRestartSupportedByHashIndex)) {
     valid_ = false;
     return;
   }
+  if (restart_index > kMaxRestartSupportedByHashIndex) {
+    requires_wide_ = true;
+  }
 
   uint32_t hash_value = GetSliceHash(key);
   hash_and_restart_pairs_.emplace_back(hash_value,
-                                       static_cast<uint8_t>(restart_index));
+                                       static_cast<uint16_t>(restart_index));
   estimated_num_buckets_ += bucket_per_key_;
 }
 
-void DataBlockHashIndexBuilder::Finish(std::string& buffer) {
+void DataBlockHashIndexBuilder::Finish(std::string& buffer, bool wide) {
   assert(Valid());
+  if (wide) {
+    assert(allow_wide_);
+    FinishWide(buffer);
+    return;
+  }
+  assert(!requires_wide_);
   uint16_t num_buckets = static_cast<uint16_t>(estimated_num_buckets_);
 
   if (num_buckets == 0) {
@@ -45,7 +69,7 @@ void DataBlockHashIndexBuilder::Finish(std::string& buffer) {
   // write the restart_index array
   for (auto& entry : hash_and_restart_pairs_) {
     uint32_t hash_value = entry.first;
-    uint8_t restart_index = entry.second;
+    uint8_t restart_index = static_cast<uint8_t>(entry.second);
     uint16_t buck_idx = static_cast<uint16_t>(hash_value % num_buckets);
     if (buckets[buck_idx] == kNoEntry) {
       buckets[buck_idx] = restart_index;
@@ -67,28 +91,109 @@ void DataBlockHashIndexBuilder::Finish(std::string& buffer) {
   assert(buffer.size() <= kMaxBlockSizeSupportedByHashIndex);
 }
 
+void DataBlockHashIndexBuilder::FinishWide(std::string& buffer) {
+  uint32_t num_buckets = static_cast<uint32_t>(estimated_num_buckets_);
+  if (num_buckets == 0) {
+    num_buckets = 1;  // sanity check
+  }
+  // Same as the narrow format, see Finish().
+  num_buckets |= 1;
+
+  std::vector<uint16_t> buckets(num_buckets, kWideNoEntry);
+  uint32_t prev_hash_value = 0;
+  uint16_t prev_restart_index = kWideNoEntry;
+  for (auto& entry : hash_and_restart_pairs_) {
+    uint32_t hash_value = entry.first;
+    uint16_t restart_index = entry.second;
+    uint32_t primary, secondary;
+    GetWideBuckets(hash_value, num_buckets, &primary, &secondary);
+    if (prev_restart_index != kWideNoEntry && hash_value == prev_hash_value &&
+        restart_index != prev_restart_index) {
+      // Most likely the same user key spanning two restart intervals, which
+      // the point lookup cannot follow, as in the narrow format.
+      buckets[primary] = kWideCollision;
+    } else if (buckets[primary] == kWideNoEntry ||
+               buckets[primary] == restart_index) {
+      buckets[primary] = restart_index;
+    } else if (buckets[primary] != kWideCollision) {
+      if (buckets[secondary] == kWideNoEntry ||
+          buckets[secondary] == restart_index) {
+        buckets[secondary] = restart_index;
+      } else {
+        buckets[primary] = kWideCollision;
+      }
+    }
+    prev_hash_value = hash_value;
+    prev_restart_index = restart_index;
+  }
+
+  for (uint16_t restart_index : buckets) {
+    PutFixed16(&buffer, restart_index);
+  }
+  PutFixed32(&buffer, num_buckets);
+  // WIDE_MARKER
+  PutFixed16(&buffer, 0);
+}
+
 void DataBlockHashIndexBuilder::Reset() {
   estimated_num_buckets_ = 0;
   valid_ = true;
+  requires_wide_ = false;
   hash_and_restart_pairs_.clear();
 }
 
-void DataBlockHashIndex::Initialize(const char* data, uint16_t size,
-                                    uint16_t* map_offset) {
-  assert(size >= sizeof(uint16_t));  // NUM_BUCKETS
-  num_buckets_ = DecodeFixed16(data + size - sizeof(uint16_t));
-  assert(num_buckets_ > 0);
-  assert(size > num_buckets_ * sizeof(uint8_t));
-  *map_offset = static_cast<uint16_t>(size - sizeof(uint16_t) -
-                                      num_buckets_ * sizeof(uint8_t));
+bool DataBlockHashIndex::Initialize(const char* data, uint32_t size,
+                                    uint32_t* map_offset) {
+  if (size < sizeof(uint16_t)) {  // NUM_BUCKETS or WIDE_MARKER
+    return false;
+  }
+  uint16_t narrow_num_buckets = DecodeFixed16(data + size - sizeof(uint16_t));
+  if (narrow_num_buckets != 0) {
+    if (size - sizeof(uint16_t) < narrow_num_buckets * sizeof(uint8_t)) {
+      return false;
+    }
+    wide_ = false;
+    num_buckets_ = narrow_num_buckets;
+    *map_offset = static_cast<uint32_t>(size - sizeof(uint16_t) -
+                                        num_buckets_ * sizeof(uint8_t));
+    return true;
+  }
+
+  const uint32_t trailer_size = sizeof(uint16_t) + sizeof(uint32_t);
+  if (size < trailer_size) {
+    return false;
+  }
+  uint32_t num_buckets = DecodeFixed32(data + size - trailer_size);
+  if (num_buckets == 0 ||
+      (size - trailer_size) / sizeof(uint16_t) < num_buckets) {
+    return false;
+  }
+  wide_ = true;
+  num_buckets_ = num_buckets;
+  *map_offset = static_cast<uint32_t>(size - trailer_size -
+                                      num_buckets_ * sizeof(uint16_t));
+  return true;
 }
 
 uint8_t DataBlockHashIndex::Lookup(const char* data, uint32_t map_offset,
                                    const Slice& key) const {
+  assert(!wide_);
   uint32_t hash_value = GetSliceHash(key);
   uint16_t idx = static_cast<uint16_t>(hash_value % num_buckets_);
   const char* bucket_table = data + map_offset;
   return static_cast<uint8_t>(*(bucket_table + idx * sizeof(uint8_t)));
 }
 
+void DataBlockHashIndex::LookupWide(const char* data, uint32_t map_offset,
+                                    const Slice& key, uint16_t* primary,
+                                    uint16_t* secondary) const {
+  assert(wide_);
+  uint32_t primary_idx, secondary_idx;
+  GetWideBuckets(GetSliceHash(key), num_buckets_, &primary_idx,
+                 &secondary_idx);
+  const char* bucket_table = data + map_offset;
+  *primary = DecodeFixed16(bucket_table + primary_idx * sizeof(uint16_t));
+  *secondary = DecodeFixed16(bucket_table + secondary_idx * sizeof(uint16_t));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -62,12 +62,50 @@ namespace ROCKSDB_NAMESPACE {
 //
 // Note that we only support blocks with #restart_interval < 254. If a block
 // has more restart interval than that, hash index will not be create for it.
+//
+// Wide format
+// -----------
+//
+// With BlockBasedTableOptions::data_block_hash_index_wide, blocks that exceed
+// either limit above get a wide hash index instead:
+//
+// HASH_IDX: [W W W ... W NUM_BUCK_32 WIDE_MARKER]
+//
+// W:           bucket, a uint16_t restart index.
+// NUM_BUCK_32: Number of buckets, a uint32_t.
+// WIDE_MARKER: A uint16_t 0, where the narrow format has its (odd, non-zero)
+//              NUM_BUCK.
+//
+// The special flags are kWideNoEntry=0xFFFF and kWideCollision=0xFFFE, so up
+// to 65534 restart intervals are supported. Offsets are not stored in the
+// index, so there is no limit on the block size.
+//
+// Each key has a primary and a secondary bucket. A key is stored in its
+// primary bucket if it is empty or already holds the key's restart index,
+// else likewise in its secondary bucket. If neither is available, the primary
+// bucket is marked as collision. Buckets are never emptied once used, so:
+//   - an empty primary bucket means the key is not in the block;
+//   - a collision in the primary bucket means falling back to binary seek;
+//   - otherwise the key can only be in the restart interval of the primary
+//     bucket, or in the one of the secondary bucket (which may be a
+//     collision, requiring a binary seek if the primary misses).
+// Compared with the narrow format, the secondary probe makes most of the
+// keys that would have collided still resolvable without a binary seek.
+//
+// When the block footer has the hash index flag, the wide format is told
+// apart from the narrow one by WIDE_MARKER. Blocks with a wide hash index
+// cannot be read by older versions.
 
 const uint8_t kNoEntry = 255;
 const uint8_t kCollision = 254;
 const uint8_t kMaxRestartSupportedByHashIndex = 253;
 
+const uint16_t kWideNoEntry = 0xFFFF;
+const uint16_t kWideCollision = 0xFFFE;
+const uint16_t kMaxRestartSupportedByWideHashIndex = 0xFFFD;
+
 // Because we use uint16_t address, we only support block no more than 64KB
+// with the narrow format.
 const size_t kMaxBlockSizeSupportedByHashIndex = 1u << 16;
 const double kDefaultUtilRatio = 0.75;
 
@@ -76,21 +114,36 @@ class DataBlockHashIndexBuilder {
   DataBlockHashIndexBuilder()
       : bucket_per_key_(-1 /*uninitialized marker*/),
         estimated_num_buckets_(0),
-        valid_(false) {}
+        valid_(false),
+        allow_wide_(false),
+        requires_wide_(false) {}
 
-  void Initialize(double util_ratio) {
+  void Initialize(double util_ratio, bool allow_wide = false) {
     if (util_ratio <= 0) {
       util_ratio = kDefaultUtilRatio;  // sanity check
     }
     bucket_per_key_ = 1 / util_ratio;
     valid_ = true;
+    allow_wide_ = allow_wide;
   }
 
   inline bool Valid() const { return valid_ && bucket_per_key_ > 0; }
+  // Whether the wide format may be used, see Initialize().
+  inline bool AllowWide() const { return allow_wide_; }
+  // Whether the added restart indexes only fit in the wide format.
+  inline bool RequiresWide() const { return requires_wide_; }
   void Add(const Slice& key, const size_t restart_index);
-  void Finish(std::string& buffer);
+  // `wide` selects the wide format, which is required if RequiresWide() or
+  // the block would exceed kMaxBlockSizeSupportedByHashIndex.
+  void Finish(std::string& buffer, bool wide = false);
   void Reset();
   inline size_t EstimateSize() const {
+    if (requires_wide_) {
+      uint32_t estimated_num_buckets =
+          static_cast<uint32_t>(estimated_num_buckets_) | 1;
+      return sizeof(uint16_t) + sizeof(uint32_t) +
+             static_cast<size_t>(estimated_num_buckets) * sizeof(uint16_t);
+    }
     uint16_t estimated_num_buckets =
         static_cast<uint16_t>(estimated_num_buckets_);
 
@@ -102,6 +155,8 @@ class DataBlockHashIndexBuilder {
   }
 
  private:
+  void FinishWide(std::string& buffer);
+
   double bucket_per_key_;  // is the multiplicative inverse of util_ratio_
   double estimated_num_buckets_;
 
@@ -109,29 +164,39 @@ class DataBlockHashIndexBuilder {
   // restart_index is larger than supported. In this case HashIndex is not
   // appended to the block content.
   bool valid_;
+  bool allow_wide_;
+  bool requires_wide_;
 
-  std::vector<std::pair<uint32_t, uint8_t>> hash_and_restart_pairs_;
+  std::vector<std::pair<uint32_t, uint16_t>> hash_and_restart_pairs_;
   friend class DataBlockHashIndex_DataBlockHashTestSmall_Test;
 };
 
 class DataBlockHashIndex {
  public:
-  DataBlockHashIndex() : num_buckets_(0) {}
+  DataBlockHashIndex() : num_buckets_(0), wide_(false) {}
 
-  void Initialize(const char* data, uint16_t size, uint16_t* map_offset);
+  // Returns false if `size` is too small for the index it ends with.
+  bool Initialize(const char* data, uint32_t size, uint32_t* map_offset);
 
+  // Narrow format only. Returns the restart index stored for `key`, kNoEntry
+  // or kCollision.
   uint8_t Lookup(const char* data, uint32_t map_offset, const Slice& key) const;
 
+  // Wide format only. Sets `*primary` and `*secondary` to the contents of the
+  // two buckets of `key`: a restart index, kWideNoEntry or kWideCollision.
+  void LookupWide(const char* data, uint32_t map_offset, const Slice& key,
+                  uint16_t* primary, uint16_t* secondary) const;
+
   inline bool Valid() { return num_buckets_ != 0; }
+  inline bool IsWide() const { return wide_; }
 
  private:
   // To make the serialized hash index compact and to save the space overhead,
-  // here all the data fields persisted in the block are in uint16 format.
-  // We find that a uint16 is large enough to index every offset of a 64KiB
-  // block.
-  // So in other words, DataBlockHashIndex does not support block size equal
-  // or greater then 64KiB.
-  uint16_t num_buckets_;
+  // the data fields persisted in narrow format blocks are in uint16 format,
+  // which is large enough to index every offset of a 64KiB block. The wide
+  // format has a uint32 number of buckets.
+  uint32_t num_buckets_;
+  bool wide_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -23,7 +23,7 @@
 namespace ROCKSDB_NAMESPACE {
 
 bool SearchForOffset(DataBlockHashIndex& index, const char* data,
-                     uint16_t map_offset, const Slice& key,
+                     uint32_t map_offset, const Slice& key,
                      uint8_t& restart_point) {
   uint8_t entry = index.Lookup(data, map_offset, key);
   if (entry == kCollision) {
@@ -95,8 +95,9 @@ TEST(DataBlockHashIndex, DataBlockHashTestSmall) {
 
     Slice s(buffer2);
     DataBlockHashIndex index;
-    uint16_t map_offset;
-    index.Initialize(s.data(), static_cast<uint16_t>(s.size()), &map_offset);
+    uint32_t map_offset;
+    ASSERT_TRUE(index.Initialize(s.data(), static_cast<uint32_t>(s.size()),
+                                 &map_offset));
 
     // the additional hash map should start at the end of the buffer
     ASSERT_EQ(original_size, map_offset);
@@ -134,8 +135,9 @@ TEST(DataBlockHashIndex, DataBlockHashTest) {
 
   Slice s(buffer2);
   DataBlockHashIndex index;
-  uint16_t map_offset;
-  index.Initialize(s.data(), static_cast<uint16_t>(s.size()), &map_offset);
+  uint32_t map_offset;
+  ASSERT_TRUE(index.Initialize(s.data(), static_cast<uint32_t>(s.size()),
+                               &map_offset));
 
   // the additional hash map should start at the end of the buffer
   ASSERT_EQ(original_size, map_offset);
@@ -171,8 +173,9 @@ TEST(DataBlockHashIndex, DataBlockHashTestCollision) {
 
   Slice s(buffer2);
   DataBlockHashIndex index;
-  uint16_t map_offset;
-  index.Initialize(s.data(), static_cast<uint16_t>(s.size()), &map_offset);
+  uint32_t map_offset;
+  ASSERT_TRUE(index.Initialize(s.data(), static_cast<uint32_t>(s.size()),
+                               &map_offset));
 
   // the additional hash map should start at the end of the buffer
   ASSERT_EQ(original_size, map_offset);
@@ -212,8 +215,9 @@ TEST(DataBlockHashIndex, DataBlockHashTestLarge) {
 
   Slice s(buffer2);
   DataBlockHashIndex index;
-  uint16_t map_offset;
-  index.Initialize(s.data(), static_cast<uint16_t>(s.size()), &map_offset);
+  uint32_t map_offset;
+  ASSERT_TRUE(index.Initialize(s.data(), static_cast<uint32_t>(s.size()),
+                               &map_offset));
 
   // the additional hash map should start at the end of the buffer
   ASSERT_EQ(original_size, map_offset);
@@ -365,6 +369,121 @@ TEST(DataBlockHashIndex, BlockSizeExceedMax) {
   }
 }
 
+TEST(DataBlockHashIndex, WideHashIndex) {
+  DataBlockHashIndexBuilder builder;
+  builder.Initialize(0.75 /*util_ratio*/, true /* allow_wide */);
+  const int kNumKeys = 2000;
+  for (int i = 0; i < kNumKeys; i++) {
+    std::string key("key" + std::to_string(i));
+    builder.Add(key, i / 2);
+  }
+  ASSERT_TRUE(builder.Valid());
+  ASSERT_TRUE(builder.RequiresWide());
+
+  std::string buffer("fake");
+  size_t estimated_size = buffer.size() + builder.EstimateSize();
+  builder.Finish(buffer, true /* wide */);
+  ASSERT_EQ(estimated_size, buffer.size());
+
+  DataBlockHashIndex index;
+  uint32_t map_offset;
+  ASSERT_TRUE(index.Initialize(buffer.data(),
+                               static_cast<uint32_t>(buffer.size()),
+                               &map_offset));
+  ASSERT_TRUE(index.IsWide());
+  ASSERT_EQ(4, map_offset);
+
+  int num_collisions = 0;
+  for (int i = 0; i < kNumKeys; i++) {
+    std::string key("key" + std::to_string(i));
+    uint16_t primary, secondary;
+    index.LookupWide(buffer.data(), map_offset, key, &primary, &secondary);
+    if (primary == kWideCollision) {
+      num_collisions++;
+      continue;
+    }
+    ASSERT_NE(kWideNoEntry, primary);
+    if (primary != i / 2) {
+      ASSERT_TRUE(secondary == i / 2 || secondary == kWideCollision);
+    }
+  }
+  // The secondary buckets should resolve most collisions.
+  ASSERT_LT(num_collisions, kNumKeys / 10);
+
+  builder.Reset();
+  ASSERT_FALSE(builder.RequiresWide());
+  builder.Add("key", kMaxRestartSupportedByWideHashIndex);
+  ASSERT_TRUE(builder.Valid());
+  builder.Add("key", kMaxRestartSupportedByWideHashIndex + 1);
+  ASSERT_FALSE(builder.Valid());
+}
+
+TEST(DataBlockHashIndex, BlockTestWide) {
+  Random rnd(1019);
+  // Small enough for a narrow HashIndex, but with too many restarts, then too
+  // large for it.
+  for (int value_size : {10, 300}) {
+    SCOPED_TRACE("value_size=" + std::to_string(value_size));
+    BlockBuilder builder(
+        2 /* block_restart_interval */, true /* use_delta_encoding */,
+        false /* use_value_delta_encoding */,
+        BlockBasedTableOptions::kDataBlockBinaryAndHash,
+        0.75 /* data_block_hash_table_util_ratio */, 0 /* ts_sz */,
+        true /* persist_user_defined_timestamps */, false /* is_user_key */,
+        false /* restart_key_prefixes */,
+        true /* data_block_hash_index_wide */);
+    // Some user keys have versions spanning several restart intervals.
+    const int kNumUserKeys = 600;
+    std::vector<std::string> ikeys;
+    for (int i = 0; i < kNumUserKeys; i++) {
+      std::string ukey("key" + std::to_string(100000 + i) + "1");
+      int num_versions = 1 + static_cast<int>(rnd.Uniform(3));
+      for (int j = num_versions; j > 0; j--) {
+        InternalKey ikey(ukey, 10 * j, kTypeValue);
+        ikeys.push_back(ikey.Encode().ToString());
+        builder.Add(ikeys.back(), rnd.RandomString(value_size));
+      }
+    }
+    Slice rawblock = builder.Finish();
+    if (value_size > 100) {
+      ASSERT_GT(rawblock.size(), kMaxBlockSizeSupportedByHashIndex);
+    } else {
+      ASSERT_LE(rawblock.size(), kMaxBlockSizeSupportedByHashIndex);
+    }
+
+    BlockContents contents;
+    contents.data = rawblock;
+    Block reader(std::move(contents));
+    ASSERT_EQ(reader.IndexType(),
+              BlockBasedTableOptions::kDataBlockBinaryAndHash);
+    ASSERT_GT(reader.NumRestarts(), kMaxRestartSupportedByHashIndex);
+
+    std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber));
+    std::unique_ptr<DataBlockIter> expected(reader.NewDataIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber));
+    for (int i = 0; i < kNumUserKeys; i++) {
+      for (const char* marker : {"1", "0"}) {
+        std::string ukey("key" + std::to_string(100000 + i) + marker);
+        for (SequenceNumber seq : {SequenceNumber{35}, SequenceNumber{15},
+                                   SequenceNumber{5}}) {
+          InternalKey seek_ikey(ukey, seq, kValueTypeForSeek);
+          std::string target = seek_ikey.Encode().ToString();
+          bool may_exist = iter->SeekForGet(target);
+          expected->Seek(target);
+          if (expected->Valid() && ExtractUserKey(expected->key()) == ukey) {
+            ASSERT_TRUE(may_exist);
+            ASSERT_TRUE(iter->Valid());
+            ASSERT_EQ(expected->key(), iter->key());
+          } else if (may_exist && iter->Valid()) {
+            ASSERT_NE(ukey, ExtractUserKey(iter->key()));
+          }
+        }
+      }
+    }
+  }
+}
+
 TEST(DataBlockHashIndex, BlockTestSingleKey) {
   Options options = Options();
 
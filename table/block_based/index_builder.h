@@ -18,6 +18,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/block_learned_index.h"
 #include "table/format.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -419,6 +420,74 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// LearnedIndexBuilder writes a binary search index block, and a meta block
+// with a model of its keys, see BlockLearnedIndex.
+class LearnedIndexBuilder : public IndexBuilder {
+ public:
+  LearnedIndexBuilder(
+      const InternalKeyComparator* comparator,
+      int index_block_restart_interval, int format_version,
+      bool use_value_delta_encoding,
+      BlockBasedTableOptions::IndexShorteningMode shortening_mode,
+      size_t ts_sz, const bool persist_user_defined_timestamps)
+      : IndexBuilder(comparator, ts_sz, persist_user_defined_timestamps),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false,
+                               ts_sz, persist_user_defined_timestamps),
+        model_builder_(static_cast<uint32_t>(index_block_restart_interval),
+                       kLearnedIndexErrorBound),
+        enabled_(ts_sz == 0 &&
+                 comparator->user_comparator() == BytewiseComparator()) {}
+
+  void AddIndexEntry(std::string* last_key_in_current_block,
+                     const Slice* first_key_in_next_block,
+                     const BlockHandle& block_handle) override {
+    primary_index_builder_.AddIndexEntry(last_key_in_current_block,
+                                         first_key_in_next_block, block_handle);
+    if (enabled_) {
+      // The primary builder has replaced the key with the separator.
+      model_builder_.Add(ExtractUserKey(*last_key_in_current_block));
+    }
+  }
+
+  void OnKeyAdded(const Slice& key) override {
+    primary_index_builder_.OnKeyAdded(key);
+  }
+
+  Status Finish(IndexBlocks* index_blocks,
+                const BlockHandle& last_partition_block_handle) override {
+    Status s = primary_index_builder_.Finish(index_blocks,
+                                             last_partition_block_handle);
+    if (enabled_) {
+      model_builder_.Finish(&model_block_);
+      if (!model_block_.empty()) {
+        index_blocks->meta_blocks.insert(
+            {kLearnedIndexBlock.c_str(), model_block_});
+      }
+    }
+    return s;
+  }
+
+  size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + model_block_.size();
+  }
+
+  bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  // Maximum distance, in index entries, between the position predicted by
+  // the model and the actual position of a key.
+  static constexpr uint32_t kLearnedIndexErrorBound = 4;
+
+  ShortenedIndexBuilder primary_index_builder_;
+  BlockLearnedIndex::Builder model_builder_;
+  const bool enabled_;
+  std::string model_block_;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
@@ -33,6 +33,8 @@ const std::string kIndexBlockName = "rocksdb.index";
 const std::string kPropertiesBlockOldName = "rocksdb.stats";
 const std::string kCompressionDictBlockName = "rocksdb.compression_dict";
 const std::string kRangeDelBlockName = "rocksdb.range_del";
+const std::string kFragmentedRangeDelBlockName =
+    "rocksdb.fragmented_range_del";
 
 MetaIndexBuilder::MetaIndexBuilder()
     : meta_index_block_(new BlockBuilder(1 /* restart interval */)) {}
@@ -36,6 +36,9 @@ extern const std::string kIndexBlockName;
 extern const std::string kPropertiesBlockOldName;
 extern const std::string kCompressionDictBlockName;
 extern const std::string kRangeDelBlockName;
+// Range deletions of kRangeDelBlockName in fragmented form, see
+// BlockBasedTableOptions::persist_fragmented_range_deletions.
+extern const std::string kFragmentedRangeDelBlockName;
 
 class MetaIndexBuilder {
  public:
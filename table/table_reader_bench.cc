@@ -276,6 +276,8 @@ DEFINE_bool(mmap_read, true, "Whether use mmap read");
 DEFINE_string(table_factory, "block_based",
               "Table factory to use: `block_based` (default), `plain_table` or "
               "`cuckoo_hash`.");
+DEFINE_bool(learned_index, false,
+            "Use the kLearnedSearch index type for block-based tables.");
 DEFINE_string(time_unit, "microsecond",
               "The time unit used for measuring performance. User can specify "
               "`microsecond` (default) or `nanosecond`");
@@ -315,7 +317,12 @@ int main(int argc, char** argv) {
     options.prefix_extractor.reset(
         ROCKSDB_NAMESPACE::NewFixedPrefixTransform(FLAGS_prefix_len));
   } else if (FLAGS_table_factory == "block_based") {
-    tf.reset(new ROCKSDB_NAMESPACE::BlockBasedTableFactory());
+    ROCKSDB_NAMESPACE::BlockBasedTableOptions table_options;
+    if (FLAGS_learned_index) {
+      table_options.index_type =
+          ROCKSDB_NAMESPACE::BlockBasedTableOptions::kLearnedSearch;
+    }
+    tf.reset(new ROCKSDB_NAMESPACE::BlockBasedTableFactory(table_options));
   } else {
     fprintf(stderr, "Invalid table type %s\n", FLAGS_table_factory.c_str());
   }
@@ -55,6 +55,7 @@
 #include "table/block_based/block_based_table_iterator.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/block_learned_index.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/flush_block_policy_impl.h"
 #include "table/block_fetcher.h"
@@ -2661,6 +2662,136 @@ TEST_P(BlockBasedTableTest, HashIndexTest) {
   IndexTest(table_options);
 }
 
+TEST_P(BlockBasedTableTest, LearnedIndexTest) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.index_type = BlockBasedTableOptions::kLearnedSearch;
+  IndexTest(table_options);
+}
+
+namespace {
+// A fixed-width key with a common prefix and a big-endian id, the layout that
+// kLearnedSearch is designed for.
+std::string LearnedIndexTestKey(uint64_t id) {
+  std::string key = "tbl:";
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    key.push_back(static_cast<char>((id >> shift) & 0xff));
+  }
+  return key;
+}
+}  // namespace
+
+TEST_P(BlockBasedTableTest, LearnedIndexSeek) {
+  // A dense range followed by a sparse, skewed one, so that the model needs
+  // more than one segment.
+  std::vector<uint64_t> ids;
+  for (uint64_t i = 0; i < 2000; i++) {
+    ids.push_back(1000 + i * 7);
+  }
+  for (uint64_t i = 1; i <= 1000; i++) {
+    ids.push_back(uint64_t{1} << 40 | (i * i * 1000));
+  }
+
+  {
+    // Every key must be within the error bound of the model.
+    BlockLearnedIndex::Builder builder(1 /* restart_interval */,
+                                       4 /* error_bound */);
+    for (uint64_t id : ids) {
+      builder.Add(LearnedIndexTestKey(id));
+    }
+    std::string contents;
+    builder.Finish(&contents);
+    std::unique_ptr<BlockLearnedIndex> model;
+    ASSERT_OK(BlockLearnedIndex::Create(contents, &model));
+    ASSERT_GT(model->NumSegments(), 1U);
+    ASSERT_LT(model->NumSegments(), ids.size() / 10);
+    const uint32_t num_entries = static_cast<uint32_t>(ids.size());
+    for (uint32_t i = 0; i < num_entries; i++) {
+      uint32_t first = 0;
+      uint32_t last = 0;
+      model->GetRestartRange(LearnedIndexTestKey(ids[i]), num_entries, &first,
+                             &last);
+      ASSERT_LE(first, i);
+      ASSERT_GE(last, i);
+      ASSERT_LE(last - first, 10U);
+    }
+    ASSERT_TRUE(BlockLearnedIndex::Create("corrupt", &model).IsCorruption());
+  }
+
+  // Seeks must land on the same entry as with a plain binary search index,
+  // including for targets that are not in the table.
+  for (int restart_interval : {1, 3, 16}) {
+    SCOPED_TRACE("index_block_restart_interval=" +
+                 std::to_string(restart_interval));
+    Options options;
+    const ImmutableOptions ioptions(options);
+    const MutableCFOptions moptions(options);
+    InternalKeyComparator ikc(options.comparator);
+    std::unique_ptr<TableConstructor> tables[2];
+    const BlockBasedTableOptions::IndexType index_types[2] = {
+        BlockBasedTableOptions::kBinarySearch,
+        BlockBasedTableOptions::kLearnedSearch};
+    std::unique_ptr<InternalIterator> iters[2];
+    for (int t = 0; t < 2; t++) {
+      BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+      table_options.index_type = index_types[t];
+      table_options.index_block_restart_interval = restart_interval;
+      table_options.block_size = 64;  // one index entry per key or two
+      tables[t].reset(new TableConstructor(BytewiseComparator(),
+                                           true /* convert_to_internal_key */));
+      for (uint64_t id : ids) {
+        tables[t]->Add(LearnedIndexTestKey(id), "v");
+      }
+      std::vector<std::string> keys;
+      stl_wrappers::KVMap kvmap;
+      tables[t]->Finish(options, ioptions, moptions, table_options, ikc, &keys,
+                        &kvmap);
+      iters[t].reset(tables[t]->GetTableReader()->NewIterator(
+          ReadOptions(), moptions.prefix_extractor.get(), /*arena=*/nullptr,
+          /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+    }
+
+    Random rnd(301);
+    std::vector<uint64_t> targets = {0, ids.front(), ids.back(),
+                                     ids.back() + 1,
+                                     std::numeric_limits<uint64_t>::max()};
+    for (int i = 0; i < 2000; i++) {
+      uint64_t id = ids[rnd.Uniform(static_cast<int>(ids.size()))];
+      targets.push_back(id);
+      targets.push_back(id + 1);
+      targets.push_back(id - 1);
+    }
+    for (uint64_t target : targets) {
+      InternalKey ikey(LearnedIndexTestKey(target), kMaxSequenceNumber,
+                       kValueTypeForSeek);
+      for (auto& iter : iters) {
+        iter->Seek(ikey.Encode());
+        ASSERT_OK(iter->status());
+      }
+      ASSERT_EQ(iters[0]->Valid(), iters[1]->Valid());
+      if (iters[0]->Valid()) {
+        ASSERT_EQ(iters[0]->key(), iters[1]->key());
+      }
+    }
+    // Targets outside of the common prefix of the keys.
+    for (const std::string& target : {std::string("a"), std::string("tbl"),
+                                      std::string("tbm"), std::string("z")}) {
+      InternalKey ikey(target, kMaxSequenceNumber, kValueTypeForSeek);
+      for (auto& iter : iters) {
+        iter->Seek(ikey.Encode());
+        ASSERT_OK(iter->status());
+      }
+      ASSERT_EQ(iters[0]->Valid(), iters[1]->Valid());
+      if (iters[0]->Valid()) {
+        ASSERT_EQ(iters[0]->key(), iters[1]->key());
+      }
+    }
+    for (int t = 0; t < 2; t++) {
+      iters[t].reset();
+      tables[t]->ResetTableReader();
+    }
+  }
+}
+
 TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   const int max_index_keys = 5;
   const int est_max_index_key_value_size = 32;
@@ -638,6 +638,10 @@ DEFINE_bool(partition_index, false, "Partition index blocks");
 
 DEFINE_bool(index_with_first_key, false, "Include first key in the index");
 
+DEFINE_bool(use_learned_index, false,
+            "Narrow index block seeks with a model of the index keys "
+            "(kLearnedSearch). Best with fixed-width keys.");
+
 DEFINE_bool(
     optimize_filters_for_memory,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().optimize_filters_for_memory,
@@ -732,6 +736,10 @@ DEFINE_uint64(compaction_readahead_size,
               ROCKSDB_NAMESPACE::Options().compaction_readahead_size,
               "Compaction readahead size");
 
+DEFINE_bool(compaction_async_io,
+            ROCKSDB_NAMESPACE::Options().compaction_async_io,
+            "Read compaction input through the asynchronous prefetch path");
+
 DEFINE_int32(log_readahead_size, 0, "WAL and manifest readahead size");
 
 DEFINE_int32(random_access_max_buffer_size, 1024 * 1024,
@@ -839,6 +847,11 @@ DEFINE_string(wal_compression, "none",
 static enum ROCKSDB_NAMESPACE::CompressionType FLAGS_wal_compression_e =
     ROCKSDB_NAMESPACE::kNoCompression;
 
+DEFINE_uint64(wal_compression_dict_max_bytes,
+              ROCKSDB_NAMESPACE::Options().wal_compression_dict_max_bytes,
+              "Max size of the dictionary trained for WAL compression. "
+              "0 to disable.");
+
 DEFINE_string(wal_dir, "", "If not empty, use the given dir for WAL");
 
 DEFINE_string(truth_db, "/dev/shm/truth_db/dbbench",
@@ -974,6 +987,10 @@ DEFINE_int32(transaction_sleep, 0,
 DEFINE_uint64(transaction_lock_timeout, 100,
               "If using a transaction_db, specifies the lock wait timeout in"
               " milliseconds before failing a transaction waiting on a lock");
+
+DEFINE_uint64(transaction_fast_lock_slots_per_stripe, 0,
+              "If using a transaction_db, sets "
+              "TransactionDBOptions::fast_lock_slots_per_stripe");
 DEFINE_string(
     options_file, "",
     "The path to a RocksDB options file.  If specified, then db_bench will "
@@ -1433,6 +1450,15 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
 DEFINE_bool(enable_pipelined_write, true,
             "Allow WAL and memtable writes to be pipelined");
 
+DEFINE_uint64(multi_batch_write_slice_size,
+              ROCKSDB_NAMESPACE::Options().multi_batch_write_slice_size,
+              "With use_multi_thread_write, split write batches larger than "
+              "this many records into slices that other writers can insert");
+
+DEFINE_uint64(num_wal_streams, ROCKSDB_NAMESPACE::Options().num_wal_streams,
+              "Number of files each WAL is striped over. Requires "
+              "enable_pipelined_write=false");
+
 DEFINE_bool(
     unordered_write, false,
     "Enable the unordered write feature, which provides higher throughput but "
@@ -1473,6 +1499,12 @@ DEFINE_bool(rate_limiter_auto_tuned, false,
             "Enable dynamic adjustment of rate limit according to demand for "
             "background I/O");
 
+DEFINE_uint64(rate_limiter_read_bytes_per_sec, 0,
+              "If non-zero, use a write-amp based rate limiter that also "
+              "limits background reads to this many bytes per second. The "
+              "read limit is tuned from the p99 latency of Get, which "
+              "requires --statistics.");
+
 DEFINE_bool(sine_write_rate, false, "Use a sine wave write_rate_limit");
 
 DEFINE_uint64(
@@ -4292,6 +4324,8 @@ class Benchmark {
         FLAGS_use_direct_io_for_flush_and_compaction;
     options.manual_wal_flush = FLAGS_manual_wal_flush;
     options.wal_compression = FLAGS_wal_compression_e;
+    options.wal_compression_dict_max_bytes =
+        static_cast<size_t>(FLAGS_wal_compression_dict_max_bytes);
     options.ttl = FLAGS_fifo_compaction_ttl;
     options.compaction_options_fifo = CompactionOptionsFIFO(
         FLAGS_fifo_compaction_max_table_files_size_mb * 1024 * 1024,
@@ -4319,6 +4353,7 @@ class Benchmark {
     options.bloom_locality = FLAGS_bloom_locality;
     options.max_file_opening_threads = FLAGS_file_opening_threads;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+    options.compaction_async_io = FLAGS_compaction_async_io;
     options.log_readahead_size = FLAGS_log_readahead_size;
     options.random_access_max_buffer_size = FLAGS_random_access_max_buffer_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
@@ -4413,6 +4448,8 @@ class Benchmark {
       } else if (FLAGS_index_with_first_key) {
         block_based_options.index_type =
             BlockBasedTableOptions::kBinarySearchWithFirstKey;
+      } else if (FLAGS_use_learned_index) {
+        block_based_options.index_type = BlockBasedTableOptions::kLearnedSearch;
       }
       BlockBasedTableOptions::IndexShorteningMode index_shortening =
           block_based_options.index_shortening;
@@ -4658,6 +4695,7 @@ class Benchmark {
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
+    options.num_wal_streams = static_cast<size_t>(FLAGS_num_wal_streams);
     options.unordered_write = FLAGS_unordered_write;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
@@ -4832,7 +4870,17 @@ class Benchmark {
     }
 
     if (options.rate_limiter == nullptr) {
-      if (FLAGS_rate_limiter_bytes_per_sec > 0) {
+      if (FLAGS_rate_limiter_read_bytes_per_sec > 0) {
+        options.rate_limiter.reset(NewWriteAmpBasedRateLimiter(
+            FLAGS_rate_limiter_bytes_per_sec > 0
+                ? static_cast<int64_t>(FLAGS_rate_limiter_bytes_per_sec)
+                : std::numeric_limits<int64_t>::max(),
+            FLAGS_rate_limiter_refill_period_us, 10 /* fairness */,
+            RateLimiter::Mode::kWritesOnly, FLAGS_rate_limiter_auto_tuned,
+            1 /* tune_per_sec */, 300 /* smooth_window_size */,
+            30 /* recent_window_size */,
+            static_cast<int64_t>(FLAGS_rate_limiter_read_bytes_per_sec)));
+      } else if (FLAGS_rate_limiter_bytes_per_sec > 0) {
         options.rate_limiter.reset(NewGenericRateLimiter(
             FLAGS_rate_limiter_bytes_per_sec,
             FLAGS_rate_limiter_refill_period_us, 10 /* fairness */,
@@ -4905,6 +4953,8 @@ class Benchmark {
     Status s;
     if (use_multi_write_) {
       options.enable_multi_batch_write = true;
+      options.multi_batch_write_slice_size =
+          static_cast<size_t>(FLAGS_multi_batch_write_slice_size);
     }
     // Open with column families if necessary.
     if (FLAGS_num_column_families > 1) {
@@ -4954,6 +5004,8 @@ class Benchmark {
       } else if (FLAGS_transaction_db) {
         TransactionDB* ptr;
         TransactionDBOptions txn_db_options;
+        txn_db_options.fast_lock_slots_per_stripe =
+            FLAGS_transaction_fast_lock_slots_per_stripe;
         if (options.unordered_write) {
           options.two_write_queues = true;
           txn_db_options.skip_concurrency_control = true;
@@ -4981,6 +5033,8 @@ class Benchmark {
     } else if (FLAGS_transaction_db) {
       TransactionDB* ptr = nullptr;
       TransactionDBOptions txn_db_options;
+      txn_db_options.fast_lock_slots_per_stripe =
+          FLAGS_transaction_fast_lock_slots_per_stripe;
       if (options.unordered_write) {
         options.two_write_queues = true;
         txn_db_options.skip_concurrency_control = true;
@@ -1773,6 +1773,9 @@ class StreamingCompress {
                                    uint32_t compress_format_version,
                                    size_t max_output_len);
   virtual void Reset() = 0;
+  // Makes all the following frames compressed with the dictionary `dict`.
+  // Returns false if dictionaries are not supported.
+  virtual bool LoadDictionary(const Slice& /*dict*/) { return false; }
 
  protected:
   const CompressionType compression_type_;
@@ -1813,6 +1816,9 @@ class StreamingUncompress {
                                      uint32_t compress_format_version,
                                      size_t max_output_len);
   virtual void Reset() = 0;
+  // Makes all the following frames uncompressed with the dictionary `dict`.
+  // Returns false if dictionaries are not supported.
+  virtual bool LoadDictionary(const Slice& /*dict*/) { return false; }
 
  protected:
   CompressionType compression_type_;
@@ -1843,6 +1849,7 @@ class ZSTDStreamingCompress final : public StreamingCompress {
   int Compress(const char* input, size_t input_size, char* output,
                size_t* output_pos) override;
   void Reset() override;
+  bool LoadDictionary(const Slice& dict) override;
 #ifdef ZSTD_ADVANCED
   ZSTD_CCtx* cctx_;
   ZSTD_inBuffer input_buffer_;
@@ -1868,6 +1875,7 @@ class ZSTDStreamingUncompress final : public StreamingUncompress {
   int Uncompress(const char* input, size_t input_size, char* output,
                  size_t* output_size) override;
   void Reset() override;
+  bool LoadDictionary(const Slice& dict) override;
 
  private:
 #ifdef ZSTD_ADVANCED
@@ -41,6 +41,7 @@ static std::unordered_map<std::string, ValueType> value_type_string_map = {
     {"TypeTitanBlobIndex", ValueType::kTypeTitanBlobIndex},
     {"TypeTitanColumnFamilyBlobIndex",
      ValueType::kTypeTitanColumnFamilyBlobIndex},
+    {"TypeSequenceSkip", ValueType::kTypeSequenceSkip},
 };
 
 std::string KeyVersion::GetTypeName() const {
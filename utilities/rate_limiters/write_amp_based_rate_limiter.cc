@@ -44,7 +44,8 @@ int64_t CalculatePadding(int64_t base) {
 WriteAmpBasedRateLimiter::WriteAmpBasedRateLimiter(
     int64_t rate_bytes_per_sec, int64_t refill_period_us, int32_t fairness,
     RateLimiter::Mode mode, Env* env, bool auto_tuned, int secs_per_tune,
-    size_t smooth_window_size, size_t recent_window_size)
+    size_t smooth_window_size, size_t recent_window_size,
+    int64_t read_rate_bytes_per_sec)
     : RateLimiter(mode),
       refill_period_us_(refill_period_us),
       rate_bytes_per_sec_(auto_tuned ? rate_bytes_per_sec / 2
@@ -71,9 +72,23 @@ WriteAmpBasedRateLimiter::WriteAmpBasedRateLimiter(
       limit_bytes_sampler_(recent_window_size, recent_window_size),
       critical_pace_up_(false),
       normal_pace_up_(false),
-      percent_delta_(0) {
+      percent_delta_(0),
+      max_read_bytes_per_sec_(read_rate_bytes_per_sec),
+      next_read_tune_us_(NowMicrosMonotonic(env_) +
+                         1000 * 1000 * secs_per_tune_),
+      read_pace_up_(false),
+      read_stats_(nullptr),
+      last_read_count_(0),
+      last_read_sum_(0),
+      recent_read_latency_(0),
+      baseline_read_latency_(0) {
   std::fill(total_requests_, total_requests_ + Env::IO_TOTAL, 0);
   std::fill(total_bytes_through_, total_bytes_through_ + Env::IO_TOTAL, 0);
+  if (read_rate_bytes_per_sec > 0) {
+    read_limiter_.reset(NewGenericRateLimiter(
+        read_rate_bytes_per_sec, refill_period_us, fairness,
+        RateLimiter::Mode::kReadsOnly));
+  }
 }
 
 WriteAmpBasedRateLimiter::~WriteAmpBasedRateLimiter() {
@@ -260,6 +275,50 @@ void WriteAmpBasedRateLimiter::Request(int64_t bytes, const Env::IOPriority pri,
   } while (!r.granted);
 }
 
+void WriteAmpBasedRateLimiter::Request(const int64_t bytes,
+                                       const Env::IOPriority pri,
+                                       Statistics* stats, OpType op_type) {
+  if (op_type == OpType::kRead && read_limiter_ != nullptr) {
+    if (pri != Env::IO_USER && pri != Env::IO_TOTAL) {
+      RequestRead(bytes, pri, stats);
+    }
+    return;
+  }
+  if (RateLimiter::IsRateLimited(op_type)) {
+    Request(bytes, pri, stats);
+  }
+}
+
+bool WriteAmpBasedRateLimiter::IsRateLimited(OpType op_type) {
+  if (op_type == OpType::kRead && read_limiter_ != nullptr) {
+    return true;
+  }
+  return RateLimiter::IsRateLimited(op_type);
+}
+
+void WriteAmpBasedRateLimiter::RequestRead(int64_t bytes, Env::IOPriority pri,
+                                           Statistics* stats) {
+  assert(read_limiter_ != nullptr);
+  if (stats != nullptr) {
+    int64_t now = static_cast<int64_t>(NowMicrosMonotonic(env_));
+    int64_t next = next_read_tune_us_.load(std::memory_order_relaxed);
+    if (now >= next &&
+        next_read_tune_us_.compare_exchange_strong(
+            next, now + 1000 * 1000 * secs_per_tune_,
+            std::memory_order_relaxed)) {
+      MutexLock g(&read_tune_mutex_);
+      TuneRead(stats);
+    }
+  }
+  // Requests are sized by the burst of the write limiter, which can be larger
+  // than the one of the read limiter.
+  while (bytes > 0) {
+    bytes -= static_cast<int64_t>(read_limiter_->RequestToken(
+        static_cast<size_t>(bytes), 0 /* alignment */, pri, stats,
+        OpType::kRead));
+  }
+}
+
 std::vector<Env::IOPriority>
 WriteAmpBasedRateLimiter::GeneratePriorityIterationOrderLocked() {
   std::vector<Env::IOPriority> pri_iteration_order(Env::IO_TOTAL /* 4 */);
@@ -430,7 +489,79 @@ Status WriteAmpBasedRateLimiter::Tune() {
   return Status::OK();
 }
 
+// Adjusts the limit of background reads based on the latency of foreground
+// reads, called **at most** once every `secs_per_tune`.
+// Statistics only expose cumulative percentiles, so the recent p99 is
+// estimated from the average latency since the last tune, scaled by the
+// p99-to-average ratio of the whole histogram. When it degrades beyond the
+// long-term baseline, the limit is cut multiplicatively, otherwise it is
+// raised additively.
+void WriteAmpBasedRateLimiter::TuneRead(Statistics* stats) {
+  read_tune_mutex_.AssertHeld();
+  // Recent p99 above this ratio of the baseline is considered degraded.
+  const double kLatencyTolerance = 1.2;
+  const double kRecentAlpha = 0.5;
+  const double kBaselineAlpha = 0.05;
+  const double kDecreaseRatio = 0.7;
+  // Intervals with fewer foreground reads are merged into the next one.
+  const uint64_t kMinReadSamples = 100;
+
+  const int64_t min_bytes_per_sec =
+      std::max<int64_t>(max_read_bytes_per_sec_ / 20, 1);
+  const int64_t increase = std::max<int64_t>(max_read_bytes_per_sec_ / 20, 1);
+  const int64_t prev_bytes_per_sec = read_limiter_->GetBytesPerSecond();
+  int64_t new_bytes_per_sec = prev_bytes_per_sec;
+
+  HistogramData data;
+  stats->histogramData(DB_GET, &data);
+  if (stats != read_stats_ || data.count < last_read_count_) {
+    // New source of latency, or its histogram has been reset.
+    read_stats_ = stats;
+    recent_read_latency_ = 0;
+    baseline_read_latency_ = 0;
+    last_read_count_ = data.count;
+    last_read_sum_ = data.sum;
+  } else if (data.count == last_read_count_) {
+    // No foreground read to protect.
+    new_bytes_per_sec = prev_bytes_per_sec + increase;
+  } else if (data.count - last_read_count_ >= kMinReadSamples &&
+             data.average > 0) {
+    double average = static_cast<double>(data.sum - last_read_sum_) /
+                     static_cast<double>(data.count - last_read_count_);
+    double p99 = average * data.percentile99 / data.average;
+    if (baseline_read_latency_ == 0) {
+      recent_read_latency_ = p99;
+      baseline_read_latency_ = p99;
+    } else {
+      recent_read_latency_ =
+          kRecentAlpha * p99 + (1 - kRecentAlpha) * recent_read_latency_;
+      baseline_read_latency_ =
+          kBaselineAlpha * p99 + (1 - kBaselineAlpha) * baseline_read_latency_;
+    }
+    if (recent_read_latency_ > baseline_read_latency_ * kLatencyTolerance) {
+      new_bytes_per_sec =
+          static_cast<int64_t>(prev_bytes_per_sec * kDecreaseRatio);
+    } else {
+      new_bytes_per_sec = prev_bytes_per_sec + increase;
+    }
+    last_read_count_ = data.count;
+    last_read_sum_ = data.sum;
+  }
+  // Compaction must not fall behind when the LSM is out of shape.
+  if (read_pace_up_.exchange(false, std::memory_order_relaxed)) {
+    new_bytes_per_sec = max_read_bytes_per_sec_;
+  }
+  new_bytes_per_sec = std::max(
+      min_bytes_per_sec, std::min(new_bytes_per_sec, max_read_bytes_per_sec_));
+  if (new_bytes_per_sec != prev_bytes_per_sec) {
+    read_limiter_->SetBytesPerSecond(new_bytes_per_sec);
+  }
+}
+
 void WriteAmpBasedRateLimiter::PaceUp(bool critical) {
+  if (critical && read_limiter_ != nullptr) {
+    read_pace_up_.store(true, std::memory_order_relaxed);
+  }
   if (auto_tuned_.load(std::memory_order_acquire)) {
     if (critical) {
       critical_pace_up_.store(true, std::memory_order_relaxed);
@@ -446,12 +577,14 @@ RateLimiter* NewWriteAmpBasedRateLimiter(
     RateLimiter::Mode mode /* = RateLimiter::Mode::kWritesOnly */,
     bool auto_tuned /* = false */, int tune_per_sec /* = 1 */,
     size_t smooth_window_size /* = 300 */,
-    size_t recent_window_size /* = 30 */) {
+    size_t recent_window_size /* = 30 */,
+    int64_t read_rate_bytes_per_sec /* = 0 */) {
   assert(rate_bytes_per_sec > 0);
   assert(refill_period_us > 0);
   assert(fairness > 0);
   assert(tune_per_sec >= 0);
   assert(smooth_window_size >= recent_window_size);
+  assert(read_rate_bytes_per_sec >= 0);
   if (smooth_window_size == 0) {
     smooth_window_size = 300;
   }
@@ -460,7 +593,8 @@ RateLimiter* NewWriteAmpBasedRateLimiter(
   }
   return new WriteAmpBasedRateLimiter(
       rate_bytes_per_sec, refill_period_us, fairness, mode, Env::Default(),
-      auto_tuned, tune_per_sec, smooth_window_size, recent_window_size);
+      auto_tuned, tune_per_sec, smooth_window_size, recent_window_size,
+      read_rate_bytes_per_sec);
 }
 
 }  // namespace ROCKSDB_NAMESPACE
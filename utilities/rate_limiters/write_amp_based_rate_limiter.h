@@ -28,7 +28,8 @@ class WriteAmpBasedRateLimiter : public RateLimiter {
                            int32_t fairness, RateLimiter::Mode mode, Env* env,
                            bool auto_tuned, int secs_per_tune,
                            size_t auto_tune_smooth_window,
-                           size_t auto_tune_recent_window);
+                           size_t auto_tune_recent_window,
+                           int64_t read_rate_bytes_per_sec = 0);
 
   virtual ~WriteAmpBasedRateLimiter();
 
@@ -46,6 +47,19 @@ class WriteAmpBasedRateLimiter : public RateLimiter {
   virtual void Request(const int64_t bytes, const Env::IOPriority pri,
                        Statistics* stats) override;
 
+  // When the read-side limiter is enabled, background reads are charged to it
+  // instead of the write limiter, and foreground reads are never throttled.
+  virtual void Request(const int64_t bytes, const Env::IOPriority pri,
+                       Statistics* stats, OpType op_type) override;
+
+  virtual bool IsRateLimited(OpType op_type) override;
+
+  // Returns the current limit of background reads, or 0 if the read-side
+  // limiter is disabled.
+  int64_t GetReadBytesPerSecond() const {
+    return read_limiter_ ? read_limiter_->GetBytesPerSecond() : 0;
+  }
+
   virtual int64_t GetSingleBurstBytes() const override {
     return refill_bytes_per_period_.load(std::memory_order_relaxed);
   }
@@ -89,6 +103,8 @@ class WriteAmpBasedRateLimiter : public RateLimiter {
   int64_t CalculateRefillBytesPerPeriod(int64_t rate_bytes_per_sec);
   void SetActualBytesPerSecond(int64_t bytes_per_second);
   Status Tune();
+  void RequestRead(int64_t bytes, Env::IOPriority pri, Statistics* stats);
+  void TuneRead(Statistics* stats);
   std::vector<Env::IOPriority> GeneratePriorityIterationOrderLocked();
 
   uint64_t NowMicrosMonotonic(Env* env) {
@@ -166,6 +182,23 @@ class WriteAmpBasedRateLimiter : public RateLimiter {
   std::atomic<bool> critical_pace_up_;
   std::atomic<bool> normal_pace_up_;
   uint32_t percent_delta_;
+
+  // Limits background reads, nullptr if disabled. Its rate is tuned within
+  // [max_read_bytes_per_sec_ / 20, max_read_bytes_per_sec_] by `TuneRead`.
+  std::unique_ptr<RateLimiter> read_limiter_;
+  const int64_t max_read_bytes_per_sec_;
+  std::atomic<int64_t> next_read_tune_us_;
+  std::atomic<bool> read_pace_up_;
+  // Guards the read tuning states below.
+  port::Mutex read_tune_mutex_;
+  // Statistics the latency was last sampled from. Only used for comparison.
+  Statistics* read_stats_;
+  uint64_t last_read_count_;
+  uint64_t last_read_sum_;
+  // Smoothed estimation of the p99 latency of foreground reads, over the
+  // last few tunes and over the long term.
+  double recent_read_latency_;
+  double baseline_read_latency_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -14,8 +14,11 @@
 #include <limits>
 
 #include "db/db_test_util.h"
+#include "env/composite_env_wrapper.h"
 #include "rocksdb/env.h"
 #include "rocksdb/rate_limiter.h"
+#include "rocksdb/statistics.h"
+#include "test_util/mock_time_env.h"
 #include "test_util/sync_point.h"
 #include "test_util/testharness.h"
 #include "util/random.h"
@@ -82,6 +85,56 @@ TEST_F(WriteAmpBasedRateLimiterTest, AutoTune) {
   // TODO: add more logic for auto-tune
 }
 
+TEST_F(WriteAmpBasedRateLimiterTest, ReadAutoTune) {
+  const int64_t kReadRate = 10 << 20;
+  auto clock = std::make_shared<MockSystemClock>(SystemClock::Default());
+  clock->SetCurrentTime(100);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(Env::Default(), clock));
+  WriteAmpBasedRateLimiter limiter(
+      10 << 20 /* rate_bytes_per_sec */, 100 * 1000 /* refill_period_us */,
+      10 /* fairness */, RateLimiter::Mode::kWritesOnly, env.get(),
+      false /* auto_tuned */, 1 /* secs_per_tune */, 100 /* smooth_window */,
+      10 /* recent_window */, kReadRate /* read_rate_bytes_per_sec */);
+  ASSERT_TRUE(limiter.IsRateLimited(RateLimiter::OpType::kRead));
+  ASSERT_EQ(kReadRate, limiter.GetReadBytesPerSecond());
+
+  std::shared_ptr<Statistics> stats = CreateDBStatistics();
+  // Records foreground reads of the given latency, then issues a background
+  // read one tune later.
+  auto read = [&](uint64_t get_micros) {
+    for (int i = 0; i < 200; i++) {
+      stats->recordInHistogram(DB_GET, get_micros);
+    }
+    clock->MockSleepForSeconds(1);
+    limiter.Request(1024 /* bytes */, Env::IO_LOW, stats.get(),
+                    RateLimiter::OpType::kRead);
+  };
+
+  // Stable foreground latency leaves background reads unthrottled.
+  for (int i = 0; i < 5; i++) {
+    read(100);
+  }
+  ASSERT_EQ(kReadRate, limiter.GetReadBytesPerSecond());
+
+  // Degraded foreground latency throttles background reads.
+  read(1000);
+  int64_t throttled = limiter.GetReadBytesPerSecond();
+  ASSERT_LT(throttled, kReadRate);
+  read(1000);
+  ASSERT_LT(limiter.GetReadBytesPerSecond(), throttled);
+  ASSERT_GE(limiter.GetReadBytesPerSecond(), kReadRate / 20);
+
+  // Reads are never charged to the write limiter.
+  limiter.Request(1024 /* bytes */, Env::IO_USER, stats.get(),
+                  RateLimiter::OpType::kRead);
+  ASSERT_EQ(0, limiter.GetTotalBytesThrough());
+
+  // A critical pace-up lifts the throttle.
+  limiter.PaceUp(true /* critical */);
+  read(1000);
+  ASSERT_EQ(kReadRate, limiter.GetReadBytesPerSecond());
+}
+
 TEST_F(WriteAmpBasedRateLimiterTest, Rate) {
   auto* env = Env::Default();
   struct Arg {
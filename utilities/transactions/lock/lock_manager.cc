@@ -10,6 +10,28 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+Status LockManager::TryLockMany(
+    PessimisticTransaction* txn,
+    const std::vector<ColumnFamilyId>& column_family_ids,
+    const std::vector<std::string>& keys, Env* env, bool exclusive) {
+  assert(column_family_ids.size() == keys.size());
+  Status s;
+  size_t num_locked = 0;
+  for (; num_locked < keys.size(); num_locked++) {
+    s = TryLock(txn, column_family_ids[num_locked], keys[num_locked], env,
+                exclusive);
+    if (!s.ok()) {
+      break;
+    }
+  }
+  if (!s.ok()) {
+    for (size_t i = 0; i < num_locked; i++) {
+      UnLock(txn, column_family_ids[i], keys[i], env);
+    }
+  }
+  return s;
+}
+
 std::shared_ptr<LockManager> NewLockManager(PessimisticTransactionDB* db,
                                             const TransactionDBOptions& opt) {
   assert(db);
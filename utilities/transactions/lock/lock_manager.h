@@ -47,6 +47,15 @@ class LockManager {
                          ColumnFamilyId column_family_id, const Endpoint& start,
                          const Endpoint& end, Env* env, bool exclusive) = 0;
 
+  // Attempt to lock a batch of keys, where keys[i] is in the column family
+  // column_family_ids[i]. The transaction must not hold a lock on any of the
+  // keys yet. If OK status is returned, the caller is responsible for calling
+  // UnLock() on these keys, otherwise none of them is left locked.
+  virtual Status TryLockMany(
+      PessimisticTransaction* txn,
+      const std::vector<ColumnFamilyId>& column_family_ids,
+      const std::vector<std::string>& keys, Env* env, bool exclusive);
+
   // Unlock a key or a range locked by TryLock().  txn must be the same
   // Transaction that locked this key.
   virtual void UnLock(PessimisticTransaction* txn, const LockTracker& tracker,
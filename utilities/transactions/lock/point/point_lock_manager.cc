@@ -64,16 +64,53 @@ struct LockMapStripe {
   UnorderedMap<std::string, LockInfo> keys;
 };
 
+// A slot of the lock-free table of a LockMap, for the keys that hash to it.
+// See TransactionDBOptions::fast_lock_slots_per_stripe. The state of a slot
+// is one of:
+// * 0: No key of the slot is locked.
+// * kFastLockWriting: A transaction is taking the lock, and writing `key`.
+// * A transaction ID: The transaction holds an exclusive lock on `key`,
+//   without expiration.
+// * kFastLockSlowMode | n: The locks on the keys of the slot are in the
+//   stripe, and n is the number of such keys and their waiters. Only
+//   changed with the stripe mutex held.
+// A transaction only takes the lock of a slot in state 0, so keys with
+// waiters always go through the stripe. Before a key is locked through the
+// stripe, the lock of its slot, if any, is moved into the stripe.
+struct ALIGN_AS(CACHE_LINE_SIZE) FastLockSlot {
+  static constexpr size_t kMaxKeySize = 55;
+
+  std::atomic<uint64_t> state{0};
+  // Only changed in state kFastLockWriting
+  uint8_t key_size = 0;
+  char key[kMaxKeySize];
+
+  bool HasKey(const std::string& k) const {
+    return k.size() == key_size && memcmp(key, k.data(), key_size) == 0;
+  }
+};
+
+namespace {
+// Transaction IDs are far below these bits.
+constexpr uint64_t kFastLockWriting = uint64_t{1} << 63;
+constexpr uint64_t kFastLockSlowMode = uint64_t{1} << 62;
+}  // anonymous namespace
+
 // Map of #num_stripes LockMapStripes
 struct LockMap {
-  explicit LockMap(size_t num_stripes,
-                   std::shared_ptr<TransactionDBMutexFactory> factory)
-      : num_stripes_(num_stripes) {
+  LockMap(size_t num_stripes, size_t fast_lock_slots_per_stripe,
+          std::shared_ptr<TransactionDBMutexFactory> factory)
+      : num_stripes_(num_stripes),
+        fast_lock_slots_per_stripe_(fast_lock_slots_per_stripe) {
     lock_map_stripes_.reserve(num_stripes);
     for (size_t i = 0; i < num_stripes; i++) {
       LockMapStripe* stripe = new LockMapStripe(factory);
       lock_map_stripes_.push_back(stripe);
     }
+    if (fast_lock_slots_per_stripe > 0) {
+      fast_lock_slots_.reset(
+          new FastLockSlot[num_stripes * fast_lock_slots_per_stripe]);
+    }
   }
 
   ~LockMap() {
@@ -91,7 +128,18 @@ struct LockMap {
 
   std::vector<LockMapStripe*> lock_map_stripes_;
 
-  size_t GetStripe(const std::string& key) const;
+  // Number of slots of the lock-free table per stripe, or 0 if none
+  const size_t fast_lock_slots_per_stripe_;
+
+  // The slots of each stripe are contiguous, so that the stripe mutex
+  // protects the slow mode of its slots.
+  std::unique_ptr<FastLockSlot[]> fast_lock_slots_;
+
+  size_t GetStripe(uint64_t key_hash) const;
+
+  // Returns the slot of a key of the given stripe, or nullptr if there is no
+  // lock-free table.
+  FastLockSlot* GetFastLockSlot(uint64_t key_hash, size_t stripe_num) const;
 };
 
 namespace {
@@ -108,23 +156,40 @@ PointLockManager::PointLockManager(PessimisticTransactionDB* txn_db,
     : txn_db_impl_(txn_db),
       default_num_stripes_(opt.num_stripes),
       max_num_locks_(opt.max_num_locks),
+      fast_lock_slots_per_stripe_(
+          opt.max_num_locks > 0 ? 0 : opt.fast_lock_slots_per_stripe),
       lock_maps_cache_(new ThreadLocalPtr(&UnrefLockMapsCache)),
       dlock_buffer_(opt.max_num_deadlocks),
       mutex_factory_(opt.custom_mutex_factory
                          ? opt.custom_mutex_factory
                          : std::make_shared<TransactionDBMutexFactoryImpl>()) {}
 
-size_t LockMap::GetStripe(const std::string& key) const {
+size_t LockMap::GetStripe(uint64_t key_hash) const {
   assert(num_stripes_ > 0);
-  return FastRange64(GetSliceNPHash64(key), num_stripes_);
+  return FastRange64(key_hash, num_stripes_);
+}
+
+FastLockSlot* LockMap::GetFastLockSlot(uint64_t key_hash,
+                                       size_t stripe_num) const {
+  if (fast_lock_slots_per_stripe_ == 0) {
+    return nullptr;
+  }
+  // FastRange64 above mostly depends on the upper bits
+  size_t slot_num = FastRange32(Lower32of64(key_hash),
+                                static_cast<uint32_t>(
+                                    fast_lock_slots_per_stripe_));
+  return &fast_lock_slots_[stripe_num * fast_lock_slots_per_stripe_ +
+                           slot_num];
 }
 
 void PointLockManager::AddColumnFamily(const ColumnFamilyHandle* cf) {
   InstrumentedMutexLock l(&lock_map_mutex_);
 
   if (lock_maps_.find(cf->GetID()) == lock_maps_.end()) {
-    lock_maps_.emplace(cf->GetID(), std::make_shared<LockMap>(
-                                        default_num_stripes_, mutex_factory_));
+    lock_maps_.emplace(cf->GetID(),
+                       std::make_shared<LockMap>(default_num_stripes_,
+                                                 fast_lock_slots_per_stripe_,
+                                                 mutex_factory_));
   } else {
     // column_family already exists in lock map
     assert(false);
@@ -237,23 +302,212 @@ Status PointLockManager::TryLock(PessimisticTransaction* txn,
     return Status::InvalidArgument(msg);
   }
 
+  const uint64_t key_hash = GetSliceNPHash64(key);
+  size_t stripe_num = lock_map->GetStripe(key_hash);
+  FastLockSlot* slot = lock_map->GetFastLockSlot(key_hash, stripe_num);
+
+  if (slot != nullptr && TryFastLock(txn, key, slot, exclusive)) {
+    return Status::OK();
+  }
+
   // Need to lock the mutex for the stripe that this key hashes to
-  size_t stripe_num = lock_map->GetStripe(key);
   assert(lock_map->lock_map_stripes_.size() > stripe_num);
   LockMapStripe* stripe = lock_map->lock_map_stripes_.at(stripe_num);
 
   LockInfo lock_info(txn->GetID(), txn->GetExpirationTime(), exclusive);
   int64_t timeout = txn->GetLockTimeout();
 
-  return AcquireWithTimeout(txn, lock_map, stripe, column_family_id, key, env,
-                            timeout, lock_info);
+  return AcquireWithTimeout(txn, lock_map, stripe, slot, column_family_id, key,
+                            env, timeout, lock_info);
+}
+
+Status PointLockManager::TryLockMany(
+    PessimisticTransaction* txn,
+    const std::vector<ColumnFamilyId>& column_family_ids,
+    const std::vector<std::string>& keys, Env* env, bool exclusive) {
+  assert(column_family_ids.size() == keys.size());
+  struct KeyToLock {
+    ColumnFamilyId cf_id;
+    size_t stripe_num;
+    const std::string* key;
+    LockMap* lock_map;
+    FastLockSlot* slot;
+  };
+  // Keeps the lock maps alive while locking, like in TryLock()
+  std::vector<std::pair<ColumnFamilyId, std::shared_ptr<LockMap>>> lock_maps;
+  std::vector<KeyToLock> to_lock;
+  to_lock.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    const ColumnFamilyId cf_id = column_family_ids[i];
+    auto it = std::find_if(
+        lock_maps.begin(), lock_maps.end(),
+        [cf_id](const std::pair<ColumnFamilyId, std::shared_ptr<LockMap>>& m) {
+          return m.first == cf_id;
+        });
+    if (it == lock_maps.end()) {
+      std::shared_ptr<LockMap> lock_map_ptr = GetLockMap(cf_id);
+      if (lock_map_ptr == nullptr) {
+        char msg[255];
+        snprintf(msg, sizeof(msg), "Column family id not found: %" PRIu32,
+                 cf_id);
+        return Status::InvalidArgument(msg);
+      }
+      it = lock_maps.emplace(lock_maps.end(), cf_id, std::move(lock_map_ptr));
+    }
+    LockMap* lock_map = it->second.get();
+    const uint64_t key_hash = GetSliceNPHash64(keys[i]);
+    const size_t stripe_num = lock_map->GetStripe(key_hash);
+    to_lock.push_back({cf_id, stripe_num, &keys[i], lock_map,
+                       lock_map->GetFastLockSlot(key_hash, stripe_num)});
+  }
+  // Like LockBatch(), lock the keys in a consistent order, so that batches
+  // cannot deadlock with each other. The order follows the one of the stripe
+  // mutexes.
+  std::sort(to_lock.begin(), to_lock.end(),
+            [](const KeyToLock& a, const KeyToLock& b) {
+              if (a.cf_id != b.cf_id) {
+                return a.cf_id < b.cf_id;
+              }
+              if (a.stripe_num != b.stripe_num) {
+                return a.stripe_num < b.stripe_num;
+              }
+              return *a.key < *b.key;
+            });
+
+  LockInfo lock_info(txn->GetID(), txn->GetExpirationTime(), exclusive);
+  const int64_t timeout = txn->GetLockTimeout();
+  Status result;
+  // The keys of to_lock locked so far
+  std::vector<bool> locked(to_lock.size(), false);
+  size_t begin = 0;
+  while (begin < to_lock.size() && result.ok()) {
+    // The keys of the same stripe are [begin, end)
+    size_t end = begin + 1;
+    while (end < to_lock.size() && to_lock[end].cf_id == to_lock[begin].cf_id &&
+           to_lock[end].stripe_num == to_lock[begin].stripe_num) {
+      end++;
+    }
+    // Take the free fast lock slots in order, up to the first key that needs
+    // the stripe. Skipping that key would lock the next ones out of order,
+    // and let two batches each wait for a key the other one holds.
+    size_t i = begin;
+    while (i < end && to_lock[i].slot != nullptr &&
+           TryFastLock(txn, *to_lock[i].key, to_lock[i].slot, exclusive)) {
+      TEST_SYNC_POINT_CALLBACK("PointLockManager::TryLockMany:FastLocked",
+                               const_cast<std::string*>(to_lock[i].key));
+      locked[i] = true;
+      i++;
+    }
+    if (i < end) {
+      // Lock the remaining keys of the stripe in one critical section
+      TEST_SYNC_POINT("PointLockManager::TryLockMany:LockStripe");
+      LockMap* lock_map = to_lock[begin].lock_map;
+      assert(lock_map->lock_map_stripes_.size() > to_lock[begin].stripe_num);
+      LockMapStripe* stripe =
+          lock_map->lock_map_stripes_.at(to_lock[begin].stripe_num);
+      if (timeout < 0) {
+        result = stripe->stripe_mutex->Lock();
+      } else {
+        result = stripe->stripe_mutex->TryLockFor(timeout);
+      }
+      if (result.ok()) {
+        for (; i < end && result.ok(); i++) {
+          // Each key gets the whole timeout, like with TryLock()
+          uint64_t end_time = 0;
+          if (timeout > 0) {
+            end_time = env->NowMicros() + timeout;
+          }
+          result = AcquireLockedWithWait(
+              txn, lock_map, stripe, to_lock[i].slot, to_lock[i].cf_id,
+              *to_lock[i].key, env, timeout, end_time, lock_info);
+          locked[i] = result.ok();
+        }
+        stripe->stripe_mutex->UnLock();
+      }
+    }
+    begin = end;
+  }
+
+  if (!result.ok()) {
+    // Release the locks taken so far, so that none of the keys is locked
+    for (size_t i = 0; i < to_lock.size(); i++) {
+      if (locked[i]) {
+        UnLock(txn, to_lock[i].cf_id, *to_lock[i].key, env);
+      }
+    }
+  }
+  return result;
+}
+
+bool PointLockManager::TryFastLock(PessimisticTransaction* txn,
+                                   const std::string& key, FastLockSlot* slot,
+                                   bool exclusive) {
+  if (!exclusive || txn->GetExpirationTime() != 0 ||
+      key.size() > FastLockSlot::kMaxKeySize) {
+    return false;
+  }
+  uint64_t state = 0;
+  if (slot->state.compare_exchange_strong(state, kFastLockWriting,
+                                          std::memory_order_acquire)) {
+    slot->key_size = static_cast<uint8_t>(key.size());
+    memcpy(slot->key, key.data(), key.size());
+    slot->state.store(txn->GetID(), std::memory_order_release);
+    return true;
+  }
+  // Already locked by this transaction
+  return state == txn->GetID() && slot->HasKey(key);
+}
+
+void PointLockManager::MoveFastLockToStripe(LockMapStripe* stripe,
+                                            FastLockSlot* slot) {
+  uint64_t state = slot->state.load(std::memory_order_acquire);
+  while (true) {
+    if (state & kFastLockSlowMode) {
+      return;
+    }
+    if (state == kFastLockWriting) {
+      // The lock is being taken, which takes no time
+      port::AsmVolatilePause();
+      state = slot->state.load(std::memory_order_acquire);
+      continue;
+    }
+    if (slot->state.compare_exchange_weak(state, kFastLockSlowMode,
+                                          std::memory_order_acq_rel)) {
+      break;
+    }
+  }
+  if (state != 0) {
+    // The transaction `state` held the lock on the key, which cannot change
+    // now that the slot is not in state 0. The key has no other lock, as the
+    // slot was not in slow mode.
+    stripe->keys.emplace(std::string(slot->key, slot->key_size),
+                         LockInfo(state, /*time=*/0, /*ex=*/true));
+    slot->state.store(kFastLockSlowMode | 1, std::memory_order_release);
+  }
+}
+
+void PointLockManager::MaybeLeaveSlowMode(FastLockSlot* slot) {
+  if (slot->state.load(std::memory_order_relaxed) == kFastLockSlowMode) {
+    slot->state.store(0, std::memory_order_release);
+  }
+}
+
+bool PointLockManager::TryFastUnLock(PessimisticTransaction* txn,
+                                     const std::string& key,
+                                     FastLockSlot* slot) {
+  uint64_t state = txn->GetID();
+  return slot->state.load(std::memory_order_relaxed) == state &&
+         slot->HasKey(key) &&
+         slot->state.compare_exchange_strong(state, 0,
+                                             std::memory_order_release);
 }
 
 // Helper function for TryLock().
 Status PointLockManager::AcquireWithTimeout(
     PessimisticTransaction* txn, LockMap* lock_map, LockMapStripe* stripe,
-    ColumnFamilyId column_family_id, const std::string& key, Env* env,
-    int64_t timeout, const LockInfo& lock_info) {
+    FastLockSlot* slot, ColumnFamilyId column_family_id,
+    const std::string& key, Env* env, int64_t timeout,
+    const LockInfo& lock_info) {
   Status result;
   uint64_t end_time = 0;
 
@@ -274,10 +528,30 @@ Status PointLockManager::AcquireWithTimeout(
     return result;
   }
 
+  result = AcquireLockedWithWait(txn, lock_map, stripe, slot, column_family_id,
+                                 key, env, timeout, end_time, lock_info);
+
+  stripe->stripe_mutex->UnLock();
+
+  return result;
+}
+
+// Helper function for TryLock() and TryLockMany(), with the stripe mutex
+// held. Waits on the stripe until the lock is acquired or end_time.
+Status PointLockManager::AcquireLockedWithWait(
+    PessimisticTransaction* txn, LockMap* lock_map, LockMapStripe* stripe,
+    FastLockSlot* slot, ColumnFamilyId column_family_id,
+    const std::string& key, Env* env, int64_t timeout, uint64_t end_time,
+    const LockInfo& lock_info) {
+  Status result;
+  if (slot != nullptr) {
+    MoveFastLockToStripe(stripe, slot);
+  }
+
   // Acquire lock if we are able to
   uint64_t expire_time_hint = 0;
   autovector<TransactionID> wait_ids;
-  result = AcquireLocked(lock_map, stripe, key, env, lock_info,
+  result = AcquireLocked(lock_map, stripe, slot, key, env, lock_info,
                          &expire_time_hint, &wait_ids);
 
   if (!result.ok() && timeout != 0) {
@@ -306,7 +580,9 @@ Status PointLockManager::AcquireWithTimeout(
           if (IncrementWaiters(txn, wait_ids, key, column_family_id,
                                lock_info.exclusive, env)) {
             result = Status::Busy(Status::SubCode::kDeadlock);
-            stripe->stripe_mutex->UnLock();
+            if (slot != nullptr) {
+              MaybeLeaveSlowMode(slot);
+            }
             return result;
           }
         }
@@ -314,6 +590,10 @@ Status PointLockManager::AcquireWithTimeout(
       }
 
       TEST_SYNC_POINT("PointLockManager::AcquireWithTimeout:WaitingTxn");
+      if (slot != nullptr) {
+        // Keep the other transactions off the fast path while waiting
+        slot->state.fetch_add(1, std::memory_order_relaxed);
+      }
       if (cv_end_time < 0) {
         // Wait indefinitely
         result = stripe->stripe_cv->Wait(stripe->stripe_mutex);
@@ -324,6 +604,9 @@ Status PointLockManager::AcquireWithTimeout(
                                               cv_end_time - now);
         }
       }
+      if (slot != nullptr) {
+        slot->state.fetch_sub(1, std::memory_order_relaxed);
+      }
 
       if (wait_ids.size() != 0) {
         txn->ClearWaitingTxn();
@@ -340,13 +623,15 @@ Status PointLockManager::AcquireWithTimeout(
       }
 
       if (result.ok() || result.IsTimedOut()) {
-        result = AcquireLocked(lock_map, stripe, key, env, lock_info,
+        result = AcquireLocked(lock_map, stripe, slot, key, env, lock_info,
                                &expire_time_hint, &wait_ids);
       }
     } while (!result.ok() && !timed_out);
   }
 
-  stripe->stripe_mutex->UnLock();
+  if (slot != nullptr) {
+    MaybeLeaveSlowMode(slot);
+  }
 
   return result;
 }
@@ -471,8 +756,9 @@ bool PointLockManager::IncrementWaiters(
 // Try to lock this key after we have acquired the mutex.
 // Sets *expire_time to the expiration time in microseconds
 //  or 0 if no expiration.
-// REQUIRED:  Stripe mutex must be held.
+// REQUIRED:  Stripe mutex must be held, and the slot (if any) in slow mode.
 Status PointLockManager::AcquireLocked(LockMap* lock_map, LockMapStripe* stripe,
+                                       FastLockSlot* slot,
                                        const std::string& key, Env* env,
                                        const LockInfo& txn_lock_info,
                                        uint64_t* expire_time,
@@ -527,6 +813,11 @@ Status PointLockManager::AcquireLocked(LockMap* lock_map, LockMapStripe* stripe,
     } else {
       // acquire lock
       stripe->keys.emplace(key, txn_lock_info);
+      if (slot != nullptr) {
+        assert(slot->state.load(std::memory_order_relaxed) &
+               kFastLockSlowMode);
+        slot->state.fetch_add(1, std::memory_order_relaxed);
+      }
 
       // Maintain lock count if there is a limit on the number of locks
       if (max_num_locks_) {
@@ -540,7 +831,8 @@ Status PointLockManager::AcquireLocked(LockMap* lock_map, LockMapStripe* stripe,
 
 void PointLockManager::UnLockKey(PessimisticTransaction* txn,
                                  const std::string& key, LockMapStripe* stripe,
-                                 LockMap* lock_map, Env* env) {
+                                 FastLockSlot* slot, LockMap* lock_map,
+                                 Env* env) {
 #ifdef NDEBUG
   (void)env;
 #endif
@@ -554,6 +846,12 @@ void PointLockManager::UnLockKey(PessimisticTransaction* txn,
     if (txn_it != txns.end()) {
       if (txns.size() == 1) {
         stripe->keys.erase(stripe_iter);
+        if (slot != nullptr) {
+          assert(slot->state.load(std::memory_order_relaxed) >
+                 kFastLockSlowMode);
+          slot->state.fetch_sub(1, std::memory_order_relaxed);
+          MaybeLeaveSlowMode(slot);
+        }
       } else {
         auto last_it = txns.end() - 1;
         if (txn_it != last_it) {
@@ -586,13 +884,20 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
     return;
   }
 
+  const uint64_t key_hash = GetSliceNPHash64(key);
+  size_t stripe_num = lock_map->GetStripe(key_hash);
+  FastLockSlot* slot = lock_map->GetFastLockSlot(key_hash, stripe_num);
+  if (slot != nullptr && TryFastUnLock(txn, key, slot)) {
+    // Nobody waits on a lock in its slot
+    return;
+  }
+
   // Lock the mutex for the stripe that this key hashes to
-  size_t stripe_num = lock_map->GetStripe(key);
   assert(lock_map->lock_map_stripes_.size() > stripe_num);
   LockMapStripe* stripe = lock_map->lock_map_stripes_.at(stripe_num);
 
   stripe->stripe_mutex->Lock().PermitUncheckedError();
-  UnLockKey(txn, key, stripe, lock_map, env);
+  UnLockKey(txn, key, stripe, slot, lock_map, env);
   stripe->stripe_mutex->UnLock();
 
   // Signal waiting threads to retry locking
@@ -613,16 +918,23 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
       return;
     }
 
-    // Bucket keys by lock_map_ stripe
-    UnorderedMap<size_t, std::vector<const std::string*>> keys_by_stripe(
-        lock_map->num_stripes_);
+    // Bucket keys by lock_map_ stripe, except those released from their
+    // slots
+    UnorderedMap<size_t,
+                 std::vector<std::pair<const std::string*, FastLockSlot*>>>
+        keys_by_stripe(lock_map->num_stripes_);
     std::unique_ptr<LockTracker::KeyIterator> key_it(
         tracker.GetKeyIterator(cf));
     assert(key_it != nullptr);
     while (key_it->HasNext()) {
       const std::string& key = key_it->Next();
-      size_t stripe_num = lock_map->GetStripe(key);
-      keys_by_stripe[stripe_num].push_back(&key);
+      const uint64_t key_hash = GetSliceNPHash64(key);
+      size_t stripe_num = lock_map->GetStripe(key_hash);
+      FastLockSlot* slot = lock_map->GetFastLockSlot(key_hash, stripe_num);
+      if (slot != nullptr && TryFastUnLock(txn, key, slot)) {
+        continue;
+      }
+      keys_by_stripe[stripe_num].emplace_back(&key, slot);
     }
 
     // For each stripe, grab the stripe mutex and unlock all keys in this stripe
@@ -635,8 +947,9 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
 
       stripe->stripe_mutex->Lock().PermitUncheckedError();
 
-      for (const std::string* key : stripe_keys) {
-        UnLockKey(txn, *key, stripe, lock_map, env);
+      for (const auto& key_and_slot : stripe_keys) {
+        UnLockKey(txn, *key_and_slot.first, stripe, key_and_slot.second,
+                  lock_map, env);
       }
 
       stripe->stripe_mutex->UnLock();
@@ -661,10 +974,20 @@ PointLockManager::PointLockStatus PointLockManager::GetPointLockStatus() {
   std::sort(cf_ids.begin(), cf_ids.end());
 
   for (auto i : cf_ids) {
-    const auto& stripes = lock_maps_[i]->lock_map_stripes_;
+    LockMap* lock_map = lock_maps_[i].get();
+    const auto& stripes = lock_map->lock_map_stripes_;
     // Iterate and lock all stripes in ascending order.
-    for (const auto& j : stripes) {
+    for (size_t stripe_num = 0; stripe_num < stripes.size(); stripe_num++) {
+      LockMapStripe* j = stripes[stripe_num];
       j->stripe_mutex->Lock().PermitUncheckedError();
+      // Move the locks of the slots into the stripe, to report them
+      const size_t num_slots = lock_map->fast_lock_slots_per_stripe_;
+      for (size_t k = 0; k < num_slots; k++) {
+        FastLockSlot* slot =
+            &lock_map->fast_lock_slots_[stripe_num * num_slots + k];
+        MoveFastLockToStripe(j, slot);
+        MaybeLeaveSlowMode(slot);
+      }
       for (const auto& it : j->keys) {
         struct KeyLockInfo info;
         info.exclusive = it.second.exclusive;
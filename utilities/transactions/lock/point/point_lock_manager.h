@@ -23,6 +23,7 @@
 namespace ROCKSDB_NAMESPACE {
 
 class ColumnFamilyHandle;
+struct FastLockSlot;
 struct LockInfo;
 struct LockMap;
 struct LockMapStripe;
@@ -137,6 +138,12 @@ class PointLockManager : public LockManager {
   Status TryLock(PessimisticTransaction* txn, ColumnFamilyId column_family_id,
                  const Endpoint& start, const Endpoint& end, Env* env,
                  bool exclusive) override;
+  // Groups the keys by lock map stripe, and locks the keys of a stripe in a
+  // single critical section.
+  Status TryLockMany(PessimisticTransaction* txn,
+                     const std::vector<ColumnFamilyId>& column_family_ids,
+                     const std::vector<std::string>& keys, Env* env,
+                     bool exclusive) override;
 
   void UnLock(PessimisticTransaction* txn, const LockTracker& tracker,
               Env* env) override;
@@ -162,6 +169,9 @@ class PointLockManager : public LockManager {
   // Limit on number of keys locked per column family
   const int64_t max_num_locks_;
 
+  // Number of slots of the lock-free table per lock map stripe
+  const size_t fast_lock_slots_per_stripe_;
+
   // The following lock order must be satisfied in order to avoid deadlocking
   // ourselves.
   //   - lock_map_mutex_
@@ -197,17 +207,46 @@ class PointLockManager : public LockManager {
   std::shared_ptr<LockMap> GetLockMap(uint32_t column_family_id);
 
   Status AcquireWithTimeout(PessimisticTransaction* txn, LockMap* lock_map,
-                            LockMapStripe* stripe, uint32_t column_family_id,
-                            const std::string& key, Env* env, int64_t timeout,
+                            LockMapStripe* stripe, FastLockSlot* slot,
+                            uint32_t column_family_id, const std::string& key,
+                            Env* env, int64_t timeout,
                             const LockInfo& lock_info);
 
+  // REQUIRED: Stripe mutex must be held.
+  Status AcquireLockedWithWait(PessimisticTransaction* txn, LockMap* lock_map,
+                               LockMapStripe* stripe, FastLockSlot* slot,
+                               uint32_t column_family_id,
+                               const std::string& key, Env* env,
+                               int64_t timeout, uint64_t end_time,
+                               const LockInfo& lock_info);
+
   Status AcquireLocked(LockMap* lock_map, LockMapStripe* stripe,
-                       const std::string& key, Env* env,
+                       FastLockSlot* slot, const std::string& key, Env* env,
                        const LockInfo& lock_info, uint64_t* wait_time,
                        autovector<TransactionID>* txn_ids);
 
   void UnLockKey(PessimisticTransaction* txn, const std::string& key,
-                 LockMapStripe* stripe, LockMap* lock_map, Env* env);
+                 LockMapStripe* stripe, FastLockSlot* slot, LockMap* lock_map,
+                 Env* env);
+
+  // Moves the lock held in the slot, if any, into the stripe, and puts the
+  // slot in slow mode. MaybeLeaveSlowMode() must be called before the stripe
+  // mutex is released.
+  // REQUIRED: Stripe mutex must be held.
+  void MoveFastLockToStripe(LockMapStripe* stripe, FastLockSlot* slot);
+
+  // Takes the slot out of slow mode if no lock or waiter is left in it.
+  // REQUIRED: Stripe mutex must be held.
+  void MaybeLeaveSlowMode(FastLockSlot* slot);
+
+  // Takes the lock in the slot if it is free, or returns whether the
+  // transaction already holds it there.
+  bool TryFastLock(PessimisticTransaction* txn, const std::string& key,
+                   FastLockSlot* slot, bool exclusive);
+
+  // Releases the lock if the transaction holds it in the slot.
+  bool TryFastUnLock(PessimisticTransaction* txn, const std::string& key,
+                     FastLockSlot* slot);
 
   bool IncrementWaiters(const PessimisticTransaction* txn,
                         const autovector<TransactionID>& wait_ids,
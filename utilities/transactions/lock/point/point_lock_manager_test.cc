@@ -6,6 +6,10 @@
 
 #include "utilities/transactions/lock/point/point_lock_manager_test.h"
 
+#include <thread>
+
+#include "util/random.h"
+
 namespace ROCKSDB_NAMESPACE {
 
 // This test is not applicable for Range Lock manager as Range Lock Manager
@@ -157,8 +161,226 @@ TEST_F(PointLockManagerTest, DeadlockDepthExceeded) {
   delete txn1;
 }
 
+TEST_F(PointLockManagerTest, FastLockSlots) {
+  TransactionDBOptions txn_db_opt;
+  txn_db_opt.transaction_lock_timeout = 0;
+  txn_db_opt.num_stripes = 1;
+  // Every key maps to the same slot
+  txn_db_opt.fast_lock_slots_per_stripe = 1;
+  ResetLocker(txn_db_opt);
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  auto txn1 = NewTxn();
+  auto txn2 = NewTxn();
+
+  // k1 takes the slot, k2 goes to the stripe
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k1", env_, true));
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k1", env_, true));
+  ASSERT_OK(locker_->TryLock(txn2, 1, "k2", env_, true));
+  ASSERT_TRUE(locker_->TryLock(txn2, 1, "k1", env_, true).IsTimedOut());
+  ASSERT_TRUE(locker_->TryLock(txn2, 1, "k1", env_, false).IsTimedOut());
+  ASSERT_TRUE(locker_->TryLock(txn1, 1, "k2", env_, false).IsTimedOut());
+
+  auto s = locker_->GetPointLockStatus();
+  ASSERT_EQ(s.size(), 2u);
+  for (auto& it : s) {
+    ASSERT_TRUE(it.second.exclusive);
+    ASSERT_EQ(it.second.ids.size(), 1u);
+    ASSERT_EQ(it.second.ids[0],
+              it.second.key == "k1" ? txn1->GetID() : txn2->GetID());
+  }
+
+  // Once released, the slot can be taken by another key
+  locker_->UnLock(txn1, 1, "k1", env_);
+  locker_->UnLock(txn2, 1, "k2", env_);
+  ASSERT_OK(locker_->TryLock(txn2, 1, "k2", env_, true));
+  ASSERT_TRUE(locker_->TryLock(txn1, 1, "k2", env_, true).IsTimedOut());
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k1", env_, true));
+  ASSERT_EQ(locker_->GetPointLockStatus().size(), 2u);
+
+  // Keys too long for a slot always go to the stripe
+  const std::string long_key(100, 'k');
+  locker_->UnLock(txn2, 1, "k2", env_);
+  ASSERT_OK(locker_->TryLock(txn2, 1, long_key, env_, true));
+  ASSERT_TRUE(locker_->TryLock(txn1, 1, long_key, env_, true).IsTimedOut());
+
+  // Cleanup
+  locker_->UnLock(txn1, 1, "k1", env_);
+  locker_->UnLock(txn2, 1, long_key, env_);
+  ASSERT_EQ(locker_->GetPointLockStatus().size(), 0u);
+
+  delete txn1;
+  delete txn2;
+}
+
+TEST_F(PointLockManagerTest, FastLockSlotsConcurrent) {
+  // Tests the mutual exclusion of locks taken both in the slots and in the
+  // stripes, by threads contending on a few keys.
+  TransactionDBOptions txn_db_opt;
+  txn_db_opt.num_stripes = 2;
+  txn_db_opt.fast_lock_slots_per_stripe = 2;
+  ResetLocker(txn_db_opt);
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+
+  constexpr int kNumKeys = 4;
+  constexpr int kNumThreads = 4;
+  std::atomic<int> holders[kNumKeys];
+  for (auto& h : holders) {
+    h.store(0);
+  }
+  TransactionOptions txn_opt;
+  txn_opt.lock_timeout = 10000;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      auto txn = NewTxn(txn_opt);
+      Random rnd(301 + t);
+      for (int i = 0; i < 1000; i++) {
+        const int k = static_cast<int>(rnd.Uniform(kNumKeys));
+        const std::string key = "k" + std::to_string(k);
+        ASSERT_OK(locker_->TryLock(txn, 1, key, env_, true));
+        ASSERT_EQ(holders[k].fetch_add(1), 0);
+        holders[k].fetch_sub(1);
+        locker_->UnLock(txn, 1, key, env_);
+      }
+      delete txn;
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(locker_->GetPointLockStatus().size(), 0u);
+}
+
+TEST_F(PointLockManagerTest, TryLockMany) {
+  for (size_t fast_lock_slots : {0, 4}) {
+    TransactionDBOptions txn_db_opt;
+    txn_db_opt.transaction_lock_timeout = 0;
+    txn_db_opt.num_stripes = 4;
+    txn_db_opt.fast_lock_slots_per_stripe = fast_lock_slots;
+    ResetLocker(txn_db_opt);
+    MockColumnFamilyHandle cf1(1), cf2(2);
+    locker_->AddColumnFamily(&cf1);
+    locker_->AddColumnFamily(&cf2);
+    auto txn1 = NewTxn();
+    auto txn2 = NewTxn();
+
+    std::vector<ColumnFamilyId> cf_ids;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 20; i++) {
+      cf_ids.push_back(i % 2 == 0 ? 1 : 2);
+      keys.push_back("k" + std::to_string(i));
+    }
+    ASSERT_OK(locker_->TryLockMany(txn1, cf_ids, keys, env_, true));
+    ASSERT_EQ(locker_->GetPointLockStatus().size(), 20u);
+    for (size_t i = 0; i < keys.size(); i++) {
+      ASSERT_TRUE(
+          locker_->TryLock(txn2, cf_ids[i], keys[i], env_, false).IsTimedOut());
+    }
+
+    // None of the keys is left locked when one of them cannot be
+    ASSERT_TRUE(locker_
+                    ->TryLockMany(txn2, {1, 1, 2}, {"a", "k0", "b"}, env_,
+                                  true)
+                    .IsTimedOut());
+    ASSERT_EQ(locker_->GetPointLockStatus().size(), 20u);
+    ASSERT_TRUE(locker_->TryLockMany(txn2, {1, 3}, {"a", "b"}, env_, true)
+                    .IsInvalidArgument());
+    ASSERT_EQ(locker_->GetPointLockStatus().size(), 20u);
+
+    for (size_t i = 0; i < keys.size(); i++) {
+      locker_->UnLock(txn1, cf_ids[i], keys[i], env_);
+    }
+    ASSERT_OK(locker_->TryLockMany(txn1, cf_ids, keys, env_, false));
+    ASSERT_OK(locker_->TryLockMany(txn2, cf_ids, keys, env_, false));
+    auto s = locker_->GetPointLockStatus();
+    ASSERT_EQ(s.size(), 20u);
+    for (auto& it : s) {
+      ASSERT_FALSE(it.second.exclusive);
+      ASSERT_EQ(it.second.ids.size(), 2u);
+    }
+
+    // Cleanup
+    for (size_t i = 0; i < keys.size(); i++) {
+      locker_->UnLock(txn1, cf_ids[i], keys[i], env_);
+      locker_->UnLock(txn2, cf_ids[i], keys[i], env_);
+    }
+    ASSERT_EQ(locker_->GetPointLockStatus().size(), 0u);
+
+    delete txn1;
+    delete txn2;
+  }
+}
+
+TEST_F(PointLockManagerTest, TryLockManyOverlappingBatches) {
+  // Two batches of the same keys must not each take the fast lock slot of a
+  // different key, and then wait for the other one in the stripe.
+  TransactionDBOptions txn_db_opt;
+  txn_db_opt.num_stripes = 1;
+  txn_db_opt.fast_lock_slots_per_stripe = 16;
+  ResetLocker(txn_db_opt);
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.lock_timeout = 1000;
+  auto txn1 = NewTxn(txn_opt);
+  auto txn2 = NewTxn(txn_opt);
+
+  // txn1 stops after locking k1 until txn2 goes to the stripe.
+  std::atomic<bool> k1_locked{false};
+  std::atomic<bool> txn2_at_stripe{false};
+  SyncPoint::GetInstance()->SetCallBack(
+      "PointLockManager::TryLockMany:FastLocked", [&](void* arg) {
+        if (*static_cast<std::string*>(arg) == "k1" &&
+            !k1_locked.exchange(true)) {
+          while (!txn2_at_stripe) {
+            std::this_thread::yield();
+          }
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "PointLockManager::TryLockMany:LockStripe", [&](void* /*arg*/) {
+        if (k1_locked) {
+          txn2_at_stripe = true;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  port::Thread t1([&]() {
+    ASSERT_OK(locker_->TryLockMany(txn1, {1, 1}, {"k1", "k2"}, env_, true));
+    locker_->UnLock(txn1, 1, "k1", env_);
+    locker_->UnLock(txn1, 1, "k2", env_);
+  });
+  while (!k1_locked) {
+    std::this_thread::yield();
+  }
+  port::Thread t2([&]() {
+    ASSERT_OK(locker_->TryLockMany(txn2, {1, 1}, {"k2", "k1"}, env_, true));
+    locker_->UnLock(txn2, 1, "k1", env_);
+    locker_->UnLock(txn2, 1, "k2", env_);
+  });
+  t1.join();
+  t2.join();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_EQ(locker_->GetPointLockStatus().size(), 0u);
+
+  delete txn1;
+  delete txn2;
+}
+
+void PointLockManagerFastLockSlotsSetup(PointLockManagerTest* self) {
+  self->PointLockManagerTest::SetUp();
+  TransactionDBOptions txn_db_opt;
+  txn_db_opt.transaction_lock_timeout = 0;
+  txn_db_opt.fast_lock_slots_per_stripe = 4;
+  self->ResetLocker(txn_db_opt);
+}
+
 INSTANTIATE_TEST_CASE_P(PointLockManager, AnyLockManagerTest,
-                        ::testing::Values(nullptr));
+                        ::testing::Values(nullptr,
+                                          PointLockManagerFastLockSlotsSetup));
 
 }  // namespace ROCKSDB_NAMESPACE
 
@@ -55,8 +55,7 @@ class PointLockManagerTest : public testing::Test {
 
     // CAUTION: This test creates a separate lock manager object (right, NOT
     // the one that the TransactionDB is using!), and runs tests on it.
-    locker_.reset(new PointLockManager(
-        static_cast<PessimisticTransactionDB*>(db_), txn_opt));
+    ResetLocker(txn_opt);
 
     wait_sync_point_name_ = "PointLockManager::AcquireWithTimeout:WaitingTxn";
   }
@@ -66,6 +65,12 @@ class PointLockManagerTest : public testing::Test {
     EXPECT_OK(DestroyDir(env_, db_dir_));
   }
 
+  // Replaces the lock manager under test with one created with `txn_opt`.
+  void ResetLocker(const TransactionDBOptions& txn_opt) {
+    locker_.reset(new PointLockManager(
+        static_cast<PessimisticTransactionDB*>(db_), txn_opt));
+  }
+
   PessimisticTransaction* NewTxn(
       TransactionOptions txn_opt = TransactionOptions()) {
     Transaction* txn = db_->BeginTransaction(WriteOptions(), txn_opt);
@@ -915,34 +915,29 @@ Status PessimisticTransaction::LockBatch(WriteBatch* batch,
     return s;
   }
 
-  // Attempt to lock all keys
+  // Attempt to lock all keys at once
+  std::vector<uint32_t> cfh_ids;
+  std::vector<std::string> keys;
   for (const auto& cf_iter : handler.keys_) {
-    uint32_t cfh_id = cf_iter.first;
-    auto& cfh_keys = cf_iter.second;
-
-    for (const auto& key_iter : cfh_keys) {
-      const std::string& key = key_iter;
-
-      s = txn_db_impl_->TryLock(this, cfh_id, key, true /* exclusive */);
-      if (!s.ok()) {
-        break;
-      }
-      PointLockRequest r;
-      r.column_family_id = cfh_id;
-      r.key = key;
-      r.seq = kMaxSequenceNumber;
-      r.read_only = false;
-      r.exclusive = true;
-      keys_to_unlock->Track(r);
-    }
-
-    if (!s.ok()) {
-      break;
+    for (const auto& key : cf_iter.second) {
+      cfh_ids.push_back(cf_iter.first);
+      keys.push_back(key);
     }
   }
-
+  s = txn_db_impl_->TryLockMany(this, cfh_ids, keys, true /* exclusive */);
   if (!s.ok()) {
-    txn_db_impl_->UnLock(this, *keys_to_unlock);
+    // None of the keys is left locked
+    return s;
+  }
+
+  for (size_t i = 0; i < keys.size(); i++) {
+    PointLockRequest r;
+    r.column_family_id = cfh_ids[i];
+    r.key = std::move(keys[i]);
+    r.seq = kMaxSequenceNumber;
+    r.read_only = false;
+    r.exclusive = true;
+    keys_to_unlock->Track(r);
   }
 
   return s;
@@ -1072,6 +1067,83 @@ Status PessimisticTransaction::TryLock(ColumnFamilyHandle* column_family,
   return s;
 }
 
+Status PessimisticTransaction::TryLockMany(
+    const std::vector<ColumnFamilyHandle*>& column_families,
+    const std::vector<Slice>& keys, bool read_only, bool exclusive) {
+  if (UNLIKELY(skip_concurrency_control_)) {
+    return Status::OK();
+  }
+  if (!tracked_locks_->IsPointLockSupported()) {
+    return TransactionBaseImpl::TryLockMany(column_families, keys, read_only,
+                                            exclusive);
+  }
+
+  // The keys already locked by this transaction, or repeated in the batch,
+  // go through TryLock() after the others are locked.
+  std::vector<size_t> batch;
+  std::vector<uint32_t> cfh_ids;
+  std::vector<std::string> key_strs;
+  std::vector<size_t> others;
+  std::set<std::pair<uint32_t, std::string>> seen;
+  for (size_t i = 0; i < keys.size(); i++) {
+    uint32_t cfh_id = GetColumnFamilyID(column_families[i]);
+    std::string key_str = keys[i].ToString();
+    if (!tracked_locks_->GetPointLockStatus(cfh_id, key_str).locked &&
+        seen.emplace(cfh_id, key_str).second) {
+      batch.push_back(i);
+      cfh_ids.push_back(cfh_id);
+      key_strs.push_back(std::move(key_str));
+    } else {
+      others.push_back(i);
+    }
+  }
+
+  Status s;
+  if (!batch.empty()) {
+    s = txn_db_impl_->TryLockMany(this, cfh_ids, key_strs, exclusive);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  SetSnapshotIfNeeded();
+
+  // Validate and track the keys like TryLock()
+  for (size_t j = 0; j < batch.size(); j++) {
+    ColumnFamilyHandle* column_family = column_families[batch[j]];
+    const ColumnFamilyHandle* const cfh =
+        column_family ? column_family : db_impl_->DefaultColumnFamily();
+    assert(cfh);
+    const Comparator* const ucmp = cfh->GetComparator();
+    assert(ucmp);
+    size_t ts_sz = ucmp->timestamp_size();
+
+    SequenceNumber tracked_at_seq = kMaxSequenceNumber;
+    if (snapshot_ == nullptr &&
+        (0 == ts_sz || kMaxTxnTimestamp == read_timestamp_)) {
+      tracked_at_seq = db_->GetLatestSequenceNumber();
+    } else {
+      s = ValidateSnapshot(column_family, keys[batch[j]], &tracked_at_seq);
+      if (!s.ok()) {
+        // Unlock the keys that are not tracked yet
+        for (size_t k = j; k < batch.size(); k++) {
+          txn_db_impl_->UnLock(this, cfh_ids[k], key_strs[k]);
+        }
+        return s;
+      }
+    }
+    TrackKey(cfh_ids[j], key_strs[j], tracked_at_seq, read_only, exclusive);
+  }
+
+  for (size_t i : others) {
+    s = TryLock(column_families[i], keys[i], read_only, exclusive);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return s;
+}
+
 Status PessimisticTransaction::GetRangeLock(ColumnFamilyHandle* column_family,
                                             const Endpoint& start_endp,
                                             const Endpoint& end_endp) {
@@ -152,6 +152,12 @@ class PessimisticTransaction : public TransactionBaseImpl {
                  bool read_only, bool exclusive, const bool do_validate = true,
                  const bool assume_tracked = false) override;
 
+  // Locks the keys not locked by this transaction yet with a single call to
+  // the lock manager.
+  Status TryLockMany(const std::vector<ColumnFamilyHandle*>& column_families,
+                     const std::vector<Slice>& keys, bool read_only,
+                     bool exclusive) override;
+
   void Clear() override;
 
   PessimisticTransactionDB* txn_db_impl_;
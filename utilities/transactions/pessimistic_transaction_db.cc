@@ -461,6 +461,12 @@ Status PessimisticTransactionDB::TryLock(PessimisticTransaction* txn,
   return lock_manager_->TryLock(txn, cfh_id, key, GetEnv(), exclusive);
 }
 
+Status PessimisticTransactionDB::TryLockMany(
+    PessimisticTransaction* txn, const std::vector<uint32_t>& cfh_ids,
+    const std::vector<std::string>& keys, bool exclusive) {
+  return lock_manager_->TryLockMany(txn, cfh_ids, keys, GetEnv(), exclusive);
+}
+
 Status PessimisticTransactionDB::TryRangeLock(PessimisticTransaction* txn,
                                               uint32_t cfh_id,
                                               const Endpoint& start_endp,
@@ -400,6 +400,18 @@ void TransactionBaseImpl::MultiGet(const ReadOptions& _read_options,
                                       sorted_input);
 }
 
+Status TransactionBaseImpl::TryLockMany(
+    const std::vector<ColumnFamilyHandle*>& column_families,
+    const std::vector<Slice>& keys, bool read_only, bool exclusive) {
+  for (size_t i = 0; i < keys.size(); ++i) {
+    Status s = TryLock(column_families[i], keys[i], read_only, exclusive);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
 std::vector<Status> TransactionBaseImpl::MultiGetForUpdate(
     const ReadOptions& read_options,
     const std::vector<ColumnFamilyHandle*>& column_family,
@@ -415,13 +427,11 @@ std::vector<Status> TransactionBaseImpl::MultiGetForUpdate(
   values->resize(num_keys);
 
   // Lock all keys
-  for (size_t i = 0; i < num_keys; ++i) {
-    Status s = TryLock(column_family[i], keys[i], true /* read_only */,
-                       true /* exclusive */);
-    if (!s.ok()) {
-      // Fail entire multiget if we cannot lock all keys
-      return std::vector<Status>(num_keys, s);
-    }
+  Status s = TryLockMany(column_family, keys, true /* read_only */,
+                         true /* exclusive */);
+  if (!s.ok()) {
+    // Fail entire multiget if we cannot lock all keys
+    return std::vector<Status>(num_keys, s);
   }
 
   // TODO(agiardullo): optimize multiget?
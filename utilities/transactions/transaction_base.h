@@ -46,6 +46,12 @@ class TransactionBaseImpl : public Transaction {
                          const bool do_validate = true,
                          const bool assume_tracked = false) = 0;
 
+  // Called before executing MultiGetForUpdate, like TryLock() for each key.
+  // Stops at the first key that fails to be locked.
+  virtual Status TryLockMany(
+      const std::vector<ColumnFamilyHandle*>& column_families,
+      const std::vector<Slice>& keys, bool read_only, bool exclusive);
+
   void SetSavePoint() override;
 
   Status RollbackToSavePoint() override;